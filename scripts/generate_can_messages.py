@@ -0,0 +1,599 @@
+"""Generate src/can_messages.h from src/can_messages.dbc.
+
+Every BO_ of the DBC becomes a struct with the raw signal values, constexpr
+physical <-> raw helpers for scaled signals, encode()/decode() on an 8-byte
+buffer and, for CRC-protected frames, checksum_ok(). Only the subset of DBC
+the file uses is parsed: BO_, SG_ (Intel byte order, no multiplexing), CM_,
+BA_DEF_, BA_DEF_DEF_ and BA_. VAL_ tables are accepted and ignored.
+
+Attributes:
+  GenMsgCycleTime  message period in ms, for the comments
+  ChecksumType     message: None, CanCrc8 (can_crc8() in byte 7) or BmwI3
+  SignalRole       signal: Data, Counter or Checksum
+
+Standalone:  python scripts/generate_can_messages.py [dbc] [header]
+PlatformIO:  pre: extra script, regenerates the header when the DBC or this
+             script is newer than it.
+"""
+
+import math
+import os
+import re
+import sys
+from fractions import Fraction
+
+DBC_PATH = os.path.join("src", "can_messages.dbc")
+HEADER_PATH = os.path.join("src", "can_messages.h")
+SCRIPT_PATH = os.path.join("scripts", "generate_can_messages.py")
+
+
+class DbcError(Exception):
+    pass
+
+
+class Signal:
+    def __init__(self, name, start, length, signed, scale, offset, minimum, maximum, unit):
+        self.name = name
+        self.start = start
+        self.length = length
+        self.signed = signed
+        self.scale = scale
+        self.offset = offset
+        self.minimum = minimum
+        self.maximum = maximum
+        self.unit = unit
+        self.role = "Data"
+        self.comment = ""
+
+
+class Message:
+    def __init__(self, frame_id, name, length, sender):
+        self.frame_id = frame_id
+        self.name = name
+        self.length = length
+        self.sender = sender
+        self.signals = []
+        self.receivers = []
+        self.cycle_time = 0
+        self.checksum = "None"
+        self.comment = ""
+
+    def signal(self, name):
+        for signal in self.signals:
+            if signal.name == name:
+                return signal
+        raise DbcError(f"{self.name}: unknown signal {name}")
+
+
+SG_RE = re.compile(
+    r'^SG_\s+(\w+)\s*:\s*(\d+)\|(\d+)@([01])([+-])\s*'
+    r'\(([^,]+),([^)]+)\)\s*\[([^|]+)\|([^\]]+)\]\s*"([^"]*)"\s*(.*)$'
+)
+BO_RE = re.compile(r"^BO_\s+(\d+)\s+(\w+)\s*:\s*(\d+)\s+(\w+)")
+CM_BO_RE = re.compile(r'^CM_\s+BO_\s+(\d+)\s+"(.*)"\s*;$', re.S)
+CM_SG_RE = re.compile(r'^CM_\s+SG_\s+(\d+)\s+(\w+)\s+"(.*)"\s*;$', re.S)
+BA_DEF_RE = re.compile(r'^BA_DEF_\s+(BO_|SG_|BU_|)\s*"(\w+)"\s+(\w+)\s*(.*);$', re.S)
+BA_BO_RE = re.compile(r'^BA_\s+"(\w+)"\s+BO_\s+(\d+)\s+(.+);$')
+BA_SG_RE = re.compile(r'^BA_\s+"(\w+)"\s+SG_\s+(\d+)\s+(\w+)\s+(.+);$')
+
+
+def statements(text):
+    """Split the DBC into statements; CM_, BA_ and VAL_ entries may span lines
+    (the bare keywords of the NS_ list do not start one)."""
+    current = None
+    for line in text.splitlines():
+        stripped = line.strip()
+        if current is not None:
+            current += "\n" + stripped
+            if stripped.endswith(";") and current.count('"') % 2 == 0:
+                yield current
+                current = None
+            continue
+        if not stripped:
+            continue
+        if re.match(r"(CM_|BA_\w*|VAL_)\s", stripped) and not (
+            stripped.endswith(";") and stripped.count('"') % 2 == 0
+        ):
+            current = stripped
+            continue
+        yield stripped
+    if current is not None:
+        raise DbcError("unterminated statement: " + current.splitlines()[0])
+
+
+def parse_dbc(text):
+    messages = []
+    by_id = {}
+    enums = {}
+    defaults = {}
+    message = None
+    for statement in statements(text):
+        if len(statement.split()) < 2:
+            continue  # NS_ list entry
+        if statement.startswith("BO_ "):
+            match = BO_RE.match(statement)
+            if not match:
+                raise DbcError("bad BO_: " + statement)
+            frame_id = int(match.group(1))
+            if frame_id & 0x80000000:
+                raise DbcError(f"{match.group(2)}: extended IDs are not supported")
+            message = Message(frame_id, match.group(2), int(match.group(3)), match.group(4))
+            if frame_id in by_id:
+                raise DbcError(f"duplicate message ID 0x{frame_id:X}")
+            messages.append(message)
+            by_id[frame_id] = message
+        elif statement.startswith("SG_ "):
+            match = SG_RE.match(statement)
+            if not match or message is None:
+                raise DbcError("bad SG_: " + statement)
+            name = match.group(1)
+            if match.group(4) != "1":
+                raise DbcError(f"{message.name}.{name}: only Intel (little-endian) signals are supported")
+            signal = Signal(
+                name,
+                int(match.group(2)),
+                int(match.group(3)),
+                match.group(5) == "-",
+                Fraction(match.group(6).strip()),
+                Fraction(match.group(7).strip()),
+                Fraction(match.group(8).strip()),
+                Fraction(match.group(9).strip()),
+                match.group(10),
+            )
+            message.signals.append(signal)
+            for receiver in match.group(11).split(","):
+                receiver = receiver.strip()
+                if receiver and receiver not in message.receivers:
+                    message.receivers.append(receiver)
+        elif statement.startswith("CM_ BO_"):
+            match = CM_BO_RE.match(statement)
+            if match:
+                lookup(by_id, match.group(1)).comment = match.group(2)
+        elif statement.startswith("CM_ SG_"):
+            match = CM_SG_RE.match(statement)
+            if match:
+                lookup(by_id, match.group(1)).signal(match.group(2)).comment = match.group(3)
+        elif statement.startswith("BA_DEF_DEF_"):
+            parts = statement[len("BA_DEF_DEF_"):].strip().rstrip(";").split(None, 1)
+            defaults[parts[0].strip('"')] = parts[1].strip().strip('"')
+        elif statement.startswith("BA_DEF_"):
+            match = BA_DEF_RE.match(statement)
+            if match and match.group(3) == "ENUM":
+                enums[match.group(2)] = [value.strip().strip('"') for value in match.group(4).split(",")]
+        elif statement.startswith("BA_ "):
+            match = BA_SG_RE.match(statement)
+            if match:
+                signal = lookup(by_id, match.group(2)).signal(match.group(3))
+                signal.role = attribute_value(enums, match.group(1), match.group(4))
+                continue
+            match = BA_BO_RE.match(statement)
+            if match:
+                target = lookup(by_id, match.group(2))
+                value = attribute_value(enums, match.group(1), match.group(3))
+                if match.group(1) == "GenMsgCycleTime":
+                    target.cycle_time = int(value)
+                elif match.group(1) == "ChecksumType":
+                    target.checksum = value
+    for message in messages:
+        if message.checksum == "None" and "ChecksumType" in defaults:
+            message.checksum = defaults["ChecksumType"]
+        validate(message)
+    return messages
+
+
+def lookup(by_id, frame_id):
+    frame_id = int(frame_id)
+    if frame_id not in by_id:
+        raise DbcError(f"attribute or comment for unknown message {frame_id}")
+    return by_id[frame_id]
+
+
+def attribute_value(enums, name, value):
+    value = value.strip().strip('"')
+    if name in enums and re.fullmatch(r"\d+", value):
+        return enums[name][int(value)]
+    return value
+
+
+def validate(message):
+    if message.checksum not in ("None", "CanCrc8", "BmwI3"):
+        raise DbcError(f"{message.name}: unknown ChecksumType {message.checksum}")
+    used = 0
+    for signal in message.signals:
+        if signal.role not in ("Data", "Counter", "Checksum"):
+            raise DbcError(f"{message.name}.{signal.name}: unknown SignalRole {signal.role}")
+        if signal.length < 1 or signal.start + signal.length > 8 * message.length:
+            raise DbcError(f"{message.name}.{signal.name}: outside the {message.length}-byte frame")
+        if signal.scale == 0:
+            raise DbcError(f"{message.name}.{signal.name}: zero scale")
+        mask = ((1 << signal.length) - 1) << signal.start
+        if used & mask:
+            raise DbcError(f"{message.name}.{signal.name}: overlaps another signal")
+        used |= mask
+    checksums = [signal for signal in message.signals if signal.role == "Checksum"]
+    if message.checksum == "None" and checksums:
+        raise DbcError(f"{message.name}: checksum signal without ChecksumType")
+    if message.checksum != "None" and len(checksums) != 1:
+        raise DbcError(f"{message.name}: ChecksumType needs exactly one checksum signal")
+    if message.checksum == "CanCrc8" and (checksums[0].start, checksums[0].length) != (56, 8):
+        raise DbcError(f"{message.name}: the CanCrc8 checksum must be 56|8")
+
+
+# --------------------------------------------------------------------------
+# C++ output
+# --------------------------------------------------------------------------
+
+
+def struct_name(message_name):
+    parts = []
+    for part in message_name.split("_"):
+        if part.isupper():
+            part = part.capitalize()
+        parts.append(part[:1].upper() + part[1:])
+    return "Can" + "".join(parts)
+
+
+def field_name(signal_name):
+    name = re.sub(r"([A-Z]+)([A-Z][a-z])", r"\1_\2", signal_name)
+    name = re.sub(r"([a-z0-9])([A-Z])", r"\1_\2", name)
+    return name.lower()
+
+
+def raw_type(signal):
+    if signal.length == 1 and not signal.signed:
+        return "bool"
+    for width in (8, 16, 32, 64):
+        if signal.length <= width:
+            return ("int%d_t" if signal.signed else "uint%d_t") % width
+    raise DbcError(signal.name + ": longer than 64 bits")
+
+
+def type_width(signal):
+    return 1 if raw_type(signal) == "bool" else int(re.search(r"\d+", raw_type(signal)).group())
+
+
+def bit_range(signal):
+    if signal.signed:
+        return -(1 << (signal.length - 1)), (1 << (signal.length - 1)) - 1
+    return 0, (1 << signal.length) - 1
+
+
+def raw_limits(signal):
+    """DBC [min|max] as raw values, limited to what the bits hold."""
+    lo, hi = bit_range(signal)
+    if signal.minimum == 0 and signal.maximum == 0:
+        return lo, hi
+    low = (signal.minimum - signal.offset) / signal.scale
+    high = (signal.maximum - signal.offset) / signal.scale
+    if low > high:
+        low, high = high, low
+    return max(lo, math.ceil(low)), min(hi, math.floor(high))
+
+
+def is_physical(signal):
+    """Scaled signals and those with a unit get float helpers; the others
+    (enums, bitfields, flags) are integers only."""
+    return signal.scale != 1 or signal.offset != 0 or bool(signal.unit)
+
+
+def int_literal(value, ctype):
+    if ctype.startswith("uint"):
+        return f"{value}U" if ctype != "uint64_t" else f"{value}ULL"
+    if ctype == "int64_t":
+        if value == -(1 << 63):
+            return "(-9223372036854775807LL - 1)"
+        return f"{value}LL"
+    if ctype == "int32_t" and value == -(1 << 31):
+        return "(-2147483647 - 1)"
+    return str(value)
+
+
+def float_literal(value):
+    text = repr(float(value))
+    if "e" not in text and "." not in text:
+        text += ".0"
+    return text + "f"
+
+
+def number(value):
+    """DBC-style number for the comments."""
+    if value.denominator == 1:
+        return str(value.numerator)
+    return repr(float(value))
+
+
+def signal_comment(signal):
+    text = (
+        f"{signal.start}|{signal.length}@1{'-' if signal.signed else '+'} "
+        f"({number(signal.scale)},{number(signal.offset)}) "
+        f"[{number(signal.minimum)}|{number(signal.maximum)}]"
+    )
+    if signal.unit:
+        text += f" {signal.unit}"
+    if signal.role != "Data":
+        text += " " + signal.role.lower()
+    return text
+
+
+def layout_hash(message):
+    """FNV-1a over start, length, sign and role of every signal."""
+    value = 0x811C9DC5
+    for signal in message.signals:
+        for byte in (signal.start, signal.length, int(signal.signed), ("Data", "Counter", "Checksum").index(signal.role)):
+            value = ((value ^ byte) * 0x01000193) & 0xFFFFFFFF
+    return value
+
+
+def used_mask(message):
+    mask = 0
+    for signal in message.signals:
+        mask |= ((1 << signal.length) - 1) << signal.start
+    return mask
+
+
+def encode_term(signal):
+    name = field_name(signal.name)
+    ctype = raw_type(signal)
+    if ctype == "bool":
+        value = f"static_cast<uint64_t>({name})"
+    else:
+        if signal.signed:
+            value = f"static_cast<uint64_t>(static_cast<u{ctype}>({name}))"
+        else:
+            value = f"static_cast<uint64_t>({name})"
+        if signal.length < type_width(signal):
+            value = f"({value} & {hex_mask(signal.length)})"
+    return value if signal.start == 0 else f"{value} << {signal.start}"
+
+
+def hex_mask(length):
+    return f"0x{(1 << length) - 1:X}" + ("U" if length <= 32 else "ULL")
+
+
+def decode_term(signal):
+    ctype = raw_type(signal)
+    bits = "bits" if signal.start == 0 else f"bits >> {signal.start}"
+    if signal.start + signal.length < 64:
+        bits = f"{bits} & {hex_mask(signal.length)}" if signal.start == 0 else f"({bits}) & {hex_mask(signal.length)}"
+    if ctype == "bool":
+        return f"({bits}) != 0U"
+    if signal.signed:
+        return f"static_cast<{ctype}>(can_codec_sign_extend({bits}, {signal.length}U))"
+    return f"static_cast<{ctype}>({bits})"
+
+
+def emit_conversions(out, signal):
+    name = field_name(signal.name)
+    ctype = raw_type(signal)
+    lo, hi = raw_limits(signal)
+    lo_text, hi_text = int_literal(lo, ctype), int_literal(hi, ctype)
+    unit = f" [{signal.unit}]" if signal.unit else ""
+    if not is_physical(signal) or raw_type(signal) == "bool":
+        if (lo, hi) != bit_range(signal):
+            out.append(f"    void set_{name}({ctype} raw) {{ {name} = can_codec_clamp<{ctype}>(raw, {lo_text}, {hi_text}); }}")
+        return
+    inverse = 1 / signal.scale
+    offset = "" if signal.offset == 0 else (
+        f" - {float_literal(signal.offset)}" if signal.offset > 0 else f" + {float_literal(-signal.offset)}"
+    )
+    value = f"(value{offset})" if offset else "value"
+    if inverse.denominator == 1:
+        scaled = f"value{offset}" if inverse == 1 else f"{value} * {float_literal(inverse)}"
+    else:
+        scaled = f"{value} / {float_literal(signal.scale)}"
+    # Dividing by an integral 1/scale gives the correctly rounded value
+    # (1000 mV / 1000 == 1.0f exactly); other scales multiply.
+    physical = f"static_cast<float>(raw)"
+    if inverse.denominator == 1 and inverse != 1:
+        physical += f" / {float_literal(inverse)}"
+    elif signal.scale != 1:
+        physical += f" * {float_literal(signal.scale)}"
+    if signal.offset != 0:
+        physical += (
+            f" + {float_literal(signal.offset)}" if signal.offset > 0 else f" - {float_literal(-signal.offset)}"
+        )
+    out.append(f"    // {signal.name}{unit}")
+    out.append(f"    static constexpr {ctype} {name}_raw(float value)")
+    out.append("    {")
+    out.append(f"        return can_codec_raw<{ctype}>({scaled}, {lo_text}, {hi_text});")
+    out.append("    }")
+    out.append(f"    static constexpr float {name}_value({ctype} raw) {{ return {physical}; }}")
+    out.append(f"    void set_{name}(float value) {{ {name} = {name}_raw(value); }}")
+    out.append(f"    float get_{name}() const {{ return {name}_value({name}); }}")
+
+
+def emit_message(out, message):
+    name = struct_name(message.name)
+    checksum = {"None": "CAN_CHECKSUM_NONE", "CanCrc8": "CAN_CHECKSUM_CRC8", "BmwI3": "CAN_CHECKSUM_BMW_I3"}[
+        message.checksum
+    ]
+    header = f"// {message.name} (0x{message.frame_id:03X}), {message.length} bytes"
+    if message.cycle_time:
+        header += f", {message.cycle_time} ms"
+    header += f", {message.sender} -> {', '.join(message.receivers) or '?'}"
+    out.append(header)
+    if message.comment:
+        out.extend(wrap_comment(message.comment, ""))
+    out.append(f"struct {name}")
+    out.append("{")
+    out.append(f"    static constexpr uint32_t kId = 0x{message.frame_id:03X}U;")
+    out.append(f"    static constexpr uint8_t kLen = {message.length}U;")
+    out.append(f'    static constexpr const char *kName = "{message.name}";')
+    out.append(f"    static constexpr CanChecksum kChecksum = {checksum};")
+    out.append(f"    static constexpr uint64_t kUsedMask = 0x{used_mask(message):016X}ULL;")
+    out.append(f"    static constexpr uint32_t kLayoutHash = 0x{layout_hash(message):08X}U;")
+    out.append("")
+    width = max(len(f"{raw_type(s)} {field_name(s.name)}{' = false;' if raw_type(s) == 'bool' else ' = 0;'}") for s in message.signals)
+    for signal in message.signals:
+        ctype = raw_type(signal)
+        if signal.comment:
+            out.extend(wrap_comment(signal.comment, "    "))
+        declaration = f"{ctype} {field_name(signal.name)}{' = false;' if ctype == 'bool' else ' = 0;'}"
+        out.append(f"    {declaration.ljust(width)} // {signal_comment(signal)}")
+    conversions = []
+    for signal in message.signals:
+        if signal.role == "Data":
+            block = []
+            emit_conversions(block, signal)
+            if block:
+                if conversions and (len(block) > 1 or len(conversions[-1]) > 1):
+                    conversions.append([""])
+                conversions.append(block)
+    if conversions:
+        out.append("")
+        for block in conversions:
+            out.extend(block)
+
+    crc = next((s for s in message.signals if s.role == "Checksum"), None)
+    out.append("")
+    if message.checksum == "CanCrc8":
+        out.append("    // Writes all 8 bytes; the checksum slot is computed, the crc field is ignored")
+    else:
+        out.append("    // Writes all 8 bytes, unused bits are 0")
+    out.append("    void encode(uint8_t data[8]) const")
+    out.append("    {")
+    terms = [encode_term(s) for s in message.signals if not (message.checksum == "CanCrc8" and s is crc)]
+    if terms:
+        out.append(f"        const uint64_t bits = {terms[0]}")
+        for term in terms[1:]:
+            out.append(f"                              | {term}")
+        out[-1] += ";"
+    else:
+        out.append("        const uint64_t bits = 0U;")
+    out.append("        can_codec_store(data, bits);")
+    if message.checksum == "CanCrc8":
+        out.append("        data[7] = can_crc8(data);")
+    out.append("    }")
+    out.append("")
+    out.append(f"    static {name} decode(const uint8_t data[8])")
+    out.append("    {")
+    out.append("        const uint64_t bits = can_codec_load(data);")
+    out.append(f"        {name} message;")
+    for signal in message.signals:
+        out.append(f"        message.{field_name(signal.name)} = {decode_term(signal)};")
+    out.append("        return message;")
+    out.append("    }")
+    if message.checksum == "CanCrc8":
+        out.append("")
+        out.append("    static bool checksum_ok(const uint8_t data[8])")
+        out.append("    {")
+        out.append("        uint8_t copy[8];")
+        out.append("        memcpy(copy, data, sizeof(copy));")
+        out.append("        copy[7] = 0U;")
+        out.append("        return can_crc8(copy) == data[7];")
+        out.append("    }")
+    out.append("")
+    out.append(f"    bool operator==(const {name} &other) const")
+    out.append("    {")
+    comparisons = [f"{field_name(s.name)} == other.{field_name(s.name)}" for s in message.signals]
+    out.append(f"        return {comparisons[0]}")
+    for comparison in comparisons[1:]:
+        out.append(f"               && {comparison}")
+    out[-1] += ";"
+    out.append("    }")
+    out.append(f"    bool operator!=(const {name} &other) const {{ return !(*this == other); }}")
+    out.append("};")
+    out.append("")
+
+
+def wrap_comment(text, indent, width=100):
+    lines = []
+    line = ""
+    for word in text.split():
+        if line and len(indent) + 3 + len(line) + 1 + len(word) > width:
+            lines.append(f"{indent}// {line}")
+            line = word
+        else:
+            line = f"{line} {word}" if line else word
+    if line:
+        lines.append(f"{indent}// {line}")
+    return lines
+
+
+def generate(messages, dbc_name):
+    out = [
+        "// Generated by scripts/generate_can_messages.py from " + dbc_name + ". Do not edit;",
+        "// change the DBC and rerun the script (PlatformIO builds do this).",
+        "",
+        "#ifndef CAN_MESSAGES_H",
+        "#define CAN_MESSAGES_H",
+        "",
+        "#include <stdint.h>",
+        "#include <string.h>",
+        "",
+        '#include "utils/can_codec.h"',
+        '#include "utils/can_crc.h"',
+        "",
+        "// Each message is a struct of raw signal values (the integers on the wire).",
+        "// For scaled signals, <signal>_raw() converts a physical value to raw",
+        "// (round to nearest, clamped to the DBC range), <signal>_value() converts",
+        "// back and set_/get_<signal>() wrap both. Integer signals with a DBC range",
+        "// narrower than their bits get a clamping set_<signal>().",
+        "",
+    ]
+    for message in messages:
+        emit_message(out, message)
+    out.append("#define CAN_MESSAGE_LIST(X) \\")
+    for index, message in enumerate(messages):
+        suffix = " \\" if index + 1 < len(messages) else ""
+        out.append(f"    X({struct_name(message.name)}){suffix}")
+    out.append("")
+    out.append("#endif // CAN_MESSAGES_H")
+    out.append("")
+    return "\n".join(out)
+
+
+def write_header(dbc_path, header_path, dbc_name):
+    with open(dbc_path, encoding="utf-8") as dbc:
+        messages = parse_dbc(dbc.read())
+    text = generate(messages, dbc_name)
+    if os.path.exists(header_path):
+        with open(header_path, encoding="utf-8") as existing:
+            if existing.read() == text:
+                return False
+    with open(header_path, "w", encoding="utf-8", newline="\n") as header:
+        header.write(text)
+    return True
+
+
+def out_of_date(root):
+    header = os.path.join(root, HEADER_PATH)
+    if not os.path.exists(header):
+        return True
+    newest = max(os.path.getmtime(os.path.join(root, DBC_PATH)), os.path.getmtime(os.path.join(root, SCRIPT_PATH)))
+    return newest > os.path.getmtime(header)
+
+
+def main(argv):
+    root = os.path.dirname(os.path.dirname(os.path.abspath(argv[0])))
+    dbc_path = argv[1] if len(argv) > 1 else os.path.join(root, DBC_PATH)
+    header_path = argv[2] if len(argv) > 2 else os.path.join(root, HEADER_PATH)
+    try:
+        changed = write_header(dbc_path, header_path, os.path.basename(dbc_path))
+    except (DbcError, OSError) as error:
+        print(f"generate_can_messages: {error}", file=sys.stderr)
+        return 1
+    print(f"{header_path}: {'written' if changed else 'up to date'}")
+    return 0
+
+
+try:
+    from SCons.Script import Import
+
+    Import("env")
+except ImportError:
+    env = None
+
+if env is not None:
+    # SCons runs extra scripts without __file__; paths are relative to the project
+    project_dir = env.subst("$PROJECT_DIR")
+    if out_of_date(project_dir):
+        try:
+            write_header(
+                os.path.join(project_dir, DBC_PATH), os.path.join(project_dir, HEADER_PATH), os.path.basename(DBC_PATH)
+            )
+        except DbcError as error:
+            sys.stderr.write(f"generate_can_messages: {error}\n")
+            env.Exit(1)
+elif __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -0,0 +1,660 @@
+#ifndef BLACKBOX_RECORDER_H
+#define BLACKBOX_RECORDER_H
+
+#include <Arduino.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "settings.h"
+#include "utils/at24c_async.h"
+#include "utils/crc32.h"
+
+// Black-box event recorder on the external AT24C I2C EEPROM.
+//
+// The device is used as a ring of fixed 16-byte records: DTC transitions,
+// BMS state changes, contactor events, current limit changes and periodic
+// pack snapshots quantised to 8 bytes. Every record carries a 16-bit
+// sequence number and a CRC-32 check byte; erased (0xFF) or torn records are
+// rejected by the type and check byte.
+//
+// log_*() only time-stamps the record and appends it to a RAM queue.
+// service() (called from a periodic task) drives the non-blocking At24cAsync
+// driver within a time budget: records are batched into page-aligned writes
+// (one I2C transaction per page chunk, never crossing a page) and the
+// device's internal write cycle is acknowledge-polled once per call instead
+// of being waited for. A partial page is written once the oldest queued
+// record is kFlushDelayMs old, so events reach the device quickly while
+// snapshots usually share a page write.
+//
+// At startup the ring is scanned page by page from service() to find the
+// record with the newest sequence; writing continues behind it. Records
+// logged before the scan has finished are queued. start_dump() reads the ring
+// oldest first in whole pages and hands every valid record to a callback
+// (console print, CAN frames); writes resume when the dump is done.
+class BlackBoxRecorder
+{
+public:
+    enum RecordType : uint8_t
+    {
+        RECORD_BOOT = 1,      // data: reset flags (u32)
+        RECORD_DTC = 2,       // data: source, bms state, old dtc (u16), new dtc (u16)
+        RECORD_STATE = 3,     // data: old state, new state, vehicle state, ready to shutdown
+        RECORD_CONTACTOR = 4, // data: old state, new state, dtc, current (0.1 A), pack voltage (0.1 V)
+        RECORD_LIMITS = 5,    // data: max discharge, max charge, rms discharge, rms charge (0.1 A)
+        RECORD_SNAPSHOT = 6,  // data: see encode_snapshot()
+    };
+
+    enum DtcSource : uint8_t
+    {
+        DTC_SOURCE_BMS = 0,
+        DTC_SOURCE_PACK = 1,
+        DTC_SOURCE_CONTACTOR = 2,
+        DTC_SOURCE_SHUNT = 3,
+    };
+
+    struct Record
+    {
+        uint32_t time_ms; // millis() when logged
+        uint16_t sequence;
+        uint8_t type;
+        uint8_t check; // low byte of the CRC-32 over the other 15 bytes
+        uint8_t data[8];
+    };
+
+    // Decoded RECORD_SNAPSHOT.
+    struct Snapshot
+    {
+        float current_A;
+        float cell_min_V;
+        float cell_max_V;
+        float soc; // 0..1
+        float temp_min_C;
+        float temp_max_C;
+    };
+
+    typedef void (*DumpCallback)(const Record &record, void *context);
+
+    static constexpr size_t kRecordBytes = sizeof(Record);
+    static constexpr size_t kQueueRecords = 32U;
+    static constexpr size_t kMaxPageBytes = 64U;
+    static constexpr uint32_t kServiceBudgetUs = 500U; // per service() call
+    static constexpr uint32_t kReadBudgetUs = 2000U;   // per service() call while scanning or dumping
+    static constexpr uint32_t kFlushDelayMs = 1000U;   // max age of a queued record
+    static constexpr uint8_t kMaxErrors = 3U;          // consecutive I2C errors before going offline
+
+    // page_bytes is capped at kMaxPageBytes; the whole page goes out in one
+    // I2C transaction.
+    BlackBoxRecorder(uint8_t i2c_address = BLACKBOX_I2C_ADDRESS,
+                     uint8_t address_bytes = BLACKBOX_ADDRESS_BYTES,
+                     uint32_t _device_bytes = BLACKBOX_DEVICE_BYTES,
+                     uint8_t _page_bytes = BLACKBOX_PAGE_BYTES)
+        : eeprom(i2c_address, address_bytes, page_size(_page_bytes), page_size(_page_bytes)),
+          device_bytes(_device_bytes),
+          page_bytes(page_size(_page_bytes)),
+          capacity(static_cast<uint16_t>(_device_bytes / kRecordBytes)),
+          state(STATE_IDLE),
+          operation(OP_NONE),
+          head(0U),
+          next_sequence(0U),
+          scan_page(0U),
+          scan_found(false),
+          scan_best_sequence(0U),
+          dump_record(0U),
+          dump_records_left(0U),
+          dump_callback(nullptr),
+          dump_context(nullptr),
+          dump_requested(false),
+          queue_head(0U),
+          queue_count(0U),
+          batch_count(0U),
+          flushing(false),
+          errors(0U),
+          write_errors(0U),
+          records_written(0U),
+          records_dropped(0U),
+          max_service_us(0U)
+    {
+    }
+
+    // Start the non-blocking ring scan; logging is possible right away.
+    void begin()
+    {
+        if (state != STATE_IDLE)
+        {
+            return;
+        }
+
+        eeprom.Begin();
+        state = STATE_SCANNING;
+    }
+
+    void log_boot(uint32_t reset_flags)
+    {
+        uint8_t data[8] = {};
+        put_u32(data, 0U, reset_flags);
+        log(RECORD_BOOT, data);
+    }
+
+    void log_dtc(DtcSource source, uint8_t bms_state, uint16_t old_dtc, uint16_t new_dtc)
+    {
+        uint8_t data[8] = {};
+        data[0] = source;
+        data[1] = bms_state;
+        put_u16(data, 2U, old_dtc);
+        put_u16(data, 4U, new_dtc);
+        log(RECORD_DTC, data);
+    }
+
+    void log_state(uint8_t old_state, uint8_t new_state, int8_t vehicle_state, bool ready_to_shutdown)
+    {
+        uint8_t data[8] = {};
+        data[0] = old_state;
+        data[1] = new_state;
+        data[2] = static_cast<uint8_t>(vehicle_state);
+        data[3] = ready_to_shutdown ? 1U : 0U;
+        log(RECORD_STATE, data);
+    }
+
+    void log_contactor(uint8_t old_state, uint8_t new_state, uint8_t dtc, float current_A, float pack_voltage_V)
+    {
+        uint8_t data[8] = {};
+        data[0] = old_state;
+        data[1] = new_state;
+        data[2] = dtc;
+        put_u16(data, 4U, static_cast<uint16_t>(quantise(current_A, 10.0f, -32768.0f, 32767.0f)));
+        put_u16(data, 6U, static_cast<uint16_t>(quantise(pack_voltage_V, 10.0f, 0.0f, 65535.0f)));
+        log(RECORD_CONTACTOR, data);
+    }
+
+    void log_limits(float max_discharge_A, float max_charge_A, float rms_discharge_A, float rms_charge_A)
+    {
+        const float limits[4] = {max_discharge_A, max_charge_A, rms_discharge_A, rms_charge_A};
+        uint8_t data[8] = {};
+        for (size_t i = 0; i < 4U; ++i)
+        {
+            put_u16(data, 2U * i, static_cast<uint16_t>(quantise(limits[i], 10.0f, 0.0f, 65535.0f)));
+        }
+        log(RECORD_LIMITS, data);
+    }
+
+    void log_snapshot(const Snapshot &snapshot)
+    {
+        uint8_t data[8];
+        encode_snapshot(snapshot, data);
+        log(RECORD_SNAPSHOT, data);
+    }
+
+    // Snapshot quantisation: current 0.1 A (i16), lowest cell 1 mV (u16),
+    // cell spread 1 mV (u8, saturating), SOC 0.5 % (u8), lowest and highest
+    // temperature 1 degC (i8).
+    static void encode_snapshot(const Snapshot &snapshot, uint8_t *data)
+    {
+        const float spread_mV = (snapshot.cell_max_V - snapshot.cell_min_V) * 1000.0f;
+        put_u16(data, 0U, static_cast<uint16_t>(quantise(snapshot.current_A, 10.0f, -32768.0f, 32767.0f)));
+        put_u16(data, 2U, static_cast<uint16_t>(quantise(snapshot.cell_min_V, 1000.0f, 0.0f, 65535.0f)));
+        data[4] = static_cast<uint8_t>(quantise(spread_mV, 1.0f, 0.0f, 255.0f));
+        data[5] = static_cast<uint8_t>(quantise(snapshot.soc, 200.0f, 0.0f, 200.0f));
+        data[6] = static_cast<uint8_t>(quantise(snapshot.temp_min_C, 1.0f, -128.0f, 127.0f));
+        data[7] = static_cast<uint8_t>(quantise(snapshot.temp_max_C, 1.0f, -128.0f, 127.0f));
+    }
+
+    static Snapshot decode_snapshot(const Record &record)
+    {
+        Snapshot snapshot;
+        snapshot.current_A = static_cast<int16_t>(get_u16(record.data, 0U)) * 0.1f;
+        snapshot.cell_min_V = get_u16(record.data, 2U) * 0.001f;
+        snapshot.cell_max_V = snapshot.cell_min_V + record.data[4] * 0.001f;
+        snapshot.soc = record.data[5] * 0.005f;
+        snapshot.temp_min_C = static_cast<int8_t>(record.data[6]);
+        snapshot.temp_max_C = static_cast<int8_t>(record.data[7]);
+        return snapshot;
+    }
+
+    // Drive the EEPROM until budget_us has elapsed (at least one step); returns
+    // early while the device is busy with its internal write cycle.
+    void service(uint32_t budget_us = kServiceBudgetUs)
+    {
+        if (state == STATE_IDLE || state == STATE_OFFLINE)
+        {
+            return;
+        }
+
+        const uint32_t start_us = micros();
+        if ((state == STATE_SCANNING || state == STATE_DUMPING) && budget_us < kReadBudgetUs)
+        {
+            budget_us = kReadBudgetUs;
+        }
+
+        for (;;)
+        {
+            if (operation == OP_NONE && !start_operation())
+            {
+                break;
+            }
+            if (eeprom.HasError())
+            {
+                fail_operation();
+                break;
+            }
+            if (eeprom.IsDone())
+            {
+                finish_operation();
+            }
+            else
+            {
+                const bool polling = eeprom.IsWaiting();
+                eeprom.Service();
+                if (polling && eeprom.IsWaiting())
+                {
+                    break; // write cycle still running
+                }
+            }
+            if ((micros() - start_us) >= budget_us)
+            {
+                break;
+            }
+        }
+
+        const uint32_t elapsed_us = micros() - start_us;
+        max_service_us = (elapsed_us > max_service_us) ? elapsed_us : max_service_us;
+    }
+
+    // Write queued records out as partial pages from service() instead of
+    // waiting for a page to fill. For the power-down path.
+    void request_flush()
+    {
+        flushing = true;
+    }
+
+    // Hand every record on the device to callback, oldest first, from
+    // service(). Returns false if a dump is already running or the device
+    // is offline.
+    bool start_dump(DumpCallback callback, void *context)
+    {
+        if (callback == nullptr || state == STATE_OFFLINE || state == STATE_IDLE || dump_requested ||
+            state == STATE_DUMPING)
+        {
+            return false;
+        }
+
+        dump_callback = callback;
+        dump_context = context;
+        dump_requested = true;
+        return true;
+    }
+
+    bool dumping() const
+    {
+        return dump_requested || state == STATE_DUMPING;
+    }
+
+    bool ready() const
+    {
+        return state == STATE_RUNNING || state == STATE_DUMPING;
+    }
+
+    bool online() const
+    {
+        return state != STATE_OFFLINE;
+    }
+
+    // Nothing queued or being written (an offline device counts as flushed).
+    bool flushed() const
+    {
+        return state == STATE_OFFLINE || (queue_count == 0U && operation != OP_WRITE);
+    }
+
+    uint16_t capacity_records() const
+    {
+        return capacity;
+    }
+
+    uint16_t queued_records() const
+    {
+        return static_cast<uint16_t>(queue_count);
+    }
+
+    uint32_t written_records() const
+    {
+        return records_written;
+    }
+
+    uint32_t dropped_records() const
+    {
+        return records_dropped;
+    }
+
+    uint32_t write_error_count() const
+    {
+        return write_errors;
+    }
+
+    uint32_t max_service_time_us() const
+    {
+        return max_service_us;
+    }
+
+    // Sequence number the next record will get.
+    uint16_t sequence() const
+    {
+        return next_sequence;
+    }
+
+    // Record parsed from raw device bytes; false if erased, torn or unknown.
+    static bool parse_record(const uint8_t *bytes, Record &record)
+    {
+        memcpy(&record, bytes, kRecordBytes);
+        return record.type >= RECORD_BOOT && record.type <= RECORD_SNAPSHOT && record.check == check_byte(record);
+    }
+
+    // One human-readable line per record for the console dump.
+    static int format_record(const Record &record, char *buffer, size_t size)
+    {
+        const uint8_t *d = record.data;
+        const int n = snprintf(buffer, size, "#%5u %10lu ms ", static_cast<unsigned>(record.sequence),
+                               static_cast<unsigned long>(record.time_ms));
+        if (n < 0 || static_cast<size_t>(n) >= size)
+        {
+            return n;
+        }
+        char *out = buffer + n;
+        const size_t left = size - static_cast<size_t>(n);
+
+        switch (record.type)
+        {
+        case RECORD_BOOT:
+            return n + snprintf(out, left, "BOOT reset flags 0x%08lX",
+                                static_cast<unsigned long>(get_u32(d, 0U)));
+        case RECORD_DTC:
+            return n + snprintf(out, left, "DTC  source %u state %u 0x%04X -> 0x%04X", d[0], d[1],
+                                get_u16(d, 2U), get_u16(d, 4U));
+        case RECORD_STATE:
+            return n + snprintf(out, left, "STATE %u -> %u vehicle %d shutdown %u", d[0], d[1],
+                                static_cast<int8_t>(d[2]), d[3]);
+        case RECORD_CONTACTOR:
+            return n + snprintf(out, left, "CONT %u -> %u dtc 0x%02X %.1f A %.1f V", d[0], d[1], d[2],
+                                static_cast<int16_t>(get_u16(d, 4U)) * 0.1f, get_u16(d, 6U) * 0.1f);
+        case RECORD_LIMITS:
+            return n + snprintf(out, left, "LIMIT dis %.1f chg %.1f rms dis %.1f chg %.1f A", get_u16(d, 0U) * 0.1f,
+                                get_u16(d, 2U) * 0.1f, get_u16(d, 4U) * 0.1f, get_u16(d, 6U) * 0.1f);
+        case RECORD_SNAPSHOT:
+        {
+            const Snapshot s = decode_snapshot(record);
+            return n + snprintf(out, left, "SNAP %.1f A cell %.3f..%.3f V soc %.1f %% T %.0f..%.0f C", s.current_A,
+                                s.cell_min_V, s.cell_max_V, s.soc * 100.0f, s.temp_min_C, s.temp_max_C);
+        }
+        default:
+            return n + snprintf(out, left, "type %u", record.type);
+        }
+    }
+
+private:
+    enum State : uint8_t
+    {
+        STATE_IDLE,     // begin() not called
+        STATE_SCANNING, // looking for the newest record
+        STATE_RUNNING,
+        STATE_DUMPING,
+        STATE_OFFLINE, // device not responding
+    };
+
+    enum Operation : uint8_t
+    {
+        OP_NONE,
+        OP_SCAN_READ,
+        OP_DUMP_READ,
+        OP_WRITE,
+    };
+
+    At24cAsync eeprom;
+    const uint32_t device_bytes;
+    const uint8_t page_bytes;
+    const uint16_t capacity; // records in the ring
+
+    State state;
+    Operation operation;
+    uint16_t head; // record index the next write starts at
+    uint16_t next_sequence;
+
+    uint16_t scan_page;
+    bool scan_found;
+    uint16_t scan_best_sequence;
+
+    uint16_t dump_record;       // next record index to hand out
+    uint16_t dump_records_left; // ring positions not read yet
+    DumpCallback dump_callback;
+    void *dump_context;
+    bool dump_requested;
+
+    Record queue[kQueueRecords];
+    size_t queue_head; // oldest queued record
+    size_t queue_count;
+    uint8_t page[kMaxPageBytes]; // write batch or read page
+    size_t batch_count;          // records in the write in flight
+    bool flushing;               // write partial pages without waiting
+
+    uint8_t errors; // consecutive
+    uint32_t write_errors;
+    uint32_t records_written;
+    uint32_t records_dropped;
+    uint32_t max_service_us;
+
+    static constexpr uint8_t page_size(uint8_t bytes)
+    {
+        return (bytes > kMaxPageBytes) ? static_cast<uint8_t>(kMaxPageBytes) : bytes;
+    }
+
+    static void put_u16(uint8_t *data, size_t offset, uint16_t value)
+    {
+        data[offset] = static_cast<uint8_t>(value & 0xFFU);
+        data[offset + 1U] = static_cast<uint8_t>(value >> 8);
+    }
+
+    static void put_u32(uint8_t *data, size_t offset, uint32_t value)
+    {
+        put_u16(data, offset, static_cast<uint16_t>(value & 0xFFFFU));
+        put_u16(data, offset + 2U, static_cast<uint16_t>(value >> 16));
+    }
+
+    static uint16_t get_u16(const uint8_t *data, size_t offset)
+    {
+        return static_cast<uint16_t>(data[offset] | (data[offset + 1U] << 8));
+    }
+
+    static uint32_t get_u32(const uint8_t *data, size_t offset)
+    {
+        return get_u16(data, offset) | (static_cast<uint32_t>(get_u16(data, offset + 2U)) << 16);
+    }
+
+    // Round value * scale to the nearest integer within [lo, hi].
+    static int32_t quantise(float value, float scale, float lo, float hi)
+    {
+        float scaled = value * scale;
+        scaled = (scaled < lo) ? lo : ((scaled > hi) ? hi : scaled);
+        return static_cast<int32_t>(scaled < 0.0f ? scaled - 0.5f : scaled + 0.5f);
+    }
+
+    static uint8_t check_byte(const Record &record)
+    {
+        Record copy = record;
+        copy.check = 0U;
+        return static_cast<uint8_t>(crc32_ieee(&copy, kRecordBytes) & 0xFFU);
+    }
+
+    void log(RecordType type, const uint8_t *data)
+    {
+        if (state == STATE_OFFLINE)
+        {
+            return;
+        }
+        if (queue_count == kQueueRecords)
+        {
+            ++records_dropped;
+            return;
+        }
+
+        Record &record = queue[(queue_head + queue_count) % kQueueRecords];
+        record.time_ms = millis();
+        record.sequence = 0U; // assigned when written
+        record.type = type;
+        record.check = 0U;
+        memcpy(record.data, data, sizeof(record.data));
+        ++queue_count;
+    }
+
+    uint16_t records_per_page() const
+    {
+        return static_cast<uint16_t>(page_bytes / kRecordBytes);
+    }
+
+    uint16_t page_count() const
+    {
+        return static_cast<uint16_t>(device_bytes / page_bytes);
+    }
+
+    bool start_operation()
+    {
+        if (state == STATE_SCANNING)
+        {
+            eeprom.StartRead(static_cast<uint16_t>(scan_page * page_bytes), page, page_bytes);
+            operation = OP_SCAN_READ;
+            return true;
+        }
+
+        if (state == STATE_RUNNING && dump_requested)
+        {
+            // Oldest record first: the write head, then once around the ring.
+            dump_requested = false;
+            dump_record = head;
+            dump_records_left = capacity;
+            state = STATE_DUMPING;
+        }
+
+        if (state == STATE_DUMPING)
+        {
+            if (dump_records_left == 0U)
+            {
+                state = STATE_RUNNING;
+                dump_callback = nullptr;
+                return false;
+            }
+            const uint16_t first = static_cast<uint16_t>(dump_record - dump_record % records_per_page());
+            eeprom.StartRead(static_cast<uint16_t>(first * kRecordBytes), page, page_bytes);
+            operation = OP_DUMP_READ;
+            return true;
+        }
+
+        return start_write();
+    }
+
+    // Batch queued records into one write up to the end of the head's page.
+    bool start_write()
+    {
+        if (queue_count == 0U)
+        {
+            return false;
+        }
+
+        const uint16_t in_page = static_cast<uint16_t>(head % records_per_page());
+        const size_t room = records_per_page() - in_page;
+        const bool page_full = queue_count >= room;
+        const bool aged = (millis() - queue[queue_head].time_ms) >= kFlushDelayMs;
+        if (!page_full && !aged && !flushing && queue_count < kQueueRecords / 2U)
+        {
+            return false;
+        }
+
+        batch_count = page_full ? room : queue_count;
+        for (size_t i = 0; i < batch_count; ++i)
+        {
+            Record record = queue[(queue_head + i) % kQueueRecords];
+            record.sequence = static_cast<uint16_t>(next_sequence + i);
+            record.check = check_byte(record);
+            memcpy(page + i * kRecordBytes, &record, kRecordBytes);
+        }
+        eeprom.StartWrite(static_cast<uint16_t>(head * kRecordBytes), page,
+                          static_cast<uint16_t>(batch_count * kRecordBytes));
+        operation = OP_WRITE;
+        return true;
+    }
+
+    void finish_operation()
+    {
+        const Operation done = operation;
+        operation = OP_NONE;
+        errors = 0U;
+
+        if (done == OP_SCAN_READ)
+        {
+            scan_page_records();
+        }
+        else if (done == OP_DUMP_READ)
+        {
+            Record record;
+            for (uint16_t i = dump_record % records_per_page(); i < records_per_page() && dump_records_left > 0U;
+                 ++i)
+            {
+                if (parse_record(page + i * kRecordBytes, record))
+                {
+                    dump_callback(record, dump_context);
+                }
+                dump_record = static_cast<uint16_t>((dump_record + 1U) % capacity);
+                --dump_records_left;
+            }
+        }
+        else if (done == OP_WRITE)
+        {
+            queue_head = (queue_head + batch_count) % kQueueRecords;
+            queue_count -= batch_count;
+            next_sequence = static_cast<uint16_t>(next_sequence + batch_count);
+            head = static_cast<uint16_t>((head + batch_count) % capacity);
+            records_written += batch_count;
+            batch_count = 0U;
+        }
+    }
+
+    // The failed step is retried by the next start_operation().
+    void fail_operation()
+    {
+        if (operation == OP_WRITE)
+        {
+            ++write_errors;
+        }
+        operation = OP_NONE;
+        batch_count = 0U;
+        if (++errors >= kMaxErrors)
+        {
+            state = STATE_OFFLINE;
+            queue_count = 0U;
+        }
+    }
+
+    // Track the record with the newest sequence (modulo 2^16: all records in
+    // the ring lie within capacity of each other).
+    void scan_page_records()
+    {
+        Record record;
+        for (uint16_t i = 0; i < records_per_page(); ++i)
+        {
+            if (!parse_record(page + i * kRecordBytes, record))
+            {
+                continue;
+            }
+            if (!scan_found || static_cast<int16_t>(record.sequence - scan_best_sequence) > 0)
+            {
+                scan_found = true;
+                scan_best_sequence = record.sequence;
+                head = static_cast<uint16_t>((scan_page * records_per_page() + i + 1U) % capacity);
+            }
+        }
+
+        if (++scan_page == page_count())
+        {
+            next_sequence = scan_found ? static_cast<uint16_t>(scan_best_sequence + 1U) : 0U;
+            head = scan_found ? head : 0U;
+            state = STATE_RUNNING;
+        }
+    }
+};
+
+#endif // BLACKBOX_RECORDER_H
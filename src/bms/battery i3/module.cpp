@@ -1,7 +1,8 @@
 #include <stdio.h>
 #include "module.h"
 #include "pack.h"
-#include "utils/can_packer.h"
+#include "can_messages.h"
+#include "console_printer.h"
 #include "CRC8BMW/crc8bmw_i3.h"
 #include <ACAN_T4.h>
 
@@ -45,7 +46,7 @@ BatteryModule::BatteryModule(int _id, BatteryPack *_pack)
     lastUpdate = millis();
 }
 
-void BatteryModule::process_message(CANMessage &msg)
+void BatteryModule::process_message(const CANMessage &msg)
 {
     if ((msg.id & 0x00F) != static_cast<uint32_t>(id)) // check if module id belongs to this module
     {
@@ -68,83 +69,87 @@ void BatteryModule::process_message(CANMessage &msg)
 
     switch (msg.id & 0x0F0) // removes the module spicif part of the message id
     {
-    case 0x0:                                             // Message 0x105 CMU0ErrorBalanceStatus 8bits 50ms
-        cmuError = unpack(msg, 0, 32, false);             // cmuError : 0|32 little_endian unsigned scale: 1, offset: 0, unit: None, None
-        balanceDirection[0] = unpack(msg, 32, 1, false);  // balanceDirection0 : 32|1 little_endian unsigned scale: 1, offset: 0, unit: None, 0=Charge;_1=Discharge
-        balanceDirection[1] = unpack(msg, 33, 1, false);  // balanceDirection1 : 33|1 little_endian unsigned scale: 1, offset: 0, unit: None, 0=Charge;_1=Discharge
-        balanceDirection[2] = unpack(msg, 34, 1, false);  // balanceDirection2 : 34|1 little_endian unsigned scale: 1, offset: 0, unit: None, 0=Charge;_1=Discharge
-        balanceDirection[3] = unpack(msg, 35, 1, false);  // balanceDirection3 : 35|1 little_endian unsigned scale: 1, offset: 0, unit: None, 0=Charge;_1=Discharge
-        balanceDirection[4] = unpack(msg, 36, 1, false);  // balanceDirection4 : 36|1 little_endian unsigned scale: 1, offset: 0, unit: None, 0=Charge;_1=Discharge
-        balanceDirection[5] = unpack(msg, 37, 1, false);  // balanceDirection5 : 37|1 little_endian unsigned scale: 1, offset: 0, unit: None, 0=Charge;_1=Discharge
-        balanceDirection[6] = unpack(msg, 38, 1, false);  // balanceDirection6 : 38|1 little_endian unsigned scale: 1, offset: 0, unit: None, 0=Charge;_1=Discharge
-        balanceDirection[7] = unpack(msg, 39, 1, false);  // balanceDirection7 : 39|1 little_endian unsigned scale: 1, offset: 0, unit: None, 0=Charge;_1=Discharge
-        balanceDirection[8] = unpack(msg, 40, 1, false);  // balanceDirection8 : 40|1 little_endian unsigned scale: 1, offset: 0, unit: None, 0=Charge;_1=Discharge
-        balanceDirection[9] = unpack(msg, 41, 1, false);  // balanceDirection9 : 41|1 little_endian unsigned scale: 1, offset: 0, unit: None, 0=Charge;_1=Discharge
-        balanceDirection[10] = unpack(msg, 42, 1, false); // balanceDirection10 : 42|1 little_endian unsigned scale: 1, offset: 0, unit: None, 0=Charge;_1=Discharge
-        balanceDirection[11] = unpack(msg, 43, 1, false); // balanceDirection11 : 43|1 little_endian unsigned scale: 1, offset: 0, unit: None, 0=Charge;_1=Discharge
-        // Counter_x105 = unpack(msg, 52, 4, false, 1, 0);   // Counter_x105 : 52|4 little_endian unsigned scale: 1, offset: 0, unit: None, None
-        // CRC_x105 = unpack(msg, 56, 8, false, 1, 0);       // CRC_x105 : 56|8 little_endian unsigned scale: 1, offset: 0, unit: None, None
+    case CanCmuErrorBalanceStatus::kId & 0x0F0: // 0x10x, 50 ms
+    {
+        const CanCmuErrorBalanceStatus frame = CanCmuErrorBalanceStatus::decode(msg.data);
+        cmuError = frame.cmu_error > 0;
+        balanceDirection[0] = frame.balance_direction0;
+        balanceDirection[1] = frame.balance_direction1;
+        balanceDirection[2] = frame.balance_direction2;
+        balanceDirection[3] = frame.balance_direction3;
+        balanceDirection[4] = frame.balance_direction4;
+        balanceDirection[5] = frame.balance_direction5;
+        balanceDirection[6] = frame.balance_direction6;
+        balanceDirection[7] = frame.balance_direction7;
+        balanceDirection[8] = frame.balance_direction8;
+        balanceDirection[9] = frame.balance_direction9;
+        balanceDirection[10] = frame.balance_direction10;
+        balanceDirection[11] = frame.balance_direction11;
         break;
+    }
 
-    case 0x20:                                                 // Message 0x125 CMU_0x125_Voltage_0_2 8bits 100ms
-        cellVoltage[0] = unpack(msg, 0, 15, false, 0.001, 0);  // cellVoltage0 : 0|15 little_endian unsigned scale: 0.001, offset: 0, unit: V, None
-        cellBalance[0] = unpack(msg, 15, 1, false);            // cellBalance1 : 15|1 little_endian unsigned scale: 1, offset: 0, unit: None, 0=Balance_Inactive;_1=Balance_Active
-        cellVoltage[1] = unpack(msg, 16, 15, false, 0.001, 0); // cellVoltage1 : 16|15 little_endian unsigned scale: 0.001, offset: 0, unit: V, None
-        cellBalance[1] = unpack(msg, 31, 1, false);            // cellBalance2 : 31|1 little_endian unsigned scale: 1, offset: 0, unit: None, 0=Balance_Inactive;_1=Balance_Active
-        cellVoltage[2] = unpack(msg, 32, 15, false, 0.001, 0); // cellVoltage2 : 32|15 little_endian unsigned scale: 0.001, offset: 0, unit: V, None
-        cellBalance[2] = unpack(msg, 47, 1, false);            // cellBalance3 : 47|1 little_endian unsigned scale: 1, offset: 0, unit: None, None
-        // Counter_0x125 = unpack(msg, 52, 4, false, 1, 0);     // Counter_0x125 : 52|4 little_endian unsigned scale: 1, offset: 0, unit: None, None
-        // CRC_0x125 = unpack(msg, 56, 8, false, 1, 0);         // CRC_0x125 : 56|8 little_endian unsigned scale: 1, offset: 0, unit: None, None
+    case CanCmuVoltage0to2::kId & 0x0F0: // 0x12x, 100 ms
+    {
+        const CanCmuVoltage0to2 frame = CanCmuVoltage0to2::decode(msg.data);
+        cellVoltage[0] = frame.get_cell_voltage0();
+        cellBalance[0] = frame.cell_balance0;
+        cellVoltage[1] = frame.get_cell_voltage1();
+        cellBalance[1] = frame.cell_balance1;
+        cellVoltage[2] = frame.get_cell_voltage2();
+        cellBalance[2] = frame.cell_balance2;
         break;
+    }
 
-    case 0x30:                                                 // Message 0x135 CMU_0x135_Voltage_3_5 8bits 100ms
-        cellVoltage[3] = unpack(msg, 0, 15, false, 0.001, 0);  // cellVoltage3 : 0|15 little_endian unsigned scale: 0.001, offset: 0, unit: V, None
-        cellBalance[3] = unpack(msg, 15, 1, false);            // cellBalance3 : 15|1 little_endian unsigned scale: 1, offset: 0, unit: None, 0=Balance_Inactive;_1=Balance_Active
-        cellVoltage[4] = unpack(msg, 16, 15, false, 0.001, 0); // cellVoltage4 : 16|15 little_endian unsigned scale: 0.001, offset: 0, unit: V, None
-        cellBalance[4] = unpack(msg, 31, 1, false);            // cellBalance4 : 31|1 little_endian unsigned scale: 1, offset: 0, unit: None, 0=Balance_Inactive;_1=Balance_Active
-        cellVoltage[5] = unpack(msg, 32, 15, false, 0.001, 0); // cellVoltage5 : 32|15 little_endian unsigned scale: 0.001, offset: 0, unit: V, None
-        cellBalance[5] = unpack(msg, 47, 1, false);            // cellBalance5 : 47|1 little_endian unsigned scale: 1, offset: 0, unit: None, 0=Balance_Inactive;_1=Balance_Active
-        // Counter_0x135 = unpack(msg, 52, 4, false, 1, 0);     // Counter_0x135 : 52|4 little_endian unsigned scale: 1, offset: 0, unit: None, None
-        // CRC_0x135 = unpack(msg, 56, 8, false, 1, 0);         // CRC_0x135 : 56|8 little_endian unsigned scale: 1, offset: 0, unit: None, None
+    case CanCmuVoltage3to5::kId & 0x0F0: // 0x13x, 100 ms
+    {
+        const CanCmuVoltage3to5 frame = CanCmuVoltage3to5::decode(msg.data);
+        cellVoltage[3] = frame.get_cell_voltage3();
+        cellBalance[3] = frame.cell_balance3;
+        cellVoltage[4] = frame.get_cell_voltage4();
+        cellBalance[4] = frame.cell_balance4;
+        cellVoltage[5] = frame.get_cell_voltage5();
+        cellBalance[5] = frame.cell_balance5;
         break;
+    }
 
-    case 0x40:                                                 // Message 0x145 CMU_0x145_Voltage_6_8 8bits 100ms
-        cellVoltage[6] = unpack(msg, 0, 15, false, 0.001, 0);  // CellVoltage6 : 0|15 little_endian unsigned scale: 0.001, offset: 0, unit: V, None
-        cellBalance[6] = unpack(msg, 15, 1, false);            // cellBalance6 : 15|1 little_endian unsigned scale: 1, offset: 0, unit: None, 0=Balance_Inactive;_1=Balance_Active
-        cellVoltage[7] = unpack(msg, 16, 15, false, 0.001, 0); // CellVoltage7 : 16|15 little_endian unsigned scale: 0.001, offset: 0, unit: V, None
-        cellBalance[7] = unpack(msg, 31, 1, false);            // cellBalance7 : 31|1 little_endian unsigned scale: 1, offset: 0, unit: None, 0=Balance_Inactive;_1=Balance_Active
-        cellVoltage[8] = unpack(msg, 32, 15, false, 0.001, 0); // CellVoltage8 : 32|15 little_endian unsigned scale: 0.001, offset: 0, unit: V, None
-        cellBalance[8] = unpack(msg, 47, 1, false);            // cellBalance8 : 47|1 little_endian unsigned scale: 1, offset: 0, unit: None, 0=Balance_Inactive;_1=Balance_Active
-        // Counter_0x145 = unpack(msg, 52, 4, false, 1, 0);     // Counter_0x145 : 52|4 little_endian unsigned scale: 1, offset: 0, unit: None, None
-        // CRC_0x145 = unpack(msg, 56, 8, false, 1, 0);         // CRC_0x145 : 56|8 little_endian unsigned scale: 1, offset: 0, unit: None, None
+    case CanCmuVoltage6to8::kId & 0x0F0: // 0x14x, 100 ms
+    {
+        const CanCmuVoltage6to8 frame = CanCmuVoltage6to8::decode(msg.data);
+        cellVoltage[6] = frame.get_cell_voltage6();
+        cellBalance[6] = frame.cell_balance6;
+        cellVoltage[7] = frame.get_cell_voltage7();
+        cellBalance[7] = frame.cell_balance7;
+        cellVoltage[8] = frame.get_cell_voltage8();
+        cellBalance[8] = frame.cell_balance8;
         break;
+    }
 
-    case 0x50:                                                  // Message 0x155 CMU_0x155_Voltage_9_11 8bits 100ms
-        cellVoltage[9] = unpack(msg, 0, 15, false, 0.001, 0);   // CellVoltage9 : 0|15 little_endian unsigned scale: 0.001, offset: 0, unit: V, None
-        cellBalance[9] = unpack(msg, 15, 1, false);             // cellBalance9 : 15|1 little_endian unsigned scale: 1, offset: 0, unit: None, 0=Balance_Inactive;_1=Balance_Active
-        cellVoltage[10] = unpack(msg, 16, 15, false, 0.001, 0); // CellVoltage10 : 16|15 little_endian unsigned scale: 0.001, offset: 0, unit: V, None
-        cellBalance[10] = unpack(msg, 31, 1, false);            // cellBalance10 : 31|1 little_endian unsigned scale: 1, offset: 0, unit: None, 0=Balance_Inactive;_1=Balance_Active
-        cellVoltage[11] = unpack(msg, 32, 15, false, 0.001, 0); // CellVoltage11 : 32|15 little_endian unsigned scale: 0.001, offset: 0, unit: V, None
-        cellBalance[11] = unpack(msg, 47, 1, false);            // cellBalance11 : 47|1 little_endian unsigned scale: 1, offset: 0, unit: None, 0=Balance_Inactive;_1=Balance_Active
-        // Counter_0x155 = unpack(msg, 55, 1, false);            // Counter_0x155 : 55|1 little_endian unsigned scale: 1, offset: 0, unit: None, None
-        // CRC_0x155 = unpack(msg, 56, 8, false, 1, 0);          // CRC_0x155 : 56|8 little_endian unsigned scale: 1, offset: 0, unit: None, None
+    case CanCmuVoltage9to11::kId & 0x0F0: // 0x15x, 100 ms
+    {
+        const CanCmuVoltage9to11 frame = CanCmuVoltage9to11::decode(msg.data);
+        cellVoltage[9] = frame.get_cell_voltage9();
+        cellBalance[9] = frame.cell_balance9;
+        cellVoltage[10] = frame.get_cell_voltage10();
+        cellBalance[10] = frame.cell_balance10;
+        cellVoltage[11] = frame.get_cell_voltage11();
+        cellBalance[11] = frame.cell_balance11;
         break;
+    }
 
-    case 0x60:                                               // Message 0x165 CMU_0x165_Total_Voltage 8bits 100ms
-        moduleVoltage = unpack(msg, 0, 16, false, 0.001, 0); // moduleVoltage : 0|16 little_endian unsigned scale: 0.001, offset: 0, unit: None, None
-        // Counter_0x165 = unpack(msg, 52, 4, false, 1, 0);     // Counter_0x165 : 52|4 little_endian unsigned scale: 1, offset: 0, unit: None, None
-        // CRC_0x165 = unpack(msg, 56, 8, false, 1, 0);         // CRC_0x165 : 56|8 little_endian unsigned scale: 1, offset: 0, unit: None, None
+    case CanCmuTotalVoltage::kId & 0x0F0: // 0x16x, 100 ms
+        moduleVoltage = CanCmuTotalVoltage::decode(msg.data).get_module_voltage();
         break;
 
-    case 0x70:                                                   // Message 0x175 CMU_0x175_Temperatures 8bits 100ms
-        cellTemperature[0] = unpack(msg, 0, 8, false, 1, -40);   // temperature0 : 0|8 little_endian unsigned scale: 1, offset: -40, unit: Â°C, None
-        cellTemperature[1] = unpack(msg, 8, 8, false, 1, -40);   // temperature1 : 8|8 little_endian unsigned scale: 1, offset: -40, unit: Â°C, None
-        cellTemperature[2] = unpack(msg, 16, 8, false, 1, -40);  // temperature2 : 16|8 little_endian unsigned scale: 1, offset: -40, unit: Â°C, None
-        cellTemperature[3] = unpack(msg, 24, 8, false, 1, -40);  // temperature3 : 24|8 little_endian unsigned scale: 1, offset: -40, unit: Â°C, None
-        temperatureInternal = unpack(msg, 32, 8, false, 1, -40); // temperatureInternal : 32|8 little_endian unsigned scale: 1, offset: -40, unit: Â°C, None
-        // Counter_0x175 = unpack(msg, 52, 4, false, 1, 0);         // Counter_0x175 : 52|4 little_endian unsigned scale: 1, offset: 0, unit: None, None
-        // CRC_0x15 = unpack(msg, 56, 8, false, 1, 0);              // CRC_0x15 : 56|8 little_endian unsigned scale: 1, offset: 0, unit: None, None
+    case CanCmuTemperatures::kId & 0x0F0: // 0x17x, 100 ms
+    {
+        const CanCmuTemperatures frame = CanCmuTemperatures::decode(msg.data);
+        cellTemperature[0] = frame.get_temperature0();
+        cellTemperature[1] = frame.get_temperature1();
+        cellTemperature[2] = frame.get_temperature2();
+        cellTemperature[3] = frame.get_temperature3();
+        temperatureInternal = frame.get_temperature_internal();
         break;
+    }
 
     default:
         break;
@@ -318,7 +323,7 @@ void BatteryModule::check_alive()
     case INIT:
         break;
     case OPERATING:
-        if ((millis() - lastUpdate) > PACK_ALIVE_TIMEOUT)
+        if ((millis() - lastUpdate) > pack->get_alive_timeout())
         {
             state = FAULT;
             dtc = static_cast<DTC_CMU>(dtc | DTC_CMU_TIMED_OUT);
@@ -377,9 +382,9 @@ bool BatteryModule::plausibilityCheck()
     {
         const float moduleDeltaVoltage = totalVoltage - moduleVoltage;
 
-        Serial.printf(
+        console.printf(
             "[CMU_IMPLAUSIBLE] t=%lu ms module=%d dtc=0x%02X reasons[V=%u T=%u M=%u] cmuError=%u\n",
-            millis(),
+            static_cast<unsigned long>(millis()),
             id,
             static_cast<uint8_t>(dtc),
             cellVoltageImplausible ? 1U : 0U,
@@ -387,7 +392,7 @@ bool BatteryModule::plausibilityCheck()
             moduleVoltageImplausible ? 1U : 0U,
             cmuError ? 1U : 0U);
 
-        Serial.printf(
+        console.printf(
             "  cellV[min=%.3f max=%.3f limits=%.3f..%.3f] moduleV[sum=%.3f reported=%.3f delta=%.3f allowed=+/-%.3f]\n",
             lowestCellVoltage,
             highestCellVoltage,
@@ -398,7 +403,7 @@ bool BatteryModule::plausibilityCheck()
             moduleDeltaVoltage,
             CMU_MAX_DELTA_MODULE_CELL_VOLTAGE);
 
-        Serial.printf(
+        console.printf(
             "  temp[min=%.2f max=%.2f internal=%.2f limits=%.2f..%.2f]\n",
             lowestTemperature,
             highestTemperature,
@@ -406,19 +411,19 @@ bool BatteryModule::plausibilityCheck()
             CMU_MIN_PLAUSIBLE_TEMPERATURE,
             CMU_MAX_PLAUSIBLE_TEMPERATURE);
 
-        Serial.print("  cellV_all:");
+        console.print("  cellV_all:");
         for (int c = 0; c < numCells; c++)
         {
-            Serial.printf(" c%d=%.3f", c, cellVoltage[c]);
+            console.printf(" c%d=%.3f", c, cellVoltage[c]);
         }
-        Serial.println();
+        console.println("");
 
-        Serial.print("  temp_all:");
+        console.print("  temp_all:");
         for (int t = 0; t < numTemperatureSensors; t++)
         {
-            Serial.printf(" t%d=%.2f", t, cellTemperature[t]);
+            console.printf(" t%d=%.2f", t, cellTemperature[t]);
         }
-        Serial.println();
+        console.println("");
     }
 #endif
 
@@ -34,7 +34,7 @@ public:
     BatteryModule(int _id, BatteryPack *_pack);
 
     // Runnables
-    void process_message(CANMessage &msg);
+    void process_message(const CANMessage &msg);
     void check_alive();
 
     // Our state
@@ -78,7 +78,7 @@ private:
 
     uint8_t crcFailureCount;
 
-    u_int32_t lastUpdate; // Times out with setting value of PACK_ALIVE_TIMEOUT in ms
+    u_int32_t lastUpdate; // Times out after the pack alive timeout (PACK_ALIVE_TIMEOUT, longer in low activity)
     BatteryPack *pack;    // The parent BatteryPack that contains this module
 
     const char *getStateString();
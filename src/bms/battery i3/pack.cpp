@@ -2,7 +2,6 @@
 #include <Arduino.h>
 
 #include "module.h"
-#include "utils/can_packer.h"
 #include "settings.h"
 #include "CRC8.h"
 #include "pack.h"
@@ -14,6 +13,8 @@ BatteryPack::BatteryPack(int _numModules)
     numModules = _numModules;
     state = INIT;
     dtc = DTC_PACK_NONE;
+    aliveTimeout = PACK_ALIVE_TIMEOUT;
+    pollsUntilTimeoutRestore = 0;
 
     // Initialise modules
     for (int m = 0; m < numModules; m++)
@@ -22,12 +23,18 @@ BatteryPack::BatteryPack(int _numModules)
     }
 }
 
-void BatteryPack::initialize()
+void BatteryPack::initialize(ACANCallBackRoutine receive)
 {
 
-    // Set up CAN port
+    // Set up CAN port. Only the module frames 0x100..0x17F are accepted and
+    // handed to receive, which ends in on_can_frame() (see
+    // utils/can_rx_dispatch.h).
+    can_receiver = this;
+    const ACANPrimaryFilter filters[] = {
+        ACANPrimaryFilter(kData, kStandard, 0x780, 0x100, receive),
+    };
     ACAN_T4_Settings settings(500 * 1000); // 500 kbit/s
-    const uint32_t errorCode = ACAN_T4::BATTERY_CAN.begin(settings);
+    const uint32_t errorCode = ACAN_T4::BATTERY_CAN.begin(settings, filters, 1);
 
 #ifdef DEBUG
     Serial.print("Bitrate prescaler: ");
@@ -167,22 +174,57 @@ void BatteryPack::request_data()
     }
 
     moduleToPoll++;
+
+    if (pollsUntilTimeoutRestore > 0)
+    {
+        pollsUntilTimeoutRestore--;
+        if (pollsUntilTimeoutRestore == 0)
+        {
+            aliveTimeout = PACK_ALIVE_TIMEOUT;
+        }
+    }
     return;
 }
 
-// Read messages into modules and check alive
-void BatteryPack::read_message()
+// The long timeout applies at once. The normal one only returns after a full
+// cycle at the normal rate plus one poll, when every module has answered a
+// recent poll; restoring it earlier would time out modules last polled
+// under the reduced rate.
+void BatteryPack::set_low_activity(bool enable)
 {
-    CANMessage msg;
+    if (enable)
+    {
+        aliveTimeout = PACK_ALIVE_TIMEOUT * LOW_ACTIVITY_POLL_DIVIDER;
+        pollsUntilTimeoutRestore = 0;
+    }
+    else if (aliveTimeout != PACK_ALIVE_TIMEOUT)
+    {
+        pollsUntilTimeoutRestore = static_cast<uint8_t>(numModules + 1);
+    }
+}
+
+BatteryPack *BatteryPack::can_receiver = nullptr;
 
-    if (ACAN_T4::BATTERY_CAN.receive(msg))
+void BatteryPack::on_can_frame(const CANMessage &msg)
+{
+    if (can_receiver != nullptr)
     {
-        for (int i = 0; i < numModules; i++)
-        {
-            modules[i].process_message(msg);
-        }
+        can_receiver->process_message(msg);
     }
+}
 
+// Decode a received frame into the module it belongs to
+void BatteryPack::process_message(const CANMessage &msg)
+{
+    for (int i = 0; i < numModules; i++)
+    {
+        modules[i].process_message(msg);
+    }
+}
+
+// Check alive and update the pack state from the module states
+void BatteryPack::update_state()
+{
     for (int i = 0; i < numModules; i++)
     {
         modules[i].check_alive();
@@ -5,7 +5,6 @@
 #include <Arduino.h>
 
 #include "module.h"
-#include "utils/can_packer.h"
 #include "settings.h"
 #include "CRC8.h"
 
@@ -37,10 +36,21 @@ public:
     BatteryModule modules[MODULES_PER_PACK]; // The child modules that make up this BatteryPack
 
     // Runnables
-    void initialize();
+    // receive: filter callback for the module frames; it must pass them on
+    // to on_can_frame() (the communications layer wraps it with the capture)
+    void initialize(ACANCallBackRoutine receive = &BatteryPack::on_can_frame);
 
     void request_data(); // Send out message
-    void read_message(); // Poll messages
+    void update_state(); // Module alive checks and pack state machine
+
+    // Low-activity profile: polls are LOW_ACTIVITY_POLL_DIVIDER times rarer,
+    // the module alive timeout grows with them
+    void set_low_activity(bool enable);
+    uint32_t get_alive_timeout() const { return aliveTimeout; }
+
+    // CAN receive: decode one frame into its module (ACAN_T4 filter callback)
+    void process_message(const CANMessage &msg);
+    static void on_can_frame(const CANMessage &msg);
 
     // Our state
     STATE_PACK getState();
@@ -84,11 +94,16 @@ private:
     uint8_t modulePollingCycle;
     uint8_t moduleToPoll;
     CANMessage pollModuleFrame;
+    uint32_t aliveTimeout;
+    uint8_t pollsUntilTimeoutRestore; // 0: no restore pending
 
     // state and dtc
     STATE_PACK state;
     DTC_PACK dtc;
 
+    // Pack the filter callback decodes into (set by initialize())
+    static BatteryPack *can_receiver;
+
     const char *getStateString();
     String getDTCString();
 };
@@ -4,17 +4,23 @@
 #include "bms/battery_manager.h"
 #include "bms/current.h"
 #include "bms/contactor_manager.h"
-#include "utils/can_packer.h"
-#include "utils/can_crc.h"
 #include "utils/current_limit_lookup.h"
 #include "utils/soc_lookup.h"
 #include "utils/resistance_lookup.h"
+#include "comms_bms.h"
 #include "serial_console.h"
+#include "work_queue.h"
 #include <cmath>
 #include <algorithm>
 
 // #define DEBUG
 
+static_assert(CanBmsVoltage::kId == BMS_MSG_VOLTAGE && CanBmsCellTemp::kId == BMS_MSG_CELL_TEMP &&
+                  CanBmsLimitsFault::kId == BMS_MSG_LIMITS && CanBmsSocSoh::kId == BMS_MSG_SOC &&
+                  CanBmsHmi::kId == BMS_MSG_HMI && CanBmsContactorTelemetry::kId == BMS_MSG_CONTACTOR_TELEMETRY &&
+                  CanVcuCommand::kId == BMS_VCU_MSG_ID,
+              "src/can_messages.dbc and settings.h disagree on a CAN ID");
+
 BMS::BMS(BatteryPack &_batteryPack, Shunt_IVTS &_shunt, Contactormanager &_contactorManager)
     : batteryPack(_batteryPack),
       shunt(_shunt),
@@ -32,6 +38,7 @@ BMS::BMS(BatteryPack &_batteryPack, Shunt_IVTS &_shunt, Contactormanager &_conta
     current_limit_rms_derated_discharge = 0.0f;
     current_limit_rms_derated_charge = 0.0f;
     ready_to_shutdown = false;
+    shutdown_store_pending = false;
     vehicle_state = STATE_SLEEP;
     last_vehicle_state = STATE_SLEEP;
     msg1_counter = 0;
@@ -43,23 +50,54 @@ BMS::BMS(BatteryPack &_batteryPack, Shunt_IVTS &_shunt, Contactormanager &_conta
     last_vcu_msg = 0;
     vcu_timeout = false;
     balancing_finished = false;
+    low_activity = false;
     ocv_current_settle_start_ms = 0U;
     avg_energy_per_hour = 0.0f;
     remaining_wh = 0.0f;
     time_remaining_s = 0.0f;
     avg_power_w = 0.0f;
     last_instantaneous_power_w = 0.0f;
+    usage_last_ms = 0U;
+    usage_persist_elapsed_s = 0U;
+    blackbox_state = INIT;
+    for (uint16_t &value : blackbox_dtc)
+    {
+        value = 0U;
+    }
+    blackbox_contactor_state = Contactormanager::INIT;
+    for (float &limit : blackbox_limits)
+    {
+        limit = 0.0f;
+    }
+    blackbox_snapshot_ms = 0U;
 }
 
 void BMS::initialize()
 {
     persistent_storage.begin();
     apply_persistent_data(persistent_storage.load());
+    usage_statistics.restore(persistent_storage.load().usage, BMS_INITIAL_CAPACITY_AH);
+
+    blackbox.begin();
+#if defined(__IMXRT1062__)
+    blackbox.log_boot(SRC_SRSR);
+#else
+    blackbox.log_boot(0U);
+#endif
 
-    // Set up CAN port
+    // Set up CAN port. Only the VCU frame and the black-box dump request are
+    // accepted; they are captured and decoded from the receive dispatch.
+    can_receiver = this;
+    const ACANPrimaryFilter filters[] = {
+        ACANPrimaryFilter(kData, kStandard, BMS_VCU_MSG_ID, &capture_can_frame<CAN_RX_BMS, &BMS::on_vcu_frame>),
+        ACANPrimaryFilter(kData,
+                          kStandard,
+                          BMS_BLACKBOX_DUMP_REQUEST_ID,
+                          &capture_can_frame<CAN_RX_BMS, &BMS::on_blackbox_dump_request>),
+    };
     ACAN_T4_Settings settings(500 * 1000); // 500 kbit/s
     settings.mTransmitBufferSize = 800;
-    const uint32_t errorCode = ACAN_T4::BMS_CAN.begin(settings);
+    const uint32_t errorCode = ACAN_T4::BMS_CAN.begin(settings, filters, 2);
 
 #ifdef DEBUG
     Serial.print("Bitrate prescaler: ");
@@ -103,15 +141,21 @@ void BMS::initialize()
 //   Runnables
 // ###############################################################################################################################################################################
 
-void BMS::Task2Ms() { read_message(); }
+void BMS::Task2Ms() { check_vcu_timeout(); }
 
 void BMS::Task10Ms()
 {
+    // Write-behind EEPROM commit, a few bytes per tick
+    persistent_storage.service();
+    // Black-box page writes on the external EEPROM, one I2C transaction per tick
+    blackbox.service();
 }
 
 void BMS::Task100Ms()
 {
     update_state_machine();
+    update_blackbox();
+    update_ocv_relaxation();
     send_battery_status_message();
 }
 
@@ -121,7 +165,13 @@ void BMS::Task1000Ms()
     update_soc_coulomb_counting();
 
     //HMI function
-    update_energy_metrics();
+    if (!low_activity)
+    {
+        update_energy_metrics();
+    }
+
+    //Ageing analytics
+    update_usage_statistics();
 
     //Current limiting function
     lookup_current_limits();
@@ -147,13 +197,28 @@ void BMS::update_state_machine()
     Contactormanager::State contactor_state = contactorManager.getState();
     ShuntState shunt_state = param::state;
 
-    if (ready_to_shutdown && state != SHUTDOWN)
+    if ((ready_to_shutdown || shutdown_store_pending) && state != SHUTDOWN)
     {
-        store_persistent_and_reset_q_as();
-        // TODO: analyse if task should also be stoped.
-        state = SHUTDOWN;
+        if (!shutdown_store_pending)
+        {
+            store_persistent_and_reset_q_as();
+            shutdown_store_pending = true;
+        }
         max_discharge_current = 0.0f;
         max_charge_current = 0.0f;
+        // Power is about to be removed. The record goes out through the
+        // budgeted write-behind service, here and in Task10Ms(); a blocking
+        // flush could outlast the watchdog and reset in the middle of the
+        // write. SHUTDOWN is entered once it is complete.
+        persistent_storage.service();
+        if (persistent_storage.busy())
+        {
+            return;
+        }
+        shutdown_store_pending = false;
+        state = SHUTDOWN;
+        // Let Task10Ms() write the black-box queue out as partial pages.
+        blackbox.request_flush();
         return;
     }
 
@@ -205,6 +270,75 @@ void BMS::update_state_machine()
     }
 }
 
+// ###############################################################################################################################################################################
+//   Black-Box Recorder
+// ###############################################################################################################################################################################
+
+// Record transitions since the last call and a periodic pack snapshot.
+void BMS::update_blackbox()
+{
+    const uint8_t bms_state = static_cast<uint8_t>(state);
+
+    if (state != blackbox_state)
+    {
+        blackbox.log_state(static_cast<uint8_t>(blackbox_state), bms_state,
+                           static_cast<int8_t>(vehicle_state), ready_to_shutdown);
+        blackbox_state = state;
+    }
+
+    const uint16_t dtcs[4] = {
+        static_cast<uint16_t>(dtc),
+        static_cast<uint16_t>(batteryPack.getDTC()),
+        static_cast<uint16_t>(contactorManager.getDTC()),
+        static_cast<uint16_t>(shunt.dtc())};
+    for (uint8_t source = 0U; source < 4U; ++source)
+    {
+        if (dtcs[source] != blackbox_dtc[source])
+        {
+            blackbox.log_dtc(static_cast<BlackBoxRecorder::DtcSource>(source), bms_state,
+                             blackbox_dtc[source], dtcs[source]);
+            blackbox_dtc[source] = dtcs[source];
+        }
+    }
+
+    const Contactormanager::State contactor_state = contactorManager.getState();
+    if (contactor_state != blackbox_contactor_state)
+    {
+        blackbox.log_contactor(static_cast<uint8_t>(blackbox_contactor_state),
+                               static_cast<uint8_t>(contactor_state),
+                               static_cast<uint8_t>(contactorManager.getDTC()),
+                               param::current, batteryPack.get_pack_voltage());
+        blackbox_contactor_state = contactor_state;
+    }
+
+    const float limits[4] = {max_discharge_current, max_charge_current,
+                             current_limit_rms_discharge, current_limit_rms_charge};
+    bool limits_changed = false;
+    for (uint8_t i = 0U; i < 4U; ++i)
+    {
+        limits_changed = limits_changed || (std::fabs(limits[i] - blackbox_limits[i]) >= BLACKBOX_LIMIT_DEADBAND_A);
+    }
+    if (limits_changed)
+    {
+        blackbox.log_limits(limits[0], limits[1], limits[2], limits[3]);
+        memcpy(blackbox_limits, limits, sizeof(blackbox_limits));
+    }
+
+    const uint32_t now_ms = millis();
+    if ((now_ms - blackbox_snapshot_ms) >= BLACKBOX_SNAPSHOT_PERIOD_MS)
+    {
+        blackbox_snapshot_ms = now_ms;
+        BlackBoxRecorder::Snapshot snapshot;
+        snapshot.current_A = param::current;
+        snapshot.cell_min_V = batteryPack.get_lowest_cell_voltage();
+        snapshot.cell_max_V = batteryPack.get_highest_cell_voltage();
+        snapshot.soc = param::soc_cc;
+        snapshot.temp_min_C = batteryPack.get_lowest_temperature();
+        snapshot.temp_max_C = batteryPack.get_highest_temperature();
+        blackbox.log_snapshot(snapshot);
+    }
+}
+
 // ###############################################################################################################################################################################
 //   Battery Management Functions
 // ###############################################################################################################################################################################
@@ -220,6 +354,50 @@ void BMS::update_soc_coulomb_counting()
         std::clamp(param::soc_cc * 100.0f, 0.0f, 100.0f);
 }
 
+void BMS::update_ocv_relaxation()
+{
+    if (batteryPack.getState() != BatteryPack::OPERATING)
+    {
+        // Cell voltages are stale or missing; a fit spanning this gap would
+        // mix two rests.
+        coulomb_counting.reset_relaxation();
+        return;
+    }
+
+    coulomb_counting.update_relaxation(batteryPack.get_lowest_cell_voltage(),
+                                       batteryPack.get_highest_cell_voltage());
+}
+
+void BMS::update_usage_statistics()
+{
+    const uint32_t now_ms = millis();
+    if (state != OPERATING || usage_last_ms == 0U)
+    {
+        usage_last_ms = now_ms;
+        return;
+    }
+
+    const float dt_s = static_cast<float>(now_ms - usage_last_ms) / 1000.0f;
+    usage_last_ms = now_ms;
+
+    usage_statistics.update(dt_s,
+                            param::soc_cc,
+                            param::current,
+                            batteryPack.get_pack_voltage(),
+                            batteryPack.get_average_temperature());
+
+    // Persist only the usage counters periodically; the coulomb counting
+    // state keeps its store-on-standby semantics (q frame reset).
+    usage_persist_elapsed_s++;
+    if (usage_persist_elapsed_s >= USAGE_PERSIST_PERIOD_S)
+    {
+        usage_persist_elapsed_s = 0U;
+        PersistentDataStorage::PersistentData data = persistent_storage.load();
+        data.usage = usage_statistics.data();
+        persistent_storage.save(data);
+    }
+}
+
 void BMS::update_energy_metrics() //FOr HMI
 {
     static unsigned long last_sample_ms = 0;
@@ -479,50 +657,83 @@ void BMS::update_balancing()
     }
 }
 
+// Balancing runs over the poll frames and needs fresh cell voltages, so it
+// keeps the full poll rate, including until every module has stopped.
+bool BMS::allows_low_activity()
+{
+    return vehicle_state == STATE_SLEEP &&
+           state != INIT &&
+           contactorManager.getState() == Contactormanager::OPEN &&
+           !batteryPack.get_balancing_active() &&
+           !batteryPack.get_any_module_balancing();
+}
+
 // ###############################################################################################################################################################################
 //   CAN Messaging
 // ###############################################################################################################################################################################
 
-// Read messages into modules and check alive
-void BMS::read_message()
+BMS *BMS::can_receiver = nullptr;
+
+void BMS::on_vcu_frame(const CANMessage &msg)
 {
-    CANMessage msg;
+    if (can_receiver != nullptr)
+    {
+        can_receiver->process_vcu_message(msg);
+    }
+}
 
-    if (ACAN_T4::BMS_CAN.receive(msg))
+void BMS::on_blackbox_dump_request(const CANMessage &msg)
+{
+    if (can_receiver != nullptr && msg.len >= 1 && msg.data[0] == 1U)
     {
-        if (msg.id == BMS_VCU_MSG_ID && msg.len == 8)
-        {
-            uint8_t tmp[8];
-            memcpy(tmp, msg.data, 8);
-            tmp[7] = 0; // crc byte cleared
-            uint8_t crc = can_crc8(tmp);
+        deferred_work.post(&BMS::deferred_blackbox_dump, can_receiver);
+    }
+}
 
-            if (crc == msg.data[7])
-            {
-                const int8_t raw_vehicle_state = static_cast<int8_t>(msg.data[0]);
-                const VehicleState new_vehicle_state = static_cast<VehicleState>(raw_vehicle_state);
-                const bool transitioned_to_standby = (new_vehicle_state == STATE_STANDBY) && (last_vehicle_state != STATE_STANDBY);
-
-                vehicle_state = new_vehicle_state;
-                if (transitioned_to_standby)
-                {
-                    store_persistent_and_reset_q_as();
-                }
-                last_vehicle_state = new_vehicle_state;
-
-                ready_to_shutdown = msg.data[1];
-                if (msg.data[2])
-                    contactorManager.close();
-                else
-                    contactorManager.open();
-
-                vcu_counter = msg.data[6] & 0x0F;
-                last_vcu_msg = millis();
-                vcu_timeout = false;
-            }
-        }
+void BMS::deferred_store_persistent(void *context)
+{
+    static_cast<BMS *>(context)->store_persistent_and_reset_q_as();
+}
+
+void BMS::deferred_blackbox_dump(void *context)
+{
+    BMS *bms = static_cast<BMS *>(context);
+    bms->blackbox.start_dump(&BMS::send_blackbox_record, bms);
+}
+
+// VCU command frame: vehicle state, shutdown request and contactor request
+void BMS::process_vcu_message(const CANMessage &msg)
+{
+    if (msg.len != CanVcuCommand::kLen || !CanVcuCommand::checksum_ok(msg.data))
+    {
+        return;
     }
 
+    const CanVcuCommand command = CanVcuCommand::decode(msg.data);
+    const VehicleState new_vehicle_state = static_cast<VehicleState>(command.vehicle_operating_mode);
+    const bool transitioned_to_standby = (new_vehicle_state == STATE_STANDBY) && (last_vehicle_state != STATE_STANDBY);
+
+    vehicle_state = new_vehicle_state;
+    if (transitioned_to_standby)
+    {
+        // EEPROM commit and counter reset run after the dispatch
+        deferred_work.post(&BMS::deferred_store_persistent, this);
+    }
+    last_vehicle_state = new_vehicle_state;
+
+    ready_to_shutdown = command.request_bms_shutdown;
+    if (command.request_contactor_close)
+        contactorManager.close();
+    else
+        contactorManager.open();
+
+    vcu_counter = command.counter;
+    last_vcu_msg = millis();
+    vcu_timeout = false;
+}
+
+void BMS::check_vcu_timeout()
+{
     if ((millis() - last_vcu_msg) > BMS_VCU_TIMEOUT)
     {
         vcu_timeout = true;
@@ -531,125 +742,96 @@ void BMS::read_message()
 
 void BMS::send_battery_status_message()
 {
-    CANMessage msg;
-
-    msg.id = BMS_MSG_VOLTAGE;
-    msg.len = 8;
-    uint16_t pack_v = (uint16_t)(batteryPack.get_pack_voltage() * 10.0f);
-    uint16_t pack_i = (uint16_t)((param::current * 10.0f) + 5000.0f);
-    msg.data[0] = pack_v & 0xFF;
-    msg.data[1] = pack_v >> 8;
-    msg.data[2] = pack_i & 0xFF;
-    msg.data[3] = pack_i >> 8;
-    msg.data[4] = (uint8_t)(batteryPack.get_lowest_cell_voltage() * 50.0f);
-    msg.data[5] = (uint8_t)(batteryPack.get_highest_cell_voltage() * 50.0f);
-    msg.data[6] = msg1_counter & 0x0F;
-    msg.data[7] = 0;
-    msg.data[7] = can_crc8(msg.data);
-    send_message(&msg);
+    CanBmsVoltage voltage;
+    voltage.set_pack_voltage(batteryPack.get_pack_voltage());
+    voltage.set_pack_current(param::current);
+    voltage.set_min_cell_voltage(batteryPack.get_lowest_cell_voltage());
+    voltage.set_max_cell_voltage(batteryPack.get_highest_cell_voltage());
+    voltage.counter = msg1_counter;
+    send_frame(voltage);
     msg1_counter = (msg1_counter + 1) & 0x0F;
 
-    msg.id = BMS_MSG_CELL_TEMP;
-    uint8_t minT = (uint8_t)(batteryPack.get_lowest_temperature() + 40.0f);
-    uint8_t maxT = (uint8_t)(batteryPack.get_highest_temperature() + 40.0f);
-    float balancingTargetVoltage = batteryPack.get_balancing_active()
-                                       ? batteryPack.get_balancing_voltage()
-                                       : 0.0f;
-    balancingTargetVoltage =
-        std::clamp(balancingTargetVoltage, 0.0f, 5.1f);
-    uint8_t balancingTarget = static_cast<uint8_t>(balancingTargetVoltage * 50.0f);
-    const float cellDeltaScaled = batteryPack.get_delta_cell_voltage() * 500.0f;
-    uint8_t cellDelta = static_cast<uint8_t>(std::clamp(cellDeltaScaled, 0.0f, 255.0f));
-    uint16_t packPower = (uint16_t)((param::power / 1000.0f) * 100.0f + 30000.0f);
-    msg.data[0] = minT;
-    msg.data[1] = maxT;
-    msg.data[2] = balancingTarget;
-    msg.data[3] = cellDelta;
-    msg.data[4] = packPower & 0xFF;
-    msg.data[5] = packPower >> 8;
-    msg.data[6] = msg2_counter & 0x0F;
-    msg.data[7] = 0;
-    msg.data[7] = can_crc8(msg.data);
-    send_message(&msg);
+    CanBmsCellTemp cell_temp;
+    cell_temp.set_min_cell_temp(batteryPack.get_lowest_temperature());
+    cell_temp.set_max_cell_temp(batteryPack.get_highest_temperature());
+    cell_temp.set_balancing_target_voltage(batteryPack.get_balancing_active() ? batteryPack.get_balancing_voltage() : 0.0f);
+    cell_temp.set_cell_voltage_delta(batteryPack.get_delta_cell_voltage());
+    cell_temp.set_pack_power(param::power / 1000.0f);
+    cell_temp.counter = msg2_counter;
+    send_frame(cell_temp);
     msg2_counter = (msg2_counter + 1) & 0x0F;
 
-    msg.id = BMS_MSG_LIMITS;
-    uint16_t maxD = (uint16_t)(max_discharge_current * 10.0f);
-    uint16_t maxC = (uint16_t)(max_charge_current * 10.0f);
-    msg.data[0] = maxD & 0xFF;
-    msg.data[1] = maxD >> 8;
-    msg.data[2] = maxC & 0xFF;
-    msg.data[3] = maxC >> 8;
-    msg.data[4] = static_cast<uint8_t>(contactorManager.getState());
-    msg.data[5] = static_cast<uint8_t>(dtc);
-    msg.data[6] = msg3_counter & 0x0F;
-    msg.data[7] = 0;
-    msg.data[7] = can_crc8(msg.data);
-    send_message(&msg);
+    CanBmsLimitsFault limits;
+    limits.set_max_discharge_current(max_discharge_current);
+    limits.set_max_charge_current(max_charge_current);
+    limits.set_contactor_state(static_cast<uint8_t>(contactorManager.getState()));
+    limits.fault_code = static_cast<uint8_t>(dtc);
+    limits.counter = msg3_counter;
+    send_frame(limits);
     msg3_counter = (msg3_counter + 1) & 0x0F;
 
-    msg.id = BMS_MSG_SOC;
-    const float soc_cc_percent = std::clamp(param::soc_cc * 100.0f, 0.0f, 100.0f);
-    uint16_t soc16 = static_cast<uint16_t>(soc_cc_percent * 100.0f);
-    const float soh_percent = std::clamp(param::soh * 100.0f, 0.0f, 100.0f);
-    uint16_t soh16 = static_cast<uint16_t>(soh_percent * 100.0f);
-    msg.data[0] = soc16 & 0xFF;
-    msg.data[1] = soc16 >> 8;
-    msg.data[2] = soh16 & 0xFF;
-    msg.data[3] = soh16 >> 8;
+    CanBmsSocSoh soc_soh;
+    soc_soh.set_soc(param::soc_cc * 100.0f);
+    soc_soh.set_soh(param::soh * 100.0f);
     if (balancing_finished)
-        msg.data[4] = 2; // balanced/finished
+        soc_soh.set_balancing_status(2); // balanced/finished
     else if (batteryPack.get_balancing_active())
-        msg.data[4] = 1; // actively balancing
+        soc_soh.set_balancing_status(1); // actively balancing
     else
-        msg.data[4] = 0; // idle
-    msg.data[5] = state;
-    msg.data[6] = msg4_counter & 0x0F;
-    msg.data[7] = 0;
-    msg.data[7] = can_crc8(msg.data);
-    send_message(&msg);
+        soc_soh.set_balancing_status(0); // idle
+    soc_soh.bms_status = static_cast<uint8_t>(state);
+    soc_soh.counter = msg4_counter;
+    send_frame(soc_soh);
     msg4_counter = (msg4_counter + 1) & 0x0F;
 
-    msg.id = BMS_MSG_HMI;
-    const float clamped_energy = std::clamp(avg_energy_per_hour, -327.67f, 327.67f);
-    const int16_t energy = static_cast<int16_t>(clamped_energy * 100.0f);
-    const float clamped_time = std::clamp(time_remaining_s, 0.0f, 65535.0f);
-    const uint16_t time_left = static_cast<uint16_t>(clamped_time);
-    const float clamped_wh = std::clamp(remaining_wh, 0.0f, 65535.0f);
-    const uint16_t wh_left = static_cast<uint16_t>(clamped_wh);
-    msg.data[0] = static_cast<uint8_t>(energy & 0xFF);
-    msg.data[1] = static_cast<uint8_t>((energy >> 8) & 0xFF);
-    msg.data[2] = static_cast<uint8_t>(time_left & 0xFF);
-    msg.data[3] = static_cast<uint8_t>(time_left >> 8);
-    msg.data[4] = static_cast<uint8_t>(wh_left & 0xFF);
-    msg.data[5] = static_cast<uint8_t>(wh_left >> 8);
-    msg.data[6] = msg5_counter & 0x0F;
-    msg.data[7] = 0;
-    msg.data[7] = can_crc8(msg.data);
-    send_message(&msg);
+    // Nobody looks at the dashboard in low activity
+    if (low_activity)
+    {
+        return;
+    }
 
+    CanBmsHmi hmi;
+    hmi.set_avg_energy_per_hour(avg_energy_per_hour);
+    hmi.set_remaining_time(time_remaining_s);
+    hmi.set_remaining_energy(remaining_wh);
+    hmi.counter = msg5_counter;
+    send_frame(hmi);
     msg5_counter = (msg5_counter + 1) & 0x0F;
 }
 
 void BMS::send_contactor_telemetry_message()
 {
+    CanBmsContactorTelemetry telemetry;
+    telemetry.set_manager_state(static_cast<uint8_t>(contactorManager.getState()));
+    telemetry.manager_dtc = static_cast<uint8_t>(contactorManager.getDTC());
+    telemetry.set_precharge_strategy(static_cast<uint8_t>(contactorManager.getPrechargeStrategy()));
+    telemetry.set_positive_state(static_cast<uint8_t>(contactorManager.getPositiveState()));
+    telemetry.positive_dtc = static_cast<uint8_t>(contactorManager.getPositiveDTC());
+    telemetry.set_precharge_state(static_cast<uint8_t>(contactorManager.getPrechargeState()));
+    telemetry.precharge_dtc = static_cast<uint8_t>(contactorManager.getPrechargeDTC());
+    telemetry.negative_closed = contactorManager.isNegativeContactorClosed();
+    telemetry.supply_available = contactorManager.isContactorVoltageAvailable();
+    telemetry.positive_feedback = contactorManager.getPositiveInputPin();
+    telemetry.precharge_feedback = contactorManager.getPrechargeInputPin();
+    telemetry.positive_can_open = contactorManager.canOpenPositiveContactor();
+    send_frame(telemetry);
+}
+
+// Black-box dump over CAN: each 16-byte record as two frames.
+void BMS::send_blackbox_record(const BlackBoxRecorder::Record &record, void *context)
+{
+    BMS *bms = static_cast<BMS *>(context);
+    uint8_t bytes[BlackBoxRecorder::kRecordBytes];
+    memcpy(bytes, &record, sizeof(bytes));
+
     CANMessage msg;
-    msg.id = BMS_MSG_CONTACTOR_TELEMETRY;
     msg.len = 8;
-
-    msg.data[0] = static_cast<uint8_t>(contactorManager.getState());
-    msg.data[1] = static_cast<uint8_t>(contactorManager.getDTC());
-    msg.data[2] = static_cast<uint8_t>(contactorManager.getPrechargeStrategy());
-    msg.data[3] = static_cast<uint8_t>(contactorManager.getPositiveState());
-    msg.data[4] = static_cast<uint8_t>(contactorManager.getPositiveDTC());
-    msg.data[5] = static_cast<uint8_t>(contactorManager.getPrechargeState());
-    msg.data[6] = static_cast<uint8_t>(contactorManager.getPrechargeDTC());
-    msg.data[7] = (contactorManager.isNegativeContactorClosed() ? 1U : 0U) |
-                  ((contactorManager.isContactorVoltageAvailable() ? 1U : 0U) << 1) |
-                  ((contactorManager.getPositiveInputPin() ? 1U : 0U) << 2) |
-                  ((contactorManager.getPrechargeInputPin() ? 1U : 0U) << 3) |
-                  ((contactorManager.canOpenPositiveContactor() ? 1U : 0U) << 4);
-    send_message(&msg);
+    msg.id = BMS_MSG_BLACKBOX_DUMP;
+    memcpy(msg.data, bytes, 8);
+    bms->send_message(&msg);
+    msg.id = BMS_MSG_BLACKBOX_DUMP + 1;
+    memcpy(msg.data, bytes + 8, 8);
+    bms->send_message(&msg);
 }
 
 void BMS::send_message(CANMessage *frame)
@@ -677,13 +859,21 @@ void BMS::apply_persistent_data(const PersistentDataStorage::PersistentData &dat
 
     energy_initial_Wh = data.energy_initial_Wh;
     measured_capacity_Wh = data.measured_capacity_Wh;
+
+    CapacityEstimatorStats cap_stats;
+    cap_stats.c1 = data.cap_c1;
+    cap_stats.c2 = data.cap_c2;
+    cap_stats.c3 = data.cap_c3;
+    cap_stats.pairs = data.cap_pairs;
+
     coulomb_counting.initialise(b_as_runtime,
                                 data.C_as,
                                 data.soh,
                                 data.have_low_anchor != 0U,
                                 q_low_as_runtime,
                                 data.soc_low_anchor,
-                                data.was_above_high_set != 0U);
+                                data.was_above_high_set != 0U,
+                                cap_stats);
     contactorManager.setPrechargeStrategy(
         static_cast<Contactormanager::PrechargeStrategy>(data.contactor_precharge_strategy));
     contactorManager.setPositiveOpenCurrentLimit(data.contactor_positive_open_current_limit_A);
@@ -703,6 +893,12 @@ PersistentDataStorage::PersistentData BMS::collect_persistent_data() const
     data.q_low_as = coulomb_counting.q_low_as() - q_as_ref;
     data.soc_low_anchor = coulomb_counting.soc_low_anchor();
     data.was_above_high_set = static_cast<uint8_t>(coulomb_counting.was_above_high_set());
+    const CapacityEstimatorStats &cap_stats = coulomb_counting.capacity_stats();
+    data.cap_c1 = cap_stats.c1;
+    data.cap_c2 = cap_stats.c2;
+    data.cap_c3 = cap_stats.c3;
+    data.cap_pairs = cap_stats.pairs;
+    data.usage = usage_statistics.data();
     data.contactor_precharge_strategy =
         static_cast<uint8_t>(contactorManager.getPrechargeStrategy());
     data.contactor_positive_open_current_limit_A =
@@ -722,6 +918,12 @@ void BMS::store_persistent_and_reset_q_as()
     apply_persistent_data(data);
 }
 
+void BMS::prepare_for_reset()
+{
+    store_persistent_and_reset_q_as();
+    blackbox.request_flush();
+}
+
 PersistentDataStorage::PersistentData BMS::get_persistent_data() const
 {
     return collect_persistent_data();
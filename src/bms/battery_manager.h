@@ -8,10 +8,12 @@
 #include "bms/battery i3/pack.h"
 #include "bms/current.h"
 #include "bms/coulomb_counting.h"
+#include "bms/usage_statistics.h"
 #include "bms/contactor_manager.h"
-#include "utils/can_packer.h"
+#include "can_messages.h"
 #include "settings.h"
 #include "persistent_data_storage.h"
+#include "blackbox_recorder.h"
 
 typedef void (*SendMessageCallback)(const CANMessage &);
 
@@ -56,7 +58,12 @@ public:
     // Runnables
     //         void print();
     void initialize();
-    void read_message(); // Poll messages
+    void check_vcu_timeout();
+
+    // CAN receive (ACAN_T4 filter callbacks on BMS_CAN)
+    void process_vcu_message(const CANMessage &msg);
+    static void on_vcu_frame(const CANMessage &msg);
+    static void on_blackbox_dump_request(const CANMessage &msg);
 
     void set_pack_power(float pack_power_w);
 
@@ -69,6 +76,13 @@ public:
     // Balancing control
     void update_balancing();
 
+    // Low-activity profile (see comms_bms.cpp): allowed in vehicle state
+    // SLEEP once operating, with open contactors and no balancing. HMI frames
+    // and metrics are suspended while it is active.
+    bool allows_low_activity();
+    void set_low_activity(bool enable) { low_activity = enable; }
+    bool is_low_activity() const { return low_activity; }
+
     // Accessors for monitoring values
     STATE_BMS get_state() const { return state; }
     DTC_BMS get_dtc() const { return dtc; }
@@ -89,17 +103,29 @@ public:
     float get_current_limit_rms_derated_charge() const { return current_limit_rms_derated_charge; }
 
     bool is_balancing_finished() const { return balancing_finished; }
+    const UsageStatistics &get_usage_statistics() const { return usage_statistics; }
+    BlackBoxRecorder &get_blackbox() { return blackbox; }
 
     PersistentDataStorage::PersistentData get_persistent_data() const;
     void update_persistent_data(const PersistentDataStorage::PersistentData &data);
 
+    // Before a software reset: stage the persistent record and flush the
+    // black box. Task10Ms() writes both out; storage_committed() reports
+    // when nothing is left.
+    void prepare_for_reset();
+    bool storage_committed() const { return !persistent_storage.busy() && blackbox.flushed(); }
+
 private:
     PersistentDataStorage persistent_storage;
+    BlackBoxRecorder blackbox;
 
     BatteryPack &batteryPack; // Reference to the BatteryPack
     Shunt_IVTS &shunt;
     Contactormanager &contactorManager;
     CoulombCounting coulomb_counting;
+    UsageStatistics usage_statistics;
+    uint32_t usage_last_ms;
+    uint32_t usage_persist_elapsed_s;
 
     bool cell_available[CELLS_PER_MODULE * MODULES_PER_PACK];
     float internal_resistance[CELLS_PER_MODULE * MODULES_PER_PACK];
@@ -157,6 +183,8 @@ private:
     // Balancing finished flag
     bool balancing_finished;
 
+    bool low_activity;
+
     // HMI Energy Metrics
     float avg_energy_per_hour;        // kWh per hour
     float time_remaining_s;           // Remaining time until empty/full depending on sign
@@ -166,9 +194,18 @@ private:
 
     void send_battery_status_message();
     void send_contactor_telemetry_message();
+    static void send_blackbox_record(const BlackBoxRecorder::Record &record, void *context);
+
+    // BMS the filter callbacks decode into (set by initialize())
+    static BMS *can_receiver;
+    // Work deferred from the receive callbacks (see work_queue.h)
+    static void deferred_store_persistent(void *context);
+    static void deferred_blackbox_dump(void *context);
 
     // --- Core Functions ---
     void update_soc_coulomb_counting();
+    void update_ocv_relaxation();
+    void update_usage_statistics();
     void calculate_soh();
     void update_energy_metrics();
 
@@ -194,6 +231,17 @@ private:
     // Helper functions
     void send_message(CANMessage *frame); // Send out CAN message
 
+    // Encodes a can_messages.h frame and sends it
+    template <typename Frame>
+    void send_frame(const Frame &frame)
+    {
+        CANMessage msg;
+        msg.id = Frame::kId;
+        msg.len = Frame::kLen;
+        frame.encode(msg.data);
+        send_message(&msg);
+    }
+
     byte moduleToBeMonitored;
 
     uint8_t msg1_counter;
@@ -213,6 +261,14 @@ private:
     PersistentDataStorage::PersistentData collect_persistent_data() const;
     void store_persistent_and_reset_q_as();
 
+    // Black-box event detection: values last recorded
+    void update_blackbox();
+    STATE_BMS blackbox_state;
+    uint16_t blackbox_dtc[4]; // indexed by BlackBoxRecorder::DtcSource
+    Contactormanager::State blackbox_contactor_state;
+    float blackbox_limits[4]; // max discharge, max charge, rms discharge, rms charge
+    uint32_t blackbox_snapshot_ms;
+
     // State and DTC
     STATE_BMS state;
     DTC_BMS dtc;
@@ -220,6 +276,7 @@ private:
     float max_charge_current;
     float max_discharge_current;
     bool ready_to_shutdown;
+    bool shutdown_store_pending; // shutdown record staged, waiting for the write-behind
     //         const char *getStateString();
     //         String getDTCString();
 };
@@ -0,0 +1,77 @@
+#include "bms/capacity_estimator.h"
+
+#include <cmath>
+
+namespace
+{
+constexpr float k_ratio = CC_CAP_EST_SIGMA_Q / CC_CAP_EST_SIGMA_DSOC;
+constexpr float k2 = k_ratio * k_ratio;
+} // namespace
+
+void CapacityEstimator::initialise(const CapacityEstimatorStats &stats, float q_init)
+{
+    stats_ = stats;
+
+    if (!(stats_.c1 > 0.0f) || !std::isfinite(stats_.c2) || !std::isfinite(stats_.c3))
+    {
+        // Virtual pair dsoc = 1, dq = q_init with a large SOC uncertainty.
+        const float w = 1.0f / (CC_CAP_EST_PRIOR_SIGMA_SOC * CC_CAP_EST_PRIOR_SIGMA_SOC);
+        stats_.c1 = w;
+        stats_.c2 = w * q_init;
+        stats_.c3 = w * q_init * q_init;
+        stats_.pairs = 0U;
+    }
+
+    solve_();
+}
+
+bool CapacityEstimator::add_pair(float dq_norm, float dsoc, float sigma_dsoc)
+{
+    if (!std::isfinite(dq_norm) || !std::isfinite(dsoc) || !(sigma_dsoc > 0.0f))
+    {
+        return false;
+    }
+    if (std::fabs(dsoc) < CC_CAP_EST_MIN_DSOC || (dq_norm * dsoc) <= 0.0f)
+    {
+        return false;
+    }
+
+    const float w = 1.0f / (sigma_dsoc * sigma_dsoc);
+
+    stats_.c1 = CC_CAP_EST_FORGETTING * stats_.c1 + w * dsoc * dsoc;
+    stats_.c2 = CC_CAP_EST_FORGETTING * stats_.c2 + w * dsoc * dq_norm;
+    stats_.c3 = CC_CAP_EST_FORGETTING * stats_.c3 + w * dq_norm * dq_norm;
+    if (stats_.pairs < UINT16_MAX)
+    {
+        stats_.pairs++;
+    }
+
+    solve_();
+    return true;
+}
+
+float CapacityEstimator::cost_(float q) const
+{
+    return (stats_.c3 - 2.0f * q * stats_.c2 + q * q * stats_.c1) / (k2 + q * q);
+}
+
+void CapacityEstimator::solve_()
+{
+    const float c1 = stats_.c1;
+    const float c2 = stats_.c2;
+    const float c3 = stats_.c3;
+
+    if (!(c2 > 0.0f))
+    {
+        return;
+    }
+
+    // dJ/dQ = 0  ->  c2 Q^2 + (c1 k^2 - c3) Q - c2 k^2 = 0, positive root.
+    const float b = c3 - c1 * k2;
+    q_ = (b + std::sqrt(b * b + 4.0f * c2 * c2 * k2)) / (2.0f * c2);
+
+    // Fisher information from the curvature of the cost: var(Q) = 2 / J''(Q).
+    const float h = 1.0e-3f * q_;
+    const float curvature = (cost_(q_ + h) - 2.0f * cost_(q_) + cost_(q_ - h)) / (h * h);
+    sigma_q_ = (curvature > 0.0f) ? std::sqrt(2.0f / curvature) : 1.0f;
+}
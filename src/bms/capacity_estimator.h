@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdint.h>
+
+// Recursive weighted total-least-squares capacity estimator
+//
+// Every valid anchor pair gives one observation of the model dq = C * dsoc,
+// where both dq (shunt charge between the anchors) and dsoc (difference of
+// the two OCV based SOC values) are noisy. Capacity is kept normalised to the
+// rated capacity (Q = C / C_rated), so all sums stay in a small numeric range.
+//
+// With the noise ratio k = sigma_q / sigma_dsoc fixed, the TLS cost
+//
+//     J(Q) = sum w_i * (y_i - Q * x_i)^2 / (k^2 + Q^2),   w_i = 1 / sigma_dsoc_i^2
+//
+// only depends on the three sums c1 = sum w x^2, c2 = sum w x y and
+// c3 = sum w y^2. The minimum has a closed form, so the sufficient statistics
+// are just these three floats (plus a pair counter). A forgetting factor is
+// applied before each new pair so the estimate follows ageing.
+//
+// The class has no Arduino dependency so it can be exercised on the host
+// (see test/capacity_estimator).
+
+#define CC_CAP_EST_FORGETTING 0.95f     // Forgetting factor per anchor pair
+#define CC_CAP_EST_SIGMA_SOC 0.02f      // 1-sigma OCV SOC error of one anchor
+#define CC_CAP_EST_SIGMA_DSOC (1.41421356f * CC_CAP_EST_SIGMA_SOC) // dsoc of a pair: two independent anchors
+#define CC_CAP_EST_SIGMA_Q 0.005f       // 1-sigma shunt charge error per pair (fraction of C_rated)
+#define CC_CAP_EST_PRIOR_SIGMA_SOC 0.3f // Weight of the initial capacity as a virtual full-span pair
+#define CC_CAP_EST_MIN_DSOC 0.30f       // Minimum SOC span of a pair
+
+struct CapacityEstimatorStats
+{
+    float c1 = 0.0f;
+    float c2 = 0.0f;
+    float c3 = 0.0f;
+    uint16_t pairs = 0U;
+};
+
+class CapacityEstimator
+{
+public:
+    CapacityEstimator() = default;
+
+    // Restore persisted statistics. If they are empty, seed them with a weak
+    // prior at q_init (capacity normalised to rated capacity).
+    void initialise(const CapacityEstimatorStats &stats, float q_init);
+
+    // dq_norm: charge between anchors / C_rated, dsoc: OCV SOC difference,
+    // sigma_dsoc: 1-sigma uncertainty of dsoc. Returns false if the pair is
+    // rejected (too small span, sign mismatch, or non-finite values).
+    bool add_pair(float dq_norm, float dsoc, float sigma_dsoc);
+
+    float q() const { return q_; }
+    float sigma_q() const { return sigma_q_; }
+    const CapacityEstimatorStats &stats() const { return stats_; }
+
+private:
+    void solve_();
+    float cost_(float q) const;
+
+    CapacityEstimatorStats stats_;
+    float q_ = 1.0f;
+    float sigma_q_ = 1.0f;
+};
@@ -4,7 +4,6 @@
 #include "bms/contactor_manager.h"
 #include "bms/contactor.h"
 #include "bms/hv_monitor.h"
-#include "utils/can_packer.h"
 #include <cmath>
 
 Contactormanager::Contactormanager() :
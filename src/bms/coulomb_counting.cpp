@@ -8,6 +8,8 @@ namespace param
     float b_as = 0.0f;
     float C_as = BMS_INITIAL_CAPACITY_AS * 0.5f; //Better have initial capacity too low
     float soh = 1.0f;
+    float C_sigma_as = 0.0f;
+    uint16_t cap_est_pairs = 0U;
     bool have_low_anchor = false;
     float q_low_as = 0.0f;
     float soc_low_anchor = 0.0f;
@@ -15,6 +17,9 @@ namespace param
     float q_as = 0.0f;
     bool ocv_valid = false;
     float soc_ocv = 0.0f;
+    bool ocv_relax_converged = false;
+    float ocv_relax_v_min = 0.0f;
+    float ocv_relax_v_max = 0.0f;
     float soc_cc = 0.0f;
     CoulombCountingState coulomb_state = CoulombCountingState::INIT;
 }
@@ -28,7 +33,6 @@ constexpr float soc_low_reset = soc_low_set + soc_hyst;
 constexpr float soc_high_reset = soc_high_set - soc_hyst;
 
 constexpr float gamma_b = 0.05f;
-constexpr float alpha_C = 0.10f;
 
 constexpr float C_rated_as = CC_CAP_RATED_AS;
 constexpr float C_min = 0.50f * C_rated_as;
@@ -57,7 +61,8 @@ void CoulombCounting::initialise(float b_as,
                                  bool have_low_anchor,
                                  float q_low_as,
                                  float soc_low_anchor,
-                                 bool was_above_high_set)
+                                 bool was_above_high_set,
+                                 const CapacityEstimatorStats &cap_stats)
 {
     b_as_ = b_as;
     C_as_ = C_as;
@@ -71,6 +76,8 @@ void CoulombCounting::initialise(float b_as,
     soc_cc_ = 0.0f;
     q_as_ = param::as;
     ocv_rest_timer_ = 0.0f;
+    reset_relaxation();
+    capacity_estimator_.initialise(cap_stats, C_as_ / C_rated_as);
 
     if (C_as_ > 0.0f)
     {
@@ -147,20 +154,30 @@ void CoulombCounting::update(float v_min, float v_max, float avg_temp_c)
     }
 
     // OCV validity based on rest time.
-    if (std::fabs(param::current) < CC_REST_THRESHOLD_A)
+    const bool resting = std::fabs(param::current) < CC_REST_THRESHOLD_A;
+    if (resting)
     {
         ocv_rest_timer_ += dt_s;
     }
     else
     {
         ocv_rest_timer_ = 0.0f;
+        // The 100 ms task may not have seen the current yet; a fit of the
+        // previous rest must not anchor SOC under load.
+        reset_relaxation();
     }
 
-    ocv_valid_ = (ocv_rest_timer_ > CC_REST_TIME_MIN_S);
+    // A converged relaxation fit gives the extrapolated OCV before the rest
+    // timer expires, and is less biased than the raw voltage afterwards.
+    const bool relax_converged = resting && relax_v_min_.converged() && relax_v_max_.converged();
+    ocv_valid_ = (ocv_rest_timer_ > CC_REST_TIME_MIN_S) || relax_converged;
     if (ocv_valid_)
     {
-        const float soc_hi = SOC_FROM_OCV_TEMP(avg_temp_c, v_max) / 100.0f;
-        const float soc_lo = SOC_FROM_OCV_TEMP(avg_temp_c, v_min) / 100.0f;
+        const float ocv_max = relax_converged ? relax_v_max_.v_inf() : v_max;
+        const float ocv_min = relax_converged ? relax_v_min_.v_inf() : v_min;
+        const SocOcvSlice soc_at_temp = socOcvSliceAtTemp(avg_temp_c);
+        const float soc_hi = soc_at_temp.f(ocv_max) / 100.0f;
+        const float soc_lo = soc_at_temp.f(ocv_min) / 100.0f;
         if (soc_hi >= soc_high_set)
         {
             soc_ocv_ = soc_hi;
@@ -222,46 +239,86 @@ void CoulombCounting::update(float v_min, float v_max, float avg_temp_c)
 
         have_low_anchor_ = true;
         q_low_as_ = q_as_;
-        soc_low_anchor_ = soc_cc_;
+        soc_low_anchor_ = soc_ocv_;
     }
 
     // ============================================================
     // 2) HIGH REGION: capacity update (with clamping) + SOH update
     // ============================================================
+    // Each low anchor contributes one (dq, dSOC_ocv) pair to the weighted
+    // TLS estimator; the estimator replaces the two-point EMA so anchor noise
+    // averages out over many pairs. The anchor is consumed by its pair:
+    // further high rests would reuse the same low anchor error, so the pairs
+    // would not be independent.
     if (ocv_valid_ && have_low_anchor_ && (soc_cc_ >= soc_high_set))
     {
-        // Two-point slope
-        float C_new = (q_as_ - q_low_as_) / (soc_ocv_ - soc_low_anchor_);
-
-        // Reject gross outliers (optional but recommended)
-        C_new = clamp(C_new, 0.30f * C_rated_as, 1.50f * C_rated_as);
+        have_low_anchor_ = false;
 
-        // EMA update
-        C_as_ = (1.0f - alpha_C) * C_as_ + alpha_C * C_new;
+        const float dq_norm = (q_as_ - q_low_as_) / C_rated_as;
+        const float dsoc = soc_ocv_ - soc_low_anchor_;
 
-        // Hard clamp
-        C_as_ = clamp(C_as_, C_min, C_max);
+        // Reject gross outliers instead of clamping them into the fit.
+        const float C_pair = (dsoc != 0.0f) ? (dq_norm / dsoc) : 0.0f;
+        const bool plausible = (C_pair >= 0.30f) && (C_pair <= 1.50f);
 
-        // SOH update (0..1, can exceed 1 if you allow it; usually clamp to 1.0)
-        if (C_rated_as > 0.0f)
-        {
-            soh_ = C_as_ / C_rated_as;
-        }
-        else
+        if (plausible && capacity_estimator_.add_pair(dq_norm, dsoc, CC_CAP_EST_SIGMA_DSOC))
         {
-            soh_ = 0.0f;
+            // Hard clamp
+            C_as_ = clamp(capacity_estimator_.q() * C_rated_as, C_min, C_max);
+
+            // SOH update (0..1, can exceed 1 if you allow it; usually clamp to 1.0)
+            if (C_rated_as > 0.0f)
+            {
+                soh_ = C_as_ / C_rated_as;
+            }
+            else
+            {
+                soh_ = 0.0f;
+            }
+            soh_ = clamp(soh_, 0.0f, 1.5f);
         }
-        soh_ = clamp(soh_, 0.0f, 1.5f);
     }
 
     publish_params_();
 }
 
+void CoulombCounting::update_relaxation(float v_min, float v_max)
+{
+    const uint32_t now = millis();
+    const bool resting = (param::state != ShuntState::FAULT) &&
+                         (std::fabs(param::current) < CC_REST_THRESHOLD_A);
+
+    if (!resting || state_ != CoulombCountingState::OPERATING || last_relax_ms_ == 0U)
+    {
+        // Restart the fit on every current pulse; t = 0 is the moment the
+        // current dropped below the rest threshold.
+        reset_relaxation();
+        last_relax_ms_ = now;
+        return;
+    }
+
+    relax_rest_s_ += static_cast<float>(now - last_relax_ms_) / 1000.0f;
+    last_relax_ms_ = now;
+
+    relax_v_min_.add_sample(relax_rest_s_, v_min);
+    relax_v_max_.add_sample(relax_rest_s_, v_max);
+}
+
+void CoulombCounting::reset_relaxation()
+{
+    relax_v_min_.reset();
+    relax_v_max_.reset();
+    relax_rest_s_ = 0.0f;
+    last_relax_ms_ = 0U;
+}
+
 void CoulombCounting::publish_params_()
 {
     param::b_as = b_as_;
     param::C_as = C_as_;
     param::soh = soh_;
+    param::C_sigma_as = capacity_estimator_.sigma_q() * C_rated_as;
+    param::cap_est_pairs = capacity_estimator_.stats().pairs;
     param::have_low_anchor = have_low_anchor_;
     param::q_low_as = q_low_as_;
     param::soc_low_anchor = soc_low_anchor_;
@@ -269,6 +326,9 @@ void CoulombCounting::publish_params_()
     param::q_as = q_as_;
     param::ocv_valid = ocv_valid_;
     param::soc_ocv = soc_ocv_;
+    param::ocv_relax_converged = relax_v_min_.converged() && relax_v_max_.converged();
+    param::ocv_relax_v_min = relax_v_min_.v_inf();
+    param::ocv_relax_v_max = relax_v_max_.v_inf();
     param::soc_cc = soc_cc_;
     param::coulomb_state = state_;
 }
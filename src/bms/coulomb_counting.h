@@ -3,7 +3,9 @@
 #include <Arduino.h>
 #include <cmath>
 
+#include "bms/capacity_estimator.h"
 #include "bms/current.h"
+#include "bms/ocv_relaxation.h"
 #include "settings.h"
 
 // Enhanced Coulomb Counting constants
@@ -22,6 +24,8 @@ namespace param {
 extern float b_as;
 extern float C_as;
 extern float soh;
+extern float C_sigma_as;
+extern uint16_t cap_est_pairs;
 extern bool have_low_anchor;
 extern float q_low_as;
 extern float soc_low_anchor;
@@ -29,6 +33,9 @@ extern bool was_above_high_set;
 extern float q_as;
 extern bool ocv_valid;
 extern float soc_ocv;
+extern bool ocv_relax_converged;
+extern float ocv_relax_v_min;
+extern float ocv_relax_v_max;
 extern float soc_cc;
 extern CoulombCountingState coulomb_state;
 }
@@ -43,10 +50,18 @@ public:
                     bool have_low_anchor,
                     float q_low_as,
                     float soc_low_anchor,
-                    bool was_above_high_set);
+                    bool was_above_high_set,
+                    const CapacityEstimatorStats &cap_stats = CapacityEstimatorStats{});
 
     void update(float v_min, float v_max, float avg_temp_c);
 
+    // Feed min/max cell voltage at the CMU update rate (100 ms) so the
+    // relaxation fitters can extrapolate OCV before the rest timer expires.
+    void update_relaxation(float v_min, float v_max);
+
+    // Drop both relaxation fits; the next update_relaxation() starts a new rest.
+    void reset_relaxation();
+
     float soc_cc() const { return soc_cc_; }
     float b_as() const { return b_as_; }
     float C_as() const { return C_as_; }
@@ -55,6 +70,7 @@ public:
     float q_low_as() const { return q_low_as_; }
     float soc_low_anchor() const { return soc_low_anchor_; }
     bool was_above_high_set() const { return was_above_high_set_; }
+    const CapacityEstimatorStats &capacity_stats() const { return capacity_estimator_.stats(); }
     CoulombCountingState state() const { return state_; }
 
 private:
@@ -73,6 +89,11 @@ private:
     float soc_cc_ = 0.0f;
     float ocv_rest_timer_ = 0.0f;
     uint32_t last_update_ms_ = 0U;
+    OcvRelaxationFitter relax_v_min_;
+    OcvRelaxationFitter relax_v_max_;
+    float relax_rest_s_ = 0.0f;
+    uint32_t last_relax_ms_ = 0U;
+    CapacityEstimator capacity_estimator_;
     CoulombCountingState state_ = CoulombCountingState::INIT;
     bool persistent_loaded_ = false;
 };
@@ -4,6 +4,7 @@
 #include <ACAN_T4.h> // for CANMessage
 #include <cmath>
 #include "settings.h"
+#include "can_messages.h"
 
 // Uncomment to enable printing of received CAN frames for the shunt.
 //#define SHUNT_CAN_DEBUG
@@ -62,6 +63,12 @@ public:
   using STATE = ShuntState;
   using DTC = ShuntDTC;
 
+  // CAN acceptance for the receive filters: result frames 0x521..0x528 go to
+  // DecodeCAN(), command responses are read by configure_shunt().
+  static constexpr uint32_t CAN_RESULT_MASK = 0x7F0;
+  static constexpr uint32_t CAN_RESULT_ACCEPTANCE = 0x520;
+  static constexpr uint32_t CAN_RESPONSE_ID = 0x511;
+
   // Status nibble (DB1[7:4]) + counter (DB1[3:0]) from result frames
   struct StatusBits
   {
@@ -137,26 +144,26 @@ public:
 #endif
 #endif
 
-    // Constants: IVT-S default result CAN IDs (node address 0)
-    static constexpr uint32_t ID_I = 0x521;
-    static constexpr uint32_t ID_U1 = 0x522;
-    static constexpr uint32_t ID_U2 = 0x523;
-    static constexpr uint32_t ID_U3 = 0x524;
-    static constexpr uint32_t ID_T = 0x525;
-    static constexpr uint32_t ID_W = 0x526;
-    static constexpr uint32_t ID_As = 0x527;
-    static constexpr uint32_t ID_Wh = 0x528;
+    // IVT-S default result CAN IDs (node address 0)
+    static constexpr uint32_t ID_I = CanIvtResultI::kId;
+    static constexpr uint32_t ID_U1 = CanIvtResultU1::kId;
+    static constexpr uint32_t ID_U2 = CanIvtResultU2::kId;
+    static constexpr uint32_t ID_U3 = CanIvtResultU3::kId;
+    static constexpr uint32_t ID_T = CanIvtResultT::kId;
+    static constexpr uint32_t ID_W = CanIvtResultW::kId;
+    static constexpr uint32_t ID_As = CanIvtResultAs::kId;
+    static constexpr uint32_t ID_Wh = CanIvtResultWh::kId;
 
     // Only IVT-S result frames have DLC 6; ignore others quickly
-    if (m.len < 6)
+    if (m.len < CanIvtResultI::kLen)
     {
       return;
     }
 
-    const uint8_t b1 = m.data[1]; // DB1 = status + counter
-
-    // Reference implementation treats bytes[5..2] as a 32-bit value.
-    const int32_t raw = readS32_le(m.data);
+    // All result frames share one layout (checked below), so one decode
+    // serves every ID; only the scaling differs.
+    const CanIvtResultI frame = CanIvtResultI::decode(m.data);
+    const int32_t raw = frame.result;
 
     const uint32_t now = millis();
 
@@ -164,12 +171,12 @@ public:
     {
     case ID_I:
     { // Current [1 mA / LSB]
-      _st_I = parseStatus_(b1);
+      _st_I = parseStatus_(frame);
       setStatusDtc_(_st_I, SHUNT_DTC_STATUS_I_ERROR);
       if (!_st_I.system_err)
       {
         // Flip IVT-S sign so discharge is negative and charge is positive.
-        _cur_A = -raw / 1000.0f;
+        _cur_A = -CanIvtResultI::result_value(raw);
         param::current = _cur_A;
         _last_valid_ms = now;
         if (_state == STATE::INIT)
@@ -194,11 +201,11 @@ public:
 
     case ID_U1:
     { // Voltage 1 [1 mV / LSB]
-      _st_U1 = parseStatus_(b1);
+      _st_U1 = parseStatus_(frame);
       setStatusDtc_(_st_U1, SHUNT_DTC_STATUS_U1_ERROR);
       if (!_st_U1.system_err)
       {
-        _u1_V = raw / 1000.0f;
+        _u1_V = CanIvtResultU1::result_value(raw);
         param::u_input_hvbox = _u1_V;
         maybeRecoverFromFault_();
       }
@@ -207,11 +214,11 @@ public:
 
     case ID_U2:
     { // Voltage 2 [1 mV / LSB]
-      _st_U2 = parseStatus_(b1);
+      _st_U2 = parseStatus_(frame);
       setStatusDtc_(_st_U2, SHUNT_DTC_STATUS_U2_ERROR);
       if (!_st_U2.system_err)
       {
-        _u2_V = raw / 1000.0f;
+        _u2_V = CanIvtResultU2::result_value(raw);
         param::u_output_hvbox = _u2_V;
         maybeRecoverFromFault_();
       }
@@ -220,11 +227,11 @@ public:
 
     case ID_U3:
     { // Voltage 3 [1 mV / LSB]
-      _st_U3 = parseStatus_(b1);
+      _st_U3 = parseStatus_(frame);
       setStatusDtc_(_st_U3, SHUNT_DTC_STATUS_U3_ERROR);
       if (!_st_U3.system_err)
       {
-        _u3_V = raw / 1000.0f;
+        _u3_V = CanIvtResultU3::result_value(raw);
         param::u3 = _u3_V;
         maybeRecoverFromFault_();
       }
@@ -233,11 +240,11 @@ public:
 
     case ID_T:
     { // Temperature [0.1 C / LSB]
-      _st_T = parseStatus_(b1);
+      _st_T = parseStatus_(frame);
       setStatusDtc_(_st_T, SHUNT_DTC_STATUS_T_ERROR);
       if (!_st_T.system_err)
       {
-        _temp_C = raw / 10.0f;
+        _temp_C = CanIvtResultT::result_value(raw);
         param::temp = _temp_C;
         if (_temp_C > ISA_SHUNT_MAX_TEMPERATURE)
         {
@@ -255,12 +262,12 @@ public:
 
     case ID_W:
     { // Power [1 W / LSB]
-      _st_W = parseStatus_(b1);
+      _st_W = parseStatus_(frame);
       setStatusDtc_(_st_W, SHUNT_DTC_STATUS_W_ERROR);
       if (!_st_W.system_err)
       {
         // Keep sign convention aligned with current decode.
-        _power_W = -static_cast<float>(raw);
+        _power_W = -CanIvtResultW::result_value(raw);
         param::power = _power_W;
         maybeRecoverFromFault_();
       }
@@ -269,13 +276,13 @@ public:
 
     case ID_As:
     { // Charge [1 As / LSB]
-      _st_As = parseStatus_(b1);
+      _st_As = parseStatus_(frame);
       setStatusDtc_(_st_As, SHUNT_DTC_STATUS_AS_ERROR);
       if (!_st_As.system_err)
       {
         // IVT-S provides an absolute counter. Convert to a software-relative
         // counter so resetAs() can re-zero without requiring a hardware reset.
-        const float as_abs = -static_cast<float>(raw);
+        const float as_abs = -CanIvtResultAs::result_value(raw);
         _as_As = as_abs - _as_offset_As;
         param::as = _as_As;
         maybeRecoverFromFault_();
@@ -285,12 +292,12 @@ public:
 
     case ID_Wh:
     { // Energy [1 Wh / LSB]
-      _st_Wh = parseStatus_(b1);
+      _st_Wh = parseStatus_(frame);
       setStatusDtc_(_st_Wh, SHUNT_DTC_STATUS_WH_ERROR);
       if (!_st_Wh.system_err)
       {
         // IVT-S provides an absolute counter. Convert to software-relative form.
-        const float wh_abs = -static_cast<float>(raw);
+        const float wh_abs = -CanIvtResultWh::result_value(raw);
         _wh_Wh = wh_abs - _wh_offset_Wh;
         param::wh = _wh_Wh;
         maybeRecoverFromFault_();
@@ -375,7 +382,7 @@ public:
     Serial.println("IVT-S shunt config: start");
     // ---------------- IVT-S defaults / protocol IDs ----------------
     static constexpr uint32_t IVT_CMD_ID = 0x411;  // IVT_Msg_Command (default)
-    static constexpr uint32_t IVT_RESP_ID = 0x511; // IVT_Msg_Response (default)
+    static constexpr uint32_t IVT_RESP_ID = CAN_RESPONSE_ID; // IVT_Msg_Response (default)
 
     // Command mux bytes (DB0)
     static constexpr uint8_t CMD_STORE = 0x32;        // STORE
@@ -576,26 +583,24 @@ public:
   }
 
 private:
-  // Read 32-bit signed value from data[2..5] in Little-Endian
-  static int32_t readS32_le(const uint8_t *d)
-  {
-    return static_cast<int32_t>(
-        (static_cast<uint32_t>(d[5]) << 24) |
-        (static_cast<uint32_t>(d[4]) << 16) |
-        (static_cast<uint32_t>(d[3]) << 8) |
-        (static_cast<uint32_t>(d[2])));
-  }
-
-  // Parse DB1 into status bits
-  static StatusBits parseStatus_(uint8_t b1)
+  static_assert(CanIvtResultU1::kLayoutHash == CanIvtResultI::kLayoutHash &&
+                    CanIvtResultU2::kLayoutHash == CanIvtResultI::kLayoutHash &&
+                    CanIvtResultU3::kLayoutHash == CanIvtResultI::kLayoutHash &&
+                    CanIvtResultT::kLayoutHash == CanIvtResultI::kLayoutHash &&
+                    CanIvtResultW::kLayoutHash == CanIvtResultI::kLayoutHash &&
+                    CanIvtResultAs::kLayoutHash == CanIvtResultI::kLayoutHash &&
+                    CanIvtResultWh::kLayoutHash == CanIvtResultI::kLayoutHash,
+                "IVT-S result frames share one layout");
+
+  // Status nibble and counter of a decoded result frame
+  static StatusBits parseStatus_(const CanIvtResultI &frame)
   {
     StatusBits s;
-    s.counter = static_cast<uint8_t>(b1 & 0x0F);
-    uint8_t hi = static_cast<uint8_t>(b1 >> 4);
-    s.ocs = (hi & 0x01) != 0;
-    s.this_out_of_range_or_me_err = (hi & 0x02) != 0;
-    s.any_me_err = (hi & 0x04) != 0;
-    s.system_err = (hi & 0x08) != 0;
+    s.counter = frame.counter;
+    s.ocs = frame.ocs;
+    s.this_out_of_range_or_me_err = frame.this_result_error;
+    s.any_me_err = frame.any_measurement_error;
+    s.system_err = frame.system_error;
     return s;
   }
 
@@ -0,0 +1,228 @@
+#include "bms/ocv_relaxation.h"
+
+#include <cmath>
+
+namespace
+{
+// Candidate time constants [s]. The grid is geometric (ratio ~1.25) so that
+// relative error in tau stays bounded; relaxation slower than the last entry is
+// not extrapolated (the fit falls back to the raw voltage once the rest timer
+// expires).
+constexpr float kTauGrid_s[OcvRelaxationFitter::kTauCount] = {
+    1.5f, 2.0f, 2.5f, 3.0f, 4.0f, 5.0f, 6.0f, 8.0f,
+    10.0f, 12.0f, 16.0f, 20.0f, 25.0f, 32.0f, 45.0f, 64.0f};
+
+// Candidates whose residual is within this many noise variances of the best
+// one are considered indistinguishable; their V_inf spread widens the error.
+constexpr float kTauAmbiguityVar = 9.0f;
+
+// Index of the pair k < j in the packed upper triangle of s_pq_.
+constexpr int pair_index(int k, int j)
+{
+    return k * (2 * OcvRelaxationFitter::kTauCount - k - 1) / 2 + (j - k - 1);
+}
+} // namespace
+
+void OcvRelaxationFitter::reset()
+{
+    for (int k = 0; k < kTauCount; ++k)
+    {
+        sums_[k] = Sums{0.0, 0.0, 0.0, 0.0, 0.0};
+    }
+    for (int i = 0; i < kPairCount; ++i)
+    {
+        s_pq_[i] = 0.0;
+    }
+    n_ = 0U;
+    t_start_s_ = 0.0f;
+    v_ref_ = 0.0f;
+    t_last_s_ = 0.0f;
+    converged_ = false;
+    v_inf_ = 0.0f;
+    tau_s_ = 0.0f;
+    std_err_v_ = 1.0e9f;
+    misfit_ = 0.0f;
+}
+
+void OcvRelaxationFitter::add_sample(float t_s, float v)
+{
+    if (t_s < CC_RELAX_SETTLE_S)
+    {
+        return;
+    }
+
+    if (n_ == 0U)
+    {
+        // Reference everything to the first accepted sample to keep the sums
+        // small (mV range) and float precision sufficient.
+        t_start_s_ = t_s;
+        v_ref_ = v;
+    }
+    else if (t_s <= t_last_s_)
+    {
+        return;
+    }
+
+    if (n_ == UINT16_MAX)
+    {
+        return;
+    }
+
+    t_last_s_ = t_s;
+    ++n_;
+
+    const float t_rel = t_s - t_start_s_;
+    const float y = v - v_ref_;
+
+    float p_k[kTauCount];
+    for (int k = 0; k < kTauCount; ++k)
+    {
+        const float p = std::exp(-t_rel / kTauGrid_s[k]);
+        p_k[k] = p;
+        Sums &s = sums_[k];
+        s.s_p += p;
+        s.s_pp += p * p;
+        s.s_y += y;
+        s.s_py += p * y;
+        s.s_yy += y * y;
+    }
+
+    int i = 0;
+    for (int k = 0; k < kTauCount; ++k)
+    {
+        for (int j = k + 1; j < kTauCount; ++j)
+        {
+            s_pq_[i++] += p_k[k] * p_k[j];
+        }
+    }
+
+    solve_();
+}
+
+void OcvRelaxationFitter::solve_()
+{
+    if (n_ < 3U)
+    {
+        converged_ = false;
+        return;
+    }
+
+    const double n = static_cast<double>(n_);
+    double a[kTauCount];
+    double sse[kTauCount];
+    bool valid[kTauCount];
+    int best_k = -1;
+    double best_var_a = 0.0;
+
+    for (int k = 0; k < kTauCount; ++k)
+    {
+        const Sums &s = sums_[k];
+        const double det = n * s.s_pp - s.s_p * s.s_p;
+        valid[k] = det > 1.0e-9; // otherwise tau too long for the observed window
+        if (!valid[k])
+        {
+            continue;
+        }
+
+        // Least squares for y = a + b * p
+        const double b = (n * s.s_py - s.s_p * s.s_y) / det;
+        a[k] = (s.s_y - b * s.s_p) / n;
+        sse[k] = s.s_yy - a[k] * s.s_y - b * s.s_py;
+        if (sse[k] < 0.0)
+        {
+            sse[k] = 0.0;
+        }
+
+        if (best_k < 0 || sse[k] < sse[best_k])
+        {
+            best_k = k;
+            best_var_a = (sse[k] / (n - 2.0)) * s.s_pp / det;
+        }
+    }
+
+    if (best_k < 0)
+    {
+        converged_ = false;
+        return;
+    }
+
+    // Spread of V_inf over all tau candidates the data cannot tell apart.
+    const double noise_var = sse[best_k] / (n - 2.0);
+    const double sse_limit = sse[best_k] + kTauAmbiguityVar * noise_var;
+    double a_min = a[best_k];
+    double a_max = a[best_k];
+    for (int k = 0; k < kTauCount; ++k)
+    {
+        if (valid[k] && sse[k] <= sse_limit)
+        {
+            a_min = std::fmin(a_min, a[k]);
+            a_max = std::fmax(a_max, a[k]);
+        }
+    }
+
+    v_inf_ = v_ref_ + static_cast<float>(a[best_k]);
+    tau_s_ = kTauGrid_s[best_k];
+    std_err_v_ = static_cast<float>(std::fmax(std::sqrt(best_var_a), 0.5 * (a_max - a_min)));
+    misfit_ = two_tau_misfit_(sse[best_k]);
+
+    converged_ = (n_ >= CC_RELAX_MIN_SAMPLES) &&
+                 (t_last_s_ >= CC_RELAX_MIN_FIT_S) &&
+                 (t_last_s_ - t_start_s_ >= CC_RELAX_MIN_TAUS * tau_s_) &&
+                 (std_err_v_ <= CC_RELAX_MAX_STDERR_V) &&
+                 (misfit_ <= CC_RELAX_MISFIT_F);
+}
+
+float OcvRelaxationFitter::two_tau_misfit_(double sse_best) const
+{
+    if (n_ < 4U)
+    {
+        return 0.0f;
+    }
+
+    // Least squares for y = a + b * p_k + c * p_j over every tau pair. The
+    // 3x3 normal equations are close to singular for neighbouring taus, so
+    // they are solved in double.
+    const double n = static_cast<double>(n_);
+    double sse_min = sse_best;
+
+    for (int k = 0; k < kTauCount; ++k)
+    {
+        const Sums &sk = sums_[k];
+        for (int j = k + 1; j < kTauCount; ++j)
+        {
+            const Sums &sj = sums_[j];
+            const double s_kj = s_pq_[pair_index(k, j)];
+            const double m00 = n, m01 = sk.s_p, m02 = sj.s_p;
+            const double m11 = sk.s_pp, m12 = s_kj, m22 = sj.s_pp;
+            const double r0 = sk.s_y, r1 = sk.s_py, r2 = sj.s_py;
+
+            // Cramer's rule on the symmetric system
+            const double c00 = m11 * m22 - m12 * m12;
+            const double c01 = m02 * m12 - m01 * m22;
+            const double c02 = m01 * m12 - m02 * m11;
+            const double det = m00 * c00 + m01 * c01 + m02 * c02;
+            if (det <= 1.0e-12)
+            {
+                continue; // slow tau too long for the observed window
+            }
+            const double c11 = m00 * m22 - m02 * m02;
+            const double c12 = m01 * m02 - m00 * m12;
+            const double c22 = m00 * m11 - m01 * m01;
+            const double a = (c00 * r0 + c01 * r1 + c02 * r2) / det;
+            const double b = (c01 * r0 + c11 * r1 + c12 * r2) / det;
+            const double c = (c02 * r0 + c12 * r1 + c22 * r2) / det;
+            const double sse = sk.s_yy - a * r0 - b * r1 - c * r2;
+            if (sse < sse_min)
+            {
+                sse_min = (sse > 0.0) ? sse : 0.0;
+            }
+        }
+    }
+
+    const double noise_var = sse_min / (n - 3.0);
+    if (noise_var <= 0.0)
+    {
+        return 0.0f;
+    }
+    return static_cast<float>((sse_best - sse_min) / noise_var);
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <stdint.h>
+
+// OCV relaxation extrapolation
+//
+// After the pack current drops below the rest threshold the cell voltage
+// relaxes towards its open-circuit value with (approximately) a first order
+// exponential: V(t) = V_inf + A * exp(-t / tau).
+//
+// The fitter keeps one set of running least-squares sums per candidate tau.
+// For a fixed tau the model is linear in (V_inf, A), so every sample only
+// updates a handful of sums and the best tau is the one with the smallest
+// residual. The confidence metric is the standard error of V_inf from that
+// fit, widened by the V_inf spread of all tau candidates that fit equally well
+// (so an ambiguous tau is not mistaken for a converged fit).
+//
+// The standard error only measures noise, not model misfit: a relaxation with
+// a second, slower time constant fits one exponential with a small residual
+// while V_inf is still biased towards the fast branch. Two checks guard
+// against that. The window must span CC_RELAX_MIN_TAUS fitted time constants,
+// so the fast branch has decayed far enough for a slow one to show. The same
+// sums plus one cross term per tau pair also give the residual of a
+// V_inf + A1 * exp(-t / tau1) + A2 * exp(-t / tau2) fit; if adding the second
+// exponential reduces the residual by more than CC_RELAX_MISFIT_F noise
+// variances, the single exponential does not explain the trace and V_inf is
+// not trusted. A slow branch that barely moves within the window (hundreds of
+// seconds) cannot be seen by either check; the fit then still anchors closer
+// to OCV than the raw voltage at the end of CC_REST_TIME_MIN_S.
+//
+// The class has no Arduino dependency so it can be exercised on the host
+// (see test/ocv_relaxation).
+
+#define CC_RELAX_SETTLE_S 0.5f       // Skip ohmic step right after current drops
+#define CC_RELAX_MIN_FIT_S 10.0f     // Minimum rest time before a fit is trusted
+#define CC_RELAX_MIN_SAMPLES 20U     // Minimum samples before a fit is trusted
+#define CC_RELAX_MAX_STDERR_V 0.002f // Max standard error of V_inf for convergence
+#define CC_RELAX_MIN_TAUS 3.5f       // Minimum fit window in fitted time constants
+#define CC_RELAX_MISFIT_F 12.0f      // Residual drop (noise variances) that flags a second time constant
+
+class OcvRelaxationFitter
+{
+public:
+    static constexpr int kTauCount = 16;
+    static constexpr int kPairCount = kTauCount * (kTauCount - 1) / 2;
+
+    OcvRelaxationFitter() { reset(); }
+
+    void reset();
+
+    // t_s: time since the current dropped below the rest threshold
+    void add_sample(float t_s, float v);
+
+    bool converged() const { return converged_; }
+    float v_inf() const { return v_inf_; }
+    float tau_s() const { return tau_s_; }
+    float std_err_v() const { return std_err_v_; }
+    // Residual drop of the two time constant fit, in noise variances
+    float misfit() const { return misfit_; }
+    uint16_t samples() const { return n_; }
+
+private:
+    // Accumulated in double: the two time constant fit below solves nearly
+    // collinear normal equations from these sums.
+    struct Sums
+    {
+        double s_p;
+        double s_pp;
+        double s_y;
+        double s_py;
+        double s_yy;
+    };
+
+    void solve_();
+    float two_tau_misfit_(double sse_best) const;
+
+    Sums sums_[kTauCount];
+    double s_pq_[kPairCount]; // sum of p_k * p_j for k < j
+    uint16_t n_;
+    float t_start_s_;
+    float v_ref_;
+    float t_last_s_;
+    bool converged_;
+    float v_inf_;
+    float tau_s_;
+    float std_err_v_;
+    float misfit_;
+};
@@ -0,0 +1,248 @@
+#include "bms/usage_statistics.h"
+
+#include <cmath>
+
+namespace
+{
+// Signed C-rate bin edges (discharge negative). Bin i covers
+// [kCrateEdges[i-1], kCrateEdges[i]); the outer bins are open ended.
+constexpr float kCrateEdges[USAGE_CRATE_BINS - 1] = {
+    -3.0f, -2.0f, -1.0f, -0.5f, -0.1f, 0.1f, 0.5f, 1.0f, 2.0f};
+
+constexpr float kTempBinLowC = -30.0f;
+constexpr float kTempBinWidthC = 10.0f;
+
+// Push one reversal and extract closed cycles (ASTM E1049 three-point rule).
+// Returns true if the stack overflowed and the oldest range was closed early.
+bool rainflow_push(float *stack, uint16_t &depth, uint32_t *hist, float x)
+{
+    bool overflowed = false;
+    if (depth == USAGE_RAINFLOW_STACK)
+    {
+        // Count the range from the starting point as a half cycle and move
+        // the starting point forward, like ASTM does for ranges containing S.
+        hist[UsageStatistics::dod_bin(std::fabs(stack[1] - stack[0]))] += 1U;
+        for (uint16_t i = 1U; i < depth; ++i)
+        {
+            stack[i - 1U] = stack[i];
+        }
+        --depth;
+        overflowed = true;
+    }
+
+    stack[depth++] = x;
+
+    while (depth >= 3U)
+    {
+        const float range_x = std::fabs(stack[depth - 1U] - stack[depth - 2U]);
+        const float range_y = std::fabs(stack[depth - 2U] - stack[depth - 3U]);
+        if (range_x < range_y)
+        {
+            break;
+        }
+
+        if (depth == 3U)
+        {
+            // Y contains the starting point: half cycle, drop the start.
+            hist[UsageStatistics::dod_bin(range_y)] += 1U;
+            stack[0] = stack[1];
+            stack[1] = stack[2];
+            depth = 2U;
+        }
+        else
+        {
+            // Full cycle: remove both points of Y.
+            hist[UsageStatistics::dod_bin(range_y)] += 2U;
+            stack[depth - 3U] = stack[depth - 1U];
+            depth -= 2U;
+        }
+    }
+
+    return overflowed;
+}
+} // namespace
+
+void UsageStatistics::restore(const UsageStatisticsData &data, float rated_capacity_ah)
+{
+    data_ = data;
+    rated_capacity_ah_ = (rated_capacity_ah > 0.0f) ? rated_capacity_ah : 1.0f;
+
+    depth_ = 0U;
+    have_sample_ = false;
+    direction_ = 0;
+    extreme_ = 0.0f;
+
+    charge_mAh_residual_ = 0.0f;
+    discharge_mAh_residual_ = 0.0f;
+    charge_Wh_residual_ = 0.0f;
+    discharge_Wh_residual_ = 0.0f;
+    for (uint8_t i = 0U; i < USAGE_TEMP_BINS; ++i)
+    {
+        temp_residual_s_[i] = 0.0f;
+    }
+    for (uint8_t i = 0U; i < USAGE_CRATE_BINS; ++i)
+    {
+        crate_residual_s_[i] = 0.0f;
+    }
+}
+
+void UsageStatistics::update(float dt_s, float soc, float current_a, float pack_voltage_v, float temp_c)
+{
+    if (!(dt_s > 0.0f) || !std::isfinite(current_a))
+    {
+        return;
+    }
+
+    if (std::isfinite(soc))
+    {
+        add_soc_sample(soc);
+    }
+
+    // Throughput
+    const float mAh = std::fabs(current_a) * dt_s / 3.6f;
+    if (current_a >= 0.0f)
+    {
+        accumulate_(data_.charge_mAh, charge_mAh_residual_, mAh);
+    }
+    else
+    {
+        accumulate_(data_.discharge_mAh, discharge_mAh_residual_, mAh);
+    }
+
+    if (std::isfinite(pack_voltage_v))
+    {
+        const float Wh = std::fabs(current_a * pack_voltage_v) * dt_s / 3600.0f;
+        if (current_a >= 0.0f)
+        {
+            accumulate_(data_.charge_Wh, charge_Wh_residual_, Wh);
+        }
+        else
+        {
+            accumulate_(data_.discharge_Wh, discharge_Wh_residual_, Wh);
+        }
+    }
+
+    // Exposure histograms
+    if (std::isfinite(temp_c))
+    {
+        const uint8_t bin = temp_bin(temp_c);
+        accumulate_(data_.temp_time_s[bin], temp_residual_s_[bin], dt_s);
+    }
+
+    const uint8_t crate = crate_bin(current_a / rated_capacity_ah_);
+    accumulate_(data_.crate_time_s[crate], crate_residual_s_[crate], dt_s);
+}
+
+void UsageStatistics::add_soc_sample(float soc)
+{
+    if (!have_sample_)
+    {
+        have_sample_ = true;
+        depth_ = 0U;
+        stack_[depth_++] = soc; // starting point S
+        extreme_ = soc;
+        direction_ = 0;
+        return;
+    }
+
+    if (direction_ == 0)
+    {
+        const float delta = soc - stack_[depth_ - 1U];
+        if (std::fabs(delta) >= USAGE_RAINFLOW_HYST)
+        {
+            direction_ = (delta > 0.0f) ? 1 : -1;
+            extreme_ = soc;
+        }
+        return;
+    }
+
+    if ((direction_ > 0 && soc > extreme_) || (direction_ < 0 && soc < extreme_))
+    {
+        extreme_ = soc;
+        return;
+    }
+
+    if (std::fabs(extreme_ - soc) >= USAGE_RAINFLOW_HYST)
+    {
+        push_reversal_(extreme_);
+        direction_ = static_cast<int8_t>(-direction_);
+        extreme_ = soc;
+    }
+}
+
+void UsageStatistics::residue_half_cycles(uint32_t hist[USAGE_DOD_BINS]) const
+{
+    float stack[USAGE_RAINFLOW_STACK];
+    uint16_t depth = depth_;
+    for (uint16_t i = 0U; i < depth; ++i)
+    {
+        stack[i] = stack_[i];
+    }
+
+    if (direction_ != 0)
+    {
+        rainflow_push(stack, depth, hist, extreme_);
+    }
+
+    for (uint16_t i = 1U; i < depth; ++i)
+    {
+        hist[dod_bin(std::fabs(stack[i] - stack[i - 1U]))] += 1U;
+    }
+}
+
+uint8_t UsageStatistics::dod_bin(float range)
+{
+    const int bin = static_cast<int>(range * static_cast<float>(USAGE_DOD_BINS));
+    if (bin < 0)
+    {
+        return 0U;
+    }
+    if (bin >= USAGE_DOD_BINS)
+    {
+        return USAGE_DOD_BINS - 1U;
+    }
+    return static_cast<uint8_t>(bin);
+}
+
+uint8_t UsageStatistics::temp_bin(float temp_c)
+{
+    const float pos = (temp_c - kTempBinLowC) / kTempBinWidthC;
+    if (!(pos >= 0.0f))
+    {
+        return 0U;
+    }
+    if (pos >= static_cast<float>(USAGE_TEMP_BINS - 1))
+    {
+        return USAGE_TEMP_BINS - 1U;
+    }
+    return static_cast<uint8_t>(pos);
+}
+
+uint8_t UsageStatistics::crate_bin(float c_rate)
+{
+    uint8_t bin = 0U;
+    while (bin < (USAGE_CRATE_BINS - 1) && c_rate >= kCrateEdges[bin])
+    {
+        ++bin;
+    }
+    return bin;
+}
+
+void UsageStatistics::push_reversal_(float soc)
+{
+    if (rainflow_push(stack_, depth_, data_.dod_half_cycles, soc))
+    {
+        ++overflows_;
+    }
+}
+
+void UsageStatistics::accumulate_(uint32_t &counter, float &residual, float increment)
+{
+    residual += increment;
+    if (residual >= 1.0f)
+    {
+        const uint32_t whole = static_cast<uint32_t>(residual);
+        counter += whole;
+        residual -= static_cast<float>(whole);
+    }
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <stdint.h>
+
+// Ageing analytics: streaming rainflow counter on soc_cc, charge/energy
+// throughput and time-at-temperature / C-rate histograms.
+//
+// All counters live in UsageStatisticsData, a fixed-size POD that is stored as
+// part of the persistent record. The rainflow residue (open half cycles) is
+// RAM only; after a reset counting restarts from the current SOC.
+//
+// Rainflow follows the ASTM E1049 three-point rule applied incrementally:
+// every confirmed reversal is pushed once and popped at most once, so the
+// cost per reversal is O(1) amortised. Reversals are confirmed once the SOC
+// moves back by USAGE_RAINFLOW_HYST from the last extreme, which filters
+// measurement noise and small regen pulses.
+//
+// The class has no Arduino dependency so it can be exercised on the host
+// (see test/usage_statistics).
+
+#define USAGE_DOD_BINS 10          // 10 % SOC depth per bin
+#define USAGE_TEMP_BINS 10         // <-20, -20..-10, ..., 50..60, >=60 degC
+#define USAGE_CRATE_BINS 10        // see kCrateEdges in usage_statistics.cpp
+#define USAGE_RAINFLOW_HYST 0.01f  // SOC reversal hysteresis (fraction)
+#define USAGE_RAINFLOW_STACK 64    // Residue stack depth
+#define USAGE_PERSIST_PERIOD_S 900U // Periodic persist interval while operating
+
+struct UsageStatisticsData
+{
+    uint32_t dod_half_cycles[USAGE_DOD_BINS] = {};
+    uint32_t temp_time_s[USAGE_TEMP_BINS] = {};
+    uint32_t crate_time_s[USAGE_CRATE_BINS] = {};
+    uint32_t charge_mAh = 0U;
+    uint32_t discharge_mAh = 0U;
+    uint32_t charge_Wh = 0U;
+    uint32_t discharge_Wh = 0U;
+};
+
+class UsageStatistics
+{
+public:
+    UsageStatistics() = default;
+
+    // Restore persisted counters; the rainflow residue is restarted.
+    // rated_capacity_ah defines 1C for the C-rate histogram.
+    void restore(const UsageStatisticsData &data, float rated_capacity_ah);
+
+    // Called once per second. Current is positive while charging.
+    void update(float dt_s, float soc, float current_a, float pack_voltage_v, float temp_c);
+
+    // Feed a SOC sample (fraction 0..1) to the rainflow counter only.
+    void add_soc_sample(float soc);
+
+    // Add the open half cycles of the residue (including the pending
+    // extreme) to hist, as if the profile ended now.
+    void residue_half_cycles(uint32_t hist[USAGE_DOD_BINS]) const;
+
+    const UsageStatisticsData &data() const { return data_; }
+    uint16_t residue_depth() const { return depth_; }
+    uint32_t residue_overflows() const { return overflows_; }
+
+    static uint8_t dod_bin(float range);
+    static uint8_t temp_bin(float temp_c);
+    static uint8_t crate_bin(float c_rate);
+
+private:
+    void push_reversal_(float soc);
+    static void accumulate_(uint32_t &counter, float &residual, float increment);
+
+    UsageStatisticsData data_;
+    float rated_capacity_ah_ = 1.0f;
+
+    float stack_[USAGE_RAINFLOW_STACK] = {};
+    uint16_t depth_ = 0U;
+    uint32_t overflows_ = 0U;
+
+    bool have_sample_ = false;
+    float extreme_ = 0.0f; // running extreme since the last reversal
+    int8_t direction_ = 0; // +1 rising, -1 falling, 0 unknown
+
+    float charge_mAh_residual_ = 0.0f;
+    float discharge_mAh_residual_ = 0.0f;
+    float charge_Wh_residual_ = 0.0f;
+    float discharge_Wh_residual_ = 0.0f;
+    float temp_residual_s_[USAGE_TEMP_BINS] = {};
+    float crate_residual_s_[USAGE_CRATE_BINS] = {};
+};
@@ -0,0 +1,1798 @@
+// Generated by scripts/generate_can_messages.py from can_messages.dbc. Do not edit;
+// change the DBC and rerun the script (PlatformIO builds do this).
+
+#ifndef CAN_MESSAGES_H
+#define CAN_MESSAGES_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include "utils/can_codec.h"
+#include "utils/can_crc.h"
+
+// Each message is a struct of raw signal values (the integers on the wire).
+// For scaled signals, <signal>_raw() converts a physical value to raw
+// (round to nearest, clamped to the DBC range), <signal>_value() converts
+// back and set_/get_<signal>() wrap both. Integer signals with a DBC range
+// narrower than their bits get a clamping set_<signal>().
+
+// CMU_ErrorBalanceStatus (0x100), 8 bytes, 50 ms, CMU -> BMS
+// BMW i3 CMU frames carry the module number in ID bits 3..0; the IDs here are those of module 0.
+struct CanCmuErrorBalanceStatus
+{
+    static constexpr uint32_t kId = 0x100U;
+    static constexpr uint8_t kLen = 8U;
+    static constexpr const char *kName = "CMU_ErrorBalanceStatus";
+    static constexpr CanChecksum kChecksum = CAN_CHECKSUM_BMW_I3;
+    static constexpr uint64_t kUsedMask = 0xFFF00FFFFFFFFFFFULL;
+    static constexpr uint32_t kLayoutHash = 0xEE65D6C0U;
+
+    // Non-zero while the CMU reports an internal error.
+    uint32_t cmu_error = 0;           // 0|32@1+ (1,0) [0|4294967295]
+    // 0=Charge, 1=Discharge
+    bool balance_direction0 = false;  // 32|1@1+ (1,0) [0|1]
+    bool balance_direction1 = false;  // 33|1@1+ (1,0) [0|1]
+    bool balance_direction2 = false;  // 34|1@1+ (1,0) [0|1]
+    bool balance_direction3 = false;  // 35|1@1+ (1,0) [0|1]
+    bool balance_direction4 = false;  // 36|1@1+ (1,0) [0|1]
+    bool balance_direction5 = false;  // 37|1@1+ (1,0) [0|1]
+    bool balance_direction6 = false;  // 38|1@1+ (1,0) [0|1]
+    bool balance_direction7 = false;  // 39|1@1+ (1,0) [0|1]
+    bool balance_direction8 = false;  // 40|1@1+ (1,0) [0|1]
+    bool balance_direction9 = false;  // 41|1@1+ (1,0) [0|1]
+    bool balance_direction10 = false; // 42|1@1+ (1,0) [0|1]
+    bool balance_direction11 = false; // 43|1@1+ (1,0) [0|1]
+    uint8_t counter = 0;              // 52|4@1+ (1,0) [0|15] counter
+    uint8_t crc = 0;                  // 56|8@1+ (1,0) [0|255] checksum
+
+    // Writes all 8 bytes, unused bits are 0
+    void encode(uint8_t data[8]) const
+    {
+        const uint64_t bits = static_cast<uint64_t>(cmu_error)
+                              | static_cast<uint64_t>(balance_direction0) << 32
+                              | static_cast<uint64_t>(balance_direction1) << 33
+                              | static_cast<uint64_t>(balance_direction2) << 34
+                              | static_cast<uint64_t>(balance_direction3) << 35
+                              | static_cast<uint64_t>(balance_direction4) << 36
+                              | static_cast<uint64_t>(balance_direction5) << 37
+                              | static_cast<uint64_t>(balance_direction6) << 38
+                              | static_cast<uint64_t>(balance_direction7) << 39
+                              | static_cast<uint64_t>(balance_direction8) << 40
+                              | static_cast<uint64_t>(balance_direction9) << 41
+                              | static_cast<uint64_t>(balance_direction10) << 42
+                              | static_cast<uint64_t>(balance_direction11) << 43
+                              | (static_cast<uint64_t>(counter) & 0xFU) << 52
+                              | static_cast<uint64_t>(crc) << 56;
+        can_codec_store(data, bits);
+    }
+
+    static CanCmuErrorBalanceStatus decode(const uint8_t data[8])
+    {
+        const uint64_t bits = can_codec_load(data);
+        CanCmuErrorBalanceStatus message;
+        message.cmu_error = static_cast<uint32_t>(bits & 0xFFFFFFFFU);
+        message.balance_direction0 = ((bits >> 32) & 0x1U) != 0U;
+        message.balance_direction1 = ((bits >> 33) & 0x1U) != 0U;
+        message.balance_direction2 = ((bits >> 34) & 0x1U) != 0U;
+        message.balance_direction3 = ((bits >> 35) & 0x1U) != 0U;
+        message.balance_direction4 = ((bits >> 36) & 0x1U) != 0U;
+        message.balance_direction5 = ((bits >> 37) & 0x1U) != 0U;
+        message.balance_direction6 = ((bits >> 38) & 0x1U) != 0U;
+        message.balance_direction7 = ((bits >> 39) & 0x1U) != 0U;
+        message.balance_direction8 = ((bits >> 40) & 0x1U) != 0U;
+        message.balance_direction9 = ((bits >> 41) & 0x1U) != 0U;
+        message.balance_direction10 = ((bits >> 42) & 0x1U) != 0U;
+        message.balance_direction11 = ((bits >> 43) & 0x1U) != 0U;
+        message.counter = static_cast<uint8_t>((bits >> 52) & 0xFU);
+        message.crc = static_cast<uint8_t>(bits >> 56);
+        return message;
+    }
+
+    bool operator==(const CanCmuErrorBalanceStatus &other) const
+    {
+        return cmu_error == other.cmu_error
+               && balance_direction0 == other.balance_direction0
+               && balance_direction1 == other.balance_direction1
+               && balance_direction2 == other.balance_direction2
+               && balance_direction3 == other.balance_direction3
+               && balance_direction4 == other.balance_direction4
+               && balance_direction5 == other.balance_direction5
+               && balance_direction6 == other.balance_direction6
+               && balance_direction7 == other.balance_direction7
+               && balance_direction8 == other.balance_direction8
+               && balance_direction9 == other.balance_direction9
+               && balance_direction10 == other.balance_direction10
+               && balance_direction11 == other.balance_direction11
+               && counter == other.counter
+               && crc == other.crc;
+    }
+    bool operator!=(const CanCmuErrorBalanceStatus &other) const { return !(*this == other); }
+};
+
+// CMU_Voltage_0to2 (0x120), 8 bytes, 100 ms, CMU -> BMS
+struct CanCmuVoltage0to2
+{
+    static constexpr uint32_t kId = 0x120U;
+    static constexpr uint8_t kLen = 8U;
+    static constexpr const char *kName = "CMU_Voltage_0to2";
+    static constexpr CanChecksum kChecksum = CAN_CHECKSUM_BMW_I3;
+    static constexpr uint64_t kUsedMask = 0xFFF0FFFFFFFFFFFFULL;
+    static constexpr uint32_t kLayoutHash = 0x39BB6419U;
+
+    uint16_t cell_voltage0 = 0; // 0|15@1+ (0.001,0) [0|32.767] V
+    bool cell_balance0 = false; // 15|1@1+ (1,0) [0|1]
+    uint16_t cell_voltage1 = 0; // 16|15@1+ (0.001,0) [0|32.767] V
+    bool cell_balance1 = false; // 31|1@1+ (1,0) [0|1]
+    uint16_t cell_voltage2 = 0; // 32|15@1+ (0.001,0) [0|32.767] V
+    bool cell_balance2 = false; // 47|1@1+ (1,0) [0|1]
+    uint8_t counter = 0;        // 52|4@1+ (1,0) [0|15] counter
+    uint8_t crc = 0;            // 56|8@1+ (1,0) [0|255] checksum
+
+    // cellVoltage0 [V]
+    static constexpr uint16_t cell_voltage0_raw(float value)
+    {
+        return can_codec_raw<uint16_t>(value * 1000.0f, 0U, 32767U);
+    }
+    static constexpr float cell_voltage0_value(uint16_t raw) { return static_cast<float>(raw) / 1000.0f; }
+    void set_cell_voltage0(float value) { cell_voltage0 = cell_voltage0_raw(value); }
+    float get_cell_voltage0() const { return cell_voltage0_value(cell_voltage0); }
+
+    // cellVoltage1 [V]
+    static constexpr uint16_t cell_voltage1_raw(float value)
+    {
+        return can_codec_raw<uint16_t>(value * 1000.0f, 0U, 32767U);
+    }
+    static constexpr float cell_voltage1_value(uint16_t raw) { return static_cast<float>(raw) / 1000.0f; }
+    void set_cell_voltage1(float value) { cell_voltage1 = cell_voltage1_raw(value); }
+    float get_cell_voltage1() const { return cell_voltage1_value(cell_voltage1); }
+
+    // cellVoltage2 [V]
+    static constexpr uint16_t cell_voltage2_raw(float value)
+    {
+        return can_codec_raw<uint16_t>(value * 1000.0f, 0U, 32767U);
+    }
+    static constexpr float cell_voltage2_value(uint16_t raw) { return static_cast<float>(raw) / 1000.0f; }
+    void set_cell_voltage2(float value) { cell_voltage2 = cell_voltage2_raw(value); }
+    float get_cell_voltage2() const { return cell_voltage2_value(cell_voltage2); }
+
+    // Writes all 8 bytes, unused bits are 0
+    void encode(uint8_t data[8]) const
+    {
+        const uint64_t bits = (static_cast<uint64_t>(cell_voltage0) & 0x7FFFU)
+                              | static_cast<uint64_t>(cell_balance0) << 15
+                              | (static_cast<uint64_t>(cell_voltage1) & 0x7FFFU) << 16
+                              | static_cast<uint64_t>(cell_balance1) << 31
+                              | (static_cast<uint64_t>(cell_voltage2) & 0x7FFFU) << 32
+                              | static_cast<uint64_t>(cell_balance2) << 47
+                              | (static_cast<uint64_t>(counter) & 0xFU) << 52
+                              | static_cast<uint64_t>(crc) << 56;
+        can_codec_store(data, bits);
+    }
+
+    static CanCmuVoltage0to2 decode(const uint8_t data[8])
+    {
+        const uint64_t bits = can_codec_load(data);
+        CanCmuVoltage0to2 message;
+        message.cell_voltage0 = static_cast<uint16_t>(bits & 0x7FFFU);
+        message.cell_balance0 = ((bits >> 15) & 0x1U) != 0U;
+        message.cell_voltage1 = static_cast<uint16_t>((bits >> 16) & 0x7FFFU);
+        message.cell_balance1 = ((bits >> 31) & 0x1U) != 0U;
+        message.cell_voltage2 = static_cast<uint16_t>((bits >> 32) & 0x7FFFU);
+        message.cell_balance2 = ((bits >> 47) & 0x1U) != 0U;
+        message.counter = static_cast<uint8_t>((bits >> 52) & 0xFU);
+        message.crc = static_cast<uint8_t>(bits >> 56);
+        return message;
+    }
+
+    bool operator==(const CanCmuVoltage0to2 &other) const
+    {
+        return cell_voltage0 == other.cell_voltage0
+               && cell_balance0 == other.cell_balance0
+               && cell_voltage1 == other.cell_voltage1
+               && cell_balance1 == other.cell_balance1
+               && cell_voltage2 == other.cell_voltage2
+               && cell_balance2 == other.cell_balance2
+               && counter == other.counter
+               && crc == other.crc;
+    }
+    bool operator!=(const CanCmuVoltage0to2 &other) const { return !(*this == other); }
+};
+
+// CMU_Voltage_3to5 (0x130), 8 bytes, 100 ms, CMU -> BMS
+struct CanCmuVoltage3to5
+{
+    static constexpr uint32_t kId = 0x130U;
+    static constexpr uint8_t kLen = 8U;
+    static constexpr const char *kName = "CMU_Voltage_3to5";
+    static constexpr CanChecksum kChecksum = CAN_CHECKSUM_BMW_I3;
+    static constexpr uint64_t kUsedMask = 0xFFF0FFFFFFFFFFFFULL;
+    static constexpr uint32_t kLayoutHash = 0x39BB6419U;
+
+    uint16_t cell_voltage3 = 0; // 0|15@1+ (0.001,0) [0|32.767] V
+    bool cell_balance3 = false; // 15|1@1+ (1,0) [0|1]
+    uint16_t cell_voltage4 = 0; // 16|15@1+ (0.001,0) [0|32.767] V
+    bool cell_balance4 = false; // 31|1@1+ (1,0) [0|1]
+    uint16_t cell_voltage5 = 0; // 32|15@1+ (0.001,0) [0|32.767] V
+    bool cell_balance5 = false; // 47|1@1+ (1,0) [0|1]
+    uint8_t counter = 0;        // 52|4@1+ (1,0) [0|15] counter
+    uint8_t crc = 0;            // 56|8@1+ (1,0) [0|255] checksum
+
+    // cellVoltage3 [V]
+    static constexpr uint16_t cell_voltage3_raw(float value)
+    {
+        return can_codec_raw<uint16_t>(value * 1000.0f, 0U, 32767U);
+    }
+    static constexpr float cell_voltage3_value(uint16_t raw) { return static_cast<float>(raw) / 1000.0f; }
+    void set_cell_voltage3(float value) { cell_voltage3 = cell_voltage3_raw(value); }
+    float get_cell_voltage3() const { return cell_voltage3_value(cell_voltage3); }
+
+    // cellVoltage4 [V]
+    static constexpr uint16_t cell_voltage4_raw(float value)
+    {
+        return can_codec_raw<uint16_t>(value * 1000.0f, 0U, 32767U);
+    }
+    static constexpr float cell_voltage4_value(uint16_t raw) { return static_cast<float>(raw) / 1000.0f; }
+    void set_cell_voltage4(float value) { cell_voltage4 = cell_voltage4_raw(value); }
+    float get_cell_voltage4() const { return cell_voltage4_value(cell_voltage4); }
+
+    // cellVoltage5 [V]
+    static constexpr uint16_t cell_voltage5_raw(float value)
+    {
+        return can_codec_raw<uint16_t>(value * 1000.0f, 0U, 32767U);
+    }
+    static constexpr float cell_voltage5_value(uint16_t raw) { return static_cast<float>(raw) / 1000.0f; }
+    void set_cell_voltage5(float value) { cell_voltage5 = cell_voltage5_raw(value); }
+    float get_cell_voltage5() const { return cell_voltage5_value(cell_voltage5); }
+
+    // Writes all 8 bytes, unused bits are 0
+    void encode(uint8_t data[8]) const
+    {
+        const uint64_t bits = (static_cast<uint64_t>(cell_voltage3) & 0x7FFFU)
+                              | static_cast<uint64_t>(cell_balance3) << 15
+                              | (static_cast<uint64_t>(cell_voltage4) & 0x7FFFU) << 16
+                              | static_cast<uint64_t>(cell_balance4) << 31
+                              | (static_cast<uint64_t>(cell_voltage5) & 0x7FFFU) << 32
+                              | static_cast<uint64_t>(cell_balance5) << 47
+                              | (static_cast<uint64_t>(counter) & 0xFU) << 52
+                              | static_cast<uint64_t>(crc) << 56;
+        can_codec_store(data, bits);
+    }
+
+    static CanCmuVoltage3to5 decode(const uint8_t data[8])
+    {
+        const uint64_t bits = can_codec_load(data);
+        CanCmuVoltage3to5 message;
+        message.cell_voltage3 = static_cast<uint16_t>(bits & 0x7FFFU);
+        message.cell_balance3 = ((bits >> 15) & 0x1U) != 0U;
+        message.cell_voltage4 = static_cast<uint16_t>((bits >> 16) & 0x7FFFU);
+        message.cell_balance4 = ((bits >> 31) & 0x1U) != 0U;
+        message.cell_voltage5 = static_cast<uint16_t>((bits >> 32) & 0x7FFFU);
+        message.cell_balance5 = ((bits >> 47) & 0x1U) != 0U;
+        message.counter = static_cast<uint8_t>((bits >> 52) & 0xFU);
+        message.crc = static_cast<uint8_t>(bits >> 56);
+        return message;
+    }
+
+    bool operator==(const CanCmuVoltage3to5 &other) const
+    {
+        return cell_voltage3 == other.cell_voltage3
+               && cell_balance3 == other.cell_balance3
+               && cell_voltage4 == other.cell_voltage4
+               && cell_balance4 == other.cell_balance4
+               && cell_voltage5 == other.cell_voltage5
+               && cell_balance5 == other.cell_balance5
+               && counter == other.counter
+               && crc == other.crc;
+    }
+    bool operator!=(const CanCmuVoltage3to5 &other) const { return !(*this == other); }
+};
+
+// CMU_Voltage_6to8 (0x140), 8 bytes, 100 ms, CMU -> BMS
+struct CanCmuVoltage6to8
+{
+    static constexpr uint32_t kId = 0x140U;
+    static constexpr uint8_t kLen = 8U;
+    static constexpr const char *kName = "CMU_Voltage_6to8";
+    static constexpr CanChecksum kChecksum = CAN_CHECKSUM_BMW_I3;
+    static constexpr uint64_t kUsedMask = 0xFFF0FFFFFFFFFFFFULL;
+    static constexpr uint32_t kLayoutHash = 0x39BB6419U;
+
+    uint16_t cell_voltage6 = 0; // 0|15@1+ (0.001,0) [0|32.767] V
+    bool cell_balance6 = false; // 15|1@1+ (1,0) [0|1]
+    uint16_t cell_voltage7 = 0; // 16|15@1+ (0.001,0) [0|32.767] V
+    bool cell_balance7 = false; // 31|1@1+ (1,0) [0|1]
+    uint16_t cell_voltage8 = 0; // 32|15@1+ (0.001,0) [0|32.767] V
+    bool cell_balance8 = false; // 47|1@1+ (1,0) [0|1]
+    uint8_t counter = 0;        // 52|4@1+ (1,0) [0|15] counter
+    uint8_t crc = 0;            // 56|8@1+ (1,0) [0|255] checksum
+
+    // cellVoltage6 [V]
+    static constexpr uint16_t cell_voltage6_raw(float value)
+    {
+        return can_codec_raw<uint16_t>(value * 1000.0f, 0U, 32767U);
+    }
+    static constexpr float cell_voltage6_value(uint16_t raw) { return static_cast<float>(raw) / 1000.0f; }
+    void set_cell_voltage6(float value) { cell_voltage6 = cell_voltage6_raw(value); }
+    float get_cell_voltage6() const { return cell_voltage6_value(cell_voltage6); }
+
+    // cellVoltage7 [V]
+    static constexpr uint16_t cell_voltage7_raw(float value)
+    {
+        return can_codec_raw<uint16_t>(value * 1000.0f, 0U, 32767U);
+    }
+    static constexpr float cell_voltage7_value(uint16_t raw) { return static_cast<float>(raw) / 1000.0f; }
+    void set_cell_voltage7(float value) { cell_voltage7 = cell_voltage7_raw(value); }
+    float get_cell_voltage7() const { return cell_voltage7_value(cell_voltage7); }
+
+    // cellVoltage8 [V]
+    static constexpr uint16_t cell_voltage8_raw(float value)
+    {
+        return can_codec_raw<uint16_t>(value * 1000.0f, 0U, 32767U);
+    }
+    static constexpr float cell_voltage8_value(uint16_t raw) { return static_cast<float>(raw) / 1000.0f; }
+    void set_cell_voltage8(float value) { cell_voltage8 = cell_voltage8_raw(value); }
+    float get_cell_voltage8() const { return cell_voltage8_value(cell_voltage8); }
+
+    // Writes all 8 bytes, unused bits are 0
+    void encode(uint8_t data[8]) const
+    {
+        const uint64_t bits = (static_cast<uint64_t>(cell_voltage6) & 0x7FFFU)
+                              | static_cast<uint64_t>(cell_balance6) << 15
+                              | (static_cast<uint64_t>(cell_voltage7) & 0x7FFFU) << 16
+                              | static_cast<uint64_t>(cell_balance7) << 31
+                              | (static_cast<uint64_t>(cell_voltage8) & 0x7FFFU) << 32
+                              | static_cast<uint64_t>(cell_balance8) << 47
+                              | (static_cast<uint64_t>(counter) & 0xFU) << 52
+                              | static_cast<uint64_t>(crc) << 56;
+        can_codec_store(data, bits);
+    }
+
+    static CanCmuVoltage6to8 decode(const uint8_t data[8])
+    {
+        const uint64_t bits = can_codec_load(data);
+        CanCmuVoltage6to8 message;
+        message.cell_voltage6 = static_cast<uint16_t>(bits & 0x7FFFU);
+        message.cell_balance6 = ((bits >> 15) & 0x1U) != 0U;
+        message.cell_voltage7 = static_cast<uint16_t>((bits >> 16) & 0x7FFFU);
+        message.cell_balance7 = ((bits >> 31) & 0x1U) != 0U;
+        message.cell_voltage8 = static_cast<uint16_t>((bits >> 32) & 0x7FFFU);
+        message.cell_balance8 = ((bits >> 47) & 0x1U) != 0U;
+        message.counter = static_cast<uint8_t>((bits >> 52) & 0xFU);
+        message.crc = static_cast<uint8_t>(bits >> 56);
+        return message;
+    }
+
+    bool operator==(const CanCmuVoltage6to8 &other) const
+    {
+        return cell_voltage6 == other.cell_voltage6
+               && cell_balance6 == other.cell_balance6
+               && cell_voltage7 == other.cell_voltage7
+               && cell_balance7 == other.cell_balance7
+               && cell_voltage8 == other.cell_voltage8
+               && cell_balance8 == other.cell_balance8
+               && counter == other.counter
+               && crc == other.crc;
+    }
+    bool operator!=(const CanCmuVoltage6to8 &other) const { return !(*this == other); }
+};
+
+// CMU_Voltage_9to11 (0x150), 8 bytes, 100 ms, CMU -> BMS
+struct CanCmuVoltage9to11
+{
+    static constexpr uint32_t kId = 0x150U;
+    static constexpr uint8_t kLen = 8U;
+    static constexpr const char *kName = "CMU_Voltage_9to11";
+    static constexpr CanChecksum kChecksum = CAN_CHECKSUM_BMW_I3;
+    static constexpr uint64_t kUsedMask = 0xFFF0FFFFFFFFFFFFULL;
+    static constexpr uint32_t kLayoutHash = 0x39BB6419U;
+
+    uint16_t cell_voltage9 = 0;  // 0|15@1+ (0.001,0) [0|32.767] V
+    bool cell_balance9 = false;  // 15|1@1+ (1,0) [0|1]
+    uint16_t cell_voltage10 = 0; // 16|15@1+ (0.001,0) [0|32.767] V
+    bool cell_balance10 = false; // 31|1@1+ (1,0) [0|1]
+    uint16_t cell_voltage11 = 0; // 32|15@1+ (0.001,0) [0|32.767] V
+    bool cell_balance11 = false; // 47|1@1+ (1,0) [0|1]
+    uint8_t counter = 0;         // 52|4@1+ (1,0) [0|15] counter
+    uint8_t crc = 0;             // 56|8@1+ (1,0) [0|255] checksum
+
+    // cellVoltage9 [V]
+    static constexpr uint16_t cell_voltage9_raw(float value)
+    {
+        return can_codec_raw<uint16_t>(value * 1000.0f, 0U, 32767U);
+    }
+    static constexpr float cell_voltage9_value(uint16_t raw) { return static_cast<float>(raw) / 1000.0f; }
+    void set_cell_voltage9(float value) { cell_voltage9 = cell_voltage9_raw(value); }
+    float get_cell_voltage9() const { return cell_voltage9_value(cell_voltage9); }
+
+    // cellVoltage10 [V]
+    static constexpr uint16_t cell_voltage10_raw(float value)
+    {
+        return can_codec_raw<uint16_t>(value * 1000.0f, 0U, 32767U);
+    }
+    static constexpr float cell_voltage10_value(uint16_t raw) { return static_cast<float>(raw) / 1000.0f; }
+    void set_cell_voltage10(float value) { cell_voltage10 = cell_voltage10_raw(value); }
+    float get_cell_voltage10() const { return cell_voltage10_value(cell_voltage10); }
+
+    // cellVoltage11 [V]
+    static constexpr uint16_t cell_voltage11_raw(float value)
+    {
+        return can_codec_raw<uint16_t>(value * 1000.0f, 0U, 32767U);
+    }
+    static constexpr float cell_voltage11_value(uint16_t raw) { return static_cast<float>(raw) / 1000.0f; }
+    void set_cell_voltage11(float value) { cell_voltage11 = cell_voltage11_raw(value); }
+    float get_cell_voltage11() const { return cell_voltage11_value(cell_voltage11); }
+
+    // Writes all 8 bytes, unused bits are 0
+    void encode(uint8_t data[8]) const
+    {
+        const uint64_t bits = (static_cast<uint64_t>(cell_voltage9) & 0x7FFFU)
+                              | static_cast<uint64_t>(cell_balance9) << 15
+                              | (static_cast<uint64_t>(cell_voltage10) & 0x7FFFU) << 16
+                              | static_cast<uint64_t>(cell_balance10) << 31
+                              | (static_cast<uint64_t>(cell_voltage11) & 0x7FFFU) << 32
+                              | static_cast<uint64_t>(cell_balance11) << 47
+                              | (static_cast<uint64_t>(counter) & 0xFU) << 52
+                              | static_cast<uint64_t>(crc) << 56;
+        can_codec_store(data, bits);
+    }
+
+    static CanCmuVoltage9to11 decode(const uint8_t data[8])
+    {
+        const uint64_t bits = can_codec_load(data);
+        CanCmuVoltage9to11 message;
+        message.cell_voltage9 = static_cast<uint16_t>(bits & 0x7FFFU);
+        message.cell_balance9 = ((bits >> 15) & 0x1U) != 0U;
+        message.cell_voltage10 = static_cast<uint16_t>((bits >> 16) & 0x7FFFU);
+        message.cell_balance10 = ((bits >> 31) & 0x1U) != 0U;
+        message.cell_voltage11 = static_cast<uint16_t>((bits >> 32) & 0x7FFFU);
+        message.cell_balance11 = ((bits >> 47) & 0x1U) != 0U;
+        message.counter = static_cast<uint8_t>((bits >> 52) & 0xFU);
+        message.crc = static_cast<uint8_t>(bits >> 56);
+        return message;
+    }
+
+    bool operator==(const CanCmuVoltage9to11 &other) const
+    {
+        return cell_voltage9 == other.cell_voltage9
+               && cell_balance9 == other.cell_balance9
+               && cell_voltage10 == other.cell_voltage10
+               && cell_balance10 == other.cell_balance10
+               && cell_voltage11 == other.cell_voltage11
+               && cell_balance11 == other.cell_balance11
+               && counter == other.counter
+               && crc == other.crc;
+    }
+    bool operator!=(const CanCmuVoltage9to11 &other) const { return !(*this == other); }
+};
+
+// CMU_TotalVoltage (0x160), 8 bytes, 100 ms, CMU -> BMS
+struct CanCmuTotalVoltage
+{
+    static constexpr uint32_t kId = 0x160U;
+    static constexpr uint8_t kLen = 8U;
+    static constexpr const char *kName = "CMU_TotalVoltage";
+    static constexpr CanChecksum kChecksum = CAN_CHECKSUM_BMW_I3;
+    static constexpr uint64_t kUsedMask = 0xFFF000000000FFFFULL;
+    static constexpr uint32_t kLayoutHash = 0x21C7D114U;
+
+    uint16_t module_voltage = 0; // 0|16@1+ (0.001,0) [0|65.535] V
+    uint8_t counter = 0;         // 52|4@1+ (1,0) [0|15] counter
+    uint8_t crc = 0;             // 56|8@1+ (1,0) [0|255] checksum
+
+    // moduleVoltage [V]
+    static constexpr uint16_t module_voltage_raw(float value)
+    {
+        return can_codec_raw<uint16_t>(value * 1000.0f, 0U, 65535U);
+    }
+    static constexpr float module_voltage_value(uint16_t raw) { return static_cast<float>(raw) / 1000.0f; }
+    void set_module_voltage(float value) { module_voltage = module_voltage_raw(value); }
+    float get_module_voltage() const { return module_voltage_value(module_voltage); }
+
+    // Writes all 8 bytes, unused bits are 0
+    void encode(uint8_t data[8]) const
+    {
+        const uint64_t bits = static_cast<uint64_t>(module_voltage)
+                              | (static_cast<uint64_t>(counter) & 0xFU) << 52
+                              | static_cast<uint64_t>(crc) << 56;
+        can_codec_store(data, bits);
+    }
+
+    static CanCmuTotalVoltage decode(const uint8_t data[8])
+    {
+        const uint64_t bits = can_codec_load(data);
+        CanCmuTotalVoltage message;
+        message.module_voltage = static_cast<uint16_t>(bits & 0xFFFFU);
+        message.counter = static_cast<uint8_t>((bits >> 52) & 0xFU);
+        message.crc = static_cast<uint8_t>(bits >> 56);
+        return message;
+    }
+
+    bool operator==(const CanCmuTotalVoltage &other) const
+    {
+        return module_voltage == other.module_voltage
+               && counter == other.counter
+               && crc == other.crc;
+    }
+    bool operator!=(const CanCmuTotalVoltage &other) const { return !(*this == other); }
+};
+
+// CMU_Temperatures (0x170), 8 bytes, 100 ms, CMU -> BMS
+struct CanCmuTemperatures
+{
+    static constexpr uint32_t kId = 0x170U;
+    static constexpr uint8_t kLen = 8U;
+    static constexpr const char *kName = "CMU_Temperatures";
+    static constexpr CanChecksum kChecksum = CAN_CHECKSUM_BMW_I3;
+    static constexpr uint64_t kUsedMask = 0xFFF000FFFFFFFFFFULL;
+    static constexpr uint32_t kLayoutHash = 0x8BA0D1ECU;
+
+    uint8_t temperature0 = 0;         // 0|8@1+ (1,-40) [-40|215] degC
+    uint8_t temperature1 = 0;         // 8|8@1+ (1,-40) [-40|215] degC
+    uint8_t temperature2 = 0;         // 16|8@1+ (1,-40) [-40|215] degC
+    uint8_t temperature3 = 0;         // 24|8@1+ (1,-40) [-40|215] degC
+    uint8_t temperature_internal = 0; // 32|8@1+ (1,-40) [-40|215] degC
+    uint8_t counter = 0;              // 52|4@1+ (1,0) [0|15] counter
+    uint8_t crc = 0;                  // 56|8@1+ (1,0) [0|255] checksum
+
+    // temperature0 [degC]
+    static constexpr uint8_t temperature0_raw(float value)
+    {
+        return can_codec_raw<uint8_t>(value + 40.0f, 0U, 255U);
+    }
+    static constexpr float temperature0_value(uint8_t raw) { return static_cast<float>(raw) - 40.0f; }
+    void set_temperature0(float value) { temperature0 = temperature0_raw(value); }
+    float get_temperature0() const { return temperature0_value(temperature0); }
+
+    // temperature1 [degC]
+    static constexpr uint8_t temperature1_raw(float value)
+    {
+        return can_codec_raw<uint8_t>(value + 40.0f, 0U, 255U);
+    }
+    static constexpr float temperature1_value(uint8_t raw) { return static_cast<float>(raw) - 40.0f; }
+    void set_temperature1(float value) { temperature1 = temperature1_raw(value); }
+    float get_temperature1() const { return temperature1_value(temperature1); }
+
+    // temperature2 [degC]
+    static constexpr uint8_t temperature2_raw(float value)
+    {
+        return can_codec_raw<uint8_t>(value + 40.0f, 0U, 255U);
+    }
+    static constexpr float temperature2_value(uint8_t raw) { return static_cast<float>(raw) - 40.0f; }
+    void set_temperature2(float value) { temperature2 = temperature2_raw(value); }
+    float get_temperature2() const { return temperature2_value(temperature2); }
+
+    // temperature3 [degC]
+    static constexpr uint8_t temperature3_raw(float value)
+    {
+        return can_codec_raw<uint8_t>(value + 40.0f, 0U, 255U);
+    }
+    static constexpr float temperature3_value(uint8_t raw) { return static_cast<float>(raw) - 40.0f; }
+    void set_temperature3(float value) { temperature3 = temperature3_raw(value); }
+    float get_temperature3() const { return temperature3_value(temperature3); }
+
+    // temperatureInternal [degC]
+    static constexpr uint8_t temperature_internal_raw(float value)
+    {
+        return can_codec_raw<uint8_t>(value + 40.0f, 0U, 255U);
+    }
+    static constexpr float temperature_internal_value(uint8_t raw) { return static_cast<float>(raw) - 40.0f; }
+    void set_temperature_internal(float value) { temperature_internal = temperature_internal_raw(value); }
+    float get_temperature_internal() const { return temperature_internal_value(temperature_internal); }
+
+    // Writes all 8 bytes, unused bits are 0
+    void encode(uint8_t data[8]) const
+    {
+        const uint64_t bits = static_cast<uint64_t>(temperature0)
+                              | static_cast<uint64_t>(temperature1) << 8
+                              | static_cast<uint64_t>(temperature2) << 16
+                              | static_cast<uint64_t>(temperature3) << 24
+                              | static_cast<uint64_t>(temperature_internal) << 32
+                              | (static_cast<uint64_t>(counter) & 0xFU) << 52
+                              | static_cast<uint64_t>(crc) << 56;
+        can_codec_store(data, bits);
+    }
+
+    static CanCmuTemperatures decode(const uint8_t data[8])
+    {
+        const uint64_t bits = can_codec_load(data);
+        CanCmuTemperatures message;
+        message.temperature0 = static_cast<uint8_t>(bits & 0xFFU);
+        message.temperature1 = static_cast<uint8_t>((bits >> 8) & 0xFFU);
+        message.temperature2 = static_cast<uint8_t>((bits >> 16) & 0xFFU);
+        message.temperature3 = static_cast<uint8_t>((bits >> 24) & 0xFFU);
+        message.temperature_internal = static_cast<uint8_t>((bits >> 32) & 0xFFU);
+        message.counter = static_cast<uint8_t>((bits >> 52) & 0xFU);
+        message.crc = static_cast<uint8_t>(bits >> 56);
+        return message;
+    }
+
+    bool operator==(const CanCmuTemperatures &other) const
+    {
+        return temperature0 == other.temperature0
+               && temperature1 == other.temperature1
+               && temperature2 == other.temperature2
+               && temperature3 == other.temperature3
+               && temperature_internal == other.temperature_internal
+               && counter == other.counter
+               && crc == other.crc;
+    }
+    bool operator!=(const CanCmuTemperatures &other) const { return !(*this == other); }
+};
+
+// IVT_Result_I (0x521), 6 bytes, 10 ms, IVTS -> BMS
+// IVT-S result frames (node address 0). All eight share one layout; the firmware flips the sign of
+// current, power, charge and energy so discharge is negative.
+struct CanIvtResultI
+{
+    static constexpr uint32_t kId = 0x521U;
+    static constexpr uint8_t kLen = 6U;
+    static constexpr const char *kName = "IVT_Result_I";
+    static constexpr CanChecksum kChecksum = CAN_CHECKSUM_NONE;
+    static constexpr uint64_t kUsedMask = 0x0000FFFFFFFFFFFFULL;
+    static constexpr uint32_t kLayoutHash = 0x1E4F9B5BU;
+
+    uint8_t mux_id = 0;                 // 0|8@1+ (1,0) [0|255]
+    uint8_t counter = 0;                // 8|4@1+ (1,0) [0|15] counter
+    bool ocs = false;                   // 12|1@1+ (1,0) [0|1]
+    bool this_result_error = false;     // 13|1@1+ (1,0) [0|1]
+    bool any_measurement_error = false; // 14|1@1+ (1,0) [0|1]
+    bool system_error = false;          // 15|1@1+ (1,0) [0|1]
+    int32_t result = 0;                 // 16|32@1- (0.001,0) [-2147483.648|2147483.647] A
+
+    // Result [A]
+    static constexpr int32_t result_raw(float value)
+    {
+        return can_codec_raw<int32_t>(value * 1000.0f, (-2147483647 - 1), 2147483647);
+    }
+    static constexpr float result_value(int32_t raw) { return static_cast<float>(raw) / 1000.0f; }
+    void set_result(float value) { result = result_raw(value); }
+    float get_result() const { return result_value(result); }
+
+    // Writes all 8 bytes, unused bits are 0
+    void encode(uint8_t data[8]) const
+    {
+        const uint64_t bits = static_cast<uint64_t>(mux_id)
+                              | (static_cast<uint64_t>(counter) & 0xFU) << 8
+                              | static_cast<uint64_t>(ocs) << 12
+                              | static_cast<uint64_t>(this_result_error) << 13
+                              | static_cast<uint64_t>(any_measurement_error) << 14
+                              | static_cast<uint64_t>(system_error) << 15
+                              | static_cast<uint64_t>(static_cast<uint32_t>(result)) << 16;
+        can_codec_store(data, bits);
+    }
+
+    static CanIvtResultI decode(const uint8_t data[8])
+    {
+        const uint64_t bits = can_codec_load(data);
+        CanIvtResultI message;
+        message.mux_id = static_cast<uint8_t>(bits & 0xFFU);
+        message.counter = static_cast<uint8_t>((bits >> 8) & 0xFU);
+        message.ocs = ((bits >> 12) & 0x1U) != 0U;
+        message.this_result_error = ((bits >> 13) & 0x1U) != 0U;
+        message.any_measurement_error = ((bits >> 14) & 0x1U) != 0U;
+        message.system_error = ((bits >> 15) & 0x1U) != 0U;
+        message.result = static_cast<int32_t>(can_codec_sign_extend((bits >> 16) & 0xFFFFFFFFU, 32U));
+        return message;
+    }
+
+    bool operator==(const CanIvtResultI &other) const
+    {
+        return mux_id == other.mux_id
+               && counter == other.counter
+               && ocs == other.ocs
+               && this_result_error == other.this_result_error
+               && any_measurement_error == other.any_measurement_error
+               && system_error == other.system_error
+               && result == other.result;
+    }
+    bool operator!=(const CanIvtResultI &other) const { return !(*this == other); }
+};
+
+// IVT_Result_U1 (0x522), 6 bytes, IVTS -> BMS
+struct CanIvtResultU1
+{
+    static constexpr uint32_t kId = 0x522U;
+    static constexpr uint8_t kLen = 6U;
+    static constexpr const char *kName = "IVT_Result_U1";
+    static constexpr CanChecksum kChecksum = CAN_CHECKSUM_NONE;
+    static constexpr uint64_t kUsedMask = 0x0000FFFFFFFFFFFFULL;
+    static constexpr uint32_t kLayoutHash = 0x1E4F9B5BU;
+
+    uint8_t mux_id = 0;                 // 0|8@1+ (1,0) [0|255]
+    uint8_t counter = 0;                // 8|4@1+ (1,0) [0|15] counter
+    bool ocs = false;                   // 12|1@1+ (1,0) [0|1]
+    bool this_result_error = false;     // 13|1@1+ (1,0) [0|1]
+    bool any_measurement_error = false; // 14|1@1+ (1,0) [0|1]
+    bool system_error = false;          // 15|1@1+ (1,0) [0|1]
+    int32_t result = 0;                 // 16|32@1- (0.001,0) [-2147483.648|2147483.647] V
+
+    // Result [V]
+    static constexpr int32_t result_raw(float value)
+    {
+        return can_codec_raw<int32_t>(value * 1000.0f, (-2147483647 - 1), 2147483647);
+    }
+    static constexpr float result_value(int32_t raw) { return static_cast<float>(raw) / 1000.0f; }
+    void set_result(float value) { result = result_raw(value); }
+    float get_result() const { return result_value(result); }
+
+    // Writes all 8 bytes, unused bits are 0
+    void encode(uint8_t data[8]) const
+    {
+        const uint64_t bits = static_cast<uint64_t>(mux_id)
+                              | (static_cast<uint64_t>(counter) & 0xFU) << 8
+                              | static_cast<uint64_t>(ocs) << 12
+                              | static_cast<uint64_t>(this_result_error) << 13
+                              | static_cast<uint64_t>(any_measurement_error) << 14
+                              | static_cast<uint64_t>(system_error) << 15
+                              | static_cast<uint64_t>(static_cast<uint32_t>(result)) << 16;
+        can_codec_store(data, bits);
+    }
+
+    static CanIvtResultU1 decode(const uint8_t data[8])
+    {
+        const uint64_t bits = can_codec_load(data);
+        CanIvtResultU1 message;
+        message.mux_id = static_cast<uint8_t>(bits & 0xFFU);
+        message.counter = static_cast<uint8_t>((bits >> 8) & 0xFU);
+        message.ocs = ((bits >> 12) & 0x1U) != 0U;
+        message.this_result_error = ((bits >> 13) & 0x1U) != 0U;
+        message.any_measurement_error = ((bits >> 14) & 0x1U) != 0U;
+        message.system_error = ((bits >> 15) & 0x1U) != 0U;
+        message.result = static_cast<int32_t>(can_codec_sign_extend((bits >> 16) & 0xFFFFFFFFU, 32U));
+        return message;
+    }
+
+    bool operator==(const CanIvtResultU1 &other) const
+    {
+        return mux_id == other.mux_id
+               && counter == other.counter
+               && ocs == other.ocs
+               && this_result_error == other.this_result_error
+               && any_measurement_error == other.any_measurement_error
+               && system_error == other.system_error
+               && result == other.result;
+    }
+    bool operator!=(const CanIvtResultU1 &other) const { return !(*this == other); }
+};
+
+// IVT_Result_U2 (0x523), 6 bytes, IVTS -> BMS
+struct CanIvtResultU2
+{
+    static constexpr uint32_t kId = 0x523U;
+    static constexpr uint8_t kLen = 6U;
+    static constexpr const char *kName = "IVT_Result_U2";
+    static constexpr CanChecksum kChecksum = CAN_CHECKSUM_NONE;
+    static constexpr uint64_t kUsedMask = 0x0000FFFFFFFFFFFFULL;
+    static constexpr uint32_t kLayoutHash = 0x1E4F9B5BU;
+
+    uint8_t mux_id = 0;                 // 0|8@1+ (1,0) [0|255]
+    uint8_t counter = 0;                // 8|4@1+ (1,0) [0|15] counter
+    bool ocs = false;                   // 12|1@1+ (1,0) [0|1]
+    bool this_result_error = false;     // 13|1@1+ (1,0) [0|1]
+    bool any_measurement_error = false; // 14|1@1+ (1,0) [0|1]
+    bool system_error = false;          // 15|1@1+ (1,0) [0|1]
+    int32_t result = 0;                 // 16|32@1- (0.001,0) [-2147483.648|2147483.647] V
+
+    // Result [V]
+    static constexpr int32_t result_raw(float value)
+    {
+        return can_codec_raw<int32_t>(value * 1000.0f, (-2147483647 - 1), 2147483647);
+    }
+    static constexpr float result_value(int32_t raw) { return static_cast<float>(raw) / 1000.0f; }
+    void set_result(float value) { result = result_raw(value); }
+    float get_result() const { return result_value(result); }
+
+    // Writes all 8 bytes, unused bits are 0
+    void encode(uint8_t data[8]) const
+    {
+        const uint64_t bits = static_cast<uint64_t>(mux_id)
+                              | (static_cast<uint64_t>(counter) & 0xFU) << 8
+                              | static_cast<uint64_t>(ocs) << 12
+                              | static_cast<uint64_t>(this_result_error) << 13
+                              | static_cast<uint64_t>(any_measurement_error) << 14
+                              | static_cast<uint64_t>(system_error) << 15
+                              | static_cast<uint64_t>(static_cast<uint32_t>(result)) << 16;
+        can_codec_store(data, bits);
+    }
+
+    static CanIvtResultU2 decode(const uint8_t data[8])
+    {
+        const uint64_t bits = can_codec_load(data);
+        CanIvtResultU2 message;
+        message.mux_id = static_cast<uint8_t>(bits & 0xFFU);
+        message.counter = static_cast<uint8_t>((bits >> 8) & 0xFU);
+        message.ocs = ((bits >> 12) & 0x1U) != 0U;
+        message.this_result_error = ((bits >> 13) & 0x1U) != 0U;
+        message.any_measurement_error = ((bits >> 14) & 0x1U) != 0U;
+        message.system_error = ((bits >> 15) & 0x1U) != 0U;
+        message.result = static_cast<int32_t>(can_codec_sign_extend((bits >> 16) & 0xFFFFFFFFU, 32U));
+        return message;
+    }
+
+    bool operator==(const CanIvtResultU2 &other) const
+    {
+        return mux_id == other.mux_id
+               && counter == other.counter
+               && ocs == other.ocs
+               && this_result_error == other.this_result_error
+               && any_measurement_error == other.any_measurement_error
+               && system_error == other.system_error
+               && result == other.result;
+    }
+    bool operator!=(const CanIvtResultU2 &other) const { return !(*this == other); }
+};
+
+// IVT_Result_U3 (0x524), 6 bytes, IVTS -> BMS
+struct CanIvtResultU3
+{
+    static constexpr uint32_t kId = 0x524U;
+    static constexpr uint8_t kLen = 6U;
+    static constexpr const char *kName = "IVT_Result_U3";
+    static constexpr CanChecksum kChecksum = CAN_CHECKSUM_NONE;
+    static constexpr uint64_t kUsedMask = 0x0000FFFFFFFFFFFFULL;
+    static constexpr uint32_t kLayoutHash = 0x1E4F9B5BU;
+
+    uint8_t mux_id = 0;                 // 0|8@1+ (1,0) [0|255]
+    uint8_t counter = 0;                // 8|4@1+ (1,0) [0|15] counter
+    bool ocs = false;                   // 12|1@1+ (1,0) [0|1]
+    bool this_result_error = false;     // 13|1@1+ (1,0) [0|1]
+    bool any_measurement_error = false; // 14|1@1+ (1,0) [0|1]
+    bool system_error = false;          // 15|1@1+ (1,0) [0|1]
+    int32_t result = 0;                 // 16|32@1- (0.001,0) [-2147483.648|2147483.647] V
+
+    // Result [V]
+    static constexpr int32_t result_raw(float value)
+    {
+        return can_codec_raw<int32_t>(value * 1000.0f, (-2147483647 - 1), 2147483647);
+    }
+    static constexpr float result_value(int32_t raw) { return static_cast<float>(raw) / 1000.0f; }
+    void set_result(float value) { result = result_raw(value); }
+    float get_result() const { return result_value(result); }
+
+    // Writes all 8 bytes, unused bits are 0
+    void encode(uint8_t data[8]) const
+    {
+        const uint64_t bits = static_cast<uint64_t>(mux_id)
+                              | (static_cast<uint64_t>(counter) & 0xFU) << 8
+                              | static_cast<uint64_t>(ocs) << 12
+                              | static_cast<uint64_t>(this_result_error) << 13
+                              | static_cast<uint64_t>(any_measurement_error) << 14
+                              | static_cast<uint64_t>(system_error) << 15
+                              | static_cast<uint64_t>(static_cast<uint32_t>(result)) << 16;
+        can_codec_store(data, bits);
+    }
+
+    static CanIvtResultU3 decode(const uint8_t data[8])
+    {
+        const uint64_t bits = can_codec_load(data);
+        CanIvtResultU3 message;
+        message.mux_id = static_cast<uint8_t>(bits & 0xFFU);
+        message.counter = static_cast<uint8_t>((bits >> 8) & 0xFU);
+        message.ocs = ((bits >> 12) & 0x1U) != 0U;
+        message.this_result_error = ((bits >> 13) & 0x1U) != 0U;
+        message.any_measurement_error = ((bits >> 14) & 0x1U) != 0U;
+        message.system_error = ((bits >> 15) & 0x1U) != 0U;
+        message.result = static_cast<int32_t>(can_codec_sign_extend((bits >> 16) & 0xFFFFFFFFU, 32U));
+        return message;
+    }
+
+    bool operator==(const CanIvtResultU3 &other) const
+    {
+        return mux_id == other.mux_id
+               && counter == other.counter
+               && ocs == other.ocs
+               && this_result_error == other.this_result_error
+               && any_measurement_error == other.any_measurement_error
+               && system_error == other.system_error
+               && result == other.result;
+    }
+    bool operator!=(const CanIvtResultU3 &other) const { return !(*this == other); }
+};
+
+// IVT_Result_T (0x525), 6 bytes, IVTS -> BMS
+struct CanIvtResultT
+{
+    static constexpr uint32_t kId = 0x525U;
+    static constexpr uint8_t kLen = 6U;
+    static constexpr const char *kName = "IVT_Result_T";
+    static constexpr CanChecksum kChecksum = CAN_CHECKSUM_NONE;
+    static constexpr uint64_t kUsedMask = 0x0000FFFFFFFFFFFFULL;
+    static constexpr uint32_t kLayoutHash = 0x1E4F9B5BU;
+
+    uint8_t mux_id = 0;                 // 0|8@1+ (1,0) [0|255]
+    uint8_t counter = 0;                // 8|4@1+ (1,0) [0|15] counter
+    bool ocs = false;                   // 12|1@1+ (1,0) [0|1]
+    bool this_result_error = false;     // 13|1@1+ (1,0) [0|1]
+    bool any_measurement_error = false; // 14|1@1+ (1,0) [0|1]
+    bool system_error = false;          // 15|1@1+ (1,0) [0|1]
+    int32_t result = 0;                 // 16|32@1- (0.1,0) [-214748364.8|214748364.7] degC
+
+    // Result [degC]
+    static constexpr int32_t result_raw(float value)
+    {
+        return can_codec_raw<int32_t>(value * 10.0f, (-2147483647 - 1), 2147483647);
+    }
+    static constexpr float result_value(int32_t raw) { return static_cast<float>(raw) / 10.0f; }
+    void set_result(float value) { result = result_raw(value); }
+    float get_result() const { return result_value(result); }
+
+    // Writes all 8 bytes, unused bits are 0
+    void encode(uint8_t data[8]) const
+    {
+        const uint64_t bits = static_cast<uint64_t>(mux_id)
+                              | (static_cast<uint64_t>(counter) & 0xFU) << 8
+                              | static_cast<uint64_t>(ocs) << 12
+                              | static_cast<uint64_t>(this_result_error) << 13
+                              | static_cast<uint64_t>(any_measurement_error) << 14
+                              | static_cast<uint64_t>(system_error) << 15
+                              | static_cast<uint64_t>(static_cast<uint32_t>(result)) << 16;
+        can_codec_store(data, bits);
+    }
+
+    static CanIvtResultT decode(const uint8_t data[8])
+    {
+        const uint64_t bits = can_codec_load(data);
+        CanIvtResultT message;
+        message.mux_id = static_cast<uint8_t>(bits & 0xFFU);
+        message.counter = static_cast<uint8_t>((bits >> 8) & 0xFU);
+        message.ocs = ((bits >> 12) & 0x1U) != 0U;
+        message.this_result_error = ((bits >> 13) & 0x1U) != 0U;
+        message.any_measurement_error = ((bits >> 14) & 0x1U) != 0U;
+        message.system_error = ((bits >> 15) & 0x1U) != 0U;
+        message.result = static_cast<int32_t>(can_codec_sign_extend((bits >> 16) & 0xFFFFFFFFU, 32U));
+        return message;
+    }
+
+    bool operator==(const CanIvtResultT &other) const
+    {
+        return mux_id == other.mux_id
+               && counter == other.counter
+               && ocs == other.ocs
+               && this_result_error == other.this_result_error
+               && any_measurement_error == other.any_measurement_error
+               && system_error == other.system_error
+               && result == other.result;
+    }
+    bool operator!=(const CanIvtResultT &other) const { return !(*this == other); }
+};
+
+// IVT_Result_W (0x526), 6 bytes, IVTS -> BMS
+struct CanIvtResultW
+{
+    static constexpr uint32_t kId = 0x526U;
+    static constexpr uint8_t kLen = 6U;
+    static constexpr const char *kName = "IVT_Result_W";
+    static constexpr CanChecksum kChecksum = CAN_CHECKSUM_NONE;
+    static constexpr uint64_t kUsedMask = 0x0000FFFFFFFFFFFFULL;
+    static constexpr uint32_t kLayoutHash = 0x1E4F9B5BU;
+
+    uint8_t mux_id = 0;                 // 0|8@1+ (1,0) [0|255]
+    uint8_t counter = 0;                // 8|4@1+ (1,0) [0|15] counter
+    bool ocs = false;                   // 12|1@1+ (1,0) [0|1]
+    bool this_result_error = false;     // 13|1@1+ (1,0) [0|1]
+    bool any_measurement_error = false; // 14|1@1+ (1,0) [0|1]
+    bool system_error = false;          // 15|1@1+ (1,0) [0|1]
+    int32_t result = 0;                 // 16|32@1- (1,0) [-2147483648|2147483647] W
+
+    // Result [W]
+    static constexpr int32_t result_raw(float value)
+    {
+        return can_codec_raw<int32_t>(value, (-2147483647 - 1), 2147483647);
+    }
+    static constexpr float result_value(int32_t raw) { return static_cast<float>(raw); }
+    void set_result(float value) { result = result_raw(value); }
+    float get_result() const { return result_value(result); }
+
+    // Writes all 8 bytes, unused bits are 0
+    void encode(uint8_t data[8]) const
+    {
+        const uint64_t bits = static_cast<uint64_t>(mux_id)
+                              | (static_cast<uint64_t>(counter) & 0xFU) << 8
+                              | static_cast<uint64_t>(ocs) << 12
+                              | static_cast<uint64_t>(this_result_error) << 13
+                              | static_cast<uint64_t>(any_measurement_error) << 14
+                              | static_cast<uint64_t>(system_error) << 15
+                              | static_cast<uint64_t>(static_cast<uint32_t>(result)) << 16;
+        can_codec_store(data, bits);
+    }
+
+    static CanIvtResultW decode(const uint8_t data[8])
+    {
+        const uint64_t bits = can_codec_load(data);
+        CanIvtResultW message;
+        message.mux_id = static_cast<uint8_t>(bits & 0xFFU);
+        message.counter = static_cast<uint8_t>((bits >> 8) & 0xFU);
+        message.ocs = ((bits >> 12) & 0x1U) != 0U;
+        message.this_result_error = ((bits >> 13) & 0x1U) != 0U;
+        message.any_measurement_error = ((bits >> 14) & 0x1U) != 0U;
+        message.system_error = ((bits >> 15) & 0x1U) != 0U;
+        message.result = static_cast<int32_t>(can_codec_sign_extend((bits >> 16) & 0xFFFFFFFFU, 32U));
+        return message;
+    }
+
+    bool operator==(const CanIvtResultW &other) const
+    {
+        return mux_id == other.mux_id
+               && counter == other.counter
+               && ocs == other.ocs
+               && this_result_error == other.this_result_error
+               && any_measurement_error == other.any_measurement_error
+               && system_error == other.system_error
+               && result == other.result;
+    }
+    bool operator!=(const CanIvtResultW &other) const { return !(*this == other); }
+};
+
+// IVT_Result_As (0x527), 6 bytes, IVTS -> BMS
+struct CanIvtResultAs
+{
+    static constexpr uint32_t kId = 0x527U;
+    static constexpr uint8_t kLen = 6U;
+    static constexpr const char *kName = "IVT_Result_As";
+    static constexpr CanChecksum kChecksum = CAN_CHECKSUM_NONE;
+    static constexpr uint64_t kUsedMask = 0x0000FFFFFFFFFFFFULL;
+    static constexpr uint32_t kLayoutHash = 0x1E4F9B5BU;
+
+    uint8_t mux_id = 0;                 // 0|8@1+ (1,0) [0|255]
+    uint8_t counter = 0;                // 8|4@1+ (1,0) [0|15] counter
+    bool ocs = false;                   // 12|1@1+ (1,0) [0|1]
+    bool this_result_error = false;     // 13|1@1+ (1,0) [0|1]
+    bool any_measurement_error = false; // 14|1@1+ (1,0) [0|1]
+    bool system_error = false;          // 15|1@1+ (1,0) [0|1]
+    int32_t result = 0;                 // 16|32@1- (1,0) [-2147483648|2147483647] As
+
+    // Result [As]
+    static constexpr int32_t result_raw(float value)
+    {
+        return can_codec_raw<int32_t>(value, (-2147483647 - 1), 2147483647);
+    }
+    static constexpr float result_value(int32_t raw) { return static_cast<float>(raw); }
+    void set_result(float value) { result = result_raw(value); }
+    float get_result() const { return result_value(result); }
+
+    // Writes all 8 bytes, unused bits are 0
+    void encode(uint8_t data[8]) const
+    {
+        const uint64_t bits = static_cast<uint64_t>(mux_id)
+                              | (static_cast<uint64_t>(counter) & 0xFU) << 8
+                              | static_cast<uint64_t>(ocs) << 12
+                              | static_cast<uint64_t>(this_result_error) << 13
+                              | static_cast<uint64_t>(any_measurement_error) << 14
+                              | static_cast<uint64_t>(system_error) << 15
+                              | static_cast<uint64_t>(static_cast<uint32_t>(result)) << 16;
+        can_codec_store(data, bits);
+    }
+
+    static CanIvtResultAs decode(const uint8_t data[8])
+    {
+        const uint64_t bits = can_codec_load(data);
+        CanIvtResultAs message;
+        message.mux_id = static_cast<uint8_t>(bits & 0xFFU);
+        message.counter = static_cast<uint8_t>((bits >> 8) & 0xFU);
+        message.ocs = ((bits >> 12) & 0x1U) != 0U;
+        message.this_result_error = ((bits >> 13) & 0x1U) != 0U;
+        message.any_measurement_error = ((bits >> 14) & 0x1U) != 0U;
+        message.system_error = ((bits >> 15) & 0x1U) != 0U;
+        message.result = static_cast<int32_t>(can_codec_sign_extend((bits >> 16) & 0xFFFFFFFFU, 32U));
+        return message;
+    }
+
+    bool operator==(const CanIvtResultAs &other) const
+    {
+        return mux_id == other.mux_id
+               && counter == other.counter
+               && ocs == other.ocs
+               && this_result_error == other.this_result_error
+               && any_measurement_error == other.any_measurement_error
+               && system_error == other.system_error
+               && result == other.result;
+    }
+    bool operator!=(const CanIvtResultAs &other) const { return !(*this == other); }
+};
+
+// IVT_Result_Wh (0x528), 6 bytes, IVTS -> BMS
+struct CanIvtResultWh
+{
+    static constexpr uint32_t kId = 0x528U;
+    static constexpr uint8_t kLen = 6U;
+    static constexpr const char *kName = "IVT_Result_Wh";
+    static constexpr CanChecksum kChecksum = CAN_CHECKSUM_NONE;
+    static constexpr uint64_t kUsedMask = 0x0000FFFFFFFFFFFFULL;
+    static constexpr uint32_t kLayoutHash = 0x1E4F9B5BU;
+
+    uint8_t mux_id = 0;                 // 0|8@1+ (1,0) [0|255]
+    uint8_t counter = 0;                // 8|4@1+ (1,0) [0|15] counter
+    bool ocs = false;                   // 12|1@1+ (1,0) [0|1]
+    bool this_result_error = false;     // 13|1@1+ (1,0) [0|1]
+    bool any_measurement_error = false; // 14|1@1+ (1,0) [0|1]
+    bool system_error = false;          // 15|1@1+ (1,0) [0|1]
+    int32_t result = 0;                 // 16|32@1- (1,0) [-2147483648|2147483647] Wh
+
+    // Result [Wh]
+    static constexpr int32_t result_raw(float value)
+    {
+        return can_codec_raw<int32_t>(value, (-2147483647 - 1), 2147483647);
+    }
+    static constexpr float result_value(int32_t raw) { return static_cast<float>(raw); }
+    void set_result(float value) { result = result_raw(value); }
+    float get_result() const { return result_value(result); }
+
+    // Writes all 8 bytes, unused bits are 0
+    void encode(uint8_t data[8]) const
+    {
+        const uint64_t bits = static_cast<uint64_t>(mux_id)
+                              | (static_cast<uint64_t>(counter) & 0xFU) << 8
+                              | static_cast<uint64_t>(ocs) << 12
+                              | static_cast<uint64_t>(this_result_error) << 13
+                              | static_cast<uint64_t>(any_measurement_error) << 14
+                              | static_cast<uint64_t>(system_error) << 15
+                              | static_cast<uint64_t>(static_cast<uint32_t>(result)) << 16;
+        can_codec_store(data, bits);
+    }
+
+    static CanIvtResultWh decode(const uint8_t data[8])
+    {
+        const uint64_t bits = can_codec_load(data);
+        CanIvtResultWh message;
+        message.mux_id = static_cast<uint8_t>(bits & 0xFFU);
+        message.counter = static_cast<uint8_t>((bits >> 8) & 0xFU);
+        message.ocs = ((bits >> 12) & 0x1U) != 0U;
+        message.this_result_error = ((bits >> 13) & 0x1U) != 0U;
+        message.any_measurement_error = ((bits >> 14) & 0x1U) != 0U;
+        message.system_error = ((bits >> 15) & 0x1U) != 0U;
+        message.result = static_cast<int32_t>(can_codec_sign_extend((bits >> 16) & 0xFFFFFFFFU, 32U));
+        return message;
+    }
+
+    bool operator==(const CanIvtResultWh &other) const
+    {
+        return mux_id == other.mux_id
+               && counter == other.counter
+               && ocs == other.ocs
+               && this_result_error == other.this_result_error
+               && any_measurement_error == other.any_measurement_error
+               && system_error == other.system_error
+               && result == other.result;
+    }
+    bool operator!=(const CanIvtResultWh &other) const { return !(*this == other); }
+};
+
+// BMS_Voltage (0x41A), 8 bytes, 100 ms, BMS -> VCU
+struct CanBmsVoltage
+{
+    static constexpr uint32_t kId = 0x41AU;
+    static constexpr uint8_t kLen = 8U;
+    static constexpr const char *kName = "BMS_Voltage";
+    static constexpr CanChecksum kChecksum = CAN_CHECKSUM_CRC8;
+    static constexpr uint64_t kUsedMask = 0xFF0FFFFFFFFFFFFFULL;
+    static constexpr uint32_t kLayoutHash = 0x4337B4D8U;
+
+    uint16_t pack_voltage = 0;    // 0|16@1+ (0.1,0) [0|650] V
+    // Positive = discharge, negative = charge.
+    uint16_t pack_current = 0;    // 16|16@1+ (0.1,-500) [-500|500] A
+    uint8_t min_cell_voltage = 0; // 32|8@1+ (0.02,0) [0|5.1] V
+    uint8_t max_cell_voltage = 0; // 40|8@1+ (0.02,0) [0|5.1] V
+    uint8_t counter = 0;          // 48|4@1+ (1,0) [0|15] counter
+    uint8_t crc = 0;              // 56|8@1+ (1,0) [0|255] checksum
+
+    // PackVoltage [V]
+    static constexpr uint16_t pack_voltage_raw(float value)
+    {
+        return can_codec_raw<uint16_t>(value * 10.0f, 0U, 6500U);
+    }
+    static constexpr float pack_voltage_value(uint16_t raw) { return static_cast<float>(raw) / 10.0f; }
+    void set_pack_voltage(float value) { pack_voltage = pack_voltage_raw(value); }
+    float get_pack_voltage() const { return pack_voltage_value(pack_voltage); }
+
+    // PackCurrent [A]
+    static constexpr uint16_t pack_current_raw(float value)
+    {
+        return can_codec_raw<uint16_t>((value + 500.0f) * 10.0f, 0U, 10000U);
+    }
+    static constexpr float pack_current_value(uint16_t raw) { return static_cast<float>(raw) / 10.0f - 500.0f; }
+    void set_pack_current(float value) { pack_current = pack_current_raw(value); }
+    float get_pack_current() const { return pack_current_value(pack_current); }
+
+    // MinCellVoltage [V]
+    static constexpr uint8_t min_cell_voltage_raw(float value)
+    {
+        return can_codec_raw<uint8_t>(value * 50.0f, 0U, 255U);
+    }
+    static constexpr float min_cell_voltage_value(uint8_t raw) { return static_cast<float>(raw) / 50.0f; }
+    void set_min_cell_voltage(float value) { min_cell_voltage = min_cell_voltage_raw(value); }
+    float get_min_cell_voltage() const { return min_cell_voltage_value(min_cell_voltage); }
+
+    // MaxCellVoltage [V]
+    static constexpr uint8_t max_cell_voltage_raw(float value)
+    {
+        return can_codec_raw<uint8_t>(value * 50.0f, 0U, 255U);
+    }
+    static constexpr float max_cell_voltage_value(uint8_t raw) { return static_cast<float>(raw) / 50.0f; }
+    void set_max_cell_voltage(float value) { max_cell_voltage = max_cell_voltage_raw(value); }
+    float get_max_cell_voltage() const { return max_cell_voltage_value(max_cell_voltage); }
+
+    // Writes all 8 bytes; the checksum slot is computed, the crc field is ignored
+    void encode(uint8_t data[8]) const
+    {
+        const uint64_t bits = static_cast<uint64_t>(pack_voltage)
+                              | static_cast<uint64_t>(pack_current) << 16
+                              | static_cast<uint64_t>(min_cell_voltage) << 32
+                              | static_cast<uint64_t>(max_cell_voltage) << 40
+                              | (static_cast<uint64_t>(counter) & 0xFU) << 48;
+        can_codec_store(data, bits);
+        data[7] = can_crc8(data);
+    }
+
+    static CanBmsVoltage decode(const uint8_t data[8])
+    {
+        const uint64_t bits = can_codec_load(data);
+        CanBmsVoltage message;
+        message.pack_voltage = static_cast<uint16_t>(bits & 0xFFFFU);
+        message.pack_current = static_cast<uint16_t>((bits >> 16) & 0xFFFFU);
+        message.min_cell_voltage = static_cast<uint8_t>((bits >> 32) & 0xFFU);
+        message.max_cell_voltage = static_cast<uint8_t>((bits >> 40) & 0xFFU);
+        message.counter = static_cast<uint8_t>((bits >> 48) & 0xFU);
+        message.crc = static_cast<uint8_t>(bits >> 56);
+        return message;
+    }
+
+    static bool checksum_ok(const uint8_t data[8])
+    {
+        uint8_t copy[8];
+        memcpy(copy, data, sizeof(copy));
+        copy[7] = 0U;
+        return can_crc8(copy) == data[7];
+    }
+
+    bool operator==(const CanBmsVoltage &other) const
+    {
+        return pack_voltage == other.pack_voltage
+               && pack_current == other.pack_current
+               && min_cell_voltage == other.min_cell_voltage
+               && max_cell_voltage == other.max_cell_voltage
+               && counter == other.counter
+               && crc == other.crc;
+    }
+    bool operator!=(const CanBmsVoltage &other) const { return !(*this == other); }
+};
+
+// BMS_CellTemp (0x41B), 8 bytes, 100 ms, BMS -> VCU
+struct CanBmsCellTemp
+{
+    static constexpr uint32_t kId = 0x41BU;
+    static constexpr uint8_t kLen = 8U;
+    static constexpr const char *kName = "BMS_CellTemp";
+    static constexpr CanChecksum kChecksum = CAN_CHECKSUM_CRC8;
+    static constexpr uint64_t kUsedMask = 0xFF0FFFFFFFFFFFFFULL;
+    static constexpr uint32_t kLayoutHash = 0xDAA79F80U;
+
+    uint8_t min_cell_temp = 0;            // 0|8@1+ (1,-40) [-40|127] degC
+    uint8_t max_cell_temp = 0;            // 8|8@1+ (1,-40) [-40|127] degC
+    // 0 V when balancing is inactive.
+    uint8_t balancing_target_voltage = 0; // 16|8@1+ (0.02,0) [0|5.1] V
+    // Highest minus lowest cell.
+    uint8_t cell_voltage_delta = 0;       // 24|8@1+ (0.002,0) [0|0.51] V
+    // Positive = discharge, negative = charge.
+    uint16_t pack_power = 0;              // 32|16@1+ (0.01,-300) [-300|200] kW
+    uint8_t counter = 0;                  // 48|4@1+ (1,0) [0|15] counter
+    uint8_t crc = 0;                      // 56|8@1+ (1,0) [0|255] checksum
+
+    // MinCellTemp [degC]
+    static constexpr uint8_t min_cell_temp_raw(float value)
+    {
+        return can_codec_raw<uint8_t>(value + 40.0f, 0U, 167U);
+    }
+    static constexpr float min_cell_temp_value(uint8_t raw) { return static_cast<float>(raw) - 40.0f; }
+    void set_min_cell_temp(float value) { min_cell_temp = min_cell_temp_raw(value); }
+    float get_min_cell_temp() const { return min_cell_temp_value(min_cell_temp); }
+
+    // MaxCellTemp [degC]
+    static constexpr uint8_t max_cell_temp_raw(float value)
+    {
+        return can_codec_raw<uint8_t>(value + 40.0f, 0U, 167U);
+    }
+    static constexpr float max_cell_temp_value(uint8_t raw) { return static_cast<float>(raw) - 40.0f; }
+    void set_max_cell_temp(float value) { max_cell_temp = max_cell_temp_raw(value); }
+    float get_max_cell_temp() const { return max_cell_temp_value(max_cell_temp); }
+
+    // BalancingTargetVoltage [V]
+    static constexpr uint8_t balancing_target_voltage_raw(float value)
+    {
+        return can_codec_raw<uint8_t>(value * 50.0f, 0U, 255U);
+    }
+    static constexpr float balancing_target_voltage_value(uint8_t raw) { return static_cast<float>(raw) / 50.0f; }
+    void set_balancing_target_voltage(float value) { balancing_target_voltage = balancing_target_voltage_raw(value); }
+    float get_balancing_target_voltage() const { return balancing_target_voltage_value(balancing_target_voltage); }
+
+    // CellVoltageDelta [V]
+    static constexpr uint8_t cell_voltage_delta_raw(float value)
+    {
+        return can_codec_raw<uint8_t>(value * 500.0f, 0U, 255U);
+    }
+    static constexpr float cell_voltage_delta_value(uint8_t raw) { return static_cast<float>(raw) / 500.0f; }
+    void set_cell_voltage_delta(float value) { cell_voltage_delta = cell_voltage_delta_raw(value); }
+    float get_cell_voltage_delta() const { return cell_voltage_delta_value(cell_voltage_delta); }
+
+    // PackPower [kW]
+    static constexpr uint16_t pack_power_raw(float value)
+    {
+        return can_codec_raw<uint16_t>((value + 300.0f) * 100.0f, 0U, 50000U);
+    }
+    static constexpr float pack_power_value(uint16_t raw) { return static_cast<float>(raw) / 100.0f - 300.0f; }
+    void set_pack_power(float value) { pack_power = pack_power_raw(value); }
+    float get_pack_power() const { return pack_power_value(pack_power); }
+
+    // Writes all 8 bytes; the checksum slot is computed, the crc field is ignored
+    void encode(uint8_t data[8]) const
+    {
+        const uint64_t bits = static_cast<uint64_t>(min_cell_temp)
+                              | static_cast<uint64_t>(max_cell_temp) << 8
+                              | static_cast<uint64_t>(balancing_target_voltage) << 16
+                              | static_cast<uint64_t>(cell_voltage_delta) << 24
+                              | static_cast<uint64_t>(pack_power) << 32
+                              | (static_cast<uint64_t>(counter) & 0xFU) << 48;
+        can_codec_store(data, bits);
+        data[7] = can_crc8(data);
+    }
+
+    static CanBmsCellTemp decode(const uint8_t data[8])
+    {
+        const uint64_t bits = can_codec_load(data);
+        CanBmsCellTemp message;
+        message.min_cell_temp = static_cast<uint8_t>(bits & 0xFFU);
+        message.max_cell_temp = static_cast<uint8_t>((bits >> 8) & 0xFFU);
+        message.balancing_target_voltage = static_cast<uint8_t>((bits >> 16) & 0xFFU);
+        message.cell_voltage_delta = static_cast<uint8_t>((bits >> 24) & 0xFFU);
+        message.pack_power = static_cast<uint16_t>((bits >> 32) & 0xFFFFU);
+        message.counter = static_cast<uint8_t>((bits >> 48) & 0xFU);
+        message.crc = static_cast<uint8_t>(bits >> 56);
+        return message;
+    }
+
+    static bool checksum_ok(const uint8_t data[8])
+    {
+        uint8_t copy[8];
+        memcpy(copy, data, sizeof(copy));
+        copy[7] = 0U;
+        return can_crc8(copy) == data[7];
+    }
+
+    bool operator==(const CanBmsCellTemp &other) const
+    {
+        return min_cell_temp == other.min_cell_temp
+               && max_cell_temp == other.max_cell_temp
+               && balancing_target_voltage == other.balancing_target_voltage
+               && cell_voltage_delta == other.cell_voltage_delta
+               && pack_power == other.pack_power
+               && counter == other.counter
+               && crc == other.crc;
+    }
+    bool operator!=(const CanBmsCellTemp &other) const { return !(*this == other); }
+};
+
+// BMS_LimitsFault (0x41C), 8 bytes, 100 ms, BMS -> VCU
+struct CanBmsLimitsFault
+{
+    static constexpr uint32_t kId = 0x41CU;
+    static constexpr uint8_t kLen = 8U;
+    static constexpr const char *kName = "BMS_LimitsFault";
+    static constexpr CanChecksum kChecksum = CAN_CHECKSUM_CRC8;
+    static constexpr uint64_t kUsedMask = 0xFF0FFFFFFFFFFFFFULL;
+    static constexpr uint32_t kLayoutHash = 0x4337B4D8U;
+
+    // Magnitude, always positive.
+    uint16_t max_discharge_current = 0; // 0|16@1+ (0.1,0) [0|6553.5] A
+    // Magnitude, always positive.
+    uint16_t max_charge_current = 0;    // 16|16@1+ (0.1,0) [0|6553.5] A
+    uint8_t contactor_state = 0;        // 32|8@1+ (1,0) [0|7]
+    // BMS::DTC_BMS bits.
+    uint8_t fault_code = 0;             // 40|8@1+ (1,0) [0|255]
+    uint8_t counter = 0;                // 48|4@1+ (1,0) [0|15] counter
+    uint8_t crc = 0;                    // 56|8@1+ (1,0) [0|255] checksum
+
+    // MaxDischargeCurrent [A]
+    static constexpr uint16_t max_discharge_current_raw(float value)
+    {
+        return can_codec_raw<uint16_t>(value * 10.0f, 0U, 65535U);
+    }
+    static constexpr float max_discharge_current_value(uint16_t raw) { return static_cast<float>(raw) / 10.0f; }
+    void set_max_discharge_current(float value) { max_discharge_current = max_discharge_current_raw(value); }
+    float get_max_discharge_current() const { return max_discharge_current_value(max_discharge_current); }
+
+    // MaxChargeCurrent [A]
+    static constexpr uint16_t max_charge_current_raw(float value)
+    {
+        return can_codec_raw<uint16_t>(value * 10.0f, 0U, 65535U);
+    }
+    static constexpr float max_charge_current_value(uint16_t raw) { return static_cast<float>(raw) / 10.0f; }
+    void set_max_charge_current(float value) { max_charge_current = max_charge_current_raw(value); }
+    float get_max_charge_current() const { return max_charge_current_value(max_charge_current); }
+
+    void set_contactor_state(uint8_t raw) { contactor_state = can_codec_clamp<uint8_t>(raw, 0U, 7U); }
+
+    // Writes all 8 bytes; the checksum slot is computed, the crc field is ignored
+    void encode(uint8_t data[8]) const
+    {
+        const uint64_t bits = static_cast<uint64_t>(max_discharge_current)
+                              | static_cast<uint64_t>(max_charge_current) << 16
+                              | static_cast<uint64_t>(contactor_state) << 32
+                              | static_cast<uint64_t>(fault_code) << 40
+                              | (static_cast<uint64_t>(counter) & 0xFU) << 48;
+        can_codec_store(data, bits);
+        data[7] = can_crc8(data);
+    }
+
+    static CanBmsLimitsFault decode(const uint8_t data[8])
+    {
+        const uint64_t bits = can_codec_load(data);
+        CanBmsLimitsFault message;
+        message.max_discharge_current = static_cast<uint16_t>(bits & 0xFFFFU);
+        message.max_charge_current = static_cast<uint16_t>((bits >> 16) & 0xFFFFU);
+        message.contactor_state = static_cast<uint8_t>((bits >> 32) & 0xFFU);
+        message.fault_code = static_cast<uint8_t>((bits >> 40) & 0xFFU);
+        message.counter = static_cast<uint8_t>((bits >> 48) & 0xFU);
+        message.crc = static_cast<uint8_t>(bits >> 56);
+        return message;
+    }
+
+    static bool checksum_ok(const uint8_t data[8])
+    {
+        uint8_t copy[8];
+        memcpy(copy, data, sizeof(copy));
+        copy[7] = 0U;
+        return can_crc8(copy) == data[7];
+    }
+
+    bool operator==(const CanBmsLimitsFault &other) const
+    {
+        return max_discharge_current == other.max_discharge_current
+               && max_charge_current == other.max_charge_current
+               && contactor_state == other.contactor_state
+               && fault_code == other.fault_code
+               && counter == other.counter
+               && crc == other.crc;
+    }
+    bool operator!=(const CanBmsLimitsFault &other) const { return !(*this == other); }
+};
+
+// BMS_SocSoh (0x41D), 8 bytes, 1000 ms, BMS -> VCU
+struct CanBmsSocSoh
+{
+    static constexpr uint32_t kId = 0x41DU;
+    static constexpr uint8_t kLen = 8U;
+    static constexpr const char *kName = "BMS_SocSoh";
+    static constexpr CanChecksum kChecksum = CAN_CHECKSUM_CRC8;
+    static constexpr uint64_t kUsedMask = 0xFF0FFFFFFFFFFFFFULL;
+    static constexpr uint32_t kLayoutHash = 0x4337B4D8U;
+
+    uint16_t soc = 0;             // 0|16@1+ (0.01,0) [0|100] %
+    uint16_t soh = 0;             // 16|16@1+ (0.01,0) [0|100] %
+    uint8_t balancing_status = 0; // 32|8@1+ (1,0) [0|2]
+    uint8_t bms_status = 0;       // 40|8@1+ (1,0) [0|255]
+    uint8_t counter = 0;          // 48|4@1+ (1,0) [0|15] counter
+    uint8_t crc = 0;              // 56|8@1+ (1,0) [0|255] checksum
+
+    // SOC [%]
+    static constexpr uint16_t soc_raw(float value)
+    {
+        return can_codec_raw<uint16_t>(value * 100.0f, 0U, 10000U);
+    }
+    static constexpr float soc_value(uint16_t raw) { return static_cast<float>(raw) / 100.0f; }
+    void set_soc(float value) { soc = soc_raw(value); }
+    float get_soc() const { return soc_value(soc); }
+
+    // SOH [%]
+    static constexpr uint16_t soh_raw(float value)
+    {
+        return can_codec_raw<uint16_t>(value * 100.0f, 0U, 10000U);
+    }
+    static constexpr float soh_value(uint16_t raw) { return static_cast<float>(raw) / 100.0f; }
+    void set_soh(float value) { soh = soh_raw(value); }
+    float get_soh() const { return soh_value(soh); }
+
+    void set_balancing_status(uint8_t raw) { balancing_status = can_codec_clamp<uint8_t>(raw, 0U, 2U); }
+
+    // Writes all 8 bytes; the checksum slot is computed, the crc field is ignored
+    void encode(uint8_t data[8]) const
+    {
+        const uint64_t bits = static_cast<uint64_t>(soc)
+                              | static_cast<uint64_t>(soh) << 16
+                              | static_cast<uint64_t>(balancing_status) << 32
+                              | static_cast<uint64_t>(bms_status) << 40
+                              | (static_cast<uint64_t>(counter) & 0xFU) << 48;
+        can_codec_store(data, bits);
+        data[7] = can_crc8(data);
+    }
+
+    static CanBmsSocSoh decode(const uint8_t data[8])
+    {
+        const uint64_t bits = can_codec_load(data);
+        CanBmsSocSoh message;
+        message.soc = static_cast<uint16_t>(bits & 0xFFFFU);
+        message.soh = static_cast<uint16_t>((bits >> 16) & 0xFFFFU);
+        message.balancing_status = static_cast<uint8_t>((bits >> 32) & 0xFFU);
+        message.bms_status = static_cast<uint8_t>((bits >> 40) & 0xFFU);
+        message.counter = static_cast<uint8_t>((bits >> 48) & 0xFU);
+        message.crc = static_cast<uint8_t>(bits >> 56);
+        return message;
+    }
+
+    static bool checksum_ok(const uint8_t data[8])
+    {
+        uint8_t copy[8];
+        memcpy(copy, data, sizeof(copy));
+        copy[7] = 0U;
+        return can_crc8(copy) == data[7];
+    }
+
+    bool operator==(const CanBmsSocSoh &other) const
+    {
+        return soc == other.soc
+               && soh == other.soh
+               && balancing_status == other.balancing_status
+               && bms_status == other.bms_status
+               && counter == other.counter
+               && crc == other.crc;
+    }
+    bool operator!=(const CanBmsSocSoh &other) const { return !(*this == other); }
+};
+
+// BMS_HMI (0x41E), 8 bytes, 1000 ms, BMS -> VCU
+struct CanBmsHmi
+{
+    static constexpr uint32_t kId = 0x41EU;
+    static constexpr uint8_t kLen = 8U;
+    static constexpr const char *kName = "BMS_HMI";
+    static constexpr CanChecksum kChecksum = CAN_CHECKSUM_CRC8;
+    static constexpr uint64_t kUsedMask = 0xFF0FFFFFFFFFFFFFULL;
+    static constexpr uint32_t kLayoutHash = 0x1F57E909U;
+
+    // Sign indicates charge (-) or discharge (+).
+    int16_t avg_energy_per_hour = 0; // 0|16@1- (0.01,0) [-327.67|327.67] kWh
+    // Time to empty when discharging, time to full when charging.
+    uint16_t remaining_time = 0;     // 16|16@1+ (1,0) [0|65535] s
+    uint16_t remaining_energy = 0;   // 32|16@1+ (1,0) [0|65535] Wh
+    uint8_t counter = 0;             // 48|4@1+ (1,0) [0|15] counter
+    uint8_t crc = 0;                 // 56|8@1+ (1,0) [0|255] checksum
+
+    // AvgEnergyPerHour [kWh]
+    static constexpr int16_t avg_energy_per_hour_raw(float value)
+    {
+        return can_codec_raw<int16_t>(value * 100.0f, -32767, 32767);
+    }
+    static constexpr float avg_energy_per_hour_value(int16_t raw) { return static_cast<float>(raw) / 100.0f; }
+    void set_avg_energy_per_hour(float value) { avg_energy_per_hour = avg_energy_per_hour_raw(value); }
+    float get_avg_energy_per_hour() const { return avg_energy_per_hour_value(avg_energy_per_hour); }
+
+    // RemainingTime [s]
+    static constexpr uint16_t remaining_time_raw(float value)
+    {
+        return can_codec_raw<uint16_t>(value, 0U, 65535U);
+    }
+    static constexpr float remaining_time_value(uint16_t raw) { return static_cast<float>(raw); }
+    void set_remaining_time(float value) { remaining_time = remaining_time_raw(value); }
+    float get_remaining_time() const { return remaining_time_value(remaining_time); }
+
+    // RemainingEnergy [Wh]
+    static constexpr uint16_t remaining_energy_raw(float value)
+    {
+        return can_codec_raw<uint16_t>(value, 0U, 65535U);
+    }
+    static constexpr float remaining_energy_value(uint16_t raw) { return static_cast<float>(raw); }
+    void set_remaining_energy(float value) { remaining_energy = remaining_energy_raw(value); }
+    float get_remaining_energy() const { return remaining_energy_value(remaining_energy); }
+
+    // Writes all 8 bytes; the checksum slot is computed, the crc field is ignored
+    void encode(uint8_t data[8]) const
+    {
+        const uint64_t bits = static_cast<uint64_t>(static_cast<uint16_t>(avg_energy_per_hour))
+                              | static_cast<uint64_t>(remaining_time) << 16
+                              | static_cast<uint64_t>(remaining_energy) << 32
+                              | (static_cast<uint64_t>(counter) & 0xFU) << 48;
+        can_codec_store(data, bits);
+        data[7] = can_crc8(data);
+    }
+
+    static CanBmsHmi decode(const uint8_t data[8])
+    {
+        const uint64_t bits = can_codec_load(data);
+        CanBmsHmi message;
+        message.avg_energy_per_hour = static_cast<int16_t>(can_codec_sign_extend(bits & 0xFFFFU, 16U));
+        message.remaining_time = static_cast<uint16_t>((bits >> 16) & 0xFFFFU);
+        message.remaining_energy = static_cast<uint16_t>((bits >> 32) & 0xFFFFU);
+        message.counter = static_cast<uint8_t>((bits >> 48) & 0xFU);
+        message.crc = static_cast<uint8_t>(bits >> 56);
+        return message;
+    }
+
+    static bool checksum_ok(const uint8_t data[8])
+    {
+        uint8_t copy[8];
+        memcpy(copy, data, sizeof(copy));
+        copy[7] = 0U;
+        return can_crc8(copy) == data[7];
+    }
+
+    bool operator==(const CanBmsHmi &other) const
+    {
+        return avg_energy_per_hour == other.avg_energy_per_hour
+               && remaining_time == other.remaining_time
+               && remaining_energy == other.remaining_energy
+               && counter == other.counter
+               && crc == other.crc;
+    }
+    bool operator!=(const CanBmsHmi &other) const { return !(*this == other); }
+};
+
+// BMS_ContactorTelemetry (0x601), 8 bytes, 100 ms, BMS -> VCU
+// Contactor status of the serial console 's' command. No counter and no CRC.
+struct CanBmsContactorTelemetry
+{
+    static constexpr uint32_t kId = 0x601U;
+    static constexpr uint8_t kLen = 8U;
+    static constexpr const char *kName = "BMS_ContactorTelemetry";
+    static constexpr CanChecksum kChecksum = CAN_CHECKSUM_NONE;
+    static constexpr uint64_t kUsedMask = 0x1FFFFFFFFFFFFFFFULL;
+    static constexpr uint32_t kLayoutHash = 0x30B5997AU;
+
+    uint8_t manager_state = 0;       // 0|8@1+ (1,0) [0|7]
+    uint8_t manager_dtc = 0;         // 8|8@1+ (1,0) [0|255]
+    uint8_t precharge_strategy = 0;  // 16|8@1+ (1,0) [0|1]
+    uint8_t positive_state = 0;      // 24|8@1+ (1,0) [0|5]
+    uint8_t positive_dtc = 0;        // 32|8@1+ (1,0) [0|255]
+    uint8_t precharge_state = 0;     // 40|8@1+ (1,0) [0|5]
+    uint8_t precharge_dtc = 0;       // 48|8@1+ (1,0) [0|255]
+    bool negative_closed = false;    // 56|1@1+ (1,0) [0|1]
+    bool supply_available = false;   // 57|1@1+ (1,0) [0|1]
+    bool positive_feedback = false;  // 58|1@1+ (1,0) [0|1]
+    bool precharge_feedback = false; // 59|1@1+ (1,0) [0|1]
+    bool positive_can_open = false;  // 60|1@1+ (1,0) [0|1]
+
+    void set_manager_state(uint8_t raw) { manager_state = can_codec_clamp<uint8_t>(raw, 0U, 7U); }
+    void set_precharge_strategy(uint8_t raw) { precharge_strategy = can_codec_clamp<uint8_t>(raw, 0U, 1U); }
+    void set_positive_state(uint8_t raw) { positive_state = can_codec_clamp<uint8_t>(raw, 0U, 5U); }
+    void set_precharge_state(uint8_t raw) { precharge_state = can_codec_clamp<uint8_t>(raw, 0U, 5U); }
+
+    // Writes all 8 bytes, unused bits are 0
+    void encode(uint8_t data[8]) const
+    {
+        const uint64_t bits = static_cast<uint64_t>(manager_state)
+                              | static_cast<uint64_t>(manager_dtc) << 8
+                              | static_cast<uint64_t>(precharge_strategy) << 16
+                              | static_cast<uint64_t>(positive_state) << 24
+                              | static_cast<uint64_t>(positive_dtc) << 32
+                              | static_cast<uint64_t>(precharge_state) << 40
+                              | static_cast<uint64_t>(precharge_dtc) << 48
+                              | static_cast<uint64_t>(negative_closed) << 56
+                              | static_cast<uint64_t>(supply_available) << 57
+                              | static_cast<uint64_t>(positive_feedback) << 58
+                              | static_cast<uint64_t>(precharge_feedback) << 59
+                              | static_cast<uint64_t>(positive_can_open) << 60;
+        can_codec_store(data, bits);
+    }
+
+    static CanBmsContactorTelemetry decode(const uint8_t data[8])
+    {
+        const uint64_t bits = can_codec_load(data);
+        CanBmsContactorTelemetry message;
+        message.manager_state = static_cast<uint8_t>(bits & 0xFFU);
+        message.manager_dtc = static_cast<uint8_t>((bits >> 8) & 0xFFU);
+        message.precharge_strategy = static_cast<uint8_t>((bits >> 16) & 0xFFU);
+        message.positive_state = static_cast<uint8_t>((bits >> 24) & 0xFFU);
+        message.positive_dtc = static_cast<uint8_t>((bits >> 32) & 0xFFU);
+        message.precharge_state = static_cast<uint8_t>((bits >> 40) & 0xFFU);
+        message.precharge_dtc = static_cast<uint8_t>((bits >> 48) & 0xFFU);
+        message.negative_closed = ((bits >> 56) & 0x1U) != 0U;
+        message.supply_available = ((bits >> 57) & 0x1U) != 0U;
+        message.positive_feedback = ((bits >> 58) & 0x1U) != 0U;
+        message.precharge_feedback = ((bits >> 59) & 0x1U) != 0U;
+        message.positive_can_open = ((bits >> 60) & 0x1U) != 0U;
+        return message;
+    }
+
+    bool operator==(const CanBmsContactorTelemetry &other) const
+    {
+        return manager_state == other.manager_state
+               && manager_dtc == other.manager_dtc
+               && precharge_strategy == other.precharge_strategy
+               && positive_state == other.positive_state
+               && positive_dtc == other.positive_dtc
+               && precharge_state == other.precharge_state
+               && precharge_dtc == other.precharge_dtc
+               && negative_closed == other.negative_closed
+               && supply_available == other.supply_available
+               && positive_feedback == other.positive_feedback
+               && precharge_feedback == other.precharge_feedback
+               && positive_can_open == other.positive_can_open;
+    }
+    bool operator!=(const CanBmsContactorTelemetry &other) const { return !(*this == other); }
+};
+
+// VCU_Command (0x437), 8 bytes, 100 ms, VCU -> BMS
+struct CanVcuCommand
+{
+    static constexpr uint32_t kId = 0x437U;
+    static constexpr uint8_t kLen = 8U;
+    static constexpr const char *kName = "VCU_Command";
+    static constexpr CanChecksum kChecksum = CAN_CHECKSUM_CRC8;
+    static constexpr uint64_t kUsedMask = 0xFF0F000000FFFFFFULL;
+    static constexpr uint32_t kLayoutHash = 0x987A78C9U;
+
+    // BMS::VehicleState, 255 = STATE_INVALID.
+    int8_t vehicle_operating_mode = 0;   // 0|8@1- (1,0) [-1|9]
+    uint8_t request_bms_shutdown = 0;    // 8|8@1+ (1,0) [0|1]
+    uint8_t request_contactor_close = 0; // 16|8@1+ (1,0) [0|1]
+    uint8_t counter = 0;                 // 48|4@1+ (1,0) [0|15] counter
+    uint8_t crc = 0;                     // 56|8@1+ (1,0) [0|255] checksum
+
+    void set_vehicle_operating_mode(int8_t raw) { vehicle_operating_mode = can_codec_clamp<int8_t>(raw, -1, 9); }
+    void set_request_bms_shutdown(uint8_t raw) { request_bms_shutdown = can_codec_clamp<uint8_t>(raw, 0U, 1U); }
+    void set_request_contactor_close(uint8_t raw) { request_contactor_close = can_codec_clamp<uint8_t>(raw, 0U, 1U); }
+
+    // Writes all 8 bytes; the checksum slot is computed, the crc field is ignored
+    void encode(uint8_t data[8]) const
+    {
+        const uint64_t bits = static_cast<uint64_t>(static_cast<uint8_t>(vehicle_operating_mode))
+                              | static_cast<uint64_t>(request_bms_shutdown) << 8
+                              | static_cast<uint64_t>(request_contactor_close) << 16
+                              | (static_cast<uint64_t>(counter) & 0xFU) << 48;
+        can_codec_store(data, bits);
+        data[7] = can_crc8(data);
+    }
+
+    static CanVcuCommand decode(const uint8_t data[8])
+    {
+        const uint64_t bits = can_codec_load(data);
+        CanVcuCommand message;
+        message.vehicle_operating_mode = static_cast<int8_t>(can_codec_sign_extend(bits & 0xFFU, 8U));
+        message.request_bms_shutdown = static_cast<uint8_t>((bits >> 8) & 0xFFU);
+        message.request_contactor_close = static_cast<uint8_t>((bits >> 16) & 0xFFU);
+        message.counter = static_cast<uint8_t>((bits >> 48) & 0xFU);
+        message.crc = static_cast<uint8_t>(bits >> 56);
+        return message;
+    }
+
+    static bool checksum_ok(const uint8_t data[8])
+    {
+        uint8_t copy[8];
+        memcpy(copy, data, sizeof(copy));
+        copy[7] = 0U;
+        return can_crc8(copy) == data[7];
+    }
+
+    bool operator==(const CanVcuCommand &other) const
+    {
+        return vehicle_operating_mode == other.vehicle_operating_mode
+               && request_bms_shutdown == other.request_bms_shutdown
+               && request_contactor_close == other.request_contactor_close
+               && counter == other.counter
+               && crc == other.crc;
+    }
+    bool operator!=(const CanVcuCommand &other) const { return !(*this == other); }
+};
+
+#define CAN_MESSAGE_LIST(X) \
+    X(CanCmuErrorBalanceStatus) \
+    X(CanCmuVoltage0to2) \
+    X(CanCmuVoltage3to5) \
+    X(CanCmuVoltage6to8) \
+    X(CanCmuVoltage9to11) \
+    X(CanCmuTotalVoltage) \
+    X(CanCmuTemperatures) \
+    X(CanIvtResultI) \
+    X(CanIvtResultU1) \
+    X(CanIvtResultU2) \
+    X(CanIvtResultU3) \
+    X(CanIvtResultT) \
+    X(CanIvtResultW) \
+    X(CanIvtResultAs) \
+    X(CanIvtResultWh) \
+    X(CanBmsVoltage) \
+    X(CanBmsCellTemp) \
+    X(CanBmsLimitsFault) \
+    X(CanBmsSocSoh) \
+    X(CanBmsHmi) \
+    X(CanBmsContactorTelemetry) \
+    X(CanVcuCommand)
+
+#endif // CAN_MESSAGES_H
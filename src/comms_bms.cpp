@@ -1,7 +1,6 @@
 #include "settings.h"
 #include <ACAN_T4.h>
 #include <Arduino.h>
-#include <TaskSchedulerDeclarations.h>
 #include <Watchdog_t4.h>
 
 #include "comms_bms.h"
@@ -13,25 +12,75 @@
 #include "bms/battery i3/pack.h"
 #include "bms/battery_manager.h"
 #include "bms/hv_monitor.h"
+#include "serial_console.h"
+#include "telemetry_stream.h"
+#include "utils/can_rx_dispatch.h"
+#include "utils/rate_schedule.h"
+#include "work_queue.h"
+
+TaskProfile task_profiles[TASK_PROFILE_COUNT] = {
+    {"shunt 10ms", 10},
+    {"contactors", CONTACTOR_TIMELOOP},
+    {"RX tick", 2},
+    {"battery poll", 13},
+    {"BMS 10ms", 10},
+    {"BMS 100ms", 100},
+    {"BMS 1000ms", 1000},
+    {"monitor 100ms", 100},
+    {"led blink", 1000},
+    {"system load", 100},
+    {"CAN RX dispatch", 0},
+    {"loop console", 0},
+    {"console drain", 0},
+    {"heartbeat check", 1},
+    {"telemetry", TELEMETRY_TICK_MS},
+    {"CAN capture", 10},
+};
+
+// Deadlines leave several periods of slack over the worst start latency of
+// the real-time tier; WATCHDOG_TIMEOUT is added on top before the reset.
+static constexpr uint32_t BMS_100MS_DEADLINE_MS = 300;
+static Heartbeat heartbeats[HEARTBEAT_COUNT] = {
+    {"pack RX", 20, 0},
+    {"shunt timeout", 50, 0},
+    {"contactors", 5 * CONTACTOR_TIMELOOP, 0},
+    {"BMS 100ms", BMS_100MS_DEADLINE_MS, 0},
+};
+HeartbeatSupervisor heartbeat_supervisor(heartbeats, HEARTBEAT_COUNT);
 
 //---------------------------------------------------------------------------------------------------------------------------------------------
 //IPace ISA Shunt Software Component
 //---------------------------------------------------------------------------------------------------------------------------------------------
 void task10ms()
 {
+    heartbeat_supervisor.check_in(HEARTBEAT_SHUNT_TIMEOUT, millis());
     shunt.checkTimeout(ISA_SHUNT_TIMEOUT);
     hv_monitor.update();
 }
 
-Task shunt_task10ms_timer(10, TASK_FOREVER, &task10ms);
+static void on_shunt_frame(const CANMessage &message)
+{
+    shunt.DecodeCAN(message);
+}
 
 void enable_update_shunt()
 {
     shunt.initialise();
     hv_monitor.initialise();
 
+    // Result frames are decoded from the receive dispatch. Command responses
+    // have no callback: only configure_shunt() reads them, with receive(),
+    // while it blocks the loop.
+    const ACANPrimaryFilter filters[] = {
+        ACANPrimaryFilter(kData,
+                          kStandard,
+                          Shunt_IVTS::CAN_RESULT_MASK,
+                          Shunt_IVTS::CAN_RESULT_ACCEPTANCE,
+                          &capture_can_frame<CAN_RX_SHUNT, &on_shunt_frame>),
+        ACANPrimaryFilter(kData, kStandard, Shunt_IVTS::CAN_RESPONSE_ID),
+    };
     ACAN_T4_Settings settings(500 * 1000);
-    const uint32_t errorCode = ACAN_T4::ISA_SHUNT_CAN.begin(settings);
+    const uint32_t errorCode = ACAN_T4::ISA_SHUNT_CAN.begin(settings, filters, 2);
     if (0 == errorCode)
     {
         Serial.println("Shunt CAN ok");
@@ -43,9 +92,7 @@ void enable_update_shunt()
         shunt.setDtcFlag(SHUNT_DTC_CAN_INIT_ERROR);
     }
 
-    scheduler.addTask(shunt_task10ms_timer);
-    shunt_task10ms_timer.enable();
-    Serial.println("Shunt update timer enabled.");
+    Serial.println("Shunt update enabled.");
 }
 
 //---------------------------------------------------------------------------------------------------------------------------------------------
@@ -53,61 +100,49 @@ void enable_update_shunt()
 //---------------------------------------------------------------------------------------------------------------------------------------------
 void update_contactors()
 {
+    heartbeat_supervisor.check_in(HEARTBEAT_CONTACTORS, millis());
     contactor_manager.update();
 }
 
-Task update_contactors_timer(CONTACTOR_TIMELOOP, TASK_FOREVER, &update_contactors);
-
 void enable_update_contactors()
 {
     contactor_manager.initialise();
-    scheduler.addTask(update_contactors_timer);
-    update_contactors_timer.enable();
-    Serial.println("Contactors update timer enabled.");
+    Serial.println("Contactors update enabled.");
 }
 
 //---------------------------------------------------------------------------------------------------------------------------------------------
 // BMW i3 Battery Software Component
 //---------------------------------------------------------------------------------------------------------------------------------------------
-void handle_battery_CAN_messages()
+static void update_activity_profile();
+
+// Merged 2 ms RX tick, replacing the separate pack and BMS 2 ms tasks. Frames
+// are decoded by the receive dispatch; this checks module timeouts, advances
+// the pack state machine, checks the VCU timeout and follows the vehicle
+// state into and out of the low-activity profile.
+void rx_tick()
 {
-    extern BatteryPack batteryPack;
-    batteryPack.read_message();
+    heartbeat_supervisor.check_in(HEARTBEAT_PACK_RX, millis());
+    batteryPack.update_state();
+    battery_manager.Task2Ms();
+    update_activity_profile();
 }
 
-Task handle_battery_CAN_messages_timer(2, TASK_FOREVER, &handle_battery_CAN_messages);
-
 void enable_handle_battery_CAN_messages()
 {
-    batteryPack.initialize();
-    scheduler.addTask(handle_battery_CAN_messages_timer);
-    handle_battery_CAN_messages_timer.enable();
-    Serial.println("Battery handle CAN messages timer enabled.");
+    // Module frames are recorded by the CAN capture before they are decoded
+    batteryPack.initialize(&capture_can_frame<CAN_RX_BATTERY, &BatteryPack::on_can_frame>);
+    Serial.println("Battery CAN enabled.");
 }
 
+// Original BMW i3 polls each pack at 100ms at 8 modules 13 ms comes to approx 100ms
 void poll_battery_for_data()
 {
-    extern BatteryPack batteryPack;
     batteryPack.request_data();
 }
 
-Task poll_battery_for_data_timer(13, TASK_FOREVER, &poll_battery_for_data); // Original BMW i3 polls each pack at 100ms at 8 modules 13 ms comes to approx 100ms
-
-void enable_poll_battery_for_data()
-{
-    scheduler.addTask(poll_battery_for_data_timer);
-    poll_battery_for_data_timer.enable();
-    Serial.println("Battery poll timer enabled.");
-}
-
 //---------------------------------------------------------------------------------------------------------------------------------------------
 // Main Battery Manager Software Component
 //---------------------------------------------------------------------------------------------------------------------------------------------
-void BMS_Task2ms()
-{
-    battery_manager.Task2Ms();
-}
-
 void BMS_Task10ms()
 {
     battery_manager.Task10Ms();
@@ -115,6 +150,7 @@ void BMS_Task10ms()
 
 void BMS_Task100ms()
 {
+    heartbeat_supervisor.check_in(HEARTBEAT_BMS_100MS, millis());
     battery_manager.Task100Ms();
 }
 
@@ -123,92 +159,547 @@ void BMS_Task1000ms()
     battery_manager.Task1000Ms();
 }
 
-Task BMS_task2ms_timer(2, TASK_FOREVER, &BMS_Task2ms);
-Task BMS_Task10ms_timer(10, TASK_FOREVER, &BMS_Task10ms);
-Task BMS_task100ms_timer(100, TASK_FOREVER, &BMS_Task100ms);
-Task BMS_task1000ms_timer(1000, TASK_FOREVER, &BMS_Task1000ms);
+void BMS_Monitor100ms()
+{
+    battery_manager.Monitor100Ms();
+}
 
-void enable_BMS_tasks()
+void enable_BMS_monitor()
 {
-    scheduler.addTask(BMS_task2ms_timer);
-    BMS_task2ms_timer.enable();
-    scheduler.addTask(BMS_Task10ms_timer);
-    BMS_Task10ms_timer.enable();
-    scheduler.addTask(BMS_task100ms_timer);
-    BMS_task100ms_timer.enable();
-    scheduler.addTask(BMS_task1000ms_timer);
-    BMS_task1000ms_timer.enable();
-    Serial.println("BMS handle tasks timer enabled.");
+    battery_manager.initialize();
+    Serial.println("BMS monitor enabled.");
 }
 
-void BMS_Monitor100ms()
+//---------------------------------------------------------------------------------------------------------------------------------------------
+// Monitoring & Debug printing
+//---------------------------------------------------------------------------------------------------------------------------------------------
+void led_blink()
 {
-    battery_manager.Monitor100Ms();
+    digitalWrite(LED_BUILTIN, !digitalRead(LED_BUILTIN));
+    // Serial.println("Serial Alive");
 }
 
-void BMS_Monitor1000ms()
+// Binary telemetry on SerialUSB1; does nothing until main.cpp opened the port
+void send_telemetry()
 {
-    //battery_manager.Monitor1000Ms();
+    telemetry.service(millis(), micros());
 }
 
-Task BMS_monitor_100ms_timer(100, TASK_FOREVER, &BMS_Monitor100ms);
-Task BMS_monitor_1000ms_timer(1000, TASK_FOREVER, &BMS_Monitor1000ms);
+//---------------------------------------------------------------------------------------------------------------------------------------------
+// Two-tier execution
+//---------------------------------------------------------------------------------------------------------------------------------------------
+// Both tiers are static rate-group tables on a 1 ms base tick (see
+// utils/rate_schedule.h).
+//
+// Hard real-time tier: CAN receive dispatch on all three buses, then the due
+// rate groups (RX tick, contactors, shunt timeout, polling, state machine
+// and limits, heartbeat check), then the work the receive callbacks
+// deferred. It runs at the top of every loop() pass and again after the
+// best-effort rate groups, so best-effort work only fills the time in
+// between. Console output never blocks: it is buffered and drained at the
+// end of the best-effort pass within CONSOLE_DRAIN_BUDGET_*.
+//
+// Buses are drained in priority order: VCU commands (contactor control)
+// first, then the shunt, then the bulk of battery module frames.
+CanRxDispatcher can_rx[CAN_RX_BUS_COUNT] = {
+    {ACAN_T4::BMS_CAN, "BMS RX age"},
+    {ACAN_T4::ISA_SHUNT_CAN, "shunt RX age"},
+    {ACAN_T4::BATTERY_CAN, "battery RX age"},
+};
 
-void enable_BMS_monitor()
+//---------------------------------------------------------------------------------------------------------------------------------------------
+// Raw CAN capture
+//---------------------------------------------------------------------------------------------------------------------------------------------
+// Every frame that reaches a filter callback is recorded on its bus (see
+// capture_can_frame() in comms_bms.h). update_can_capture() watches for new
+// DTC bits, module CRC failures and timeouts and freezes all buses on the
+// first enabled one, so the frames around a fault stay until 'X a'.
+CanCapture<CAN_CAPTURE_FRAMES> can_capture[CAN_RX_BUS_COUNT];
+
+#define CAN_CAPTURE_STRINGIFY_INNER(x) #x
+#define CAN_CAPTURE_STRINGIFY(x) CAN_CAPTURE_STRINGIFY_INNER(x)
+static const char *const can_capture_interfaces[CAN_RX_BUS_COUNT] = {
+    CAN_CAPTURE_STRINGIFY(BMS_CAN),
+    CAN_CAPTURE_STRINGIFY(ISA_SHUNT_CAN),
+    CAN_CAPTURE_STRINGIFY(BATTERY_CAN),
+};
+#undef CAN_CAPTURE_STRINGIFY
+#undef CAN_CAPTURE_STRINGIFY_INNER
+
+static uint8_t can_capture_triggers = CAN_CAPTURE_TRIGGERS;
+
+const char *get_can_capture_interface(CanRxBus bus)
 {
-    battery_manager.initialize();
-    scheduler.addTask(BMS_monitor_100ms_timer);
-    BMS_monitor_100ms_timer.enable();
-    scheduler.addTask(BMS_monitor_1000ms_timer);
-    BMS_monitor_1000ms_timer.enable();
-    Serial.println("BMS monitor enabled.");
+    return can_capture_interfaces[bus];
+}
+
+void trigger_can_capture(CanCaptureTrigger cause)
+{
+    const uint32_t now = micros();
+    for (auto &capture : can_capture)
+    {
+        capture.trigger(cause, now, CAN_CAPTURE_POST_FRAMES, CAN_CAPTURE_POST_MS * 1000UL);
+    }
+}
+
+void rearm_can_capture()
+{
+    for (auto &capture : can_capture)
+    {
+        capture.rearm();
+    }
+}
+
+bool is_can_capture_frozen()
+{
+    for (const auto &capture : can_capture)
+    {
+        if (capture.get_state() != CanCapture<CAN_CAPTURE_FRAMES>::FROZEN)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint8_t get_can_capture_triggers()
+{
+    return can_capture_triggers;
+}
+
+void set_can_capture_triggers(uint8_t mask)
+{
+    can_capture_triggers = mask;
+}
+
+// Fault indications seen on the last check; new bits are the triggers
+struct CanCaptureWatch
+{
+    uint32_t dtc[5]; // BMS, pack, contactor manager, shunt, OR of the modules
+    uint32_t crc_failures;
+    bool timeout;
+};
+
+static CanCaptureWatch read_can_capture_watch()
+{
+    CanCaptureWatch watch = {{battery_manager.get_dtc(), batteryPack.getDTC(), contactor_manager.getDTC(), param::dtc, 0U},
+                             0U,
+                             false};
+    for (BatteryModule &module : batteryPack.modules)
+    {
+        watch.dtc[4] |= module.getDTC();
+        watch.crc_failures += module.get_crc_failure_count();
+    }
+    watch.timeout = battery_manager.get_vcu_timeout() || (param::dtc & SHUNT_DTC_TIMED_OUT) ||
+                    (watch.dtc[4] & BatteryModule::DTC_CMU_TIMED_OUT);
+    return watch;
+}
+
+static CanCaptureTrigger detect_can_capture_trigger()
+{
+    static CanCaptureWatch last;
+    static bool primed = false;
+    const CanCaptureWatch now = read_can_capture_watch();
+    const CanCaptureWatch previous = last;
+    last = now;
+    if (!primed)
+    {
+        primed = true;
+        return CAN_CAPTURE_TRIGGER_NONE;
+    }
+    if (now.timeout && !previous.timeout)
+    {
+        return CAN_CAPTURE_TRIGGER_TIMEOUT;
+    }
+    if (now.crc_failures > previous.crc_failures)
+    {
+        return CAN_CAPTURE_TRIGGER_CRC;
+    }
+    for (size_t i = 0; i < sizeof(now.dtc) / sizeof(now.dtc[0]); ++i)
+    {
+        if ((now.dtc[i] & ~previous.dtc[i]) != 0U)
+        {
+            return CAN_CAPTURE_TRIGGER_DTC;
+        }
+    }
+    return CAN_CAPTURE_TRIGGER_NONE;
+}
+
+void update_can_capture()
+{
+    const uint32_t now = micros();
+    for (auto &capture : can_capture)
+    {
+        capture.service(now);
+    }
+    const CanCaptureTrigger cause = detect_can_capture_trigger();
+    if (cause != CAN_CAPTURE_TRIGGER_NONE && (can_capture_triggers & (1U << cause)) != 0U)
+    {
+        trigger_can_capture(cause);
+    }
+}
+
+static constexpr uint32_t DEFERRED_WORK_BUDGET_US = 500;
+static constexpr size_t CONSOLE_DRAIN_BUDGET_BYTES = 512;
+static constexpr uint32_t CONSOLE_DRAIN_BUDGET_US = 200;
+static constexpr uint32_t SERIAL_CONSOLE_BUDGET_US = 2000;
+static constexpr uint32_t BASE_TICK_US = 1000;
+
+static void dispatch_CAN_receive()
+{
+    // Only passes that decoded a frame are profiled
+    const uint32_t dispatch_start = task_profiler_cycles();
+    uint32_t frames = 0;
+    for (CanRxDispatcher &bus : can_rx)
+    {
+        frames += bus.dispatch();
+    }
+    if (frames != 0)
+    {
+        task_profiles[TASK_PROFILE_CAN_RX].record(dispatch_start, task_profiler_cycles());
+    }
+}
+
+// Every tick: feed WDT3 if every heartbeat is fresh. Before
+// start_heartbeat_supervisor() the watchdog is not running and is not fed.
+static bool heartbeat_supervisor_started = false;
+
+void start_heartbeat_supervisor()
+{
+    heartbeat_supervisor.start(millis());
+    heartbeat_supervisor_started = true;
+}
+
+static void supervise_heartbeats()
+{
+    if (heartbeat_supervisor_started && heartbeat_supervisor.supervise(millis()))
+    {
+        wdt.feed();
+    }
+}
+
+// Table order is the priority within a tick. Odd offsets keep the slower
+// groups off the RX tick and 100 ms / 1000 ms off each other; the 13 ms poll
+// drifts through all ticks. The 'S' console command prints the worst tick.
+//
+// The low-activity divider column: in SLEEP the CMU poll and the 100 ms
+// group (state machine, status and limit frames) run on every 10th slot,
+// contactors, shunt timeout, RX tick and the 1 s limits keep their rate.
+// Real-time runnables have no budget (last column); they are sized by the
+// worst tick report instead.
+static constexpr RateTask realtime_entries[] = {
+    {"RX tick", &rx_tick, 2, 0, &task_profiles[TASK_PROFILE_RX_TICK], 1, 0},
+    {"contactors", &update_contactors, CONTACTOR_TIMELOOP, 1, &task_profiles[TASK_PROFILE_CONTACTORS], 1, 0},
+    {"shunt 10ms", &task10ms, 10, 3, &task_profiles[TASK_PROFILE_SHUNT_10MS], 1, 0},
+    {"battery poll", &poll_battery_for_data, 13, 5, &task_profiles[TASK_PROFILE_BATTERY_POLL], LOW_ACTIVITY_POLL_DIVIDER, 0},
+    {"BMS 100ms", &BMS_Task100ms, 100, 7, &task_profiles[TASK_PROFILE_BMS_100MS], LOW_ACTIVITY_BMS_100MS_DIVIDER, 0},
+    {"BMS 1000ms", &BMS_Task1000ms, 1000, 9, &task_profiles[TASK_PROFILE_BMS_1000MS], 1, 0},
+    {"heartbeat check", &supervise_heartbeats, 1, 0, &task_profiles[TASK_PROFILE_SUPERVISOR], 1, 0},
+};
+
+// Hooks without work are nullptr and dropped by make_rate_table(); give
+// them a function to schedule them. In low activity the contactor telemetry
+// and the LED are off, the load is measured once per second and the binary
+// telemetry groups and the CAN capture triggers are serviced ten times less
+// often.
+//
+// Every best-effort runnable has a budget in us (last column, see
+// RateBudget): a run over it costs the runnable its next slots, and the
+// real-time tier gets a turn before each one. BMS 10ms covers one 32-byte
+// I2C page write of the black box at 400 kHz.
+static constexpr RateTask best_effort_entries[] = {
+    {"BMS 10ms", &BMS_Task10ms, 10, 0, &task_profiles[TASK_PROFILE_BMS_10MS], 1, 1000},
+    {"monitor 100ms", &BMS_Monitor100ms, 100, 2, &task_profiles[TASK_PROFILE_MONITOR_100MS], RateTask::kSuspended, 100},
+    {"system load", &update_system_load, 100, 4, &task_profiles[TASK_PROFILE_SYSTEM_LOAD], 10, 50},
+    {"led blink", &led_blink, 1000, 6, &task_profiles[TASK_PROFILE_LED_BLINK], RateTask::kSuspended, 20},
+    {"telemetry", &send_telemetry, TELEMETRY_TICK_MS, 5, &task_profiles[TASK_PROFILE_TELEMETRY], 10, 300},
+    {"CAN capture", &update_can_capture, 10, 3, &task_profiles[TASK_PROFILE_CAN_CAPTURE], 10, 200},
+    {"monitor 1000ms", nullptr, 1000, 8, nullptr, 1, 100},
+    {"print debug", nullptr, 1000, 8, nullptr, 1, 100},
+};
+
+static constexpr auto realtime_table = make_rate_table(realtime_entries);
+static constexpr auto best_effort_table = make_rate_table(best_effort_entries);
+static RateScheduler<realtime_table.kCapacity> realtime_schedule(realtime_table, BASE_TICK_US);
+static RateScheduler<best_effort_table.kCapacity> best_effort_schedule(best_effort_table, BASE_TICK_US);
+static RateBudget serial_console_budget(SERIAL_CONSOLE_BUDGET_US);
+
+void start_rate_schedules()
+{
+    const uint32_t now = micros();
+    realtime_schedule.start(now);
+    best_effort_schedule.start(now);
+    best_effort_schedule.set_yield_hook(&run_realtime_tier);
 }
 
 //---------------------------------------------------------------------------------------------------------------------------------------------
-// Monitoring & Debug printing
+// Low-activity profile
 //---------------------------------------------------------------------------------------------------------------------------------------------
-void print_debug()
+// Entered when the BMS allows it (vehicle state SLEEP, contactors open, no
+// balancing) and left on the next RX tick after the VCU reports any other
+// state. The next CMU poll then follows within one 13 ms slot, well inside
+// one CMU cycle (8 x 13 ms). Deadlines and timeouts of the slowed runnables
+// stretch on entry and shrink only once the full rate is back.
+#if defined(__IMXRT1062__)
+extern "C" uint32_t set_arm_clock(uint32_t frequency);
+#endif
+
+static void scale_cpu_clock(bool low_activity)
+{
+#if defined(__IMXRT1062__)
+    if (LOW_ACTIVITY_CPU_CLOCK_HZ != 0)
+    {
+        // The CAN, UART and USB clocks do not derive from the ARM clock.
+        // Profiles measured at the other clock are converted with the new one.
+        set_arm_clock(low_activity ? LOW_ACTIVITY_CPU_CLOCK_HZ : F_CPU);
+    }
+#else
+    (void)low_activity;
+#endif
+}
+
+static void update_activity_profile()
+{
+    const bool low_activity = battery_manager.allows_low_activity();
+    if (low_activity == realtime_schedule.is_low_activity())
+    {
+        return;
+    }
+
+    const uint32_t now = millis();
+    if (low_activity)
+    {
+        heartbeat_supervisor.set_deadline(HEARTBEAT_BMS_100MS, BMS_100MS_DEADLINE_MS * LOW_ACTIVITY_BMS_100MS_DIVIDER, now);
+        batteryPack.set_low_activity(true);
+        digitalWrite(LED_BUILTIN, LOW);
+    }
+    else
+    {
+        // The 100 ms group runs again within 100 ms of now
+        heartbeat_supervisor.set_deadline(HEARTBEAT_BMS_100MS, BMS_100MS_DEADLINE_MS, now);
+        batteryPack.set_low_activity(false);
+    }
+    realtime_schedule.set_low_activity(low_activity);
+    best_effort_schedule.set_low_activity(low_activity);
+    battery_manager.set_low_activity(low_activity);
+    scale_cpu_clock(low_activity);
+}
+
+bool is_low_activity()
 {
-  
+    return realtime_schedule.is_low_activity();
 }
 
-Task print_debug_timer(1000, TASK_FOREVER, &print_debug);
+size_t get_rate_tasks(RateTier tier, const RateTask **tasks)
+{
+    if (tier == RATE_TIER_REALTIME)
+    {
+        *tasks = realtime_table.tasks;
+        return realtime_table.count;
+    }
+    *tasks = best_effort_table.tasks;
+    return best_effort_table.count;
+}
 
-void enable_print_debug()
+const RateBudget &get_rate_budget(RateTier tier, size_t i)
 {
-    scheduler.addTask(print_debug_timer);
-    print_debug_timer.enable();
-    Serial.println("Print debug timer enabled.");
+    if (tier == RATE_TIER_REALTIME)
+    {
+        return realtime_schedule.get_budget(i);
+    }
+    return best_effort_schedule.get_budget(i);
 }
 
-void led_blink()
+const RateBudget &get_serial_console_budget()
 {
-    digitalWrite(LED_BUILTIN, !digitalRead(LED_BUILTIN));
-    // Serial.println("Serial Alive");
+    return serial_console_budget;
 }
 
-Task led_blink_timer(1000, TASK_FOREVER, &led_blink);
+// Worst-case tick with the largest execution time measured so far
+RateScheduleReport get_rate_schedule_report(RateTier tier, bool low_activity)
+{
+    const RateTask *tasks = nullptr;
+    const size_t count = get_rate_tasks(tier, &tasks);
+    float cost_us[realtime_table.kCapacity > best_effort_table.kCapacity ? realtime_table.kCapacity
+                                                                         : best_effort_table.kCapacity] = {};
+    for (size_t i = 0; i < count; ++i)
+    {
+        cost_us[i] = (tasks[i].profile != nullptr) ? tasks[i].profile->max_us() : 0.0f;
+    }
+    return analyse_rate_tasks(tasks, count, cost_us, low_activity);
+}
 
-void enable_led_blink()
+void run_realtime_tier()
 {
-    scheduler.addTask(led_blink_timer);
-    led_blink_timer.enable();
-    Serial.println("Led blink enabled.");
+    dispatch_CAN_receive();
+    realtime_schedule.execute(micros());
+    deferred_work.run(DEFERRED_WORK_BUDGET_US);
+}
+
+void run_best_effort_tier()
+{
+    best_effort_schedule.execute(micros());
+    run_realtime_tier();
+    // Console commands are held to a budget like the table runnables; the
+    // drain below stops by itself at its byte and time budget.
+    if (Serial.available() && serial_console_budget.admit())
+    {
+        const uint32_t console_start = task_profiler_cycles();
+        serial_console();
+        const uint32_t console_end = task_profiler_cycles();
+        task_profiles[TASK_PROFILE_SERIAL_CONSOLE].record(console_start, console_end);
+        serial_console_budget.charge((console_end - console_start) / task_profiler_cycles_per_us());
+    }
+    // A running CAN capture export moves on every pass, not only when a
+    // key was typed; it stops at its line limit or half a console ring.
+    service_can_capture_export();
+    service_pending_reboot();
+    // Only passes that wrote output are profiled
+    const uint32_t drain_start = task_profiler_cycles();
+    if (console.drain(CONSOLE_DRAIN_BUDGET_BYTES, CONSOLE_DRAIN_BUDGET_US) > 0U)
+    {
+        task_profiles[TASK_PROFILE_CONSOLE_DRAIN].record(drain_start, task_profiler_cycles());
+    }
 }
 
 //---------------------------------------------------------------------------------------------------------------------------------------------
 //CPU Load Monitoring
 //---------------------------------------------------------------------------------------------------------------------------------------------
+static uint32_t system_load_window_start = 0;
+static uint64_t system_load_busy_start = 0;
+static float system_load_percent = 0.0f;
+static float system_load_max_percent = 0.0f;
+static uint8_t task_profile_frame = 0;
+
+static uint64_t total_busy_cycles()
+{
+    uint64_t busy = 0;
+    for (size_t i = 0; i < TASK_PROFILE_COUNT; ++i)
+    {
+        busy += task_profiles[i].busy_cycles();
+    }
+    return busy;
+}
+
+static uint16_t saturate_us(float us)
+{
+    if (us <= 0.0f)
+    {
+        return 0;
+    }
+    return (us >= 65535.0f) ? 65535U : static_cast<uint16_t>(us + 0.5f);
+}
+
+static uint8_t saturate_count(uint32_t count)
+{
+    return (count > 255U) ? 255U : static_cast<uint8_t>(count);
+}
+
+static uint8_t load_byte(float percent)
+{
+    return (percent >= 255.0f) ? 255U : static_cast<uint8_t>(percent + 0.5f);
+}
+
+// One BMS_MSG_TASK_PROFILE frame per call: two pages per task, then a
+// system load summary (see CAN_Message_Packing.md).
+static void send_task_profile_message()
+{
+    static constexpr uint8_t kFrames = 2U * TASK_PROFILE_COUNT + 1U;
+    static constexpr uint8_t kSummaryIndex = 0x7F;
+
+    CANMessage msg;
+    msg.id = BMS_MSG_TASK_PROFILE;
+    msg.len = 8;
+    task_profile_frame = static_cast<uint8_t>(task_profile_frame % kFrames);
+    if (task_profile_frame == kFrames - 1U)
+    {
+        msg.data[0] = kSummaryIndex;
+        msg.data[1] = load_byte(system_load_percent);
+        msg.data[2] = load_byte(system_load_max_percent);
+        msg.data[3] = TASK_PROFILE_COUNT;
+        for (uint8_t i = 4; i < 8; ++i)
+        {
+            msg.data[i] = 0;
+        }
+        ACAN_T4::BMS_CAN.tryToSend(msg);
+        ++task_profile_frame;
+        return;
+    }
+
+    const uint8_t index = task_profile_frame >> 1;
+    const uint8_t page = task_profile_frame & 1U;
+    const TaskProfile &profile = task_profiles[index];
+    msg.data[0] = static_cast<uint8_t>(index | (page << 7));
+    uint16_t words[3];
+    if (page == 0)
+    {
+        words[0] = saturate_us(profile.avg_us());
+        words[1] = saturate_us(profile.p99_us());
+        words[2] = saturate_us(profile.max_us());
+        msg.data[7] = saturate_count(profile.get_overruns());
+    }
+    else
+    {
+        words[0] = saturate_us(profile.min_us());
+        words[1] = saturate_us(profile.late_us());
+        words[2] = saturate_us(-profile.early_us());
+        msg.data[7] = saturate_count(profile.get_missed());
+    }
+    for (uint8_t i = 0; i < 3; ++i)
+    {
+        msg.data[1 + 2 * i] = static_cast<uint8_t>(words[i] & 0xFF);
+        msg.data[2 + 2 * i] = static_cast<uint8_t>(words[i] >> 8);
+    }
+    ACAN_T4::BMS_CAN.tryToSend(msg);
+    ++task_profile_frame;
+}
+
+// Share of the last window spent inside profiled code; the rest is idle
+// scheduler and loop() polling.
 void update_system_load()
 {
-    // Serial.print("Monitor");
+    const uint32_t now = task_profiler_cycles();
+    const uint64_t busy = total_busy_cycles();
+    const uint32_t window = now - system_load_window_start;
+    if (window != 0U && busy >= system_load_busy_start)
+    {
+        system_load_percent = 100.0f * static_cast<float>(busy - system_load_busy_start) / static_cast<float>(window);
+        if (system_load_percent > system_load_max_percent)
+        {
+            system_load_max_percent = system_load_percent;
+        }
+    }
+    system_load_window_start = now;
+    system_load_busy_start = busy;
+
+    // Telemetry is suspended in low activity
+    if (!realtime_schedule.is_low_activity())
+    {
+        send_task_profile_message();
+    }
+}
+
+float get_system_load_percent()
+{
+    return system_load_percent;
 }
 
-Task update_system_load_timer(100, TASK_FOREVER, &update_system_load);
+float get_system_load_max_percent()
+{
+    return system_load_max_percent;
+}
 
-void enable_update_system_load()
+void reset_task_profiles()
 {
-    scheduler.addTask(update_system_load_timer);
-    update_system_load_timer.enable();
-    Serial.println("System Load update timer enabled.");
+    for (TaskProfile &profile : task_profiles)
+    {
+        profile.reset();
+    }
+    for (CanRxDispatcher &bus : can_rx)
+    {
+        bus.reset_statistics();
+    }
+    system_load_window_start = task_profiler_cycles();
+    system_load_busy_start = 0;
+    system_load_max_percent = 0.0f;
 }
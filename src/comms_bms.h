@@ -3,7 +3,6 @@
 #define COMMS_BMS_H
 
 #include <Arduino.h>
-#include <TaskSchedulerDeclarations.h>
 #include <Watchdog_t4.h>
 
 #include <bms/current.h>
@@ -11,12 +10,116 @@
 #include "bms/contactor_manager.h"
 #include "bms/battery i3/pack.h"
 #include "bms/battery_manager.h"
+#include "utils/task_profiler.h"
+#include "utils/can_capture.h"
+#include "utils/can_rx_dispatch.h"
+#include "utils/rate_schedule.h"
+#include "watchdog_supervisor.h"
 
-extern Scheduler scheduler;
+// Two cooperative tiers, both called from loop(); nothing runs from a timer
+// interrupt. The real-time runnables poll CAN mailboxes, use the Serial and
+// Wire drivers and share state with the console without locking, so an ISR
+// tick would need all of that made interrupt-safe. Instead the real-time
+// tier runs at the top of every loop() pass and before each best-effort
+// runnable, and every best-effort runnable has an enforced execution budget
+// (RateBudget in utils/rate_schedule.h): a run over budget loses its next
+// slots until the excess is repaid. The real-time tier therefore waits for at
+// most one best-effort runnable, and over time the best-effort tier uses no
+// more than its budgets.
+//
+// Hard real-time tier: CAN RX, contactors, shunt timeout and limits
+void run_realtime_tier();
+// Best-effort tier: console, telemetry and persistence
+void run_best_effort_tier();
+
+// Static rate-group tables of both tiers on a 1 ms base tick
+enum RateTier
+{
+    RATE_TIER_REALTIME,
+    RATE_TIER_BEST_EFFORT,
+    RATE_TIER_COUNT
+};
+void start_rate_schedules();
+size_t get_rate_tasks(RateTier tier, const RateTask **tasks);
+const RateBudget &get_rate_budget(RateTier tier, size_t i);
+const RateBudget &get_serial_console_budget();
+RateScheduleReport get_rate_schedule_report(RateTier tier, bool low_activity = false);
+
+// Low-activity profile in vehicle state SLEEP (reduced polling, no HMI and
+// telemetry frames)
+bool is_low_activity();
+
+// Execution-time profiles of the runnables below and of the loop() work
+enum TaskProfileId
+{
+    TASK_PROFILE_SHUNT_10MS,
+    TASK_PROFILE_CONTACTORS,
+    TASK_PROFILE_RX_TICK,
+    TASK_PROFILE_BATTERY_POLL,
+    TASK_PROFILE_BMS_10MS,
+    TASK_PROFILE_BMS_100MS,
+    TASK_PROFILE_BMS_1000MS,
+    TASK_PROFILE_MONITOR_100MS,
+    TASK_PROFILE_LED_BLINK,
+    TASK_PROFILE_SYSTEM_LOAD,
+    TASK_PROFILE_CAN_RX,
+    TASK_PROFILE_SERIAL_CONSOLE,
+    TASK_PROFILE_CONSOLE_DRAIN,
+    TASK_PROFILE_SUPERVISOR,
+    TASK_PROFILE_TELEMETRY,
+    TASK_PROFILE_CAN_CAPTURE,
+    TASK_PROFILE_COUNT
+};
+extern TaskProfile task_profiles[TASK_PROFILE_COUNT];
+void reset_task_profiles();
+
+// Receive dispatch per bus, frame age statistics
+// in priority order
+enum CanRxBus
+{
+    CAN_RX_BMS,
+    CAN_RX_SHUNT,
+    CAN_RX_BATTERY,
+    CAN_RX_BUS_COUNT
+};
+extern CanRxDispatcher can_rx[CAN_RX_BUS_COUNT];
+
+// Raw frame capture per bus (utils/can_capture.h). Filter callbacks are
+// registered as capture_can_frame<bus, decoder> so every received frame is
+// recorded before it is decoded. Triggers freeze all buses together.
+extern CanCapture<CAN_CAPTURE_FRAMES> can_capture[CAN_RX_BUS_COUNT];
+template <CanRxBus Bus, ACANCallBackRoutine Decode>
+void capture_can_frame(const CANMessage &message)
+{
+    can_capture[Bus].record(message, micros());
+    Decode(message);
+}
+const char *get_can_capture_interface(CanRxBus bus);
+void trigger_can_capture(CanCaptureTrigger cause);
+void rearm_can_capture();
+bool is_can_capture_frozen();
+uint8_t get_can_capture_triggers();
+void set_can_capture_triggers(uint8_t mask);
+void update_can_capture();
+
+// Heartbeats of the critical runnables; WDT3 is only fed while all are fresh
+enum HeartbeatId
+{
+    HEARTBEAT_PACK_RX,
+    HEARTBEAT_SHUNT_TIMEOUT,
+    HEARTBEAT_CONTACTORS,
+    HEARTBEAT_BMS_100MS,
+    HEARTBEAT_COUNT
+};
+extern WDT_T4<WDT3> wdt;
+extern HeartbeatSupervisor heartbeat_supervisor;
+void start_heartbeat_supervisor();
 
 // Commands to make the onboard LED blink
 void led_blink();
-void enable_led_blink();
+
+// Binary telemetry on SerialUSB1 (telemetry_stream.h)
+void send_telemetry();
 
 // Commands to handle the current sensor
 extern Shunt_IVTS shunt;
@@ -29,27 +132,23 @@ void update_contactors();
 void enable_update_contactors();
 
 void update_system_load();
-void enable_update_system_load();
+float get_system_load_percent();
+float get_system_load_max_percent();
 
 // Command to handle the BMW i3 Battery
 extern BatteryPack batteryPack;
-void handle_battery_CAN_messages();
+void rx_tick();
 void enable_handle_battery_CAN_messages();
 void poll_battery_for_data();
-void enable_poll_battery_for_data();
 
 //Commands to handle the BMS software module
 extern BMS battery_manager;
 void handle_bms_CAN_messages();
 void enable_handle_bms_CAN_messages();
 void BMS_monitor_100ms();
-void BMS_Monitor1000ms();
 void enable_BMS_monitor();
-void enable_BMS_tasks();
 
 //Debug
 extern int balancecount;
-void print_debug();
-void enable_print_debug();
 
 #endif
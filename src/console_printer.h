@@ -2,31 +2,101 @@
 #define CONSOLE_PRINTER_H
 
 #include <Arduino.h>
-#include <stdarg.h>
+#include <string.h>
 
-class ConsolePrinter {
+#include "utils/console_ring.h"
+
+// Buffered console output.
+//
+// print(), println() and printf() only append to a ring (see
+// utils/console_ring.h) and never touch Serial, so they are safe to call
+// from any runnable, including CAN decode. printf() stores the format and
+// its arguments and is formatted when drained; print() of numbers is
+// formatted on the spot by Print. The best-effort tier calls drain() once
+// per loop() pass, which writes at most a byte and time budget and only
+// what the USB buffer takes without blocking. When the ring is full, output
+// is dropped (and counted) instead of waiting for the host.
+//
+// All producers run in loop() context; the ring is not written from
+// interrupts.
+class ConsolePrinter : private Print {
 public:
+    static constexpr size_t kBufferBytes = 16384;
+    static constexpr size_t kChunkBytes = 64;
+
+    typedef ConsoleRing<kBufferBytes> Ring;
+
+    uint32_t dropped_bytes() const {
+        return ring.dropped_bytes();
+    }
+    const Ring &get_ring() const {
+        return ring;
+    }
+
     void print(const char *msg) {
-        Serial.print(msg);
+        Print::print(msg);
     }
     template <typename T>
     void print(const T &value) {
-        Serial.print(value);
+        Print::print(value);
     }
     void println(const char *msg) {
-        Serial.println(msg);
+        Print::println(msg);
     }
     template <typename T>
     void println(const T &value) {
-        Serial.println(value);
-    }
-    void printf(const char *fmt, ...) {
-        char buf[128];
-        va_list args;
-        va_start(args, fmt);
-        vsnprintf(buf, sizeof(buf), fmt, args);
-        va_end(args);
-        Serial.print(buf);
+        Print::println(value);
+    }
+    // fmt must be a string literal; it is read when the record is drained.
+    template <typename... Args>
+    void printf(const char *fmt, Args... args) {
+        ring.write_format(fmt, args...);
+    }
+
+    // Writes buffered output to Serial until budget_bytes are written,
+    // budget_us have passed, the USB buffer is full or the ring is empty.
+    // Returns the number of bytes written.
+    size_t drain(size_t budget_bytes, uint32_t budget_us) {
+        const uint32_t start = micros();
+        size_t written = 0;
+        while (written < budget_bytes && (micros() - start) < budget_us) {
+            const int space = Serial.availableForWrite();
+            if (space <= 0) {
+                break;
+            }
+            size_t chunk = budget_bytes - written;
+            chunk = (chunk < kChunkBytes) ? chunk : kChunkBytes;
+            chunk = (chunk < static_cast<size_t>(space)) ? chunk : static_cast<size_t>(space);
+            char buffer[kChunkBytes];
+            const size_t count = ring.read(buffer, chunk);
+            if (count == 0) {
+                break;
+            }
+            Serial.write(reinterpret_cast<const uint8_t *>(buffer), count);
+            written += count;
+        }
+        return written;
+    }
+
+    // Blocking drain, for output that must leave before a reset.
+    void flush(uint32_t timeout_ms) {
+        const uint32_t start = millis();
+        while (!ring.empty() && (millis() - start) < timeout_ms) {
+            drain(kBufferBytes, 1000);
+        }
+        Serial.flush();
+    }
+
+private:
+    Ring ring;
+
+    size_t write(uint8_t value) override {
+        return write(&value, 1);
+    }
+
+    size_t write(const uint8_t *buffer, size_t size) override {
+        ring.write_text(reinterpret_cast<const char *>(buffer), size);
+        return size;
     }
 };
 
@@ -1,8 +1,6 @@
 #include <Arduino.h>
 #include <ACAN_T4.h>
 
-#include <TaskScheduler.h>
-#include "utils/Map2D3D.h"
 #include <Watchdog_t4.h>
 #include "settings.h"
 #include <bms/current.h>
@@ -13,20 +11,22 @@
 #include "bms/hv_monitor.h"
 #include "comms_bms.h"
 #include "serial_console.h"
+#include "telemetry_stream.h"
+#include "watchdog_supervisor.h"
 
 #ifndef __IMXRT1062__
 #error "This sketch should be compiled for Teensy 4.1"
 #endif
 
 // Create system objects
-Scheduler scheduler;
 WDT_T4<WDT3> wdt; // use the RTWDT which should be the safest one
 
+// Fired 255 WDT3 clock cycles before the reset: only enough time to record
+// which heartbeat starved the watchdog. Reported by the 'r' console command
+// after the reset.
 void wdtCallback()
 {
-  Serial.println("Watchdog was not fed. It will eat you soon. Sorry...");
-  // The callback for WDOG3 is also different from the other 2 watchdogs, it is not called earlier like a trigger,
-  // it's fired 255 cycles before the actual reset, so you have little time to collect diagnostic info before the reset happens.
+  record_watchdog_freeze_frame(heartbeat_supervisor, millis());
 }
 
 // Our software components
@@ -41,13 +41,17 @@ BMS battery_manager(batteryPack, shunt, contactor_manager);
 
 void setup()
 {
+  capture_watchdog_freeze_frame();
   Serial.begin(500000);
+#ifdef USB_DUAL_SERIAL
+  // Binary telemetry stream (telemetry_stream.h); the baud rate is ignored on USB
+  SerialUSB1.begin(1000000);
+  telemetry.begin(SerialUSB1);
+#endif
 #ifdef DEBUG
   // Setup internal LED
   pinMode(LED_BUILTIN, OUTPUT);
   // Setup serial port
-  SerialUSB1.begin(1000000);
-  // SignalManager::setStream(SerialUSB1);
   while (!Serial)
   {
     delay(50);
@@ -63,17 +67,18 @@ void setup()
   // Brownout method here & Setup non-volatile memory
 
   // System functions startup
-  scheduler.startNow();
-  // scheduler.cpuLoadReset();
-  enable_led_blink();
-  enable_update_system_load();
   enable_BMS_monitor();
 
   // Sub-modules startup
   enable_update_shunt();
+  if (take_boot_request() == BOOT_REQUEST_CONFIGURE_SHUNT)
+  {
+    // Requested by the 'cs' console command; blocks for seconds, so it runs
+    // before the watchdog starts
+    Serial.println(shunt.configure_shunt() ? "Shunt configured." : "Shunt configuration failed.");
+  }
   enable_update_contactors();
   enable_handle_battery_CAN_messages();
-  enable_poll_battery_for_data();
 
   // For the following code the init must be in the update. Init is always blocking
   // while ((shunt.state() != Shunt_IVTS::OPERATING) || (contactor_manager.getState() != Contactormanager::OPEN) || (batteryPack.getState() != BatteryPack::OPERATING))
@@ -82,30 +87,22 @@ void setup()
   // }
 
   // Main module startup
-  enable_BMS_tasks();
-  enable_print_debug();
   enable_serial_console();
-
-  // Watchdog startup
-  // WDT_timings_t config;
-  // // GEVCU might loop very rapidly sometimes so windowing mode would be tough. Revisit later
-  // // config.window = 100; /* in milliseconds, 32ms to 522.232s, must be smaller than timeout */
-  // config.timeout = WATCHDOG_TIMEOUT; /* in milliseconds, 32ms to 522.232s */
-  // config.callback = wdtCallback;
-  // wdt.begin(config);
+  start_rate_schedules(); // rate groups tick from here, after the blocking init
+  reset_task_profiles();
+
+  // Watchdog startup, fed by the heartbeat supervisor from here on
+  WDT_timings_t config;
+  // GEVCU might loop very rapidly sometimes so windowing mode would be tough. Revisit later
+  // config.window = 100; /* in milliseconds, 32ms to 522.232s, must be smaller than timeout */
+  config.timeout = WATCHDOG_TIMEOUT; /* in milliseconds, 32ms to 522.232s */
+  config.callback = wdtCallback;
+  start_heartbeat_supervisor();
+  wdt.begin(config);
 }
 
 void loop()
 {
-  scheduler.execute();
-  serial_console();
-  // Poll shunt CAN as often as possible
-  CANMessage message;
-  while (ACAN_T4::ISA_SHUNT_CAN.receive(message))
-  {
-    shunt.DecodeCAN(message);
-  }
-
-  // wdt.feed(); // must feed the watchdog every so often or it'll get angry
+  run_realtime_tier();
+  run_best_effort_tier();
 }
-
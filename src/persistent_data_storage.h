@@ -3,9 +3,47 @@
 
 #include <Arduino.h>
 #include <EEPROM.h>
+#include <stddef.h>
 
+#include "bms/usage_statistics.h"
 #include "settings.h"
-
+#include "utils/crc32.h"
+
+// Size of the journal ring at the start of the EEPROM (default: all of it).
+#ifndef PERSISTENT_JOURNAL_BYTES
+#ifdef E2END
+#define PERSISTENT_JOURNAL_BYTES (E2END + 1)
+#else
+#define PERSISTENT_JOURNAL_BYTES 4096
+#endif
+#endif
+
+// Log-structured journal of PersistentData in an EEPROM byte ring.
+//
+// Every save() appends one entry: a delta holding only the fields that
+// changed since the previous entry, or a full checkpoint holding all fields.
+// Fields are stored as {id, length, value} (TLV) so a record can be read by
+// any firmware: fields it does not know, or whose size changed, are skipped
+// and keep their defaults. A record of the v13 slot ring is migrated on load
+// through the tables in the "Migration" section below; the next save writes
+// a current checkpoint.
+// A checkpoint is written for the first save, after kCheckpointInterval
+// deltas, when a delta would not be smaller than a checkpoint, and whenever
+// the free space in front of the last checkpoint would drop below one
+// checkpoint, so the checkpoint and the deltas after it are never
+// overwritten. Entries carry a sequence number and a CRC-32 over header and
+// payload and may wrap around the end of the ring.
+//
+// At startup the ring is read once into RAM, the newest valid checkpoint is
+// located and the deltas following it are replayed while their sequence
+// numbers are consecutive. The cost is bounded by the ring size.
+//
+// Writes are write-behind: save() only serialises the entry into a staging
+// buffer, service() (called from a periodic task) writes it out a few bytes
+// at a time within a time budget, and the power-down path keeps calling it
+// until !busy(). The payload is written before the header; an entry
+// interrupted by a reset fails the CRC and ends the replay at the previous
+// entry.
 class PersistentDataStorage
 {
 public:
@@ -14,7 +52,7 @@ public:
         float energy_initial_Wh = 0.0f;
         float measured_capacity_Wh = BMS_INITIAL_CAPACITY_WH;
         float b_as = 0.0f;
-        float C_as = BMS_INITIAL_CAPACITY_AS*0.8f;
+        float C_as = BMS_INITIAL_CAPACITY_AH * 3600.0f * 0.8f;
         float soh = 1.0f;
         uint8_t have_low_anchor = 0U;
         float q_low_as = 0.0f;
@@ -23,13 +61,34 @@ public:
         uint8_t contactor_precharge_strategy = CONTACTOR_PRECHARGE_STRATEGY_DEFAULT;
         float contactor_positive_open_current_limit_A =
             CONTACTOR_POSITIVE_OPEN_CURRENT_DEFAULT_A;
+        // Capacity estimator sufficient statistics (c1 == 0 -> reseed from C_as)
+        float cap_c1 = 0.0f;
+        float cap_c2 = 0.0f;
+        float cap_c3 = 0.0f;
+        uint16_t cap_pairs = 0U;
+        // Ageing analytics (rainflow DoD, throughput, exposure histograms)
+        UsageStatisticsData usage;
     };
 
+    static constexpr uint32_t kServiceBudgetUs = 200U;  // per service() call
+    static constexpr size_t kJournalBytes = PERSISTENT_JOURNAL_BYTES;
+    static constexpr uint16_t kCheckpointInterval = 32U; // deltas between checkpoints
+    static constexpr uint16_t kVersion = 14U;            // entry layout written (TLV)
+
     PersistentDataStorage()
         : initialized(false),
-          has_valid_data(false),
-          last_sequence(0U),
-          last_slot(kSlotCount - 1U)
+          have_checkpoint(false),
+          checkpoint_offset(0U),
+          deltas_since_checkpoint(0U),
+          head(0U),
+          next_sequence(1U),
+          writing(false),
+          write_base(0U),
+          write_pos(0U),
+          write_len(0U),
+          pending(false),
+          force_checkpoint(false),
+          loaded_version(0U)
     {
     }
 
@@ -41,7 +100,7 @@ public:
         }
 
         initialized = true;
-        scan_slots();
+        scan_journal();
     }
 
     PersistentData load()
@@ -54,6 +113,9 @@ public:
         return cached_data;
     }
 
+    // Queue data for writing and return immediately. load() returns it at
+    // once; a save issued while an entry is still being written replaces any
+    // save queued behind it.
     void save(const PersistentData &data)
     {
         if (!initialized)
@@ -61,153 +123,551 @@ public:
             begin();
         }
 
-        const uint32_t next_sequence = has_valid_data ? (last_sequence + 1U) : 1U;
-        const size_t next_slot = has_valid_data ? ((last_slot + 1U) % kSlotCount) : 0U;
+        cached_data = data;
+        if (writing)
+        {
+            pending_data = data;
+            pending = true;
+            return;
+        }
 
-        write_slot(next_slot, next_sequence, data);
+        stage(data);
+    }
 
-        cached_data = data;
-        has_valid_data = true;
-        last_sequence = next_sequence;
-        last_slot = next_slot;
+    // Write queued bytes until budget_us has elapsed (at least one byte).
+    void service(uint32_t budget_us = kServiceBudgetUs)
+    {
+        if (!writing)
+        {
+            return;
+        }
+
+        const uint32_t start_us = micros();
+        do
+        {
+            if (!write_next_byte())
+            {
+                return;
+            }
+        } while ((micros() - start_us) < budget_us);
+    }
+
+    // Write everything queued; blocks without a bound, so never from a
+    // scheduled task (the watchdog would fire). For the host tests.
+    void flush()
+    {
+        while (writing)
+        {
+            write_next_byte();
+        }
+    }
+
+    bool busy() const
+    {
+        return writing;
+    }
+
+    // Size of a full checkpoint entry; deltas are smaller.
+    static constexpr size_t checkpoint_bytes()
+    {
+        return kCheckpointBytes;
+    }
+
+    // Deltas replayed on top of the checkpoint by the last startup scan.
+    uint16_t replayed_deltas() const
+    {
+        return replayed;
+    }
+
+    // Layout version the data was loaded from at startup (0: defaults).
+    uint16_t source_version() const
+    {
+        return loaded_version;
     }
 
 private:
-    struct RecordHeader
+    struct EntryHeader
     {
-        uint32_t magic;
+        uint16_t magic;
+        uint8_t type;
+        uint8_t reserved;
         uint16_t version;
-        uint16_t payload_size;
+        uint16_t length; // payload bytes
         uint32_t sequence;
-        uint32_t crc;
+        uint32_t crc; // CRC-32 over header (crc = 0) and payload
+    };
+
+    // Payload: a list of {field id, length, value bytes} (TLV).
+    struct FieldInfo
+    {
+        uint8_t id;
+        uint16_t offset;
+        uint16_t size;
     };
 
-    static constexpr uint32_t kMagic = 0x54564355UL; // 'TVCU'
-    static constexpr uint16_t kVersion = 13U;
-    static constexpr size_t kSlotCount = 16U;
+#define PERSISTENT_FIELD(id, member)                                  \
+    FieldInfo                                                         \
+    {                                                                 \
+        id, static_cast<uint16_t>(offsetof(PersistentData, member)), \
+            sizeof(static_cast<PersistentData *>(nullptr)->member)    \
+    }
 
-    bool initialized;
-    bool has_valid_data;
-    uint32_t last_sequence;
-    size_t last_slot;
-    PersistentData cached_data;
+    // Ids are part of the stored format: never reuse or renumber them.
+    static constexpr FieldInfo kFields[] = {
+        PERSISTENT_FIELD(1, energy_initial_Wh),
+        PERSISTENT_FIELD(2, measured_capacity_Wh),
+        PERSISTENT_FIELD(3, b_as),
+        PERSISTENT_FIELD(4, C_as),
+        PERSISTENT_FIELD(5, soh),
+        PERSISTENT_FIELD(6, have_low_anchor),
+        PERSISTENT_FIELD(7, q_low_as),
+        PERSISTENT_FIELD(8, soc_low_anchor),
+        PERSISTENT_FIELD(9, was_above_high_set),
+        PERSISTENT_FIELD(10, contactor_precharge_strategy),
+        PERSISTENT_FIELD(11, contactor_positive_open_current_limit_A),
+        PERSISTENT_FIELD(12, cap_c1),
+        PERSISTENT_FIELD(13, cap_c2),
+        PERSISTENT_FIELD(14, cap_c3),
+        PERSISTENT_FIELD(15, cap_pairs),
+        PERSISTENT_FIELD(16, usage.dod_half_cycles),
+        PERSISTENT_FIELD(17, usage.temp_time_s),
+        PERSISTENT_FIELD(18, usage.crate_time_s),
+        PERSISTENT_FIELD(19, usage.charge_mAh),
+        PERSISTENT_FIELD(20, usage.discharge_mAh),
+        PERSISTENT_FIELD(21, usage.charge_Wh),
+        PERSISTENT_FIELD(22, usage.discharge_Wh),
+    };
 
-    size_t slot_size() const
+#undef PERSISTENT_FIELD
+
+    static constexpr size_t kFieldCount = sizeof(kFields) / sizeof(kFields[0]);
+
+    // Checkpoint payload: every field with its id and length.
+    static constexpr size_t kCheckpointPayload = [] {
+        size_t size = 0U;
+        for (size_t i = 0; i < kFieldCount; ++i)
+        {
+            size += 2U + kFields[i].size;
+        }
+        return size;
+    }();
+
+    static constexpr uint16_t kMagic = 0x4A54U; // 'TJ'
+    static constexpr uint8_t kEntryCheckpoint = 1U;
+    static constexpr uint8_t kEntryDelta = 2U;
+    static constexpr size_t kCheckpointBytes = sizeof(EntryHeader) + kCheckpointPayload;
+    // Entries read back may come from firmware with more fields.
+    static constexpr size_t kMaxEntryBytes = kCheckpointBytes + 64U;
+
+    static_assert(kJournalBytes >= 2U * kCheckpointBytes, "Journal must hold two checkpoints");
+#ifdef E2END
+    static_assert(kJournalBytes <= (E2END + 1), "Persistent journal does not fit into EEPROM");
+#endif
+
+    bool initialized;
+    PersistentData cached_data;  // latest save()
+    PersistentData journal_data; // state after the last staged entry
+    uint16_t replayed = 0U;
+
+    // Ring state
+    bool have_checkpoint;
+    size_t checkpoint_offset;
+    uint16_t deltas_since_checkpoint;
+    size_t head;
+    uint32_t next_sequence;
+
+    // Write-behind state: staging holds the entry being written to
+    // write_base, pending_data the next save queued behind it.
+    bool writing;
+    size_t write_base;
+    size_t write_pos;
+    size_t write_len;
+    uint8_t staging[kCheckpointBytes];
+    bool pending;
+    PersistentData pending_data;
+
+    bool force_checkpoint;   // next entry must be a checkpoint (after migration)
+    uint16_t loaded_version;
+
+    static size_t ring(size_t offset)
     {
-        return sizeof(RecordHeader) + sizeof(PersistentData);
+        return offset % kJournalBytes;
     }
 
-    void scan_slots()
+    // Bytes that can be written at head without touching the last checkpoint.
+    size_t free_bytes() const
     {
-        has_valid_data = false;
-        last_sequence = 0U;
-        last_slot = kSlotCount - 1U;
+        if (!have_checkpoint)
+        {
+            return kJournalBytes;
+        }
+        return ring(checkpoint_offset + kJournalBytes - head);
+    }
 
-        RecordHeader best_header{};
-        PersistentData best_data{};
+    // Encode all fields (base == nullptr) or those that differ from base.
+    static size_t encode_fields(const PersistentData &data, const PersistentData *base, uint8_t *out)
+    {
+        const uint8_t *src = reinterpret_cast<const uint8_t *>(&data);
+        const uint8_t *old = reinterpret_cast<const uint8_t *>(base);
+        size_t len = 0U;
+        for (size_t i = 0; i < kFieldCount; ++i)
+        {
+            const FieldInfo &field = kFields[i];
+            if (base != nullptr && memcmp(src + field.offset, old + field.offset, field.size) == 0)
+            {
+                continue;
+            }
+            out[len++] = field.id;
+            out[len++] = static_cast<uint8_t>(field.size);
+            memcpy(out + len, src + field.offset, field.size);
+            len += field.size;
+        }
+        return len;
+    }
 
-        for (size_t i = 0; i < kSlotCount; ++i)
+    static const FieldInfo *field_by_id(uint8_t id)
+    {
+        for (size_t i = 0; i < kFieldCount; ++i)
         {
-            RecordHeader header;
-            PersistentData data;
+            if (kFields[i].id == id)
+            {
+                return &kFields[i];
+            }
+        }
+        return nullptr;
+    }
 
-            if (!read_slot(i, header, data))
+    // Apply an encoded field list in one pass, copying only fields this
+    // firmware knows with their current size. Returns false if the payload
+    // is malformed.
+    static bool apply_fields(const uint8_t *payload, size_t len, PersistentData &data)
+    {
+        uint8_t *dst = reinterpret_cast<uint8_t *>(&data);
+        size_t pos = 0U;
+        while (pos < len)
+        {
+            const uint8_t id = payload[pos++];
+            if (pos >= len)
             {
-                continue;
+                return false;
+            }
+            const size_t size = payload[pos++];
+            if (pos + size > len)
+            {
+                return false;
             }
 
-            if (!has_valid_data || header.sequence > best_header.sequence)
+            const FieldInfo *field = field_by_id(id);
+            if (field != nullptr && field->size == size)
             {
-                has_valid_data = true;
-                best_header = header;
-                best_data = data;
-                last_slot = i;
+                memcpy(dst + field->offset, payload + pos, size);
             }
+            pos += size;
+        }
+        return true;
+    }
+
+    // Check the entry at offset of the RAM image; on success copy it
+    // (unwrapped) into entry and return its total size, else 0.
+    static size_t parse_entry(const uint8_t *image, size_t offset, EntryHeader &header, uint8_t *entry)
+    {
+        for (size_t i = 0; i < sizeof(EntryHeader); ++i)
+        {
+            entry[i] = image[ring(offset + i)];
         }
+        memcpy(&header, entry, sizeof(EntryHeader));
 
-        if (has_valid_data)
+        if (header.magic != kMagic ||
+            (header.type != kEntryCheckpoint && header.type != kEntryDelta) ||
+            header.version < kVersion || sizeof(EntryHeader) + header.length > kMaxEntryBytes)
         {
-            cached_data = best_data;
-            last_sequence = best_header.sequence;
+            return 0U;
         }
-        else
+
+        const size_t size = sizeof(EntryHeader) + header.length;
+        for (size_t i = sizeof(EntryHeader); i < size; ++i)
         {
-            cached_data = PersistentData{};
-            last_sequence = 0U;
-            last_slot = kSlotCount - 1U;
+            entry[i] = image[ring(offset + i)];
         }
+
+        EntryHeader header_copy = header;
+        header_copy.crc = 0U;
+        uint32_t crc = crc32_ieee(&header_copy, sizeof(header_copy));
+        crc = crc32_ieee(entry + sizeof(EntryHeader), header.length, crc);
+        return (crc == header.crc) ? size : 0U;
     }
 
-    static uint32_t compute_crc(const RecordHeader &header, const PersistentData &data)
+    void scan_journal()
     {
-        uint32_t hash = 2166136261UL;
+        uint8_t image[kJournalBytes];
+        for (size_t i = 0; i < kJournalBytes; ++i)
+        {
+            image[i] = EEPROM.read(static_cast<int>(i));
+        }
 
-        auto update = [&hash](const uint8_t *bytes, size_t len) {
-            for (size_t i = 0; i < len; ++i)
+        uint8_t entry[kMaxEntryBytes];
+        EntryHeader header;
+
+        // Pass 1: newest checkpoint, highest sequence of all entries.
+        bool found = false;
+        size_t best_offset = 0U;
+        uint32_t best_sequence = 0U;
+        uint32_t max_sequence = 0U;
+        for (size_t offset = 0; offset < kJournalBytes; ++offset)
+        {
+            const size_t size = parse_entry(image, offset, header, entry);
+            if (size == 0U)
+            {
+                continue;
+            }
+            max_sequence = (header.sequence > max_sequence) ? header.sequence : max_sequence;
+            if (header.type == kEntryCheckpoint && (!found || header.sequence > best_sequence))
             {
-                hash ^= bytes[i];
-                hash *= 16777619UL;
+                found = true;
+                best_offset = offset;
+                best_sequence = header.sequence;
             }
-        };
+            offset += size - 1U; // a valid entry cannot contain another one
+        }
 
-        RecordHeader header_copy = header;
-        header_copy.crc = 0U;
+        PersistentData data{};
+        replayed = 0U;
+        have_checkpoint = false;
+        checkpoint_offset = 0U;
+        deltas_since_checkpoint = 0U;
+        head = 0U;
+        force_checkpoint = false;
+        loaded_version = 0U;
 
-        update(reinterpret_cast<const uint8_t *>(&header_copy), sizeof(header_copy));
-        update(reinterpret_cast<const uint8_t *>(&data), sizeof(data));
+        if (found)
+        {
+            // Pass 2: checkpoint plus the chain of consecutive deltas after it.
+            size_t offset = best_offset;
+            size_t size = parse_entry(image, offset, header, entry);
+            const uint16_t version = header.version;
+            apply_fields(entry + sizeof(EntryHeader), header.length, data);
+            have_checkpoint = true;
+            checkpoint_offset = best_offset;
+            loaded_version = version;
+            force_checkpoint = (version != kVersion);
+
+            uint32_t expected = best_sequence + 1U;
+            offset = ring(offset + size);
+            for (size_t guard = 0; guard < kJournalBytes / sizeof(EntryHeader); ++guard)
+            {
+                size = parse_entry(image, offset, header, entry);
+                if (size == 0U || header.type != kEntryDelta || header.version != version ||
+                    header.sequence != expected)
+                {
+                    break;
+                }
+                PersistentData next = data;
+                if (!apply_fields(entry + sizeof(EntryHeader), header.length, next))
+                {
+                    break;
+                }
+                data = next;
+                ++replayed;
+                ++deltas_since_checkpoint;
+                ++expected;
+                offset = ring(offset + size);
+            }
+            head = offset;
+        }
+        else if (load_legacy_slots(data))
+        {
+            force_checkpoint = true;
+        }
 
-        return hash;
+        cached_data = data;
+        journal_data = data;
+        next_sequence = max_sequence + 1U;
     }
 
-    bool read_slot(size_t index, RecordHeader &header, PersistentData &data) const
+    // Serialise data as the next journal entry and start writing it.
+    void stage(const PersistentData &data)
     {
-        const size_t base = index * slot_size();
-        EEPROM.get(static_cast<int>(base), header);
+        uint8_t *payload = staging + sizeof(EntryHeader);
+        bool checkpoint = !have_checkpoint || force_checkpoint || deltas_since_checkpoint >= kCheckpointInterval;
+        size_t len = 0U;
 
-        if (header.magic != kMagic)
+        if (!checkpoint)
         {
-            return false;
+            len = encode_fields(data, &journal_data, payload);
+            if (len == 0U)
+            {
+                return; // nothing changed
+            }
+            checkpoint = (len >= kCheckpointPayload) ||
+                         (sizeof(EntryHeader) + len + kCheckpointBytes > free_bytes());
+        }
+        if (checkpoint)
+        {
+            len = encode_fields(data, nullptr, payload);
         }
 
-        if (header.version != kVersion)
+        EntryHeader header;
+        header.magic = kMagic;
+        header.type = checkpoint ? kEntryCheckpoint : kEntryDelta;
+        header.reserved = 0U;
+        header.version = kVersion;
+        header.length = static_cast<uint16_t>(len);
+        header.sequence = next_sequence++;
+        header.crc = 0U;
+        uint32_t crc = crc32_ieee(&header, sizeof(header));
+        header.crc = crc32_ieee(payload, len, crc);
+        memcpy(staging, &header, sizeof(EntryHeader));
+
+        write_base = head;
+        write_len = sizeof(EntryHeader) + len;
+        write_pos = 0U;
+        writing = true;
+
+        if (checkpoint)
         {
-            return false;
+            have_checkpoint = true;
+            checkpoint_offset = head;
+            deltas_since_checkpoint = 0U;
+            force_checkpoint = false;
         }
+        else
+        {
+            ++deltas_since_checkpoint;
+        }
+        head = ring(head + write_len);
+        journal_data = data;
+    }
 
-        if (header.payload_size != sizeof(PersistentData))
+    // Write one staged byte, payload first and header last. Returns false
+    // once nothing is left to write.
+    bool write_next_byte()
+    {
+        if (!writing)
         {
             return false;
         }
 
-        EEPROM.get(static_cast<int>(base + sizeof(RecordHeader)), data);
+        size_t offset = write_pos + sizeof(EntryHeader);
+        if (offset >= write_len)
+        {
+            offset -= write_len;
+        }
+        EEPROM.update(static_cast<int>(ring(write_base + offset)), staging[offset]);
+        ++write_pos;
 
-        const uint32_t stored_crc = header.crc;
-        RecordHeader header_copy = header;
-        header_copy.crc = 0U;
-        const uint32_t calculated_crc = compute_crc(header_copy, data);
+        if (write_pos >= write_len)
+        {
+            writing = false;
+            if (pending)
+            {
+                pending = false;
+                stage(pending_data);
+            }
+        }
+        return writing;
+    }
+
+    //-------------------------------------------------------------------------
+    // Migration from older layouts. These tables describe stored formats and
+    // must never change.
+    //-------------------------------------------------------------------------
+
+    // v13: ring of 16 slots {LegacySlotHeader, raw PersistentData} with an
+    // FNV-1a checksum.
+    struct LegacySlotHeader
+    {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t payload_size;
+        uint32_t sequence;
+        uint32_t crc;
+    };
+
+    static constexpr uint32_t kLegacySlotMagic = 0x54564355UL; // 'TVCU'
+    static constexpr uint16_t kLegacySlotVersion = 13U;
+    static constexpr uint16_t kLegacySlotPayload = 40U;
+    static constexpr size_t kLegacySlotCount = 16U;
+    static constexpr FieldInfo kLegacySlotFields[] = {
+        {1, 0, 4}, {2, 4, 4}, {3, 8, 4}, {4, 12, 4}, {5, 16, 4}, {6, 20, 1}, {7, 24, 4}, {8, 28, 4},
+        {9, 32, 1}, {10, 33, 1}, {11, 36, 4}};
 
-        if (calculated_crc != stored_crc)
+    static uint32_t legacy_slot_crc(const LegacySlotHeader &header, const uint8_t *payload)
+    {
+        uint32_t hash = 2166136261UL;
+        LegacySlotHeader header_copy = header;
+        header_copy.crc = 0U;
+        const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&header_copy);
+        for (size_t i = 0; i < sizeof(header_copy); ++i)
         {
-            return false;
+            hash = (hash ^ bytes[i]) * 16777619UL;
+        }
+        for (size_t i = 0; i < header.payload_size; ++i)
+        {
+            hash = (hash ^ payload[i]) * 16777619UL;
         }
+        return hash;
+    }
 
-        return true;
+    static void read_eeprom(size_t address, uint8_t *out, size_t len)
+    {
+        for (size_t i = 0; i < len; ++i)
+        {
+            out[i] = EEPROM.read(static_cast<int>(address + i));
+        }
     }
 
-    void write_slot(size_t index, uint32_t sequence, const PersistentData &data)
+    // Import the newest valid slot record.
+    bool load_legacy_slots(PersistentData &data)
     {
-        const size_t base = index * slot_size();
+        const size_t slot_size = sizeof(LegacySlotHeader) + kLegacySlotPayload;
+        const size_t eeprom_bytes = EEPROM.length();
+        uint8_t payload[kLegacySlotPayload];
+        bool found = false;
+        uint32_t best_sequence = 0U;
+        size_t best_base = 0U;
+
+        for (size_t i = 0; i < kLegacySlotCount && (i + 1U) * slot_size <= eeprom_bytes; ++i)
+        {
+            LegacySlotHeader header;
+            read_eeprom(i * slot_size, reinterpret_cast<uint8_t *>(&header), sizeof(header));
+            if (header.magic != kLegacySlotMagic || header.version != kLegacySlotVersion ||
+                header.payload_size != kLegacySlotPayload)
+            {
+                continue;
+            }
+            read_eeprom(i * slot_size + sizeof(header), payload, kLegacySlotPayload);
+            if (legacy_slot_crc(header, payload) != header.crc)
+            {
+                continue;
+            }
+            if (!found || header.sequence > best_sequence)
+            {
+                found = true;
+                best_sequence = header.sequence;
+                best_base = i * slot_size;
+            }
+        }
 
-        RecordHeader header;
-        header.magic = kMagic;
-        header.version = kVersion;
-        header.payload_size = sizeof(PersistentData);
-        header.sequence = sequence;
-        header.crc = 0U;
-        header.crc = compute_crc(header, data);
+        if (!found)
+        {
+            return false;
+        }
 
-        EEPROM.put(static_cast<int>(base), header);
-        EEPROM.put(static_cast<int>(base + sizeof(RecordHeader)), data);
+        read_eeprom(best_base + sizeof(LegacySlotHeader), payload, kLegacySlotPayload);
+        uint8_t *dst = reinterpret_cast<uint8_t *>(&data);
+        for (const FieldInfo &legacy : kLegacySlotFields)
+        {
+            const FieldInfo *field = field_by_id(legacy.id);
+            if (field != nullptr && field->size == legacy.size)
+            {
+                memcpy(dst + field->offset, payload + legacy.offset, legacy.size);
+            }
+        }
+        // Start the journal behind the imported slot so it survives until
+        // the first checkpoint is complete.
+        head = ring(best_base + slot_size);
+        loaded_version = kLegacySlotVersion;
+        return true;
     }
 };
 
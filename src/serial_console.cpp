@@ -4,6 +4,9 @@
 #include <string.h>
 
 #include "bms/hv_monitor.h"
+#include "signal_registry.h"
+#include "telemetry_stream.h"
+#include "work_queue.h"
 
 #define SERIAL_CONSOLE_STRINGIFY_INNER(x) #x
 #define SERIAL_CONSOLE_STRINGIFY(x) SERIAL_CONSOLE_STRINGIFY_INNER(x)
@@ -19,8 +22,10 @@ static const char FIRMWARE_BUILD_TIME[] = __TIME__;
 #undef SERIAL_CONSOLE_STRINGIFY
 #undef SERIAL_CONSOLE_STRINGIFY_INNER
 
+#if defined(__IMXRT1062__)
 static uint32_t boot_reset_flags = 0;
 static bool boot_reset_flags_captured = false;
+#endif
 
 static void capture_boot_reset_flags() {
 #if defined(__IMXRT1062__)
@@ -31,9 +36,9 @@ static void capture_boot_reset_flags() {
 #endif
 }
 
+#if defined(__IMXRT1062__)
 static String decode_boot_reset_flags(uint32_t flags) {
     String causes = "";
-#if defined(__IMXRT1062__)
     if (flags & SRC_SRSR_LOCKUP_SYSRESETREQ) {
         causes += "SW_OR_LOCKUP, ";
     }
@@ -61,9 +66,6 @@ static String decode_boot_reset_flags(uint32_t flags) {
     if (flags & SRC_SRSR_IPP_RESET_B) {
         causes += "IPP_RESET_B, ";
     }
-#else
-    (void)flags;
-#endif
 
     if (causes.length() == 0) {
         return "none/unknown";
@@ -71,6 +73,7 @@ static String decode_boot_reset_flags(uint32_t flags) {
     causes.remove(causes.length() - 2);
     return causes;
 }
+#endif
 
 static void print_uptime_line() {
     const uint32_t uptime_ms = millis();
@@ -79,6 +82,24 @@ static void print_uptime_line() {
     console.printf("Uptime: %.1fs (%.2f min)\n", uptime_s, uptime_min);
 }
 
+#if defined(__IMXRT1062__)
+static void print_watchdog_freeze_frame() {
+    const WatchdogFreezeFrame *frame = boot_watchdog_freeze_frame();
+    if (frame == nullptr) {
+        console.println("Watchdog freeze-frame: none");
+        return;
+    }
+    console.printf("Watchdog freeze-frame: %s late by %lums (deadline %lums)\n",
+                   frame->task,
+                   static_cast<unsigned long>(frame->overdue_ms),
+                   static_cast<unsigned long>(frame->deadline_ms));
+    console.printf("  stale heartbeats 0x%02lX, supervisor last ran %lums before reset, uptime %lums\n",
+                   static_cast<unsigned long>(frame->stale_mask),
+                   static_cast<unsigned long>(frame->supervisor_age_ms),
+                   static_cast<unsigned long>(frame->uptime_ms));
+}
+#endif
+
 static void print_boot_diagnostics(bool include_crash_report) {
     capture_boot_reset_flags();
     print_uptime_line();
@@ -94,8 +115,10 @@ static void print_boot_diagnostics(bool include_crash_report) {
         } else {
             console.println("CrashReport: none");
         }
+        print_watchdog_freeze_frame();
     } else {
         console.printf("CrashReport Pending: %s\n", CrashReport ? "yes" : "no");
+        console.printf("Watchdog freeze-frame: %s\n", boot_watchdog_freeze_frame() ? "yes" : "no");
     }
 #else
     (void)include_crash_report;
@@ -312,7 +335,7 @@ void print_console_help() {
                    FIRMWARE_BUILD_TIME);
     console.println("Available commands:");
     console.println("  c - close contactors");
-    console.println("  cs - configure shunt");
+    console.println("  cs - configure shunt (reboots, contactors must be open)");
     console.println("  o - open contactors");
     console.println("  s - show contactor status");
     console.println("  p - print pack status");
@@ -322,9 +345,16 @@ void print_console_help() {
     console.println("  B - print BMS status");
     console.println("  i - print current sensor status");
     console.println("  u - print uptime + boot diagnostics");
-    console.println("  r - print CrashReport (and clear it)");
+    console.println("  r - print CrashReport (and clear it) and watchdog freeze-frame");
     console.println("  P - print persistent data");
     console.println("  E idx value - set persistent data value (see 'P')");
+    console.println("  U - print usage statistics (rainflow, throughput, exposure)");
+    console.println("  L - dump black-box recorder (external EEPROM)");
+    console.println("  T - print task timing profile (Tr resets it)");
+    console.println("  S - print rate-group schedule, worst-case tick and activity profile");
+    console.println("  Y - print binary telemetry status (Y group ms sets a group period, 0 = off)");
+    console.println("  G - print all registered signals (G name, prefix or id prints matching ones)");
+    console.println("  X - CAN capture status (X t trigger, X a re-arm, X c candump / X g SavvyCAN export, X m mask)");
     console.println("  h - print this help message");
 }
 
@@ -566,6 +596,9 @@ void print_bms_status() {
                    param::C_as);
     console.printf("  soh: %.3f\n",
                    param::soh);
+    console.printf("  C_sigma: %.1fAs (%u pairs)\n",
+                   param::C_sigma_as,
+                   static_cast<unsigned>(param::cap_est_pairs));
     console.printf("  have_low_anchor: %u\n",
                    param::have_low_anchor ? 1U : 0U);
     console.printf("  q_low_as: %.1fAs\n",
@@ -580,6 +613,10 @@ void print_bms_status() {
                    param::ocv_valid ? 1U : 0U);
     console.printf("  soc_ocv: %.1f%%\n",
                    param::soc_ocv * 100.0f);
+    console.printf("  ocv_relax: converged=%u v_min_inf=%.3fV v_max_inf=%.3fV\n",
+                   param::ocv_relax_converged ? 1U : 0U,
+                   param::ocv_relax_v_min,
+                   param::ocv_relax_v_max);
 
     console.println("Current Limits:");
     console.printf("  Max Charge: %.1fA\n",
@@ -693,7 +730,399 @@ void print_persistent_data() {
     console.printf("  9: contactor_precharge_strategy = %u\n", data.contactor_precharge_strategy);
     console.printf(" 10: contactor_positive_open_current_limit_A = %.3f\n",
                    data.contactor_positive_open_current_limit_A);
-    console.println("Use 'E idx value' to update a field.");
+    console.printf(" 11: cap_c1 = %.6g\n", data.cap_c1);
+    console.printf(" 12: cap_c2 = %.6g\n", data.cap_c2);
+    console.printf(" 13: cap_c3 = %.6g\n", data.cap_c3);
+    console.printf(" 14: cap_pairs = %u\n", static_cast<unsigned>(data.cap_pairs));
+    console.println("Use 'E idx value' to update a field ('E 11 0' reseeds capacity from C_as).");
+}
+
+void print_usage_statistics() {
+    static const char *const kTempLabels[USAGE_TEMP_BINS] = {
+        "  <-20", "-20..-10", "-10..0", "0..10", "10..20",
+        "20..30", "30..40", "40..50", "50..60", "  >=60"};
+    static const char *const kCrateLabels[USAGE_CRATE_BINS] = {
+        "D >3C", "D 2-3C", "D 1-2C", "D .5-1C", "D .1-.5C",
+        "rest", "C .1-.5C", "C .5-1C", "C 1-2C", "C >2C"};
+
+    const UsageStatistics &usage = battery_manager.get_usage_statistics();
+    const UsageStatisticsData &data = usage.data();
+
+    uint32_t residue[USAGE_DOD_BINS] = {};
+    usage.residue_half_cycles(residue);
+
+    console.println("Usage statistics:");
+    console.printf("  Throughput: charge %.1fAh %.1fkWh, discharge %.1fAh %.1fkWh\n",
+                   data.charge_mAh / 1000.0f, data.charge_Wh / 1000.0f,
+                   data.discharge_mAh / 1000.0f, data.discharge_Wh / 1000.0f);
+    console.println("  Rainflow DoD [cycles] (+ open half cycles):");
+    for (uint8_t i = 0U; i < USAGE_DOD_BINS; ++i) {
+        console.printf("    %3u..%3u%%: %8.1f (+%u)\n",
+                       static_cast<unsigned>(i * 10U),
+                       static_cast<unsigned>((i + 1U) * 10U),
+                       data.dod_half_cycles[i] * 0.5f,
+                       static_cast<unsigned>(residue[i]));
+    }
+    console.printf("  Residue depth: %u, overflows: %lu\n",
+                   static_cast<unsigned>(usage.residue_depth()),
+                   static_cast<unsigned long>(usage.residue_overflows()));
+    console.println("  Time at temperature [h]:");
+    for (uint8_t i = 0U; i < USAGE_TEMP_BINS; ++i) {
+        console.printf("    %8s C: %9.2f\n", kTempLabels[i], data.temp_time_s[i] / 3600.0f);
+    }
+    console.println("  Time at C-rate [h]:");
+    for (uint8_t i = 0U; i < USAGE_CRATE_BINS; ++i) {
+        console.printf("    %9s: %9.2f\n", kCrateLabels[i], data.crate_time_s[i] / 3600.0f);
+    }
+}
+
+static void print_blackbox_record(const BlackBoxRecorder::Record &record, void *context) {
+    (void)context;
+    char line[96];
+    BlackBoxRecorder::format_record(record, line, sizeof(line));
+    console.println(line);
+}
+
+void print_blackbox() {
+    BlackBoxRecorder &blackbox = battery_manager.get_blackbox();
+    console.printf("Black-box: %s, %u records capacity, next sequence %u, %u queued\n",
+                   blackbox.online() ? (blackbox.ready() ? "ready" : "scanning") : "offline",
+                   static_cast<unsigned>(blackbox.capacity_records()),
+                   static_cast<unsigned>(blackbox.sequence()),
+                   static_cast<unsigned>(blackbox.queued_records()));
+    console.printf("  written %lu, dropped %lu, write errors %lu, worst service %lu us\n",
+                   static_cast<unsigned long>(blackbox.written_records()),
+                   static_cast<unsigned long>(blackbox.dropped_records()),
+                   static_cast<unsigned long>(blackbox.write_error_count()),
+                   static_cast<unsigned long>(blackbox.max_service_time_us()));
+    if (blackbox.start_dump(&print_blackbox_record, nullptr)) {
+        console.println("Dumping records, oldest first:");
+    } else {
+        console.println("Dump not started (offline or already dumping).");
+    }
+}
+
+void print_task_profiles() {
+    console.printf("CPU load %.1f%% (max %.1f%%)\n",
+                   get_system_load_percent(),
+                   get_system_load_max_percent());
+    console.println("Task              period    runs   min us   avg us   p99 us   max us  late us early us over miss");
+    for (const TaskProfile &profile : task_profiles) {
+        console.printf("%-16s %5lums %7lu %8.1f %8.1f %8.1f %8.1f %8.1f %8.1f %4lu %4lu\n",
+                       profile.get_name(),
+                       static_cast<unsigned long>(profile.get_period_ms()),
+                       static_cast<unsigned long>(profile.get_count()),
+                       profile.min_us(),
+                       profile.avg_us(),
+                       profile.p99_us(),
+                       profile.max_us(),
+                       profile.late_us(),
+                       profile.early_us(),
+                       static_cast<unsigned long>(profile.get_overruns()),
+                       static_cast<unsigned long>(profile.get_missed()));
+    }
+    console.println("CAN RX frame age (upper bound, arrival to decode):");
+    for (const CanRxDispatcher &bus : can_rx) {
+        const TaskProfile &age = bus.frame_age();
+        console.printf("%-16s %7lu frames  avg %8.1f us  p99 %8.1f us  max %8.1f us\n",
+                       age.get_name(),
+                       static_cast<unsigned long>(bus.frames()),
+                       age.avg_us(),
+                       age.p99_us(),
+                       age.max_us());
+    }
+    console.printf("Deferred work: %u pending, max %u, dropped %lu\n",
+                   static_cast<unsigned>(deferred_work.pending()),
+                   static_cast<unsigned>(deferred_work.max_pending()),
+                   static_cast<unsigned long>(deferred_work.dropped()));
+    console.printf("Console buffer: %u of %u bytes used, max %u, dropped %lu bytes in %lu writes\n",
+                   static_cast<unsigned>(console.get_ring().used()),
+                   static_cast<unsigned>(ConsolePrinter::kBufferBytes),
+                   static_cast<unsigned>(console.get_ring().max_used()),
+                   static_cast<unsigned long>(console.get_ring().dropped_bytes()),
+                   static_cast<unsigned long>(console.get_ring().dropped_records()));
+    const uint32_t now = millis();
+    console.printf("Watchdog: fed %lu, starved %lu\n",
+                   static_cast<unsigned long>(heartbeat_supervisor.fed()),
+                   static_cast<unsigned long>(heartbeat_supervisor.starved()));
+    for (size_t i = 0; i < heartbeat_supervisor.size(); ++i) {
+        const Heartbeat &heartbeat = heartbeat_supervisor.get(i);
+        console.printf("  %-16s last %5lums ago, deadline %5lums\n",
+                       heartbeat.name,
+                       static_cast<unsigned long>(now - heartbeat.last_ms),
+                       static_cast<unsigned long>(heartbeat.deadline_ms));
+    }
+}
+
+void print_rate_schedule() {
+    static const char *const tier_names[RATE_TIER_COUNT] = {"Real-time", "Best-effort"};
+    for (int t = 0; t < RATE_TIER_COUNT; ++t) {
+        const RateTier tier = static_cast<RateTier>(t);
+        const RateTask *tasks = nullptr;
+        const size_t count = get_rate_tasks(tier, &tasks);
+        const RateScheduleReport report = get_rate_schedule_report(tier);
+        console.printf("%s tier (1 ms base tick, hyperperiod %lu ticks)\n",
+                       tier_names[t],
+                       static_cast<unsigned long>(report.hyperperiod_ticks));
+        console.println("  Task              period offset   max us budget overruns throttled");
+        for (size_t i = 0; i < count; ++i) {
+            const RateBudget &budget = get_rate_budget(tier, i);
+            console.printf("  %-16s %6u %6u %8.1f %6lu %8lu %9lu\n",
+                           tasks[i].name,
+                           static_cast<unsigned>(tasks[i].period_ticks),
+                           static_cast<unsigned>(tasks[i].offset_ticks),
+                           (tasks[i].profile != nullptr) ? tasks[i].profile->max_us() : 0.0f,
+                           static_cast<unsigned long>(budget.budget_us),
+                           static_cast<unsigned long>(budget.overruns),
+                           static_cast<unsigned long>(budget.throttled));
+        }
+        console.printf("  Worst tick %lu: %.1f us (average %.1f us):",
+                       static_cast<unsigned long>(report.worst_tick),
+                       report.worst_us,
+                       report.average_us);
+        for (size_t i = 0; i < count; ++i) {
+            if (report.worst_tasks & (1UL << i)) {
+                console.printf(" %s", tasks[i].name);
+            }
+        }
+        console.println("");
+        const RateScheduleReport low = get_rate_schedule_report(tier, true);
+        console.printf("  Low activity: worst tick %.1f us, average %.1f us\n", low.worst_us, low.average_us);
+    }
+    const RateBudget &console_budget = get_serial_console_budget();
+    console.printf("Console commands: budget %lu us, %lu overruns, %lu throttled\n",
+                   static_cast<unsigned long>(console_budget.budget_us),
+                   static_cast<unsigned long>(console_budget.overruns),
+                   static_cast<unsigned long>(console_budget.throttled));
+    console.printf("Activity profile: %s\n", is_low_activity() ? "low (SLEEP)" : "full");
+}
+
+void print_telemetry_status() {
+    console.printf("Telemetry on SerialUSB1: %s, protocol %u, %lu bytes sent\n",
+                   telemetry.is_enabled() ? "enabled" : "disabled",
+                   static_cast<unsigned>(kTelemetryVersion),
+                   static_cast<unsigned long>(telemetry.get_bytes()));
+    console.println("  # Group         period   frame  frames skipped rejected");
+    for (int g = 0; g < TELEMETRY_GROUP_COUNT; ++g) {
+        const TelemetryGroup group = static_cast<TelemetryGroup>(g);
+        const TelemetryStream::GroupStats &stats = telemetry.get_stats(group);
+        console.printf("  %d %-12s %5ums %5uB %7lu %7lu %8lu\n",
+                       g,
+                       kTelemetryLayouts[g].name,
+                       static_cast<unsigned>(telemetry.get_period(group)),
+                       static_cast<unsigned>(telemetry_max_frame_size(group)),
+                       static_cast<unsigned long>(stats.frames),
+                       static_cast<unsigned long>(stats.skipped),
+                       static_cast<unsigned long>(stats.rejected));
+    }
+}
+
+// Y group period_ms (0 turns the group off)
+void modify_telemetry_period() {
+    char group_token[8];
+    char period_token[8];
+    if (!read_serial_token(group_token, sizeof(group_token)) || !read_serial_token(period_token, sizeof(period_token))) {
+        discard_serial_line();
+        print_telemetry_status();
+        return;
+    }
+    discard_serial_line();
+
+    const int group = atoi(group_token);
+    const long period = atol(period_token);
+    if (group < 0 || group >= TELEMETRY_GROUP_COUNT || period < 0 || period > UINT16_MAX) {
+        console.println("Usage: Y group period_ms (see 'Y').");
+        return;
+    }
+    telemetry.set_period(static_cast<TelemetryGroup>(group), static_cast<uint16_t>(period));
+    console.printf("Telemetry group %s: %s\n",
+                   kTelemetryLayouts[group].name,
+                   (period == 0) ? "off" : "on");
+}
+
+static const char *signal_value_format(const SignalInfo &info) {
+    if (info.type != SIGNAL_TYPE_F32 || info.scale >= 1.0f) {
+        return "%.0f";
+    }
+    return (info.scale >= 0.1f) ? "%.1f" : ((info.scale >= 0.01f) ? "%.2f" : "%.3f");
+}
+
+static void print_signal_value(const SignalInfo &info, float value) {
+    if (info.type == SIGNAL_TYPE_BITS) {
+        console.printf(" 0x%lX", static_cast<unsigned long>(value));
+        return;
+    }
+    console.print(" ");
+    console.printf(signal_value_format(info), static_cast<double>(value));
+}
+
+static void print_signal(SignalId id) {
+    const SignalInfo &info = kSignalInfo[id];
+    console.printf("  %3d %-28s %-4s %-4s %3u ",
+                   static_cast<int>(id),
+                   info.name,
+                   info.unit,
+                   signal_type_name(info.type),
+                   static_cast<unsigned>(info.count));
+    for (uint16_t i = 0; i < info.count; ++i) {
+        if (i != 0 && (i % 12) == 0) {
+            console.print("\n                                               ");
+        }
+        print_signal_value(info, signal_read(id, i));
+    }
+    console.println("");
+}
+
+static bool signal_matches(SignalId id, const char *token) {
+    if (isdigit(static_cast<unsigned char>(token[0]))) {
+        return atoi(token) == static_cast<int>(id);
+    }
+    return strncmp(kSignalInfo[id].name, token, strlen(token)) == 0;
+}
+
+// G [name | prefix | id]: signal registry values
+void print_signals() {
+    char token[32];
+    const bool filtered = read_serial_token(token, sizeof(token));
+    discard_serial_line();
+
+    console.println("   id Signal                       unit type   n value");
+    int printed = 0;
+    for (int id = 0; id < SIGNAL_COUNT; ++id) {
+        if (filtered && !signal_matches(static_cast<SignalId>(id), token)) {
+            continue;
+        }
+        print_signal(static_cast<SignalId>(id));
+        ++printed;
+    }
+    if (printed == 0) {
+        console.println("No matching signal (see 'G').");
+    }
+}
+
+static const char *can_capture_state_to_string(CanCapture<CAN_CAPTURE_FRAMES>::State state) {
+    switch (state) {
+        case CanCapture<CAN_CAPTURE_FRAMES>::ARMED: return "armed";
+        case CanCapture<CAN_CAPTURE_FRAMES>::POST_TRIGGER: return "post-trigger";
+        case CanCapture<CAN_CAPTURE_FRAMES>::FROZEN: return "frozen";
+        default: return "unknown";
+    }
+}
+
+static const char *const can_capture_bus_names[CAN_RX_BUS_COUNT] = {"BMS", "shunt", "battery"};
+
+void print_can_capture_status() {
+    const uint8_t mask = get_can_capture_triggers();
+    console.printf("CAN capture: %u frames per bus, %u post-trigger (max %u ms), triggers 0x%02X:",
+                   static_cast<unsigned>(CAN_CAPTURE_FRAMES),
+                   static_cast<unsigned>(CAN_CAPTURE_POST_FRAMES),
+                   static_cast<unsigned>(CAN_CAPTURE_POST_MS),
+                   static_cast<unsigned>(mask));
+    for (int t = CAN_CAPTURE_TRIGGER_MANUAL; t < CAN_CAPTURE_TRIGGER_COUNT; ++t) {
+        if (mask & (1U << t)) {
+            console.printf(" %s", can_capture_trigger_name(static_cast<CanCaptureTrigger>(t)));
+        }
+    }
+    console.println("");
+    console.println("  Bus     if     state        recorded window trigger@ cause      trigger time");
+    for (int b = 0; b < CAN_RX_BUS_COUNT; ++b) {
+        const CanCapture<CAN_CAPTURE_FRAMES> &capture = can_capture[b];
+        const bool triggered = capture.get_state() != CanCapture<CAN_CAPTURE_FRAMES>::ARMED;
+        console.printf("  %-7s %-6s %-12s %8lu %6u ",
+                       can_capture_bus_names[b],
+                       get_can_capture_interface(static_cast<CanRxBus>(b)),
+                       can_capture_state_to_string(capture.get_state()),
+                       static_cast<unsigned long>(capture.frames()),
+                       static_cast<unsigned>(capture.size()));
+        if (triggered) {
+            console.printf("%8u %-10s %.6f s\n",
+                           static_cast<unsigned>(capture.trigger_index()),
+                           can_capture_trigger_name(capture.get_trigger()),
+                           capture.get_trigger_time_us() / 1e6);
+        } else {
+            console.println("       -");
+        }
+    }
+}
+
+// Export of a frozen capture, all buses merged in time order. A few lines
+// per best-effort pass while the console ring is at most half full, so it
+// runs to the end unattended.
+static CanCaptureExport<CAN_CAPTURE_FRAMES, CAN_RX_BUS_COUNT> can_capture_export;
+static bool can_capture_export_gvret = false;
+
+static void start_can_capture_export(bool gvret) {
+    if (!is_can_capture_frozen()) {
+        console.println("CAN capture is not frozen; trigger it first (X t) or wait for the post-trigger window.");
+        return;
+    }
+    can_capture_export.start();
+    can_capture_export_gvret = gvret;
+    console.printf("CAN capture export (%s), trigger: %s\n",
+                   gvret ? "SavvyCAN GVRET CSV" : "candump -l",
+                   can_capture_trigger_name(can_capture[0].get_trigger()));
+    if (gvret) {
+        console.print(kCanCaptureGvretHeader);
+    }
+}
+
+void service_can_capture_export() {
+    static constexpr uint32_t kLinesPerPass = 32;
+    const bool done = can_capture_export.service(can_capture, kLinesPerPass, [](size_t bus, const CanCaptureRecord &record) {
+        if (console.get_ring().used() >= ConsolePrinter::kBufferBytes / 2) {
+            return false;
+        }
+        char line[96];
+        const size_t length = can_capture_export_gvret
+                                  ? can_capture_format_gvret(record, static_cast<unsigned>(bus), line, sizeof(line))
+                                  : can_capture_format_candump(record, get_can_capture_interface(static_cast<CanRxBus>(bus)), line, sizeof(line));
+        if (length != 0) {
+            console.print(line);
+        }
+        return true;
+    });
+    if (done) {
+        console.printf("CAN capture export done, %lu frames. X a re-arms.\n",
+                       static_cast<unsigned long>(can_capture_export.frames()));
+    }
+}
+
+// X: status; X t: trigger now; X a: re-arm; X c / X g: export as candump or
+// SavvyCAN GVRET CSV; X m mask: enabled triggers (bit = CanCaptureTrigger)
+void can_capture_command() {
+    char token[8];
+    char mask_token[8];
+    const bool has_token = read_serial_token(token, sizeof(token));
+    const bool has_mask = has_token && token[0] == 'm' && read_serial_token(mask_token, sizeof(mask_token));
+    discard_serial_line();
+    if (!has_token) {
+        print_can_capture_status();
+        return;
+    }
+    switch (token[0]) {
+        case 't':
+            trigger_can_capture(CAN_CAPTURE_TRIGGER_MANUAL);
+            console.println("CAN capture triggered.");
+            break;
+        case 'a':
+            can_capture_export.stop();
+            rearm_can_capture();
+            console.println("CAN capture re-armed.");
+            break;
+        case 'c':
+        case 'g':
+            start_can_capture_export(token[0] == 'g');
+            break;
+        case 'm':
+            if (has_mask) {
+                set_can_capture_triggers(static_cast<uint8_t>(strtoul(mask_token, nullptr, 0)));
+            }
+            print_can_capture_status();
+            break;
+        default:
+            console.println("Usage: X [t | a | c | g | m mask]");
+            break;
+    }
 }
 
 void modify_persistent_data() {
@@ -764,6 +1193,22 @@ void modify_persistent_data() {
             }
             data.contactor_positive_open_current_limit_A = value;
             break;
+        case 11:
+            data.cap_c1 = value;
+            break;
+        case 12:
+            data.cap_c2 = value;
+            break;
+        case 13:
+            data.cap_c3 = value;
+            break;
+        case 14:
+            if (value < 0.0f) {
+                console.println("Value must be >= 0.");
+                return;
+            }
+            data.cap_pairs = static_cast<uint16_t>(value);
+            break;
         default:
             updated = false;
             break;
@@ -780,16 +1225,51 @@ void modify_persistent_data() {
 }
 
 
+// Reboot requested by 'cs', held back until Task10Ms() has written the
+// staged persistent record and the black-box queue, or the timeout expired.
+static bool reboot_pending = false;
+static uint32_t reboot_request_ms = 0;
+
+void service_pending_reboot() {
+    static constexpr uint32_t kCommitTimeoutMs = 1000;
+    if (!reboot_pending) {
+        return;
+    }
+    const bool committed = battery_manager.storage_committed();
+    if (!committed && millis() - reboot_request_ms < kCommitTimeoutMs) {
+        return;
+    }
+    reboot_pending = false;
+    console.println(committed ? "Rebooting to configure shunt..."
+                              : "Storage not committed in time, rebooting to configure shunt...");
+    console.flush(50); // well inside the watchdog timeout
+    request_reboot(BOOT_REQUEST_CONFIGURE_SHUNT);
+}
+
 void serial_console() {
+    if (reboot_pending) {
+        // No commands between the request and the reset
+        while (Serial.available()) {
+            Serial.read();
+        }
+        return;
+    }
     while (Serial.available()) {
         char cmd = Serial.read();
         switch (cmd) {
             case 'c':
                 if (Serial.available() && Serial.peek() == 's') {
                     Serial.read();
-                    console.println("Configuring shunt...");
-                    const bool ok = shunt.configure_shunt();
-                    console.println(ok ? "Shunt configured." : "Shunt configuration failed.");
+                    // configure_shunt() blocks for seconds and would starve
+                    // the watchdog; it runs in setup() after a reboot.
+                    if (contactor_manager.getState() != Contactormanager::OPEN) {
+                        console.println("Open the contactors before configuring the shunt.");
+                    } else {
+                        console.println("Writing persistent data and black box before the reboot...");
+                        battery_manager.prepare_for_reset();
+                        reboot_pending = true;
+                        reboot_request_ms = millis();
+                    }
                 } else {
                     console.println("Closing contactors...");
                     contactor_manager.close();
@@ -861,6 +1341,33 @@ void serial_console() {
             case 'E':
                 modify_persistent_data();
                 break;
+            case 'U':
+                print_usage_statistics();
+                break;
+            case 'L':
+                print_blackbox();
+                break;
+            case 'T':
+                if (Serial.available() && Serial.peek() == 'r') {
+                    Serial.read();
+                    reset_task_profiles();
+                    console.println("Task profiles reset.");
+                } else {
+                    print_task_profiles();
+                }
+                break;
+            case 'S':
+                print_rate_schedule();
+                break;
+            case 'X':
+                can_capture_command();
+                break;
+            case 'G':
+                print_signals();
+                break;
+            case 'Y':
+                modify_telemetry_period();
+                break;
             case 'B':
                 print_bms_status();
                 break;
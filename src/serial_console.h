@@ -16,5 +16,16 @@ void print_bms_status();
 void print_shunt_status();
 void print_persistent_data();
 void modify_persistent_data();
+void print_usage_statistics();
+void print_blackbox();
+void print_task_profiles();
+void print_rate_schedule();
+void print_signals();
+void print_can_capture_status();
+void can_capture_command();
+void service_can_capture_export();
+void service_pending_reboot();
+void print_telemetry_status();
+void modify_telemetry_period();
 
 #endif // SERIAL_CONSOLE_H
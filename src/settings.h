@@ -77,6 +77,9 @@
 #define BMS_MSG_SOC 0x41D
 #define BMS_MSG_HMI 0x41E
 #define BMS_MSG_CONTACTOR_TELEMETRY 0x601
+#define BMS_BLACKBOX_DUMP_REQUEST_ID 0x438 // data[0] == 1 starts a black-box dump
+#define BMS_MSG_BLACKBOX_DUMP 0x602        // record bytes 0..7, bytes 8..15 on BMS_MSG_BLACKBOX_DUMP + 1
+#define BMS_MSG_TASK_PROFILE 0x604         // per-task timing, muxed by data[0] (task | page << 7)
 #define BMS_VCU_TIMEOUT 300
 
 #define BMS_ENERGY_AVG_WINDOW_SEC 60.0f
@@ -86,6 +89,14 @@
 
 // Enhanced Coulomb Counting constants live in bms/coulomb_counting.h
 
+// Black-box recorder on the external AT24C I2C EEPROM (blackbox_recorder.h)
+#define BLACKBOX_I2C_ADDRESS 0x50
+#define BLACKBOX_ADDRESS_BYTES 2
+#define BLACKBOX_DEVICE_BYTES 4096UL        // AT24C32
+#define BLACKBOX_PAGE_BYTES 32
+#define BLACKBOX_SNAPSHOT_PERIOD_MS 10000UL
+#define BLACKBOX_LIMIT_DEADBAND_A 5.0f      // limit change that is recorded
+
 //BMW i3 Specs from Samsung SDI document
 #define SAFETY_LIMIT_CHARGE 4.25
 #define SAFETY_LIMIT_DISCHARGE 1.5
@@ -133,6 +144,34 @@
 #define BALANCE_MAX_TEMP     50.0f    // Do not balance above this temperature (°C)
 #define BALANCE_OFFSET_V     0.03f   // Offset added to lowest cell voltage for target (V)
 
+// -----------------------------------------------------------------------------
+// Low-activity profile (vehicle state SLEEP, contactors open, no balancing)
+// -----------------------------------------------------------------------------
+#define LOW_ACTIVITY_POLL_DIVIDER      10 // CMU poll on every 10th 13 ms slot, about 1 s per module cycle
+#define LOW_ACTIVITY_BMS_100MS_DIVIDER 10 // state machine, status and limit frames once per second
+#define LOW_ACTIVITY_CPU_CLOCK_HZ      0  // core clock while in the profile, e.g. 150000000; 0 keeps F_CPU
+
+// -----------------------------------------------------------------------------
+// Binary telemetry on SerialUSB1 (telemetry_stream.h), period per group in ms,
+// multiples of TELEMETRY_TICK_MS; 0 turns a group off. Changed at run time
+// with the 'Y' console command.
+// -----------------------------------------------------------------------------
+#define TELEMETRY_TICK_MS              10
+#define TELEMETRY_CELL_VOLTAGES_PERIOD 100  // 96 cell voltages, ~210 bytes per frame
+#define TELEMETRY_TEMPERATURES_PERIOD  1000
+#define TELEMETRY_SHUNT_PERIOD         10   // IVT-S results
+#define TELEMETRY_LIMITS_PERIOD        100  // current limits, SoC, cell extremes
+#define TELEMETRY_STATES_PERIOD        100  // BMS, contactor, pack and module states and DTCs
+
+// -----------------------------------------------------------------------------
+// Raw CAN capture per bus (utils/can_capture.h). A trigger freezes every bus
+// after its post-trigger window; 'X' exports and re-arms.
+// -----------------------------------------------------------------------------
+#define CAN_CAPTURE_FRAMES      512 // per bus, power of two, 20 bytes each
+#define CAN_CAPTURE_POST_FRAMES 128 // post-trigger window, the rest is pre-trigger
+#define CAN_CAPTURE_POST_MS     200 // ends the window early on a silent bus
+#define CAN_CAPTURE_TRIGGERS    ((1U << CAN_CAPTURE_TRIGGER_DTC) | (1U << CAN_CAPTURE_TRIGGER_CRC) | (1U << CAN_CAPTURE_TRIGGER_TIMEOUT))
+
 
 
 
@@ -160,7 +199,7 @@
 
 // #define BALANCE_INTERVAL 1200                       // number of seconds between balancing sessions
 
-// #define WATCHDOG_TIMEOUT 150 // Set the watchdog timeout in milliseconds
+#define WATCHDOG_TIMEOUT 150 // Set the watchdog timeout in milliseconds, counted from the last feed
 
 
 #endif
@@ -0,0 +1,35 @@
+#include "signal_registry.h"
+
+#include <type_traits>
+
+#include "comms_bms.h"
+#include "bms/coulomb_counting.h"
+#include "bms/hv_monitor.h"
+
+template <typename T>
+static inline float signal_value(T value)
+{
+    if constexpr (std::is_enum<T>::value)
+    {
+        return static_cast<float>(static_cast<typename std::underlying_type<T>::type>(value));
+    }
+    else
+    {
+        return static_cast<float>(value);
+    }
+}
+
+#define SIGNAL_READER(id, name, unit, type, scale, count, read) \
+    static float read_##id(uint16_t i)                          \
+    {                                                           \
+        (void)i;                                                \
+        return signal_value(read);                              \
+    }
+SIGNAL_LIST(SIGNAL_READER)
+#undef SIGNAL_READER
+
+const SignalReader signal_readers[SIGNAL_COUNT] = {
+#define SIGNAL_READER_ENTRY(id, name, unit, type, scale, count, read) &read_##id,
+    SIGNAL_LIST(SIGNAL_READER_ENTRY)
+#undef SIGNAL_READER_ENTRY
+};
@@ -0,0 +1,163 @@
+#ifndef SIGNAL_REGISTRY_H
+#define SIGNAL_REGISTRY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "settings.h"
+
+// Central list of the live values: param:: variables, BMS getters and the
+// per-module arrays. Each entry is
+//
+//   X(ID, name, unit, type, scale, count, read)
+//
+// scale is the resolution used when the value is packed as an integer (1 for
+// integer signals). count > 1 makes an array signal; read is the accessor
+// expression with the element index in i. It is only expanded in
+// signal_registry.cpp, so this header (names, units, IDs) builds on the host
+// without the BMS objects.
+#define SIGNAL_LIST(X) \
+    X(PACK_VOLTAGE, "pack_voltage", "V", SIGNAL_TYPE_F32, 0.01f, 1, batteryPack.get_pack_voltage()) \
+    X(CELL_VOLTAGE_MIN, "cell_voltage_min", "V", SIGNAL_TYPE_F32, 0.001f, 1, batteryPack.get_lowest_cell_voltage()) \
+    X(CELL_VOLTAGE_MAX, "cell_voltage_max", "V", SIGNAL_TYPE_F32, 0.001f, 1, batteryPack.get_highest_cell_voltage()) \
+    X(CELL_VOLTAGE_DELTA, "cell_voltage_delta", "V", SIGNAL_TYPE_F32, 0.001f, 1, batteryPack.get_delta_cell_voltage()) \
+    X(TEMPERATURE_MIN, "temperature_min", "degC", SIGNAL_TYPE_F32, 0.1f, 1, batteryPack.get_lowest_temperature()) \
+    X(TEMPERATURE_MAX, "temperature_max", "degC", SIGNAL_TYPE_F32, 0.1f, 1, batteryPack.get_highest_temperature()) \
+    X(TEMPERATURE_AVG, "temperature_avg", "degC", SIGNAL_TYPE_F32, 0.1f, 1, batteryPack.get_average_temperature()) \
+    X(BALANCING_ACTIVE, "balancing_active", "", SIGNAL_TYPE_BOOL, 1.0f, 1, batteryPack.get_balancing_active()) \
+    X(BALANCING_VOLTAGE, "balancing_voltage", "V", SIGNAL_TYPE_F32, 0.001f, 1, batteryPack.get_balancing_voltage()) \
+    X(PACK_STATE, "pack_state", "", SIGNAL_TYPE_ENUM, 1.0f, 1, batteryPack.getState()) \
+    X(PACK_DTC, "pack_dtc", "", SIGNAL_TYPE_BITS, 1.0f, 1, batteryPack.getDTC()) \
+    X(CELL_VOLTAGE, "cell_voltage", "V", SIGNAL_TYPE_F32, 0.001f, MODULES_PER_PACK * CELLS_PER_MODULE, batteryPack.modules[i / CELLS_PER_MODULE].get_cell_voltage(i % CELLS_PER_MODULE)) \
+    X(CELL_BALANCING, "cell_balancing", "", SIGNAL_TYPE_BOOL, 1.0f, MODULES_PER_PACK * CELLS_PER_MODULE, batteryPack.modules[i / CELLS_PER_MODULE].get_balancing(i % CELLS_PER_MODULE)) \
+    X(MODULE_TEMPERATURE, "module_temperature", "degC", SIGNAL_TYPE_F32, 0.1f, MODULES_PER_PACK * TEMPS_PER_MODULE, batteryPack.modules[i / TEMPS_PER_MODULE].get_temperature(i % TEMPS_PER_MODULE)) \
+    X(MODULE_INTERNAL_TEMPERATURE, "module_internal_temperature", "degC", SIGNAL_TYPE_F32, 0.1f, MODULES_PER_PACK, batteryPack.modules[i].get_internal_temperature()) \
+    X(MODULE_STATE, "module_state", "", SIGNAL_TYPE_ENUM, 1.0f, MODULES_PER_PACK, batteryPack.modules[i].getState()) \
+    X(MODULE_DTC, "module_dtc", "", SIGNAL_TYPE_BITS, 1.0f, MODULES_PER_PACK, batteryPack.modules[i].getDTC()) \
+    X(MODULE_CRC_FAILURES, "module_crc_failures", "", SIGNAL_TYPE_U8, 1.0f, MODULES_PER_PACK, batteryPack.modules[i].get_crc_failure_count()) \
+    X(SHUNT_CURRENT, "shunt_current", "A", SIGNAL_TYPE_F32, 0.001f, 1, param::current) \
+    X(SHUNT_CURRENT_AVG, "shunt_current_avg", "A", SIGNAL_TYPE_F32, 0.001f, 1, param::current_avg) \
+    X(SHUNT_CURRENT_SLEW, "shunt_current_slew", "dA/s", SIGNAL_TYPE_F32, 0.1f, 1, param::current_dA_per_s) \
+    X(SHUNT_U_INPUT, "shunt_u_input_hvbox", "V", SIGNAL_TYPE_F32, 0.001f, 1, param::u_input_hvbox) \
+    X(SHUNT_U_OUTPUT, "shunt_u_output_hvbox", "V", SIGNAL_TYPE_F32, 0.001f, 1, param::u_output_hvbox) \
+    X(SHUNT_U3, "shunt_u3", "V", SIGNAL_TYPE_F32, 0.001f, 1, param::u3) \
+    X(SHUNT_TEMPERATURE, "shunt_temperature", "degC", SIGNAL_TYPE_F32, 0.1f, 1, param::temp) \
+    X(SHUNT_POWER, "shunt_power", "W", SIGNAL_TYPE_F32, 1.0f, 1, param::power) \
+    X(SHUNT_CHARGE, "shunt_charge", "As", SIGNAL_TYPE_F32, 1.0f, 1, param::as) \
+    X(SHUNT_ENERGY, "shunt_energy", "Wh", SIGNAL_TYPE_F32, 1.0f, 1, param::wh) \
+    X(SHUNT_STATE, "shunt_state", "", SIGNAL_TYPE_ENUM, 1.0f, 1, param::state) \
+    X(SHUNT_DTC, "shunt_dtc", "", SIGNAL_TYPE_BITS, 1.0f, 1, param::dtc) \
+    X(CC_BIAS, "cc_bias", "As", SIGNAL_TYPE_F32, 0.01f, 1, param::b_as) \
+    X(CC_CAPACITY, "cc_capacity", "As", SIGNAL_TYPE_F32, 1.0f, 1, param::C_as) \
+    X(CC_CAPACITY_SIGMA, "cc_capacity_sigma", "As", SIGNAL_TYPE_F32, 1.0f, 1, param::C_sigma_as) \
+    X(CC_CAPACITY_PAIRS, "cc_capacity_pairs", "", SIGNAL_TYPE_U16, 1.0f, 1, param::cap_est_pairs) \
+    X(CC_SOH, "cc_soh", "", SIGNAL_TYPE_F32, 0.001f, 1, param::soh) \
+    X(CC_CHARGE, "cc_charge", "As", SIGNAL_TYPE_F32, 1.0f, 1, param::q_as) \
+    X(CC_SOC_OCV, "cc_soc_ocv", "", SIGNAL_TYPE_F32, 0.001f, 1, param::soc_ocv) \
+    X(CC_SOC, "cc_soc", "", SIGNAL_TYPE_F32, 0.001f, 1, param::soc_cc) \
+    X(CC_OCV_VALID, "cc_ocv_valid", "", SIGNAL_TYPE_BOOL, 1.0f, 1, param::ocv_valid) \
+    X(CC_OCV_RELAX_CONVERGED, "cc_ocv_relax_converged", "", SIGNAL_TYPE_BOOL, 1.0f, 1, param::ocv_relax_converged) \
+    X(CC_STATE, "cc_state", "", SIGNAL_TYPE_ENUM, 1.0f, 1, param::coulomb_state) \
+    X(HVM_VOLTAGE_MATCHED, "hvm_voltage_matched", "", SIGNAL_TYPE_BOOL, 1.0f, 1, param::voltage_matched) \
+    X(HVM_DELTA_VOLTAGE, "hvm_delta_voltage", "V", SIGNAL_TYPE_F32, 0.01f, 1, param::hv_monitor_delta_voltage) \
+    X(HVM_STATE, "hvm_state", "", SIGNAL_TYPE_ENUM, 1.0f, 1, param::hv_monitor_state) \
+    X(HVM_DTC, "hvm_dtc", "", SIGNAL_TYPE_BITS, 1.0f, 1, param::hv_monitor_dtc) \
+    X(BMS_STATE, "bms_state", "", SIGNAL_TYPE_ENUM, 1.0f, 1, battery_manager.get_state()) \
+    X(BMS_DTC, "bms_dtc", "", SIGNAL_TYPE_BITS, 1.0f, 1, battery_manager.get_dtc()) \
+    X(VEHICLE_STATE, "vehicle_state", "", SIGNAL_TYPE_ENUM, 1.0f, 1, battery_manager.get_vehicle_state()) \
+    X(READY_TO_SHUTDOWN, "ready_to_shutdown", "", SIGNAL_TYPE_BOOL, 1.0f, 1, battery_manager.get_ready_to_shutdown()) \
+    X(VCU_TIMEOUT, "vcu_timeout", "", SIGNAL_TYPE_BOOL, 1.0f, 1, battery_manager.get_vcu_timeout()) \
+    X(LOW_ACTIVITY, "low_activity", "", SIGNAL_TYPE_BOOL, 1.0f, 1, is_low_activity()) \
+    X(SOC, "soc", "%", SIGNAL_TYPE_F32, 0.01f, 1, battery_manager.get_soc()) \
+    X(SOC_OCV_LUT, "soc_ocv_lut", "%", SIGNAL_TYPE_F32, 0.01f, 1, battery_manager.get_soc_ocv_lut()) \
+    X(SOC_COULOMB_COUNTING, "soc_coulomb_counting", "%", SIGNAL_TYPE_F32, 0.01f, 1, battery_manager.get_soc_coulomb_counting()) \
+    X(MAX_CHARGE_CURRENT, "max_charge_current", "A", SIGNAL_TYPE_F32, 0.1f, 1, battery_manager.get_max_charge_current()) \
+    X(MAX_DISCHARGE_CURRENT, "max_discharge_current", "A", SIGNAL_TYPE_F32, 0.1f, 1, battery_manager.get_max_discharge_current()) \
+    X(LIMIT_PEAK_DISCHARGE, "limit_peak_discharge", "A", SIGNAL_TYPE_F32, 0.1f, 1, battery_manager.get_current_limit_peak_discharge()) \
+    X(LIMIT_RMS_DISCHARGE, "limit_rms_discharge", "A", SIGNAL_TYPE_F32, 0.1f, 1, battery_manager.get_current_limit_rms_discharge()) \
+    X(LIMIT_PEAK_CHARGE, "limit_peak_charge", "A", SIGNAL_TYPE_F32, 0.1f, 1, battery_manager.get_current_limit_peak_charge()) \
+    X(LIMIT_RMS_CHARGE, "limit_rms_charge", "A", SIGNAL_TYPE_F32, 0.1f, 1, battery_manager.get_current_limit_rms_charge()) \
+    X(LIMIT_RMS_DERATED_DISCHARGE, "limit_rms_derated_discharge", "A", SIGNAL_TYPE_F32, 0.1f, 1, battery_manager.get_current_limit_rms_derated_discharge()) \
+    X(LIMIT_RMS_DERATED_CHARGE, "limit_rms_derated_charge", "A", SIGNAL_TYPE_F32, 0.1f, 1, battery_manager.get_current_limit_rms_derated_charge()) \
+    X(CONTACTOR_STATE, "contactor_state", "", SIGNAL_TYPE_ENUM, 1.0f, 1, contactor_manager.getState()) \
+    X(CONTACTOR_DTC, "contactor_dtc", "", SIGNAL_TYPE_BITS, 1.0f, 1, contactor_manager.getDTC())
+
+enum SignalId
+{
+#define SIGNAL_ENUM_ENTRY(id, name, unit, type, scale, count, read) SIGNAL_##id,
+    SIGNAL_LIST(SIGNAL_ENUM_ENTRY)
+#undef SIGNAL_ENUM_ENTRY
+    SIGNAL_COUNT
+};
+
+enum SignalType : uint8_t
+{
+    SIGNAL_TYPE_BOOL,
+    SIGNAL_TYPE_ENUM, // state enumerations
+    SIGNAL_TYPE_BITS, // DTC bit masks
+    SIGNAL_TYPE_U8,
+    SIGNAL_TYPE_U16,
+    SIGNAL_TYPE_F32,
+};
+
+struct SignalInfo
+{
+    const char *name;
+    const char *unit;
+    SignalType type;
+    uint16_t count;
+    float scale;
+};
+
+// Metadata by SignalId, in flash
+static constexpr SignalInfo kSignalInfo[SIGNAL_COUNT] = {
+#define SIGNAL_INFO_ENTRY(id, name, unit, type, scale, count, read) {name, unit, type, count, scale},
+    SIGNAL_LIST(SIGNAL_INFO_ENTRY)
+#undef SIGNAL_INFO_ENTRY
+};
+
+// Element i of the signal as a float. Integer signals are exact up to 2^24.
+typedef float (*SignalReader)(uint16_t i);
+
+// Accessors by SignalId (signal_registry.cpp)
+extern const SignalReader signal_readers[SIGNAL_COUNT];
+
+inline float signal_read(SignalId id, uint16_t index = 0U)
+{
+    return (index < kSignalInfo[id].count) ? signal_readers[id](index) : 0.0f;
+}
+
+inline const char *signal_type_name(SignalType type)
+{
+    switch (type)
+    {
+    case SIGNAL_TYPE_BOOL:
+        return "bool";
+    case SIGNAL_TYPE_ENUM:
+        return "enum";
+    case SIGNAL_TYPE_BITS:
+        return "bits";
+    case SIGNAL_TYPE_U8:
+        return "u8";
+    case SIGNAL_TYPE_U16:
+        return "u16";
+    default:
+        return "f32";
+    }
+}
+
+constexpr bool signal_name_equal(const char *a, const char *b)
+{
+    return (*a == *b) && ((*a == '\0') || signal_name_equal(a + 1, b + 1));
+}
+
+// SignalId of a name, SIGNAL_COUNT if there is none. Linear, for the console
+// and for compile-time lookups; consumers keep the SignalId.
+constexpr SignalId signal_find(const char *name, size_t id = 0U)
+{
+    return (id >= SIGNAL_COUNT)                           ? SIGNAL_COUNT
+           : signal_name_equal(kSignalInfo[id].name, name) ? static_cast<SignalId>(id)
+                                                           : signal_find(name, id + 1U);
+}
+
+#endif // SIGNAL_REGISTRY_H
@@ -0,0 +1,108 @@
+#include "telemetry_stream.h"
+
+#include "comms_bms.h"
+
+// Samplers read the live values in layout order (utils/telemetry_protocol.h)
+
+static void sample_cell_voltages(TelemetryFrameWriter &writer)
+{
+    writer.put(batteryPack.get_pack_voltage());
+    writer.begin_blocks(MODULES_PER_PACK);
+    for (BatteryModule &module : batteryPack.modules)
+    {
+        for (byte c = 0; c < CELLS_PER_MODULE; c++)
+        {
+            writer.put(module.get_cell_voltage(c));
+        }
+    }
+}
+
+static void sample_temperatures(TelemetryFrameWriter &writer)
+{
+    writer.begin_blocks(MODULES_PER_PACK);
+    for (BatteryModule &module : batteryPack.modules)
+    {
+        for (byte t = 0; t < TEMPS_PER_MODULE; t++)
+        {
+            writer.put(module.get_temperature(t));
+        }
+        writer.put(module.get_internal_temperature());
+    }
+}
+
+static void sample_shunt(TelemetryFrameWriter &writer)
+{
+    writer.put(param::current);
+    writer.put(param::current_avg);
+    writer.put(param::u_input_hvbox);
+    writer.put(param::u_output_hvbox);
+    writer.put(param::u3);
+    writer.put(param::temp);
+    writer.put(param::power);
+    writer.put(param::as);
+    writer.put(param::wh);
+    writer.put_raw(static_cast<int32_t>(param::state));
+    writer.put_raw(static_cast<int32_t>(param::dtc));
+}
+
+static void sample_limits(TelemetryFrameWriter &writer)
+{
+    writer.put(battery_manager.get_max_charge_current());
+    writer.put(battery_manager.get_max_discharge_current());
+    writer.put(battery_manager.get_current_limit_peak_discharge());
+    writer.put(battery_manager.get_current_limit_rms_discharge());
+    writer.put(battery_manager.get_current_limit_peak_charge());
+    writer.put(battery_manager.get_current_limit_rms_charge());
+    writer.put(battery_manager.get_current_limit_rms_derated_discharge());
+    writer.put(battery_manager.get_current_limit_rms_derated_charge());
+    writer.put(battery_manager.get_soc());
+    writer.put(battery_manager.get_soc_ocv_lut());
+    writer.put(battery_manager.get_soc_coulomb_counting());
+    writer.put(batteryPack.get_lowest_cell_voltage());
+    writer.put(batteryPack.get_highest_cell_voltage());
+    writer.put(batteryPack.get_lowest_temperature());
+    writer.put(batteryPack.get_highest_temperature());
+}
+
+static void sample_states(TelemetryFrameWriter &writer)
+{
+    writer.put_raw(battery_manager.get_state());
+    writer.put_raw(battery_manager.get_dtc());
+    writer.put_raw(battery_manager.get_vehicle_state());
+    writer.put_raw(contactor_manager.getState());
+    writer.put_raw(batteryPack.getState());
+    writer.put_raw(static_cast<int32_t>(param::state));
+    writer.put_raw(batteryPack.get_balancing_active() ? 1 : 0);
+    writer.put_raw(is_low_activity() ? 1 : 0);
+    writer.begin_blocks(MODULES_PER_PACK);
+    for (BatteryModule &module : batteryPack.modules)
+    {
+        uint16_t balancing = 0;
+        for (byte c = 0; c < CELLS_PER_MODULE; c++)
+        {
+            balancing |= module.get_balancing(c) ? (1U << c) : 0U;
+        }
+        writer.put_raw(module.getState());
+        writer.put_raw(module.getDTC());
+        writer.put_raw(module.get_crc_failure_count());
+        writer.put_raw(balancing);
+    }
+}
+
+static const TelemetryStream::Sample telemetry_samplers[TELEMETRY_GROUP_COUNT] = {
+    &sample_cell_voltages,
+    &sample_temperatures,
+    &sample_shunt,
+    &sample_limits,
+    &sample_states,
+};
+
+static const uint16_t telemetry_periods_ms[TELEMETRY_GROUP_COUNT] = {
+    TELEMETRY_CELL_VOLTAGES_PERIOD,
+    TELEMETRY_TEMPERATURES_PERIOD,
+    TELEMETRY_SHUNT_PERIOD,
+    TELEMETRY_LIMITS_PERIOD,
+    TELEMETRY_STATES_PERIOD,
+};
+
+TelemetryStream telemetry(telemetry_samplers, telemetry_periods_ms);
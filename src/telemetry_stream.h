@@ -0,0 +1,327 @@
+#ifndef TELEMETRY_STREAM_H
+#define TELEMETRY_STREAM_H
+
+#include <Arduino.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "utils/cobs.h"
+#include "utils/crc32.h"
+#include "utils/telemetry_protocol.h"
+
+// Writes one telemetry frame (see utils/telemetry_protocol.h) straight into
+// its COBS encoded output: values go from the getters through the layout's
+// scale and the running CRC into the output buffer, with no staging copy.
+//
+// put() takes the fields in layout order as physical values; they are
+// rounded to the layout resolution and clamped to the field type.
+// put_raw() stores an integer as is (states, DTC and bit masks). A frame
+// whose values do not match its layout is rejected by finish().
+class TelemetryFrameWriter
+{
+public:
+    void begin(uint8_t *out, size_t capacity, TelemetryGroup _group, uint16_t sequence, uint32_t time_us)
+    {
+        layout = &kTelemetryLayouts[_group];
+        encoder.begin(out, capacity);
+        crc = 0U;
+        in_blocks = false;
+        blocks_left = 0U;
+        field = 0U;
+        repeat = 0U;
+        valid = true;
+        emit_byte(kTelemetryVersion);
+        emit_byte(static_cast<uint8_t>(_group));
+        emit(sequence, 2U);
+        emit(time_us, 4U);
+    }
+
+    void put(float value)
+    {
+        const TelemetryField *f = next_field();
+        if (f == nullptr)
+        {
+            return;
+        }
+        emit_scaled(*f, value / f->scale);
+    }
+
+    void put_raw(int32_t value)
+    {
+        const TelemetryField *f = next_field();
+        if (f == nullptr)
+        {
+            return;
+        }
+        emit_raw(*f, value);
+    }
+
+    // After the fields: the number of blocks that follow
+    void begin_blocks(uint8_t count)
+    {
+        if (layout->block_fields == nullptr || in_blocks || field != layout->field_count || count > layout->max_blocks)
+        {
+            valid = false;
+            return;
+        }
+        emit_byte(count);
+        in_blocks = true;
+        blocks_left = count;
+        field = 0U;
+        repeat = 0U;
+    }
+
+    // Appends the CRC and the delimiter. Returns the encoded frame size, 0
+    // if the values did not match the layout or the buffer was too small.
+    size_t finish()
+    {
+        const bool complete = in_blocks ? (blocks_left == 0U)
+                                        : (field == layout->field_count && layout->block_fields == nullptr);
+        if (!valid || !complete)
+        {
+            return 0U;
+        }
+        const uint32_t frame_crc = crc;
+        for (size_t i = 0; i < kTelemetryCrcBytes; ++i)
+        {
+            encoder.put(static_cast<uint8_t>(frame_crc >> (8U * i)));
+        }
+        return encoder.finish();
+    }
+
+private:
+    const TelemetryLayout *layout = &kTelemetryLayouts[0];
+    CobsEncoder encoder;
+    uint32_t crc = 0U;
+    bool in_blocks = false;
+    uint8_t blocks_left = 0U;
+    uint8_t field = 0U;  // index into the fields (or block fields)
+    uint8_t repeat = 0U; // values of the current field already written
+    bool valid = true;
+
+    const TelemetryField *next_field()
+    {
+        const TelemetryField *fields = in_blocks ? layout->block_fields : layout->fields;
+        const uint8_t count = in_blocks ? layout->block_field_count : layout->field_count;
+        if (field >= count || (in_blocks && blocks_left == 0U))
+        {
+            valid = false;
+            return nullptr;
+        }
+        const TelemetryField *f = &fields[field];
+        if (++repeat == f->count)
+        {
+            repeat = 0U;
+            if (++field == count && in_blocks)
+            {
+                field = 0U;
+                --blocks_left;
+            }
+        }
+        return f;
+    }
+
+    static void limits(TelemetryType type, int32_t *low, int32_t *high)
+    {
+        switch (type)
+        {
+        case TELEMETRY_U8:
+            *low = 0;
+            *high = UINT8_MAX;
+            break;
+        case TELEMETRY_I8:
+            *low = INT8_MIN;
+            *high = INT8_MAX;
+            break;
+        case TELEMETRY_U16:
+            *low = 0;
+            *high = UINT16_MAX;
+            break;
+        case TELEMETRY_I16:
+            *low = INT16_MIN;
+            *high = INT16_MAX;
+            break;
+        case TELEMETRY_U32:
+            *low = 0;
+            *high = INT32_MAX;
+            break;
+        default:
+            *low = INT32_MIN;
+            *high = INT32_MAX;
+            break;
+        }
+    }
+
+    // value in units of the field resolution
+    void emit_scaled(const TelemetryField &f, float value)
+    {
+        int32_t low = 0;
+        int32_t high = 0;
+        limits(f.type, &low, &high);
+        int32_t raw = 0;
+        if (!isfinite(value))
+        {
+            raw = 0;
+        }
+        else if (value <= static_cast<float>(low))
+        {
+            raw = low;
+        }
+        else if (value >= static_cast<float>(high))
+        {
+            raw = high;
+        }
+        else
+        {
+            raw = static_cast<int32_t>(lroundf(value));
+        }
+        emit(static_cast<uint32_t>(raw), telemetry_type_size(f.type));
+    }
+
+    void emit_raw(const TelemetryField &f, int32_t value)
+    {
+        int32_t low = 0;
+        int32_t high = 0;
+        limits(f.type, &low, &high);
+        value = (value < low) ? low : ((value > high) ? high : value);
+        emit(static_cast<uint32_t>(value), telemetry_type_size(f.type));
+    }
+
+    void emit(uint32_t value, size_t size)
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            emit_byte(static_cast<uint8_t>(value >> (8U * i)));
+        }
+    }
+
+    void emit_byte(uint8_t value)
+    {
+        crc = crc32_ieee(&value, 1U, crc);
+        encoder.put(value);
+    }
+};
+
+// Samples the groups at their periods and writes each as one frame.
+//
+// Flow control: a frame is only built when the port has room for the
+// group's largest encoded frame, so write() never waits for the host. A
+// slot without room is skipped and counted; the sequence still advances so
+// the decoder sees the gap. A late service() call sends a group once and
+// moves its next slot past now instead of sending a burst.
+class TelemetryStream
+{
+public:
+    typedef void (*Sample)(TelemetryFrameWriter &writer);
+
+    static constexpr size_t kFrameBufferBytes = telemetry_largest_frame_size();
+
+    struct GroupStats
+    {
+        uint32_t frames;
+        uint32_t skipped; // slots without room in the port
+        uint32_t rejected; // sampler did not match the layout
+    };
+
+    // samplers[g] writes the values of group g; nullptr disables it
+    TelemetryStream(const Sample (&_samplers)[TELEMETRY_GROUP_COUNT], const uint16_t (&periods_ms)[TELEMETRY_GROUP_COUNT])
+        : samplers(_samplers)
+    {
+        for (size_t g = 0; g < TELEMETRY_GROUP_COUNT; ++g)
+        {
+            groups[g].period_ms = periods_ms[g];
+        }
+    }
+
+    void begin(Print &_port)
+    {
+        port = &_port;
+    }
+    bool is_enabled() const { return port != nullptr; }
+
+    // 0 turns the group off. Takes effect at once.
+    void set_period(TelemetryGroup group, uint16_t period_ms)
+    {
+        groups[group].period_ms = period_ms;
+        groups[group].due = false;
+    }
+    uint16_t get_period(TelemetryGroup group) const { return groups[group].period_ms; }
+
+    // Returns the number of bytes written.
+    size_t service(uint32_t now_ms, uint32_t now_us)
+    {
+        if (port == nullptr)
+        {
+            return 0U;
+        }
+        size_t written = 0U;
+        for (size_t g = 0; g < TELEMETRY_GROUP_COUNT; ++g)
+        {
+            Group &group = groups[g];
+            if (group.period_ms == 0U || samplers[g] == nullptr)
+            {
+                continue;
+            }
+            if (!group.due)
+            {
+                group.next_ms = now_ms;
+                group.due = true;
+            }
+            if (static_cast<int32_t>(now_ms - group.next_ms) < 0)
+            {
+                continue;
+            }
+            group.next_ms += group.period_ms;
+            if (static_cast<int32_t>(now_ms - group.next_ms) >= 0)
+            {
+                group.next_ms = now_ms + group.period_ms;
+            }
+
+            const TelemetryGroup id = static_cast<TelemetryGroup>(g);
+            const uint16_t sequence = group.sequence++;
+            if (port->availableForWrite() < static_cast<int>(telemetry_max_frame_size(id)))
+            {
+                ++group.stats.skipped;
+                continue;
+            }
+            writer.begin(frame, sizeof(frame), id, sequence, now_us);
+            samplers[g](writer);
+            const size_t size = writer.finish();
+            if (size == 0U)
+            {
+                ++group.stats.rejected;
+                continue;
+            }
+            port->write(frame, size);
+            ++group.stats.frames;
+            written += size;
+        }
+        bytes += written;
+        return written;
+    }
+
+    const GroupStats &get_stats(TelemetryGroup group) const { return groups[group].stats; }
+    uint32_t get_bytes() const { return bytes; }
+
+private:
+    struct Group
+    {
+        uint16_t period_ms = 0U;
+        uint16_t sequence = 0U;
+        bool due = false;
+        uint32_t next_ms = 0U;
+        GroupStats stats = {0U, 0U, 0U};
+    };
+
+    const Sample (&samplers)[TELEMETRY_GROUP_COUNT];
+    Print *port = nullptr;
+    Group groups[TELEMETRY_GROUP_COUNT];
+    TelemetryFrameWriter writer;
+    uint32_t bytes = 0U;
+    uint8_t frame[kFrameBufferBytes];
+};
+
+extern TelemetryStream telemetry;
+
+#endif // TELEMETRY_STREAM_H
@@ -3,6 +3,10 @@
 #include <Arduino.h>
 #include <Wire.h>
 
+// Non-blocking AT24C driver: StartWrite()/StartRead() queue a transfer and
+// every Service() call performs at most one I2C transaction (one page chunk
+// or one acknowledge poll during the internal write cycle).
+
 class At24cAsync {
  public:
   struct Stats {
@@ -115,6 +119,8 @@ class At24cAsync {
 
   bool IsDone() const { return state_ == State::kDone; }
   bool HasError() const { return state_ == State::kError; }
+  // The device is in its internal write cycle and is being polled.
+  bool IsWaiting() const { return state_ == State::kWaiting; }
   bool IsBusy() const { return state_ != State::kIdle && state_ != State::kDone; }
   const Stats &GetStats() const { return stats_; }
 
@@ -129,8 +135,9 @@ class At24cAsync {
   };
 
   bool WriteNextPage() {
-    uint16_t count =
-        remaining_ >= page_size_ ? page_size_ : static_cast<uint8_t>(remaining_);
+    // A page write wraps inside the page, so never cross its end.
+    const uint16_t page_left = page_size_ - (current_address_ % page_size_);
+    uint16_t count = remaining_ >= page_left ? page_left : remaining_;
     if (max_chunk_ > 0 && count > max_chunk_) {
       count = max_chunk_;
     }
@@ -0,0 +1,305 @@
+#ifndef CAN_CAPTURE_H
+#define CAN_CAPTURE_H
+
+#include <ACAN_T4.h>
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// Raw CAN frame capture of one bus.
+//
+// record() stores every received frame with its µs timestamp in a ring of
+// N records: a 20-byte copy and one index store, no lock, no branch on the
+// frame content. The ring always holds the last N frames.
+//
+// trigger() marks the current position and keeps recording for the
+// post-trigger window (post_frames frames or post_us, whichever ends first;
+// service() checks the time so a bus that went silent still freezes). Then
+// the ring freezes: it holds the pre-trigger frames followed by the
+// post-trigger frames until rearm(). Only the first trigger of an armed
+// capture counts.
+//
+// Lock-free for one producer context (record(), trigger()) and readers that
+// only read the frames once get_state() is FROZEN.
+enum CanCaptureTrigger : uint8_t
+{
+    CAN_CAPTURE_TRIGGER_NONE,
+    CAN_CAPTURE_TRIGGER_MANUAL,
+    CAN_CAPTURE_TRIGGER_DTC,     // a DTC bit was set
+    CAN_CAPTURE_TRIGGER_CRC,     // a module frame failed its CRC
+    CAN_CAPTURE_TRIGGER_TIMEOUT, // module, shunt or VCU timeout
+    CAN_CAPTURE_TRIGGER_COUNT
+};
+
+inline const char *can_capture_trigger_name(CanCaptureTrigger trigger)
+{
+    switch (trigger)
+    {
+    case CAN_CAPTURE_TRIGGER_MANUAL:
+        return "manual";
+    case CAN_CAPTURE_TRIGGER_DTC:
+        return "DTC";
+    case CAN_CAPTURE_TRIGGER_CRC:
+        return "CRC error";
+    case CAN_CAPTURE_TRIGGER_TIMEOUT:
+        return "timeout";
+    default:
+        return "none";
+    }
+}
+
+struct CanCaptureRecord
+{
+    static constexpr uint8_t kExtended = 1U << 0;
+    static constexpr uint8_t kRemote = 1U << 1;
+
+    uint32_t time_us;
+    uint32_t id;
+    uint8_t len;
+    uint8_t flags;
+    uint8_t reserved[2];
+    uint8_t data[8];
+};
+static_assert(sizeof(CanCaptureRecord) == 20U, "compact capture record");
+
+template <size_t N>
+class CanCapture
+{
+    static_assert(N >= 2U && (N & (N - 1U)) == 0U, "capture size must be a power of two");
+
+public:
+    static constexpr size_t kCapacity = N;
+
+    enum State : uint8_t
+    {
+        ARMED,        // recording, waiting for a trigger
+        POST_TRIGGER, // recording the post-trigger window
+        FROZEN,       // window complete, not recording
+    };
+
+    void record(const CANMessage &message, uint32_t now_us)
+    {
+        const uint8_t current = state.load(std::memory_order_relaxed);
+        if (current == FROZEN)
+        {
+            return;
+        }
+        const uint32_t position = head.load(std::memory_order_relaxed);
+        CanCaptureRecord &slot = records[position & (N - 1U)];
+        slot.time_us = now_us;
+        slot.id = message.id;
+        slot.len = message.len;
+        slot.flags = (message.ext ? CanCaptureRecord::kExtended : 0U) | (message.rtr ? CanCaptureRecord::kRemote : 0U);
+        memcpy(slot.data, message.data, sizeof(slot.data));
+        head.store(position + 1U, std::memory_order_release);
+        if (current == POST_TRIGGER && position + 1U - trigger_position >= post_frames)
+        {
+            state.store(FROZEN, std::memory_order_release);
+        }
+    }
+
+    // post_frames is limited to N - 1 so at least one pre-trigger frame is
+    // kept. Returns false if the capture was not armed.
+    bool trigger(CanCaptureTrigger cause, uint32_t now_us, uint32_t _post_frames, uint32_t _post_us)
+    {
+        if (state.load(std::memory_order_relaxed) != ARMED)
+        {
+            return false;
+        }
+        trigger_cause = cause;
+        trigger_time_us = now_us;
+        trigger_position = head.load(std::memory_order_relaxed);
+        post_frames = (_post_frames < N) ? _post_frames : static_cast<uint32_t>(N - 1U);
+        post_us = _post_us;
+        state.store((post_frames == 0U) ? FROZEN : POST_TRIGGER, std::memory_order_release);
+        return true;
+    }
+
+    // Ends the post-trigger window after post_us without frames
+    void service(uint32_t now_us)
+    {
+        if (state.load(std::memory_order_relaxed) == POST_TRIGGER && now_us - trigger_time_us >= post_us)
+        {
+            state.store(FROZEN, std::memory_order_release);
+        }
+    }
+
+    void rearm()
+    {
+        trigger_cause = CAN_CAPTURE_TRIGGER_NONE;
+        state.store(ARMED, std::memory_order_release);
+    }
+
+    State get_state() const { return static_cast<State>(state.load(std::memory_order_acquire)); }
+    CanCaptureTrigger get_trigger() const { return trigger_cause; }
+    uint32_t get_trigger_time_us() const { return trigger_time_us; }
+    uint32_t frames() const { return head.load(std::memory_order_relaxed); } // recorded since boot
+
+    // Frames in the ring, oldest first
+    size_t size() const
+    {
+        const uint32_t count = head.load(std::memory_order_acquire);
+        return (count < N) ? count : N;
+    }
+    const CanCaptureRecord &at(size_t index) const
+    {
+        const uint32_t first = head.load(std::memory_order_acquire) - static_cast<uint32_t>(size());
+        return records[(first + index) & (N - 1U)];
+    }
+    // Index of the first post-trigger frame in at() order
+    size_t trigger_index() const
+    {
+        const uint32_t first = head.load(std::memory_order_acquire) - static_cast<uint32_t>(size());
+        return trigger_position - first;
+    }
+
+private:
+    CanCaptureRecord records[N];
+    std::atomic<uint32_t> head{0U};
+    std::atomic<uint8_t> state{ARMED};
+    CanCaptureTrigger trigger_cause = CAN_CAPTURE_TRIGGER_NONE;
+    uint32_t trigger_position = 0U;
+    uint32_t trigger_time_us = 0U;
+    uint32_t post_frames = 0U;
+    uint32_t post_us = 0U;
+};
+
+// Export of the frozen captures of Buses buses, merged in time order.
+//
+// Driven by a periodic pass, not by console input: each service() call hands
+// at most max_frames frames, oldest first over all buses, to
+// emit(bus, record). emit returns false when its output has no room; that
+// frame is offered again on the next pass.
+template <size_t N, size_t Buses>
+class CanCaptureExport
+{
+public:
+    void start()
+    {
+        for (size_t b = 0; b < Buses; ++b)
+        {
+            next[b] = 0U;
+        }
+        exported = 0U;
+        running = true;
+    }
+
+    void stop() { running = false; }
+    bool active() const { return running; }
+    uint32_t frames() const { return exported; } // handed out since start()
+
+    // Returns true on the pass that finds every frame handed out; the
+    // export then ends.
+    template <typename Emit>
+    bool service(const CanCapture<N> (&captures)[Buses], uint32_t max_frames, Emit emit)
+    {
+        if (!running)
+        {
+            return false;
+        }
+        for (uint32_t n = 0; n < max_frames; ++n)
+        {
+            size_t bus = Buses;
+            uint32_t oldest_us = 0U;
+            for (size_t b = 0; b < Buses; ++b)
+            {
+                if (next[b] >= captures[b].size())
+                {
+                    continue;
+                }
+                const uint32_t time_us = captures[b].at(next[b]).time_us;
+                if (bus == Buses || static_cast<int32_t>(time_us - oldest_us) < 0)
+                {
+                    bus = b;
+                    oldest_us = time_us;
+                }
+            }
+            if (bus == Buses)
+            {
+                running = false;
+                return true;
+            }
+            if (!emit(bus, captures[bus].at(next[bus])))
+            {
+                return false;
+            }
+            ++next[bus];
+            ++exported;
+        }
+        return false;
+    }
+
+private:
+    size_t next[Buses] = {};
+    uint32_t exported = 0U;
+    bool running = false;
+};
+
+// Export formats, one line per frame (newline included). Both return the
+// line length, 0 if out is too small.
+//
+// candump -l:        (seconds.micros) interface ID#DATA
+// SavvyCAN (GVRET):  Time Stamp,ID,Extended,Dir,Bus,LEN,D1,...,D8 with the
+//                    time in µs
+static constexpr const char *kCanCaptureGvretHeader = "Time Stamp,ID,Extended,Dir,Bus,LEN,D1,D2,D3,D4,D5,D6,D7,D8\n";
+
+inline size_t can_capture_format_candump(const CanCaptureRecord &record, const char *interface, char *out, size_t capacity)
+{
+    static const char hex[] = "0123456789ABCDEF";
+    int length = snprintf(out,
+                          capacity,
+                          (record.flags & CanCaptureRecord::kExtended) ? "(%lu.%06lu) %s %08lX#" : "(%lu.%06lu) %s %03lX#",
+                          static_cast<unsigned long>(record.time_us / 1000000U),
+                          static_cast<unsigned long>(record.time_us % 1000000U),
+                          interface,
+                          static_cast<unsigned long>(record.id));
+    const uint8_t len = (record.len <= 8U) ? record.len : 8U;
+    if (length < 0 || static_cast<size_t>(length) + 2U * len + 3U > capacity)
+    {
+        return 0U;
+    }
+    if (record.flags & CanCaptureRecord::kRemote)
+    {
+        out[length++] = 'R';
+    }
+    else
+    {
+        for (uint8_t i = 0; i < len; ++i)
+        {
+            out[length++] = hex[record.data[i] >> 4];
+            out[length++] = hex[record.data[i] & 0x0FU];
+        }
+    }
+    out[length++] = '\n';
+    out[length] = '\0';
+    return static_cast<size_t>(length);
+}
+
+inline size_t can_capture_format_gvret(const CanCaptureRecord &record, unsigned bus, char *out, size_t capacity)
+{
+    const uint8_t len = (record.len <= 8U) ? record.len : 8U;
+    int length = snprintf(out,
+                          capacity,
+                          "%lu,%08lX,%s,Rx,%u,%u",
+                          static_cast<unsigned long>(record.time_us),
+                          static_cast<unsigned long>(record.id),
+                          (record.flags & CanCaptureRecord::kExtended) ? "true" : "false",
+                          bus,
+                          static_cast<unsigned>(len));
+    for (uint8_t i = 0; i < 8U && length > 0 && static_cast<size_t>(length) < capacity; ++i)
+    {
+        length += (i < len) ? snprintf(out + length, capacity - length, ",%02X", record.data[i])
+                            : snprintf(out + length, capacity - length, ",");
+    }
+    if (length < 0 || static_cast<size_t>(length) + 2U > capacity)
+    {
+        return 0U;
+    }
+    out[length++] = '\n';
+    out[length] = '\0';
+    return static_cast<size_t>(length);
+}
+
+#endif // CAN_CAPTURE_H
@@ -0,0 +1,70 @@
+#ifndef CAN_CODEC_H
+#define CAN_CODEC_H
+
+#include <stdint.h>
+#include <string.h>
+
+// Support code of the CAN message structs in can_messages.h, which
+// scripts/generate_can_messages.py generates from src/can_messages.dbc.
+//
+// A frame is handled as one little-endian uint64: decoding is a load plus
+// a shift and mask per signal, encoding the reverse. Signals stay raw
+// integers in the structs; only the <signal>_raw()/<signal>_value()
+// helpers touch float, so integer signals never do.
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__)
+#error "can_codec.h assumes a little-endian target"
+#endif
+
+enum CanChecksum : uint8_t
+{
+    CAN_CHECKSUM_NONE,
+    CAN_CHECKSUM_CRC8,    // can_crc8() over the 8 bytes with byte 7 zeroed, in byte 7
+    CAN_CHECKSUM_BMW_I3,  // CRC8BMWi3(), checked by the module code
+};
+
+static inline uint64_t can_codec_load(const uint8_t data[8])
+{
+    uint64_t bits;
+    memcpy(&bits, data, sizeof(bits));
+    return bits;
+}
+
+static inline void can_codec_store(uint8_t data[8], uint64_t bits)
+{
+    memcpy(data, &bits, sizeof(bits));
+}
+
+// Two's complement value of the low bit_len bits of raw
+static constexpr int64_t can_codec_sign_extend(uint64_t raw, unsigned bit_len)
+{
+    const uint64_t sign = 1ULL << (bit_len - 1U);
+    return static_cast<int64_t>(raw ^ sign) - static_cast<int64_t>(sign);
+}
+
+// Scaled physical value to a raw signal value: rounds to nearest and
+// clamps to [lo, hi]; NaN gives lo. The comparisons are done in float, so
+// a bound that float cannot represent exactly still clamps before the
+// conversion could overflow.
+template <typename Raw>
+static constexpr Raw can_codec_raw(float scaled, Raw lo, Raw hi)
+{
+    if (!(scaled > static_cast<float>(lo)))
+    {
+        return lo;
+    }
+    if (!(scaled < static_cast<float>(hi)))
+    {
+        return hi;
+    }
+    return static_cast<Raw>((scaled >= 0.0f) ? scaled + 0.5f : scaled - 0.5f);
+}
+
+// Raw signal value clamped to [lo, hi]
+template <typename Raw>
+static constexpr Raw can_codec_clamp(Raw raw, Raw lo, Raw hi)
+{
+    return (raw < lo) ? lo : ((raw > hi) ? hi : raw);
+}
+
+#endif // CAN_CODEC_H
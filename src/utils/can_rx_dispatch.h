@@ -0,0 +1,79 @@
+#ifndef CAN_RX_DISPATCH_H
+#define CAN_RX_DISPATCH_H
+
+#include <ACAN_T4.h>
+#include <Arduino.h>
+
+#include "utils/task_profiler.h"
+
+// Callback dispatch for one ACAN_T4 bus.
+//
+// The FlexCAN interrupt of ACAN_T4 moves frames into the driver's receive
+// buffer; dispatch() hands them to the callbacks of the matching
+// ACANPrimaryFilter (set at begin()) via dispatchReceivedMessage(), so every
+// frame is decoded on the next real-time tier pass instead of on the next
+// slot of a polling task.
+//
+// ACAN_T4 does not expose the FlexCAN mailbox timestamp, so the frame age is
+// bounded from above instead: a frame decoded at t arrived after the last
+// pass that found the receive buffer empty. The bound (arrival to decode)
+// is collected in a TaskProfile with period 0, in microseconds.
+class CanRxDispatcher
+{
+public:
+    // Frames per pass; a burst beyond this waits for the next pass.
+    static constexpr uint32_t kMaxFramesPerPass = 32U;
+
+    CanRxDispatcher(ACAN_T4 &_bus, const char *_name)
+        : bus(_bus),
+          age(_name, 0U)
+    {
+    }
+
+    uint32_t dispatch()
+    {
+        uint32_t frames = 0U;
+        while (frames < kMaxFramesPerPass)
+        {
+            const uint32_t now = micros();
+            if (!bus.dispatchReceivedMessage())
+            {
+                empty_since_us = now;
+                seen_empty = true;
+                break;
+            }
+            ++frames;
+            if (seen_empty)
+            {
+                record_age(micros());
+            }
+        }
+        frame_count += frames;
+        return frames;
+    }
+
+    const TaskProfile &frame_age() const { return age; }
+    uint32_t frames() const { return frame_count; }
+    void reset_statistics()
+    {
+        age.reset();
+        frame_count = 0U;
+    }
+
+private:
+    ACAN_T4 &bus;
+    TaskProfile age;
+    uint32_t empty_since_us = 0U;
+    bool seen_empty = false; // frames queued before the first empty pass have no bound
+    uint32_t frame_count = 0U;
+
+    void record_age(uint32_t decoded_us)
+    {
+        // TaskProfile counts in cycles; the differences stay exact across the
+        // 32-bit wrap of the scaled values.
+        const uint32_t cycles_per_us = task_profiler_cycles_per_us();
+        age.record(empty_since_us * cycles_per_us, decoded_us * cycles_per_us);
+    }
+};
+
+#endif // CAN_RX_DISPATCH_H
@@ -0,0 +1,139 @@
+#ifndef COBS_H
+#define COBS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Consistent Overhead Byte Stuffing. Encoded data contains no zero byte, so
+// a 0x00 ends a frame and a receiver resynchronises at the next one after a
+// lost or corrupt byte. Overhead is one byte per 254 bytes plus one.
+//
+// CobsEncoder encodes byte by byte straight into the output buffer, so a
+// frame can be serialised from its sources without a staging copy.
+
+static constexpr size_t cobs_max_encoded_size(size_t size)
+{
+    return size + size / 254U + 1U;
+}
+
+class CobsEncoder
+{
+public:
+    void begin(uint8_t *_out, size_t _capacity)
+    {
+        out = _out;
+        capacity = _capacity;
+        code_pos = 0U;
+        pos = 1U;
+        code = 1U;
+        overflow = (capacity == 0U);
+    }
+
+    void put(uint8_t value)
+    {
+        if (value != 0U)
+        {
+            emit(value);
+            ++code;
+            if (code == 0xFFU)
+            {
+                close_block();
+            }
+        }
+        else
+        {
+            close_block();
+        }
+    }
+
+    void put(const void *data, size_t size)
+    {
+        const uint8_t *bytes = static_cast<const uint8_t *>(data);
+        for (size_t i = 0; i < size; ++i)
+        {
+            put(bytes[i]);
+        }
+    }
+
+    // Closes the last block and appends the 0x00 delimiter. Returns the
+    // encoded size including the delimiter, 0 if the buffer was too small.
+    size_t finish()
+    {
+        if (overflow || pos >= capacity)
+        {
+            return 0U;
+        }
+        out[code_pos] = code;
+        out[pos++] = 0U;
+        return pos;
+    }
+
+private:
+    uint8_t *out = nullptr;
+    size_t capacity = 0U;
+    size_t code_pos = 0U;
+    size_t pos = 0U;
+    uint8_t code = 1U;
+    bool overflow = false;
+
+    void emit(uint8_t value)
+    {
+        if (pos < capacity)
+        {
+            out[pos] = value;
+        }
+        else
+        {
+            overflow = true;
+        }
+        ++pos;
+    }
+
+    void close_block()
+    {
+        if (code_pos < capacity)
+        {
+            out[code_pos] = code;
+        }
+        code_pos = pos;
+        emit(0U); // placeholder for the next code byte
+        code = 1U;
+    }
+};
+
+// Decodes one frame without its delimiter. Returns the decoded size, 0 for
+// malformed input (a zero byte or a block running past the end) or when out
+// is too small.
+static inline size_t cobs_decode(const uint8_t *in, size_t size, uint8_t *out, size_t capacity)
+{
+    size_t read = 0U;
+    size_t written = 0U;
+    while (read < size)
+    {
+        const uint8_t code = in[read++];
+        if (code == 0U || read + code - 1U > size)
+        {
+            return 0U;
+        }
+        for (uint8_t i = 1U; i < code; ++i)
+        {
+            const uint8_t value = in[read++];
+            if (value == 0U || written >= capacity)
+            {
+                return 0U;
+            }
+            out[written++] = value;
+        }
+        if (code != 0xFFU && read < size)
+        {
+            if (written >= capacity)
+            {
+                return 0U;
+            }
+            out[written++] = 0U;
+        }
+    }
+    return written;
+}
+
+#endif // COBS_H
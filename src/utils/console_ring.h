@@ -0,0 +1,647 @@
+#ifndef CONSOLE_RING_H
+#define CONSOLE_RING_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <type_traits>
+
+// Console output ring with deferred formatting.
+//
+// Producers append records and never wait. Text is copied as is. A printf
+// record stores the format pointer, which must be a string literal (the
+// pointer is its ID), and the raw arguments, each tagged with the type the
+// compiler saw. %s arguments are copied, so temporaries are fine. Formatting
+// happens in read(), on the consumer side, one literal run or conversion at
+// a time, so lines have no length limit.
+//
+// A record that does not fit is dropped whole and its bytes are counted;
+// the next record that fits is preceded by a "[console: N bytes dropped]"
+// marker at the point of the loss.
+//
+// Lock-free for one producer context and one consumer context (head and
+// tail are only written by their own side).
+//
+// Supported conversions: d i u x X o c f F e E g G a A s p and %%, with flags,
+// width and precision; length modifiers are ignored since the argument type
+// is stored. '*' width and precision are not supported.
+template <size_t N>
+class ConsoleRing
+{
+    static_assert(N >= 64U && (N & (N - 1U)) == 0U, "ring size must be a power of two");
+
+public:
+    static constexpr size_t kCapacity = N;
+    static constexpr size_t kMaxStringBytes = 255U; // longer %s arguments are cut
+    static constexpr size_t kMaxTextRecordBytes = N / 4U; // longer writes are split
+
+    // true when everything was stored
+    bool write_text(const char *text, size_t size)
+    {
+        bool stored = true;
+        while (size > 0U)
+        {
+            const size_t part = (size < kMaxTextRecordBytes) ? size : kMaxTextRecordBytes;
+            uint32_t pos = 0U;
+            if (reserve(kHeaderBytes + part, KIND_TEXT, &pos))
+            {
+                put(pos, text, part);
+                publish(pos);
+            }
+            else
+            {
+                stored = false;
+            }
+            text += part;
+            size -= part;
+        }
+        return stored;
+    }
+
+    template <typename... Args>
+    bool write_format(const char *format, Args... args)
+    {
+        const Arg list[sizeof...(Args) + 1U] = {make_arg<Args>(args)..., Arg{}};
+        size_t size = kHeaderBytes + sizeof(format);
+        for (size_t i = 0; i < sizeof...(Args); ++i)
+        {
+            size += list[i].encoded_size();
+        }
+        uint32_t pos = 0U;
+        if (!reserve(size, KIND_FORMAT, &pos))
+        {
+            return false;
+        }
+        put(pos, &format, sizeof(format));
+        for (size_t i = 0; i < sizeof...(Args); ++i)
+        {
+            const Arg &arg = list[i];
+            put(pos, &arg.tag, 1U);
+            if (arg.tag == TAG_STRING)
+            {
+                const uint8_t length = static_cast<uint8_t>(arg.string_length);
+                put(pos, &length, 1U);
+                put(pos, arg.string, arg.string_length);
+            }
+            else
+            {
+                put(pos, &arg.value, arg.value_size());
+            }
+        }
+        publish(pos);
+        return true;
+    }
+
+    // Consumer: formats up to max_bytes of output into out, returns the
+    // number of bytes written (0 when the ring is empty).
+    size_t read(char *out, size_t max_bytes)
+    {
+        size_t count = 0U;
+        while (count < max_bytes)
+        {
+            if (piece_pos < piece_length)
+            {
+                size_t n = piece_length - piece_pos;
+                n = (n < max_bytes - count) ? n : max_bytes - count;
+                memcpy(out + count, piece + piece_pos, n);
+                piece_pos += n;
+                count += n;
+                continue;
+            }
+            if (!next_piece())
+            {
+                break;
+            }
+        }
+        return count;
+    }
+
+    bool empty() const
+    {
+        return piece_pos == piece_length && !in_record && tail.load(std::memory_order_relaxed) == head.load(std::memory_order_acquire);
+    }
+    size_t used() const
+    {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+    size_t max_used() const { return high_water.load(std::memory_order_relaxed); }
+    uint32_t dropped_bytes() const { return dropped_total.load(std::memory_order_relaxed); }
+    uint32_t dropped_records() const { return dropped_record_count.load(std::memory_order_relaxed); }
+
+private:
+    enum Kind : uint8_t
+    {
+        KIND_TEXT,
+        KIND_FORMAT,
+        KIND_DROPPED
+    };
+
+    enum Tag : uint8_t
+    {
+        TAG_NONE,
+        TAG_INT32,
+        TAG_UINT32,
+        TAG_INT64,
+        TAG_UINT64,
+        TAG_DOUBLE,
+        TAG_STRING,
+        TAG_POINTER
+    };
+
+    // Record header: uint16_t size (header included), uint8_t kind
+    static constexpr size_t kHeaderBytes = 3U;
+    static constexpr size_t kDroppedRecordBytes = kHeaderBytes + sizeof(uint32_t);
+    static constexpr size_t kPieceBytes = 64U;
+
+    struct Arg
+    {
+        uint8_t tag = TAG_NONE;
+        union
+        {
+            int32_t i32;
+            uint32_t u32;
+            int64_t i64;
+            uint64_t u64;
+            double f64;
+            uintptr_t pointer;
+        } value = {};
+        const char *string = nullptr;
+        size_t string_length = 0U;
+
+        size_t value_size() const
+        {
+            switch (tag)
+            {
+            case TAG_INT32:
+            case TAG_UINT32:
+                return 4U;
+            case TAG_INT64:
+            case TAG_UINT64:
+            case TAG_DOUBLE:
+                return 8U;
+            case TAG_POINTER:
+                return sizeof(uintptr_t);
+            default:
+                return 0U;
+            }
+        }
+
+        size_t encoded_size() const
+        {
+            return 1U + ((tag == TAG_STRING) ? 1U + string_length : value_size());
+        }
+    };
+
+    template <typename T>
+    struct unsupported : std::false_type
+    {
+    };
+
+    template <typename T>
+    static Arg make_arg(T value)
+    {
+        Arg arg;
+        if constexpr (std::is_enum<T>::value)
+        {
+            return make_arg<typename std::underlying_type<T>::type>(static_cast<typename std::underlying_type<T>::type>(value));
+        }
+        else if constexpr (std::is_integral<T>::value && std::is_signed<T>::value && sizeof(T) <= 4U)
+        {
+            arg.tag = TAG_INT32;
+            arg.value.i32 = value;
+        }
+        else if constexpr (std::is_integral<T>::value && sizeof(T) <= 4U)
+        {
+            arg.tag = TAG_UINT32;
+            arg.value.u32 = value;
+        }
+        else if constexpr (std::is_integral<T>::value && std::is_signed<T>::value)
+        {
+            arg.tag = TAG_INT64;
+            arg.value.i64 = value;
+        }
+        else if constexpr (std::is_integral<T>::value)
+        {
+            arg.tag = TAG_UINT64;
+            arg.value.u64 = value;
+        }
+        else if constexpr (std::is_floating_point<T>::value)
+        {
+            arg.tag = TAG_DOUBLE;
+            arg.value.f64 = static_cast<double>(value);
+        }
+        else if constexpr (std::is_pointer<T>::value &&
+                           std::is_same<typename std::remove_cv<typename std::remove_pointer<T>::type>::type, char>::value)
+        {
+            arg.tag = TAG_STRING;
+            arg.string = (value != nullptr) ? value : "(null)";
+            size_t length = 0U;
+            while (length < kMaxStringBytes && arg.string[length] != '\0')
+            {
+                ++length;
+            }
+            arg.string_length = length;
+        }
+        else if constexpr (std::is_pointer<T>::value)
+        {
+            arg.tag = TAG_POINTER;
+            arg.value.pointer = reinterpret_cast<uintptr_t>(value);
+        }
+        else
+        {
+            static_assert(unsupported<T>::value, "console printf argument must be a number, enum, string or pointer");
+        }
+        return arg;
+    }
+
+    std::atomic<uint32_t> head{0U}; // written by the producer
+    std::atomic<uint32_t> tail{0U}; // written by the consumer
+    std::atomic<uint32_t> high_water{0U};
+    std::atomic<uint32_t> dropped_total{0U};
+    std::atomic<uint32_t> dropped_record_count{0U};
+    uint32_t dropped_pending = 0U; // producer: bytes lost since the last marker
+    uint8_t buffer[N];
+
+    // Consumer state
+    char piece[kPieceBytes];
+    size_t piece_length = 0U;
+    size_t piece_pos = 0U;
+    bool in_record = false;
+    uint32_t record_start = 0U;
+    uint32_t record_size = 0U;
+    uint8_t record_kind = KIND_TEXT;
+    uint32_t cursor = 0U;         // ring index inside the record (text or next argument)
+    const char *format = nullptr; // format records
+    size_t string_left = 0U;      // bytes of a %s argument still to copy
+
+    void put(uint32_t &pos, const void *data, size_t size)
+    {
+        const size_t offset = pos & (N - 1U);
+        const size_t first = (size < N - offset) ? size : N - offset;
+        memcpy(buffer + offset, data, first);
+        memcpy(buffer, static_cast<const uint8_t *>(data) + first, size - first);
+        pos += static_cast<uint32_t>(size);
+    }
+
+    void get(uint32_t pos, void *data, size_t size) const
+    {
+        const size_t offset = pos & (N - 1U);
+        const size_t first = (size < N - offset) ? size : N - offset;
+        memcpy(data, buffer + offset, first);
+        memcpy(static_cast<uint8_t *>(data) + first, buffer, size - first);
+    }
+
+    void put_header(uint32_t &pos, size_t size, uint8_t kind)
+    {
+        const uint16_t size16 = static_cast<uint16_t>(size);
+        put(pos, &size16, 2U);
+        put(pos, &kind, 1U);
+    }
+
+    // Starts a record of size bytes at *pos, after a pending drop marker.
+    bool reserve(size_t size, uint8_t kind, uint32_t *pos)
+    {
+        const uint32_t start = head.load(std::memory_order_relaxed);
+        const size_t free_bytes = N - (start - tail.load(std::memory_order_acquire));
+        const size_t marker = (dropped_pending != 0U) ? kDroppedRecordBytes : 0U;
+        if (size > UINT16_MAX || size + marker > free_bytes)
+        {
+            dropped_pending += static_cast<uint32_t>(size);
+            dropped_total.store(dropped_total.load(std::memory_order_relaxed) + static_cast<uint32_t>(size),
+                                std::memory_order_relaxed);
+            dropped_record_count.store(dropped_record_count.load(std::memory_order_relaxed) + 1U,
+                                       std::memory_order_relaxed);
+            return false;
+        }
+        *pos = start;
+        if (marker != 0U)
+        {
+            put_header(*pos, kDroppedRecordBytes, KIND_DROPPED);
+            put(*pos, &dropped_pending, sizeof(dropped_pending));
+            dropped_pending = 0U;
+        }
+        put_header(*pos, size, kind);
+        return true;
+    }
+
+    void publish(uint32_t pos)
+    {
+        const uint32_t used_bytes = pos - tail.load(std::memory_order_relaxed);
+        if (used_bytes > high_water.load(std::memory_order_relaxed))
+        {
+            high_water.store(used_bytes, std::memory_order_relaxed);
+        }
+        head.store(pos, std::memory_order_release);
+    }
+
+    void finish_record()
+    {
+        in_record = false;
+        tail.store(record_start + record_size, std::memory_order_release);
+    }
+
+    void set_piece(const void *data, size_t size)
+    {
+        memcpy(piece, data, size);
+        piece_length = size;
+        piece_pos = 0U;
+    }
+
+    // Fills piece with the next output of the current record; false when
+    // the ring is empty.
+    bool next_piece()
+    {
+        while (true)
+        {
+            if (!in_record)
+            {
+                if (tail.load(std::memory_order_relaxed) == head.load(std::memory_order_acquire))
+                {
+                    return false;
+                }
+                record_start = tail.load(std::memory_order_relaxed);
+                uint16_t size16 = 0U;
+                get(record_start, &size16, 2U);
+                get(record_start + 2U, &record_kind, 1U);
+                record_size = size16;
+                cursor = record_start + kHeaderBytes;
+                in_record = true;
+                if (record_kind == KIND_FORMAT)
+                {
+                    get(cursor, &format, sizeof(format));
+                    cursor += sizeof(format);
+                    string_left = 0U;
+                }
+            }
+
+            const uint32_t record_end = record_start + record_size;
+            if (record_kind == KIND_DROPPED)
+            {
+                uint32_t lost = 0U;
+                get(cursor, &lost, sizeof(lost));
+                piece_length = static_cast<size_t>(
+                    snprintf(piece, kPieceBytes, "\n[console: %lu bytes dropped]\n", static_cast<unsigned long>(lost)));
+                piece_pos = 0U;
+                finish_record();
+                return true;
+            }
+            if (record_kind == KIND_TEXT)
+            {
+                if (cursor == record_end)
+                {
+                    finish_record();
+                    continue;
+                }
+                const size_t n = (record_end - cursor < kPieceBytes) ? record_end - cursor : kPieceBytes;
+                get(cursor, piece, n);
+                cursor += static_cast<uint32_t>(n);
+                piece_length = n;
+                piece_pos = 0U;
+                return true;
+            }
+            if (format_piece())
+            {
+                return true;
+            }
+            finish_record();
+        }
+    }
+
+    // Next literal run or conversion of the current printf record; false at
+    // the end of the format.
+    bool format_piece()
+    {
+        if (string_left > 0U)
+        {
+            const size_t n = (string_left < kPieceBytes) ? string_left : kPieceBytes;
+            get(cursor, piece, n);
+            cursor += static_cast<uint32_t>(n);
+            string_left -= n;
+            piece_length = n;
+            piece_pos = 0U;
+            return true;
+        }
+        if (*format == '\0')
+        {
+            return false;
+        }
+        if (format[0] == '%' && format[1] == '%')
+        {
+            format += 2;
+            set_piece("%", 1U);
+            return true;
+        }
+        if (*format != '%')
+        {
+            size_t n = 0U;
+            while (format[n] != '\0' && format[n] != '%' && n < kPieceBytes)
+            {
+                ++n;
+            }
+            set_piece(format, n);
+            format += n;
+            return true;
+        }
+
+        // Conversion: rebuild the spec without length modifiers
+        char spec[24];
+        size_t s = 0U;
+        spec[s++] = *format++;
+        while (*format != '\0' && strchr("-+ #0", *format) != nullptr && s < 8U)
+        {
+            spec[s++] = *format++;
+        }
+        while (*format >= '0' && *format <= '9' && s < 12U)
+        {
+            spec[s++] = *format++;
+        }
+        if (*format == '.')
+        {
+            spec[s++] = *format++;
+            while (*format >= '0' && *format <= '9' && s < 16U)
+            {
+                spec[s++] = *format++;
+            }
+        }
+        while (*format != '\0' && strchr("hlLqjzt", *format) != nullptr)
+        {
+            ++format;
+        }
+        const char conversion = *format;
+        if (conversion != '\0')
+        {
+            ++format;
+        }
+        const bool plain = (s == 1U);
+
+        Arg arg;
+        if (cursor < record_start + record_size)
+        {
+            get(cursor, &arg.tag, 1U);
+            cursor += 1U;
+            if (arg.tag == TAG_STRING)
+            {
+                uint8_t length = 0U;
+                get(cursor, &length, 1U);
+                cursor += 1U;
+                arg.string_length = length;
+            }
+            else
+            {
+                get(cursor, &arg.value, arg.value_size());
+                cursor += static_cast<uint32_t>(arg.value_size());
+            }
+        }
+
+        int written = 0;
+        switch ((arg.tag == TAG_NONE) ? '?' : conversion)
+        {
+        case '?':
+            written = snprintf(piece, kPieceBytes, "(?)");
+            break;
+        case 'd':
+        case 'i':
+            spec[s++] = 'l';
+            spec[s++] = 'l';
+            spec[s++] = 'd';
+            spec[s] = '\0';
+            written = snprintf(piece, kPieceBytes, spec, static_cast<long long>(signed_value(arg)));
+            break;
+        case 'u':
+        case 'x':
+        case 'X':
+        case 'o':
+            spec[s++] = 'l';
+            spec[s++] = 'l';
+            spec[s++] = conversion;
+            spec[s] = '\0';
+            written = snprintf(piece, kPieceBytes, spec, static_cast<unsigned long long>(unsigned_value(arg)));
+            break;
+        case 'c':
+            spec[s++] = 'c';
+            spec[s] = '\0';
+            written = snprintf(piece, kPieceBytes, spec, static_cast<int>(signed_value(arg)));
+            break;
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+            spec[s++] = conversion;
+            spec[s] = '\0';
+            written = snprintf(piece, kPieceBytes, spec, double_value(arg));
+            break;
+        case 's':
+            if (arg.tag != TAG_STRING)
+            {
+                written = snprintf(piece, kPieceBytes, "(?)");
+            }
+            else if (plain)
+            {
+                // Copied straight from the record, in pieces
+                string_left = arg.string_length;
+                return format_piece_or_empty();
+            }
+            else
+            {
+                char text[kPieceBytes];
+                const size_t n = (arg.string_length < kPieceBytes - 1U) ? arg.string_length : kPieceBytes - 1U;
+                get(cursor, text, n);
+                text[n] = '\0';
+                cursor += static_cast<uint32_t>(arg.string_length);
+                spec[s++] = 's';
+                spec[s] = '\0';
+                written = snprintf(piece, kPieceBytes, spec, text);
+            }
+            break;
+        case 'p':
+            written = snprintf(piece, kPieceBytes, "%p", reinterpret_cast<void *>(arg.value.pointer));
+            break;
+        default:
+            // Unknown conversion: print it as written
+            spec[s++] = conversion;
+            spec[s] = '\0';
+            written = snprintf(piece, kPieceBytes, "%s", spec);
+            break;
+        }
+        piece_length = (written < 0) ? 0U : ((static_cast<size_t>(written) < kPieceBytes) ? static_cast<size_t>(written) : kPieceBytes - 1U);
+        piece_pos = 0U;
+        return true;
+    }
+
+    // An empty %s argument produces no piece; go on with the format.
+    bool format_piece_or_empty()
+    {
+        if (string_left == 0U)
+        {
+            piece_length = 0U;
+            piece_pos = 0U;
+            return true;
+        }
+        return format_piece();
+    }
+
+    static int64_t signed_value(const Arg &arg)
+    {
+        switch (arg.tag)
+        {
+        case TAG_INT32:
+            return arg.value.i32;
+        case TAG_UINT32:
+            return arg.value.u32;
+        case TAG_INT64:
+            return arg.value.i64;
+        case TAG_UINT64:
+            return static_cast<int64_t>(arg.value.u64);
+        case TAG_DOUBLE:
+            return static_cast<int64_t>(arg.value.f64);
+        case TAG_POINTER:
+            return static_cast<int64_t>(arg.value.pointer);
+        default:
+            return 0;
+        }
+    }
+
+    static uint64_t unsigned_value(const Arg &arg)
+    {
+        // printf semantics: %u/%x of a negative int shows its own width
+        switch (arg.tag)
+        {
+        case TAG_INT32:
+            return static_cast<uint32_t>(arg.value.i32);
+        case TAG_UINT32:
+            return arg.value.u32;
+        case TAG_INT64:
+            return static_cast<uint64_t>(arg.value.i64);
+        case TAG_UINT64:
+            return arg.value.u64;
+        case TAG_DOUBLE:
+            return static_cast<uint64_t>(arg.value.f64);
+        case TAG_POINTER:
+            return arg.value.pointer;
+        default:
+            return 0U;
+        }
+    }
+
+    static double double_value(const Arg &arg)
+    {
+        switch (arg.tag)
+        {
+        case TAG_DOUBLE:
+            return arg.value.f64;
+        case TAG_NONE:
+        case TAG_STRING:
+            return 0.0;
+        default:
+            return static_cast<double>(signed_value(arg));
+        }
+    }
+};
+
+#endif // CONSOLE_RING_H
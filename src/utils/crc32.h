@@ -0,0 +1,53 @@
+#ifndef CRC32_H
+#define CRC32_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#define CRC32_PROGMEM PROGMEM
+#else
+#define CRC32_PROGMEM
+#endif
+
+// CRC-32 (IEEE 802.3 / zlib: reflected polynomial 0xEDB88320, init and final
+// xor 0xFFFFFFFF), one table lookup per byte. The 1 KB table is generated at
+// compile time and kept in flash. Pass the previous result as crc to continue
+// a running checksum over several buffers; crc32_ieee("123456789", 9) is
+// 0xCBF43926.
+
+struct Crc32Table
+{
+    uint32_t v[256];
+};
+
+constexpr Crc32Table make_crc32_table()
+{
+    Crc32Table table{};
+    for (uint32_t i = 0; i < 256U; ++i)
+    {
+        uint32_t c = i;
+        for (int k = 0; k < 8; ++k)
+        {
+            c = (c & 1U) ? (0xEDB88320UL ^ (c >> 1)) : (c >> 1);
+        }
+        table.v[i] = c;
+    }
+    return table;
+}
+
+static constexpr Crc32Table kCrc32Table CRC32_PROGMEM = make_crc32_table();
+
+static inline uint32_t crc32_ieee(const void *data, size_t len, uint32_t crc = 0U)
+{
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    crc = ~crc;
+    for (size_t i = 0; i < len; ++i)
+    {
+        crc = kCrc32Table.v[(crc ^ bytes[i]) & 0xFFU] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+#endif // CRC32_H
@@ -0,0 +1,536 @@
+#ifndef LUT_H
+#define LUT_H
+
+//-----------------------------------------------------------------------------
+// Constexpr lookup tables with linear / bilinear interpolation
+//-----------------------------------------------------------------------------
+//
+// Unlike Map2D/Map3D (utils/Map2D3D.h) these tables are built entirely at
+// compile time from the constexpr source arrays and live in flash: there is no
+// RAM copy, no first-call initialisation and no static-init guard. Each axis
+// carries the reciprocal of every segment width, so a lookup is a bracket
+// search plus one multiply-add per axis and no division.
+//
+// Axes may be declared ascending or descending. The builders normalise every
+// axis to ascending at compile time and reverse the matching y rows/columns,
+// so the runtime lookup never deals with the axis direction. An axis that is
+// not strictly monotonic makes the builder a non-constant expression, i.e. a
+// compile error at the table definition. static_assert(lut_axis_monotonic(xs))
+// next to the source arrays gives a readable message for the same check.
+//
+// Uniform axes (every node within a quarter step of the ideal grid) are
+// detected at build time; their segment index is computed with one multiply
+// and a truncation plus a single correction step instead of a bisection.
+//
+// For repeated lookups along x1 at a fixed x2 (e.g. SOC of many cells at one
+// temperature) Lut2D::slice_x2() resolves the x2 bracket once and returns a
+// LutSlice whose f(x1) only searches the x1 axis.
+//
+// Lut2D::f_batch() evaluates a whole array of x1 values (e.g. all cell
+// voltages) at one x2, or at one x2 per group of consecutive entries (e.g.
+// one temperature per module). Per x2 it interpolates the table column once
+// into a 1D curve; the per-element kernel is then a branch-free bracket and
+// one multiply-add, with results identical to f().
+//
+// make_inverse_lut2d() builds x1 = g(y, x2) from a table whose columns are
+// non-decreasing in x1 (e.g. OCV(SOC, T) from SOC(OCV, T)) at compile time,
+// sampled on a caller-supplied y grid.
+//
+// The y storage is selected per table by the last template parameter: float
+// (default) or int16_t. int16_t tables hold y as offset + scale * code over
+// the table's own value range (quantisation step (max - min) / 65534) and
+// interpolate with Q15 weights in 32-bit integer arithmetic; only the bracket
+// search on the float axis and the final scaling use the FPU. code(x) returns
+// the raw interpolated code for callers that stay in integers.
+//
+// Usage:
+//   static constexpr Lut1D<18> kLut LUT_PROGMEM = make_lut1d(kXs, kYs);
+//   static constexpr Lut1D<18, int16_t> kLutQ LUT_PROGMEM = make_lut1d<int16_t>(kXs, kYs);
+//   float y = kLut.f(x);
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <type_traits>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#define LUT_PROGMEM PROGMEM
+#else
+#define LUT_PROGMEM
+#endif
+
+template <int N>
+constexpr bool lut_axis_monotonic(const float (&xs)[N])
+{
+    if (N < 2)
+    {
+        return false;
+    }
+    const bool ascending = xs[1] > xs[0];
+    for (int i = 1; i < N; ++i)
+    {
+        if (ascending ? !(xs[i] > xs[i - 1]) : !(xs[i] < xs[i - 1]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Intentionally not defined and not constexpr: reached only for a broken
+// axis, which turns the constexpr table definition into a compile error.
+void lut_axis_must_be_strictly_monotonic();
+
+template <int N>
+constexpr bool lut_axis_descending(const float (&xs)[N])
+{
+    return xs[N - 1] < xs[0];
+}
+
+// Index into the source array for normalised (ascending) position i.
+template <int N>
+constexpr int lut_source_index(const float (&xs)[N], int i)
+{
+    return lut_axis_descending(xs) ? (N - 1 - i) : i;
+}
+
+// Segment index i and fractional position t (0..1) of a clamped query.
+struct LutBracket
+{
+    int i;
+    float t;
+};
+
+template <int N>
+struct LutAxis
+{
+    float x[N];          // strictly ascending
+    float inv_dx[N - 1]; // 1 / (x[i + 1] - x[i])
+    bool uniform;        // index can be computed directly
+    float inv_step;      // (N - 1) / (x[N - 1] - x[0]), uniform axes only
+
+    // Clamp u to the axis and return the segment index i with
+    // x[i] <= u <= x[i + 1] and the fractional position t in it.
+    constexpr LutBracket locate(float u) const
+    {
+        if (!(u > x[0]))
+        {
+            return LutBracket{0, 0.0f};
+        }
+        if (!(u < x[N - 1]))
+        {
+            return LutBracket{N - 2, 1.0f};
+        }
+
+        int i = 0;
+        if (uniform)
+        {
+            i = static_cast<int>((u - x[0]) * inv_step);
+            i = (i > N - 2) ? (N - 2) : i;
+            // Nodes are within a quarter step of the grid, so the guess is off
+            // by at most one segment.
+            if (u < x[i])
+            {
+                --i;
+            }
+            else if (u >= x[i + 1] && i < N - 2)
+            {
+                ++i;
+            }
+        }
+        else
+        {
+            int j = N - 1;
+            while (j - i > 1)
+            {
+                const int k = (i + j) >> 1;
+                if (u >= x[k])
+                {
+                    i = k;
+                }
+                else
+                {
+                    j = k;
+                }
+            }
+        }
+
+        return LutBracket{i, (u - x[i]) * inv_dx[i]};
+    }
+
+    // Branch-free equivalent of locate() for the batch kernels: selects and
+    // a fixed-length compare-count instead of early returns and bisection.
+    LutBracket locate_branchless(float u) const
+    {
+        int i = 0;
+        if (uniform)
+        {
+            float g = (u - x[0]) * inv_step;
+            g = (g > 0.0f) ? g : 0.0f;
+            g = (g < static_cast<float>(N - 2)) ? g : static_cast<float>(N - 2);
+            i = static_cast<int>(g);
+            i -= static_cast<int>(u < x[i]) & static_cast<int>(i > 0);
+            i += static_cast<int>(u >= x[i + 1]) & static_cast<int>(i < N - 2);
+        }
+        else
+        {
+            for (int k = 1; k < N - 1; ++k)
+            {
+                i += static_cast<int>(u >= x[k]);
+            }
+        }
+
+        float t = (u - x[i]) * inv_dx[i];
+        t = (t > 0.0f) ? t : 0.0f; // also maps NaN to the first node
+        t = (t < 1.0f) ? t : 1.0f;
+        return LutBracket{i, t};
+    }
+};
+
+template <int N>
+constexpr LutAxis<N> make_lut_axis(const float (&xs)[N])
+{
+    if (!lut_axis_monotonic(xs))
+    {
+        lut_axis_must_be_strictly_monotonic();
+    }
+
+    LutAxis<N> axis{};
+    for (int i = 0; i < N; ++i)
+    {
+        axis.x[i] = xs[lut_source_index(xs, i)];
+    }
+    for (int i = 0; i < N - 1; ++i)
+    {
+        axis.inv_dx[i] = 1.0f / (axis.x[i + 1] - axis.x[i]);
+    }
+
+    const float step = (axis.x[N - 1] - axis.x[0]) / static_cast<float>(N - 1);
+    axis.uniform = true;
+    for (int i = 1; i < N - 1; ++i)
+    {
+        const float dev = axis.x[i] - (axis.x[0] + static_cast<float>(i) * step);
+        if (dev > 0.25f * step || dev < -0.25f * step)
+        {
+            axis.uniform = false;
+        }
+    }
+    axis.inv_step = 1.0f / step;
+    return axis;
+}
+
+//-----------------------------------------------------------------------------
+// int16_t storage: y = offset + scale * code
+//-----------------------------------------------------------------------------
+
+struct LutQ15Scale
+{
+    float offset;
+    float scale;
+};
+
+constexpr LutQ15Scale make_lut_q15_scale(float lo, float hi)
+{
+    return LutQ15Scale{0.5f * (lo + hi), (hi > lo) ? (hi - lo) / 65534.0f : 1.0f};
+}
+
+constexpr int16_t lut_q15_code(const LutQ15Scale &q, float v)
+{
+    const float c = (v - q.offset) / q.scale;
+    const int32_t code = static_cast<int32_t>(c >= 0.0f ? c + 0.5f : c - 0.5f);
+    return static_cast<int16_t>(code > 32767 ? 32767 : (code < -32767 ? -32767 : code));
+}
+
+// Q15 weight of t in [0, 1]; 1.0 maps to 32768.
+constexpr int32_t lut_q15_weight(float t)
+{
+    return static_cast<int32_t>(t * 32768.0f + 0.5f);
+}
+
+// a + w * (b - a) rounded; |b - a| <= 65534 and w <= 32768 fit in 32 bits.
+constexpr int32_t lut_q15_lerp(int32_t a, int32_t b, int32_t w)
+{
+    return a + (((b - a) * w + 16384) >> 15);
+}
+
+//-----------------------------------------------------------------------------
+// y = f(x)
+//-----------------------------------------------------------------------------
+
+template <int N, typename Y = float>
+struct Lut1D
+{
+    LutAxis<N> axis;
+    float y[N];
+
+    constexpr float f(float x) const
+    {
+        const LutBracket b = axis.locate(x);
+        return y[b.i] + b.t * (y[b.i + 1] - y[b.i]);
+    }
+};
+
+template <int N>
+struct Lut1D<N, int16_t>
+{
+    LutAxis<N> axis;
+    int16_t y[N];
+    LutQ15Scale q;
+
+    constexpr int16_t code(float x) const
+    {
+        const LutBracket b = axis.locate(x);
+        return static_cast<int16_t>(lut_q15_lerp(y[b.i], y[b.i + 1], lut_q15_weight(b.t)));
+    }
+
+    constexpr float f(float x) const
+    {
+        return q.offset + q.scale * static_cast<float>(code(x));
+    }
+};
+
+template <typename Y = float, int N>
+constexpr Lut1D<N, Y> make_lut1d(const float (&xs)[N], const float (&ys)[N])
+{
+    Lut1D<N, Y> lut{};
+    lut.axis = make_lut_axis(xs);
+    if constexpr (std::is_same<Y, int16_t>::value)
+    {
+        float lo = ys[0];
+        float hi = ys[0];
+        for (int i = 1; i < N; ++i)
+        {
+            lo = (ys[i] < lo) ? ys[i] : lo;
+            hi = (ys[i] > hi) ? ys[i] : hi;
+        }
+        lut.q = make_lut_q15_scale(lo, hi);
+        for (int i = 0; i < N; ++i)
+        {
+            lut.y[i] = lut_q15_code(lut.q, ys[lut_source_index(xs, i)]);
+        }
+    }
+    else
+    {
+        static_assert(std::is_same<Y, float>::value, "Lut1D storage must be float or int16_t");
+        for (int i = 0; i < N; ++i)
+        {
+            lut.y[i] = ys[lut_source_index(xs, i)];
+        }
+    }
+    return lut;
+}
+
+//-----------------------------------------------------------------------------
+// y = f(x1, x2), ys[i][j] = f(x1s[i], x2s[j])
+//-----------------------------------------------------------------------------
+
+template <int R, int C, typename Y = float>
+struct Lut2D;
+
+// Lut2D with the x2 bracket resolved; f(x1) searches only the x1 axis.
+template <int R, int C>
+struct LutSlice
+{
+    const Lut2D<R, C> *lut;
+    LutBracket b2;
+
+    constexpr float f(float x1) const
+    {
+        return lut->at(lut->axis1.locate(x1), b2);
+    }
+};
+
+template <int R, int C, typename Y>
+struct Lut2D
+{
+    LutAxis<R> axis1;
+    LutAxis<C> axis2;
+    float y[R][C];
+
+    constexpr float at(LutBracket b1, LutBracket b2) const
+    {
+        const int i = b1.i;
+        const int j = b2.i;
+        const float y0 = y[i][j] + b2.t * (y[i][j + 1] - y[i][j]);
+        const float y1 = y[i + 1][j] + b2.t * (y[i + 1][j + 1] - y[i + 1][j]);
+        return y0 + b1.t * (y1 - y0);
+    }
+
+    constexpr float f(float x1, float x2) const
+    {
+        return at(axis1.locate(x1), axis2.locate(x2));
+    }
+
+    constexpr LutSlice<R, C> slice_x2(float x2) const
+    {
+        return LutSlice<R, C>{this, axis2.locate(x2)};
+    }
+
+    // out[k] = f(x1[k], x2) for k < n.
+    void f_batch(const float *x1, float *out, int n, float x2) const
+    {
+        float curve[R];
+        column_curve_(axis2.locate(x2), curve);
+        curve_batch_(curve, x1, out, n);
+    }
+
+    // out[k] = f(x1[k], x2[k / group]) for k < n, e.g. one temperature per
+    // module of `group` cells.
+    void f_batch(const float *x1, float *out, int n, const float *x2, int group) const
+    {
+        float curve[R];
+        for (int k = 0, g = 0; k < n; k += group, ++g)
+        {
+            column_curve_(axis2.locate(x2[g]), curve);
+            curve_batch_(curve, x1 + k, out + k, (n - k < group) ? (n - k) : group);
+        }
+    }
+
+private:
+    // Interpolate the table along x2 into curve[R] (same arithmetic as at()).
+    void column_curve_(LutBracket b2, float *curve) const
+    {
+        const int j = b2.i;
+        for (int i = 0; i < R; ++i)
+        {
+            curve[i] = y[i][j] + b2.t * (y[i][j + 1] - y[i][j]);
+        }
+    }
+
+    void curve_batch_(const float *curve, const float *x1, float *out, int n) const
+    {
+        for (int k = 0; k < n; ++k)
+        {
+            const LutBracket b = axis1.locate_branchless(x1[k]);
+            out[k] = curve[b.i] + b.t * (curve[b.i + 1] - curve[b.i]);
+        }
+    }
+};
+
+template <int R, int C>
+struct Lut2D<R, C, int16_t>
+{
+    LutAxis<R> axis1;
+    LutAxis<C> axis2;
+    int16_t y[R][C];
+    LutQ15Scale q;
+
+    constexpr int16_t at_code(LutBracket b1, LutBracket b2) const
+    {
+        const int i = b1.i;
+        const int j = b2.i;
+        const int32_t w2 = lut_q15_weight(b2.t);
+        const int32_t y0 = lut_q15_lerp(y[i][j], y[i][j + 1], w2);
+        const int32_t y1 = lut_q15_lerp(y[i + 1][j], y[i + 1][j + 1], w2);
+        return static_cast<int16_t>(lut_q15_lerp(y0, y1, lut_q15_weight(b1.t)));
+    }
+
+    constexpr int16_t code(float x1, float x2) const
+    {
+        return at_code(axis1.locate(x1), axis2.locate(x2));
+    }
+
+    constexpr float f(float x1, float x2) const
+    {
+        return q.offset + q.scale * static_cast<float>(code(x1, x2));
+    }
+};
+
+template <typename Y = float, int R, int C>
+constexpr Lut2D<R, C, Y> make_lut2d(const float (&x1s)[R], const float (&x2s)[C], const float (&ys)[R][C])
+{
+    Lut2D<R, C, Y> lut{};
+    lut.axis1 = make_lut_axis(x1s);
+    lut.axis2 = make_lut_axis(x2s);
+    if constexpr (std::is_same<Y, int16_t>::value)
+    {
+        float lo = ys[0][0];
+        float hi = ys[0][0];
+        for (int i = 0; i < R; ++i)
+        {
+            for (int j = 0; j < C; ++j)
+            {
+                lo = (ys[i][j] < lo) ? ys[i][j] : lo;
+                hi = (ys[i][j] > hi) ? ys[i][j] : hi;
+            }
+        }
+        lut.q = make_lut_q15_scale(lo, hi);
+        for (int i = 0; i < R; ++i)
+        {
+            for (int j = 0; j < C; ++j)
+            {
+                lut.y[i][j] = lut_q15_code(lut.q, ys[lut_source_index(x1s, i)][lut_source_index(x2s, j)]);
+            }
+        }
+    }
+    else
+    {
+        static_assert(std::is_same<Y, float>::value, "Lut2D storage must be float or int16_t");
+        for (int i = 0; i < R; ++i)
+        {
+            for (int j = 0; j < C; ++j)
+            {
+                lut.y[i][j] = ys[lut_source_index(x1s, i)][lut_source_index(x2s, j)];
+            }
+        }
+    }
+    return lut;
+}
+
+//-----------------------------------------------------------------------------
+// Inverse along x1: x1 = g(y, x2)
+//-----------------------------------------------------------------------------
+
+// Intentionally not defined and not constexpr, see above.
+void lut_column_must_be_non_decreasing();
+
+// Largest x1 with f(x1, x2s[j]) <= target on the piecewise-linear column j.
+// A flat run (e.g. SOC 0 % over several voltages) maps to its last node, so
+// the inverse is monotonic and continuous where the column starts rising.
+template <int R, int C>
+constexpr float lut_invert_column(const Lut2D<R, C> &fwd, int j, float target)
+{
+    if (!(target >= fwd.y[0][j]))
+    {
+        return fwd.axis1.x[0];
+    }
+    for (int i = 0; i < R - 1; ++i)
+    {
+        const float y0 = fwd.y[i][j];
+        const float y1 = fwd.y[i + 1][j];
+        if (y1 > target)
+        {
+            return fwd.axis1.x[i] + (target - y0) / (y1 - y0) * (fwd.axis1.x[i + 1] - fwd.axis1.x[i]);
+        }
+    }
+    return fwd.axis1.x[R - 1];
+}
+
+template <int R, int C, int M>
+constexpr Lut2D<M, C> make_inverse_lut2d(const Lut2D<R, C> &fwd, const float (&ys)[M])
+{
+    for (int j = 0; j < C; ++j)
+    {
+        for (int i = 0; i < R - 1; ++i)
+        {
+            if (fwd.y[i + 1][j] < fwd.y[i][j])
+            {
+                lut_column_must_be_non_decreasing();
+            }
+        }
+    }
+
+    Lut2D<M, C> inv{};
+    inv.axis1 = make_lut_axis(ys);
+    inv.axis2 = fwd.axis2;
+    for (int m = 0; m < M; ++m)
+    {
+        for (int j = 0; j < C; ++j)
+        {
+            inv.y[m][j] = lut_invert_column(fwd, j, inv.axis1.x[m]);
+        }
+    }
+    return inv;
+}
+
+#endif // LUT_H
@@ -0,0 +1,340 @@
+#ifndef RATE_SCHEDULE_H
+#define RATE_SCHEDULE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "utils/task_profiler.h"
+
+// Static rate-group executive.
+//
+// Runnables are listed in a compile-time table with a period and an offset
+// in base ticks; a runnable runs on every tick where
+// tick % period == offset. Entries without a function (hooks with no work
+// yet) are dropped from the table by make_rate_table(), so they cost nothing
+// at run time. Per runnable the executive keeps a tick countdown; a pass
+// that finds no tick due is one compare, and a due tick is one decrement per
+// runnable. Runnables run in table order, which is their priority within a
+// tick, each inside its TaskProfile.
+//
+// If execute() is called late, the elapsed ticks are processed at once and
+// every runnable that had a slot in them runs once (the TaskProfile counts
+// the missed slots).
+//
+// set_low_activity() switches to a reduced profile: a runnable with a
+// low_activity_divider of N runs on every Nth of its slots, kSuspended ones
+// not at all. Switching back takes effect at the next slot.
+//
+// The executive is cooperative: it never interrupts a runnable. A runnable
+// with a budget_us (the best-effort tier) is held to it by RateBudget below,
+// and the yield hook runs before each one, so a higher tier that became due
+// waits for at most one budgeted runnable.
+//
+//     static constexpr RateTask entries[] = {{"RX tick", &rx_tick, 2, 0, &profile, 1, 0}, ...};
+//     static constexpr auto table = make_rate_table(entries);
+//     RateScheduler<table.kCapacity> schedule(table, 1000);
+
+struct RateTask
+{
+    typedef void (*Run)();
+
+    static constexpr uint16_t kSuspended = UINT16_MAX;
+
+    const char *name;
+    Run run;
+    uint16_t period_ticks;
+    uint16_t offset_ticks; // < period_ticks
+    TaskProfile *profile;
+    uint16_t low_activity_divider; // 0 and 1: full rate, kSuspended: does not run
+    uint32_t budget_us;            // execution budget per slot, 0: unlimited
+};
+
+// Execution budget of a runnable. Without preemption the budget cannot stop
+// a run part-way, so it is enforced on the following slots instead: time
+// beyond the budget becomes debt, and while there is debt the runnable's
+// slots are skipped, each repaying one budget. Over any longer window the
+// runnable thus gets at most budget_us per slot, however long one run takes.
+// The debt is capped at kMaxDebtSlots budgets so that a single stall (USB
+// enumeration, a flash erase) does not starve the runnable for long.
+struct RateBudget
+{
+    static constexpr uint32_t kMaxDebtSlots = 16U;
+
+    RateBudget() = default;
+    explicit RateBudget(uint32_t _budget_us)
+        : budget_us(_budget_us)
+    {
+    }
+
+    uint32_t budget_us = 0U; // 0: unlimited
+    uint32_t debt_us = 0U;
+    uint32_t overruns = 0U;  // runs longer than budget_us
+    uint32_t throttled = 0U; // slots skipped to repay debt
+
+    // Whether the runnable may take this slot
+    bool admit()
+    {
+        if (debt_us == 0U)
+        {
+            return true;
+        }
+        debt_us = (debt_us > budget_us) ? debt_us - budget_us : 0U;
+        ++throttled;
+        return false;
+    }
+
+    void charge(uint32_t used_us)
+    {
+        if (budget_us == 0U || used_us <= budget_us)
+        {
+            return;
+        }
+        ++overruns;
+        const uint32_t max_debt = budget_us * kMaxDebtSlots;
+        const uint32_t excess = used_us - budget_us;
+        debt_us = (excess >= max_debt - debt_us) ? max_debt : debt_us + excess;
+    }
+};
+
+template <size_t N>
+struct RateTable
+{
+    static constexpr size_t kCapacity = N;
+
+    RateTask tasks[N];
+    size_t count;
+};
+
+template <size_t N>
+constexpr RateTable<N> make_rate_table(const RateTask (&entries)[N])
+{
+    RateTable<N> table{};
+    table.count = 0;
+    for (size_t i = 0; i < N; ++i)
+    {
+        if (entries[i].run != nullptr && entries[i].period_ticks != 0U)
+        {
+            table.tasks[table.count] = entries[i];
+            ++table.count;
+        }
+    }
+    return table;
+}
+
+// Worst-case tick over one hyperperiod (least common multiple of the
+// periods, capped at 10^6 ticks), for a given execution time per table
+// entry, in the full or the low-activity profile.
+struct RateScheduleReport
+{
+    uint32_t hyperperiod_ticks;
+    uint32_t worst_tick;
+    float worst_us;
+    float average_us;     // per tick
+    uint32_t worst_tasks; // bit i: table entry i runs in the worst tick
+};
+
+static inline bool rate_task_divided(const RateTask &task, bool low_activity)
+{
+    return low_activity && task.low_activity_divider > 1U;
+}
+
+static inline RateScheduleReport analyse_rate_tasks(const RateTask *tasks, size_t count, const float *cost_us,
+                                                    bool low_activity = false)
+{
+    static constexpr uint32_t kMaxHyperperiod = 1000000U;
+
+    RateScheduleReport report = {1U, 0U, 0.0f, 0.0f, 0U};
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (rate_task_divided(tasks[i], low_activity) && tasks[i].low_activity_divider == RateTask::kSuspended)
+        {
+            continue;
+        }
+        const uint32_t period = rate_task_divided(tasks[i], low_activity)
+                                    ? static_cast<uint32_t>(tasks[i].period_ticks) * tasks[i].low_activity_divider
+                                    : tasks[i].period_ticks;
+        uint32_t a = report.hyperperiod_ticks;
+        uint32_t b = period;
+        while (b != 0U)
+        {
+            const uint32_t t = a % b;
+            a = b;
+            b = t;
+        }
+        const uint64_t lcm = static_cast<uint64_t>(report.hyperperiod_ticks) / a * period;
+        report.hyperperiod_ticks = (lcm > kMaxHyperperiod) ? kMaxHyperperiod : static_cast<uint32_t>(lcm);
+    }
+
+    double total_us = 0.0;
+    for (uint32_t tick = 0; tick < report.hyperperiod_ticks; ++tick)
+    {
+        float tick_us = 0.0f;
+        uint32_t mask = 0U;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const RateTask &task = tasks[i];
+            if (tick % task.period_ticks != task.offset_ticks)
+            {
+                continue;
+            }
+            // The scheduler runs the first slot of every divider group
+            if (!rate_task_divided(task, low_activity) ||
+                (task.low_activity_divider != RateTask::kSuspended &&
+                 (tick / task.period_ticks) % task.low_activity_divider == 0U))
+            {
+                tick_us += cost_us[i];
+                mask |= 1UL << i;
+            }
+        }
+        total_us += tick_us;
+        if (tick_us > report.worst_us)
+        {
+            report.worst_us = tick_us;
+            report.worst_tick = tick;
+            report.worst_tasks = mask;
+        }
+    }
+    report.average_us = static_cast<float>(total_us / report.hyperperiod_ticks);
+    return report;
+}
+
+template <size_t N>
+RateScheduleReport analyse_rate_table(const RateTable<N> &table, const float *cost_us, bool low_activity = false)
+{
+    return analyse_rate_tasks(table.tasks, table.count, cost_us, low_activity);
+}
+
+template <size_t N>
+class RateScheduler
+{
+public:
+    RateScheduler(const RateTable<N> &_table, uint32_t _tick_us)
+        : table(_table),
+          tick_us(_tick_us)
+    {
+    }
+
+    // The first tick is due at now_us.
+    void start(uint32_t now_us)
+    {
+        next_tick_us = now_us;
+        for (size_t i = 0; i < table.count; ++i)
+        {
+            remaining[i] = static_cast<uint32_t>(table.tasks[i].offset_ticks) + 1U;
+            skipped[i] = 0U;
+            budgets[i] = RateBudget(table.tasks[i].budget_us);
+        }
+        started = true;
+    }
+
+    // Called before every runnable with a budget
+    void set_yield_hook(RateTask::Run hook) { yield_hook = hook; }
+
+    void set_low_activity(bool enable)
+    {
+        if (enable == low_activity)
+        {
+            return;
+        }
+        low_activity = enable;
+        for (size_t i = 0; i < table.count; ++i)
+        {
+            skipped[i] = 0U;
+            // The first start in the new profile is not a missed slot
+            if (table.tasks[i].profile != nullptr)
+            {
+                table.tasks[i].profile->resync();
+            }
+        }
+    }
+
+    // Returns the number of base ticks processed.
+    uint32_t execute(uint32_t now_us)
+    {
+        if (!started || static_cast<int32_t>(now_us - next_tick_us) < 0)
+        {
+            return 0U;
+        }
+        const uint32_t elapsed = (now_us - next_tick_us) / tick_us + 1U;
+        next_tick_us += elapsed * tick_us;
+        ticks += elapsed;
+
+        for (size_t i = 0; i < table.count; ++i)
+        {
+            const RateTask &task = table.tasks[i];
+            if (remaining[i] > elapsed)
+            {
+                remaining[i] -= elapsed;
+                continue;
+            }
+            remaining[i] = task.period_ticks - (elapsed - remaining[i]) % task.period_ticks;
+            if (rate_task_divided(task, low_activity))
+            {
+                // Slot numbers in the gap of a late call are not tracked;
+                // the divider counts calls that had at least one slot.
+                if (task.low_activity_divider == RateTask::kSuspended || skipped[i]++ != 0U)
+                {
+                    if (skipped[i] >= task.low_activity_divider)
+                    {
+                        skipped[i] = 0U;
+                    }
+                    continue;
+                }
+                if (task.profile != nullptr)
+                {
+                    task.profile->resync();
+                }
+            }
+            if (task.budget_us == 0U)
+            {
+                run_task(task);
+                continue;
+            }
+            if (!budgets[i].admit())
+            {
+                continue;
+            }
+            if (yield_hook != nullptr)
+            {
+                yield_hook();
+            }
+            const uint32_t start = task_profiler_cycles();
+            run_task(task);
+            budgets[i].charge((task_profiler_cycles() - start) / task_profiler_cycles_per_us());
+        }
+        return elapsed;
+    }
+
+    const RateTable<N> &get_table() const { return table; }
+    uint32_t get_tick_us() const { return tick_us; }
+    uint32_t get_ticks() const { return ticks; }
+    bool is_low_activity() const { return low_activity; }
+    const RateBudget &get_budget(size_t i) const { return budgets[i]; }
+
+private:
+    static void run_task(const RateTask &task)
+    {
+        if (task.profile != nullptr)
+        {
+            TaskProfileScope scope(*task.profile);
+            task.run();
+        }
+        else
+        {
+            task.run();
+        }
+    }
+
+    const RateTable<N> &table;
+    const uint32_t tick_us;
+    uint32_t next_tick_us = 0U;
+    uint32_t ticks = 0U;
+    bool started = false;
+    bool low_activity = false;
+    uint32_t remaining[N] = {};
+    uint16_t skipped[N] = {}; // slots since the last run in low activity
+    RateBudget budgets[N];
+    RateTask::Run yield_hook = nullptr;
+};
+
+#endif // RATE_SCHEDULE_H
@@ -1,11 +1,7 @@
 #ifndef RESISTANCE_LOOKUP_H
 #define RESISTANCE_LOOKUP_H
 
-#ifdef ARDUINO
-#include <Arduino.h>
-#endif
-
-#include "utils/Map2D3D.h"
+#include "utils/lut.h"
 
 // temperature_index:
 // 0 = -25°C
@@ -24,21 +20,15 @@
 // ...
 // 11 = 5%
 
-#ifdef ARDUINO
-#define LUT_PROGMEM PROGMEM
-#else
-#define LUT_PROGMEM
-#endif
-
-static const float kResistanceTemperatureLevels[4] LUT_PROGMEM = {
+static constexpr float kResistanceTemperatureLevels[4] = {
     -25, -10, 25, 40
 };
 
-static const float kResistanceSocLevels[12] LUT_PROGMEM = {
+static constexpr float kResistanceSocLevels[12] = {
     100, 95, 90, 80, 70, 60, 50, 40, 30, 20, 10, 5
 };
 
-static const float kResistanceTable413A[12][4] LUT_PROGMEM = {
+static constexpr float kResistanceTable413A[12][4] = {
     {3.85, 2.22, 0.69, 0.53},
     {3.84, 2.22, 0.68, 0.53},
     {3.87, 2.22, 0.68, 0.52},
@@ -53,7 +43,7 @@ static const float kResistanceTable413A[12][4] LUT_PROGMEM = {
     {16.31, 11.30, 1.81, 0.71}
 };
 
-static const float kResistanceTable294A[12][4] LUT_PROGMEM = {
+static constexpr float kResistanceTable294A[12][4] = {
     {4.29, 2.77, 0.96, 0.75},
     {4.31, 2.77, 0.95, 0.74},
     {4.39, 2.76, 0.94, 0.73},
@@ -68,40 +58,21 @@ static const float kResistanceTable294A[12][4] LUT_PROGMEM = {
     {48.00, 22.52, 3.79, 1.51}
 };
 
+static_assert(lut_axis_monotonic(kResistanceTemperatureLevels),
+              "kResistanceTemperatureLevels must be strictly monotonic");
+static_assert(lut_axis_monotonic(kResistanceSocLevels), "kResistanceSocLevels must be strictly monotonic");
+
+static constexpr Lut2D<12, 4> kResistance413ALut LUT_PROGMEM =
+    make_lut2d(kResistanceSocLevels, kResistanceTemperatureLevels, kResistanceTable413A);
+static constexpr Lut2D<12, 4> kResistance294ALut LUT_PROGMEM =
+    make_lut2d(kResistanceSocLevels, kResistanceTemperatureLevels, kResistanceTable294A);
+
 inline float resistanceFromSocTemp413A(float temperature, float soc) {
-    static Map3D<12, 4, float, float> map;
-    static bool initialized = false;
-    if (!initialized) {
-#ifdef ARDUINO
-        map.setX1s_P(kResistanceSocLevels);
-        map.setX2s_P(kResistanceTemperatureLevels);
-        map.setYs_P(&kResistanceTable413A[0][0]);
-#else
-        map.setX1s(kResistanceSocLevels);
-        map.setX2s(kResistanceTemperatureLevels);
-        map.setYs(&kResistanceTable413A[0][0]);
-#endif
-        initialized = true;
-    }
-    return map.f(soc, temperature);
+    return kResistance413ALut.f(soc, temperature);
 }
 
 inline float resistanceFromSocTemp294A(float temperature, float soc) {
-    static Map3D<12, 4, float, float> map;
-    static bool initialized = false;
-    if (!initialized) {
-#ifdef ARDUINO
-        map.setX1s_P(kResistanceSocLevels);
-        map.setX2s_P(kResistanceTemperatureLevels);
-        map.setYs_P(&kResistanceTable294A[0][0]);
-#else
-        map.setX1s(kResistanceSocLevels);
-        map.setX2s(kResistanceTemperatureLevels);
-        map.setYs(&kResistanceTable294A[0][0]);
-#endif
-        initialized = true;
-    }
-    return map.f(soc, temperature);
+    return kResistance294ALut.f(soc, temperature);
 }
 
 inline float resistanceFromSocTemp(float temperature, float soc, int current_index) {
@@ -110,6 +81,28 @@ inline float resistanceFromSocTemp(float temperature, float soc, int current_ind
         resistanceFromSocTemp294A(temperature, soc);
 }
 
+// Resolve the temperature bracket once; slice.f(soc) returns R [mOhm].
+typedef LutSlice<12, 4> ResistanceSocSlice;
+
+inline ResistanceSocSlice resistanceSliceAtTemp(float temperature, int current_index) {
+    return current_index == 0 ?
+        kResistance413ALut.slice_x2(temperature) :
+        kResistance294ALut.slice_x2(temperature);
+}
+
+// r[k] = R [mOhm] at soc[k] for k < n, all at one temperature.
+inline void resistanceFromSocTempBatch(float temperature, const float *soc, float *r, int n,
+                                       int current_index) {
+    (current_index == 0 ? kResistance413ALut : kResistance294ALut).f_batch(soc, r, n, temperature);
+}
+
+// As above with one temperature per group of cells_per_temp consecutive cells.
+inline void resistanceFromSocTempBatch(const float *temperatures, int cells_per_temp,
+                                       const float *soc, float *r, int n, int current_index) {
+    (current_index == 0 ? kResistance413ALut : kResistance294ALut)
+        .f_batch(soc, r, n, temperatures, cells_per_temp);
+}
+
 #define RESISTANCE_FROM_SOC_TEMP(t, soc, current) \
     resistanceFromSocTemp((t), (soc), (current))
 
@@ -1,28 +1,18 @@
 #ifndef SOC_LOOKUP_H
 #define SOC_LOOKUP_H
 
-#ifdef ARDUINO
-#include <Arduino.h>
-#endif
+#include "utils/lut.h"
 
-#include "utils/Map2D3D.h"
-
-#ifdef ARDUINO
-#define LUT_PROGMEM PROGMEM
-#else
-#define LUT_PROGMEM
-#endif
-
-static const float kTemperatureLevels[4] LUT_PROGMEM = {
+static constexpr float kTemperatureLevels[4] = {
   40, 25, -10, -25
 };
 
-static const float kVoltageLevels[17] LUT_PROGMEM = {
+static constexpr float kVoltageLevels[17] = {
   3.350, 3.400, 3.450, 3.500, 3.550, 3.600, 3.650, 3.700, 3.750, 3.800,
   3.850, 3.900, 3.950, 4.000, 4.050, 4.100, 4.150
 };
 
-static const float kSocTable[17][4] LUT_PROGMEM = {
+static constexpr float kSocTable[17][4] = {
   {  0.000,   0.000,   0.000,   0.000},
   {  0.880,   0.000,   0.000,   0.000},
   {  9.650,   5.350,   3.780,   3.000},
@@ -42,22 +32,61 @@ static const float kSocTable[17][4] LUT_PROGMEM = {
   {100.000, 100.000, 100.000, 100.000}
 };
 
+static_assert(lut_axis_monotonic(kTemperatureLevels), "kTemperatureLevels must be strictly monotonic");
+static_assert(lut_axis_monotonic(kVoltageLevels), "kVoltageLevels must be strictly monotonic");
+
+static constexpr Lut2D<17, 4> kSocLut LUT_PROGMEM =
+    make_lut2d(kVoltageLevels, kTemperatureLevels, kSocTable);
+
 inline float socFromOcvTemp(float temperature, float ocv) {
-    static Map3D<17, 4, float, float> map;
-    static bool initialized = false;
-    if (!initialized) {
-#ifdef ARDUINO
-        map.setX1s_P(kVoltageLevels);
-        map.setX2s_P(kTemperatureLevels);
-        map.setYs_P(&kSocTable[0][0]);
-#else
-        map.setX1s(kVoltageLevels);
-        map.setX2s(kTemperatureLevels);
-        map.setYs(&kSocTable[0][0]);
-#endif
-        initialized = true;
-    }
-    return map.f(ocv, temperature);
+    return kSocLut.f(ocv, temperature);
+}
+
+// Resolve the temperature bracket once; slice.f(ocv) returns SOC [%].
+typedef LutSlice<17, 4> SocOcvSlice;
+
+inline SocOcvSlice socOcvSliceAtTemp(float temperature) {
+    return kSocLut.slice_x2(temperature);
+}
+
+// soc[k] = SOC [%] of ocv[k] for k < n, all at one temperature.
+inline void socFromOcvTempBatch(float temperature, const float *ocv, float *soc, int n) {
+    kSocLut.f_batch(ocv, soc, n, temperature);
+}
+
+// As above with one temperature per group of cells_per_temp consecutive cells
+// (e.g. module temperatures with CELLS_PER_MODULE).
+inline void socFromOcvTempBatch(const float *temperatures, int cells_per_temp,
+                                const float *ocv, float *soc, int n) {
+    kSocLut.f_batch(ocv, soc, n, temperatures, cells_per_temp);
+}
+
+// Inverse table OCV(SOC, T), generated at build time from kSocLut on a 1 %
+// SOC grid. Each temperature column is the inverse of the kSocLut column at
+// the grid points and monotonic by construction. Between the measured
+// temperatures the two tables interpolate along different directions, so
+// SOC -> OCV -> SOC round trips within about 0.5 % SOC (see test/lut).
+static constexpr float kOcvSocLevels[101] = {
+    0.0,   1.0,   2.0,   3.0,   4.0,   5.0,   6.0,   7.0,   8.0,   9.0,
+   10.0,  11.0,  12.0,  13.0,  14.0,  15.0,  16.0,  17.0,  18.0,  19.0,
+   20.0,  21.0,  22.0,  23.0,  24.0,  25.0,  26.0,  27.0,  28.0,  29.0,
+   30.0,  31.0,  32.0,  33.0,  34.0,  35.0,  36.0,  37.0,  38.0,  39.0,
+   40.0,  41.0,  42.0,  43.0,  44.0,  45.0,  46.0,  47.0,  48.0,  49.0,
+   50.0,  51.0,  52.0,  53.0,  54.0,  55.0,  56.0,  57.0,  58.0,  59.0,
+   60.0,  61.0,  62.0,  63.0,  64.0,  65.0,  66.0,  67.0,  68.0,  69.0,
+   70.0,  71.0,  72.0,  73.0,  74.0,  75.0,  76.0,  77.0,  78.0,  79.0,
+   80.0,  81.0,  82.0,  83.0,  84.0,  85.0,  86.0,  87.0,  88.0,  89.0,
+   90.0,  91.0,  92.0,  93.0,  94.0,  95.0,  96.0,  97.0,  98.0,  99.0,
+  100.0
+};
+
+static_assert(lut_axis_monotonic(kOcvSocLevels), "kOcvSocLevels must be strictly monotonic");
+
+static constexpr Lut2D<101, 4> kOcvLut LUT_PROGMEM = make_inverse_lut2d(kSocLut, kOcvSocLevels);
+
+// OCV [V] for SOC [%]; clamps to the table range like socFromOcvTemp().
+inline float ocvFromSocTemp(float temperature, float soc) {
+    return kOcvLut.f(soc, temperature);
 }
 
 #define SOC_FROM_OCV_TEMP(t, ocv) socFromOcvTemp((t), (ocv))
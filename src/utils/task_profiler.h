@@ -0,0 +1,247 @@
+#ifndef TASK_PROFILER_H
+#define TASK_PROFILER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__IMXRT1062__)
+#include <Arduino.h>
+#else
+#include <chrono>
+#endif
+
+// Execution-time and start-jitter statistics for periodic runnables.
+//
+// Time is taken from the cycle counter (DWT CYCCNT on target, steady_clock
+// nanoseconds on the host), so a measurement costs two register reads. Per
+// task the profile keeps min/avg/max execution time, a quarter-octave
+// histogram for percentiles (about 9 % resolution), the spread of start
+// times around the nominal period, overruns (execution longer than the
+// period) and missed slots (two or more periods between starts). Tasks with
+// period 0 (loop() work) only get execution-time statistics.
+//
+// Runnables in a rate table (utils/rate_schedule.h) are timed by the
+// executive; wrap other work with a TaskProfileScope on the stack:
+//     { TaskProfileScope scope(task_profiles[TASK_PROFILE_SERIAL_CONSOLE]); serial_console(); }
+
+static inline uint32_t task_profiler_cycles()
+{
+#if defined(__IMXRT1062__)
+    return ARM_DWT_CYCCNT;
+#else
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+#endif
+}
+
+static inline uint32_t task_profiler_cycles_per_us()
+{
+#if defined(__IMXRT1062__)
+    return F_CPU_ACTUAL / 1000000UL;
+#else
+    return 1000U; // nanoseconds
+#endif
+}
+
+class TaskProfile
+{
+public:
+    static constexpr size_t kBins = 124U; // quarter octaves up to 2^32 cycles
+
+    TaskProfile(const char *_name, uint32_t _period_ms)
+        : name(_name),
+          period_ms(_period_ms)
+    {
+        reset();
+    }
+
+    void reset()
+    {
+        count = 0U;
+        total_cycles = 0U;
+        min_cycles = UINT32_MAX;
+        max_cycles = 0U;
+        overrun_count = 0U;
+        missed_count = 0U;
+        late_cycles = 0;
+        early_cycles = 0;
+        have_start = false;
+        last_start = 0U;
+        for (uint16_t &bin : histogram)
+        {
+            bin = 0U;
+        }
+    }
+
+    // One execution from start to end (cycle counter values).
+    void record(uint32_t start, uint32_t end)
+    {
+        const uint32_t cycles = end - start;
+        ++count;
+        total_cycles += cycles;
+        min_cycles = (cycles < min_cycles) ? cycles : min_cycles;
+        max_cycles = (cycles > max_cycles) ? cycles : max_cycles;
+        add_to_histogram(bin_of(cycles));
+
+        if (period_ms == 0U)
+        {
+            return;
+        }
+        const uint32_t period = period_ms * 1000U * task_profiler_cycles_per_us();
+        if (cycles > period)
+        {
+            ++overrun_count;
+        }
+        if (have_start)
+        {
+            const uint32_t interval = start - last_start;
+            const int32_t deviation = static_cast<int32_t>(interval - period);
+            late_cycles = (deviation > late_cycles) ? deviation : late_cycles;
+            early_cycles = (deviation < early_cycles) ? deviation : early_cycles;
+            if (interval >= 2U * period)
+            {
+                ++missed_count;
+            }
+        }
+        have_start = true;
+        last_start = start;
+    }
+
+    // The next start is not compared with the previous one, e.g. after
+    // slots were skipped on purpose.
+    void resync()
+    {
+        have_start = false;
+    }
+
+    // Cycles below which the fraction q of executions lies (bin upper edge).
+    uint32_t percentile_cycles(float q) const
+    {
+        uint32_t total = 0U;
+        for (uint16_t bin : histogram)
+        {
+            total += bin;
+        }
+        if (total == 0U)
+        {
+            return 0U;
+        }
+
+        const uint32_t target = static_cast<uint32_t>(q * static_cast<float>(total) + 0.5f);
+        uint32_t seen = 0U;
+        for (size_t i = 0; i < kBins; ++i)
+        {
+            seen += histogram[i];
+            if (seen >= target && histogram[i] != 0U)
+            {
+                const uint32_t upper = bin_upper(i);
+                return (upper < max_cycles) ? upper : max_cycles;
+            }
+        }
+        return max_cycles;
+    }
+
+    const char *get_name() const { return name; }
+    uint32_t get_period_ms() const { return period_ms; }
+    uint32_t get_count() const { return count; }
+    uint32_t get_overruns() const { return overrun_count; }
+    uint32_t get_missed() const { return missed_count; }
+
+    float min_us() const { return (count == 0U) ? 0.0f : to_us(min_cycles); }
+    float max_us() const { return to_us(max_cycles); }
+    float avg_us() const { return (count == 0U) ? 0.0f : to_us(total_cycles) / static_cast<float>(count); }
+    float p99_us() const { return to_us(percentile_cycles(0.99f)); }
+    // Largest start delay (+) and advance (-) against the period.
+    float late_us() const { return to_us_signed(late_cycles); }
+    float early_us() const { return to_us_signed(early_cycles); }
+    uint64_t busy_cycles() const { return total_cycles; }
+
+private:
+    const char *name;
+    uint32_t period_ms;
+
+    uint32_t count;
+    uint64_t total_cycles;
+    uint32_t min_cycles;
+    uint32_t max_cycles;
+    uint32_t overrun_count;
+    uint32_t missed_count;
+    int32_t late_cycles;
+    int32_t early_cycles;
+    bool have_start;
+    uint32_t last_start;
+    uint16_t histogram[kBins];
+
+    // Exact below 8 cycles, then four bins per octave.
+    static size_t bin_of(uint32_t cycles)
+    {
+        if (cycles < 8U)
+        {
+            return cycles;
+        }
+        const uint32_t msb = 31U - static_cast<uint32_t>(__builtin_clz(cycles));
+        const uint32_t quarter = (cycles >> (msb - 2U)) & 3U;
+        return 8U + (msb - 3U) * 4U + quarter;
+    }
+
+    static uint32_t bin_upper(size_t bin)
+    {
+        if (bin < 8U)
+        {
+            return static_cast<uint32_t>(bin);
+        }
+        const uint32_t msb = 3U + static_cast<uint32_t>(bin - 8U) / 4U;
+        const uint32_t quarter = static_cast<uint32_t>(bin - 8U) % 4U;
+        const uint64_t upper = ((4ULL + quarter + 1U) << (msb - 2U)) - 1U;
+        return (upper > UINT32_MAX) ? UINT32_MAX : static_cast<uint32_t>(upper);
+    }
+
+    // Counts are halved when one would overflow, so the percentiles follow
+    // recent behaviour on long runs.
+    void add_to_histogram(size_t bin)
+    {
+        if (histogram[bin] == UINT16_MAX)
+        {
+            for (uint16_t &value : histogram)
+            {
+                value = static_cast<uint16_t>(value >> 1);
+            }
+        }
+        ++histogram[bin];
+    }
+
+    static float to_us(uint64_t cycles)
+    {
+        return static_cast<float>(cycles) / static_cast<float>(task_profiler_cycles_per_us());
+    }
+
+    static float to_us_signed(int32_t cycles)
+    {
+        return static_cast<float>(cycles) / static_cast<float>(task_profiler_cycles_per_us());
+    }
+};
+
+// Times the enclosing block into a TaskProfile.
+class TaskProfileScope
+{
+public:
+    explicit TaskProfileScope(TaskProfile &_profile)
+        : profile(_profile),
+          start(task_profiler_cycles())
+    {
+    }
+
+    ~TaskProfileScope()
+    {
+        profile.record(start, task_profiler_cycles());
+    }
+
+    TaskProfileScope(const TaskProfileScope &) = delete;
+    TaskProfileScope &operator=(const TaskProfileScope &) = delete;
+
+private:
+    TaskProfile &profile;
+    const uint32_t start;
+};
+
+#endif // TASK_PROFILER_H
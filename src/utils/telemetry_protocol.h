@@ -0,0 +1,296 @@
+#ifndef TELEMETRY_PROTOCOL_H
+#define TELEMETRY_PROTOCOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "settings.h"
+#include "signal_registry.h"
+#include "utils/cobs.h"
+#include "utils/crc32.h"
+
+// Binary telemetry protocol on the second USB serial (SerialUSB1).
+//
+// Every frame is COBS encoded (utils/cobs.h) and ends with a 0x00 byte.
+// Decoded, all values little endian:
+//
+//   0     protocol version (kTelemetryVersion)
+//   1     group (TelemetryGroup)
+//   2-3   sequence, per group; a gap means frames were skipped
+//   4-7   time since boot in µs when the group was sampled
+//   8..   payload, laid out by the group's TelemetryLayout
+//   last 4  CRC-32 (utils/crc32.h) over all bytes before it
+//
+// Payload: the fields of the layout in order, each repeated count times,
+// then, for layouts with blocks, a u8 block count and that many blocks of
+// the block fields (one block per battery module). Values are integers;
+// the physical value is raw * scale in unit.
+//
+// Firmware and the host decoder (tools/telemetry_decode) share these
+// tables; change kTelemetryVersion when a layout changes. Units and scales
+// of fields that carry a registry signal come from kSignalInfo.
+
+static constexpr uint8_t kTelemetryVersion = 1U;
+static constexpr size_t kTelemetryHeaderBytes = 8U;
+static constexpr size_t kTelemetryCrcBytes = 4U;
+
+enum TelemetryGroup : uint8_t
+{
+    TELEMETRY_CELL_VOLTAGES,
+    TELEMETRY_TEMPERATURES,
+    TELEMETRY_SHUNT,
+    TELEMETRY_LIMITS,
+    TELEMETRY_STATES,
+    TELEMETRY_GROUP_COUNT
+};
+
+enum TelemetryType : uint8_t
+{
+    TELEMETRY_U8,
+    TELEMETRY_I8,
+    TELEMETRY_U16,
+    TELEMETRY_I16,
+    TELEMETRY_U32,
+    TELEMETRY_I32
+};
+
+struct TelemetryField
+{
+    const char *name;
+    const char *unit;
+    TelemetryType type;
+    float scale; // physical = raw * scale
+    uint8_t count;
+};
+
+struct TelemetryLayout
+{
+    const char *name;
+    const TelemetryField *fields;
+    uint8_t field_count;
+    const TelemetryField *block_fields; // nullptr: no blocks
+    uint8_t block_field_count;
+    uint8_t max_blocks;
+};
+
+static constexpr size_t telemetry_type_size(TelemetryType type)
+{
+    return (type == TELEMETRY_U8 || type == TELEMETRY_I8) ? 1U : (type == TELEMETRY_U16 || type == TELEMETRY_I16) ? 2U : 4U;
+}
+
+// Field carrying a registry signal: unit and scale are taken from
+// kSignalInfo (signal_registry.h), the single source of signal metadata.
+#define TELEMETRY_SIGNAL_FIELD(name, signal, type, count) \
+    TelemetryField { name, kSignalInfo[signal].unit, type, kSignalInfo[signal].scale, count }
+
+static constexpr TelemetryField kTelemetryCellFields[] = {
+    TELEMETRY_SIGNAL_FIELD("pack_voltage", SIGNAL_PACK_VOLTAGE, TELEMETRY_U16, 1),
+};
+static constexpr TelemetryField kTelemetryCellBlockFields[] = {
+    TELEMETRY_SIGNAL_FIELD("cell", SIGNAL_CELL_VOLTAGE, TELEMETRY_U16, CELLS_PER_MODULE),
+};
+
+static constexpr TelemetryField kTelemetryTemperatureBlockFields[] = {
+    TELEMETRY_SIGNAL_FIELD("temp", SIGNAL_MODULE_TEMPERATURE, TELEMETRY_I16, TEMPS_PER_MODULE),
+    TELEMETRY_SIGNAL_FIELD("internal_temp", SIGNAL_MODULE_INTERNAL_TEMPERATURE, TELEMETRY_I16, 1),
+};
+
+static constexpr TelemetryField kTelemetryShuntFields[] = {
+    TELEMETRY_SIGNAL_FIELD("current", SIGNAL_SHUNT_CURRENT, TELEMETRY_I32, 1),
+    TELEMETRY_SIGNAL_FIELD("current_avg", SIGNAL_SHUNT_CURRENT_AVG, TELEMETRY_I32, 1),
+    TELEMETRY_SIGNAL_FIELD("u_input_hvbox", SIGNAL_SHUNT_U_INPUT, TELEMETRY_I32, 1),
+    TELEMETRY_SIGNAL_FIELD("u_output_hvbox", SIGNAL_SHUNT_U_OUTPUT, TELEMETRY_I32, 1),
+    TELEMETRY_SIGNAL_FIELD("u3", SIGNAL_SHUNT_U3, TELEMETRY_I32, 1),
+    TELEMETRY_SIGNAL_FIELD("temp", SIGNAL_SHUNT_TEMPERATURE, TELEMETRY_I16, 1),
+    TELEMETRY_SIGNAL_FIELD("power", SIGNAL_SHUNT_POWER, TELEMETRY_I32, 1),
+    TELEMETRY_SIGNAL_FIELD("charge", SIGNAL_SHUNT_CHARGE, TELEMETRY_I32, 1),
+    TELEMETRY_SIGNAL_FIELD("energy", SIGNAL_SHUNT_ENERGY, TELEMETRY_I32, 1),
+    TELEMETRY_SIGNAL_FIELD("state", SIGNAL_SHUNT_STATE, TELEMETRY_U8, 1),
+    TELEMETRY_SIGNAL_FIELD("dtc", SIGNAL_SHUNT_DTC, TELEMETRY_U16, 1),
+};
+
+static constexpr TelemetryField kTelemetryLimitFields[] = {
+    TELEMETRY_SIGNAL_FIELD("max_charge_current", SIGNAL_MAX_CHARGE_CURRENT, TELEMETRY_I16, 1),
+    TELEMETRY_SIGNAL_FIELD("max_discharge_current", SIGNAL_MAX_DISCHARGE_CURRENT, TELEMETRY_I16, 1),
+    TELEMETRY_SIGNAL_FIELD("peak_discharge", SIGNAL_LIMIT_PEAK_DISCHARGE, TELEMETRY_I16, 1),
+    TELEMETRY_SIGNAL_FIELD("rms_discharge", SIGNAL_LIMIT_RMS_DISCHARGE, TELEMETRY_I16, 1),
+    TELEMETRY_SIGNAL_FIELD("peak_charge", SIGNAL_LIMIT_PEAK_CHARGE, TELEMETRY_I16, 1),
+    TELEMETRY_SIGNAL_FIELD("rms_charge", SIGNAL_LIMIT_RMS_CHARGE, TELEMETRY_I16, 1),
+    TELEMETRY_SIGNAL_FIELD("rms_derated_discharge", SIGNAL_LIMIT_RMS_DERATED_DISCHARGE, TELEMETRY_I16, 1),
+    TELEMETRY_SIGNAL_FIELD("rms_derated_charge", SIGNAL_LIMIT_RMS_DERATED_CHARGE, TELEMETRY_I16, 1),
+    TELEMETRY_SIGNAL_FIELD("soc", SIGNAL_SOC, TELEMETRY_U16, 1),
+    TELEMETRY_SIGNAL_FIELD("soc_ocv_lut", SIGNAL_SOC_OCV_LUT, TELEMETRY_U16, 1),
+    TELEMETRY_SIGNAL_FIELD("soc_coulomb_counting", SIGNAL_SOC_COULOMB_COUNTING, TELEMETRY_U16, 1),
+    TELEMETRY_SIGNAL_FIELD("lowest_cell_voltage", SIGNAL_CELL_VOLTAGE_MIN, TELEMETRY_U16, 1),
+    TELEMETRY_SIGNAL_FIELD("highest_cell_voltage", SIGNAL_CELL_VOLTAGE_MAX, TELEMETRY_U16, 1),
+    TELEMETRY_SIGNAL_FIELD("lowest_temp", SIGNAL_TEMPERATURE_MIN, TELEMETRY_I16, 1),
+    TELEMETRY_SIGNAL_FIELD("highest_temp", SIGNAL_TEMPERATURE_MAX, TELEMETRY_I16, 1),
+};
+
+static constexpr TelemetryField kTelemetryStateFields[] = {
+    TELEMETRY_SIGNAL_FIELD("bms_state", SIGNAL_BMS_STATE, TELEMETRY_U8, 1),
+    TELEMETRY_SIGNAL_FIELD("bms_dtc", SIGNAL_BMS_DTC, TELEMETRY_U16, 1),
+    TELEMETRY_SIGNAL_FIELD("vehicle_state", SIGNAL_VEHICLE_STATE, TELEMETRY_I8, 1),
+    TELEMETRY_SIGNAL_FIELD("contactor_state", SIGNAL_CONTACTOR_STATE, TELEMETRY_U8, 1),
+    TELEMETRY_SIGNAL_FIELD("pack_state", SIGNAL_PACK_STATE, TELEMETRY_U8, 1),
+    TELEMETRY_SIGNAL_FIELD("shunt_state", SIGNAL_SHUNT_STATE, TELEMETRY_U8, 1),
+    TELEMETRY_SIGNAL_FIELD("balancing_active", SIGNAL_BALANCING_ACTIVE, TELEMETRY_U8, 1),
+    TELEMETRY_SIGNAL_FIELD("low_activity", SIGNAL_LOW_ACTIVITY, TELEMETRY_U8, 1),
+};
+static constexpr TelemetryField kTelemetryStateBlockFields[] = {
+    TELEMETRY_SIGNAL_FIELD("state", SIGNAL_MODULE_STATE, TELEMETRY_U8, 1),
+    TELEMETRY_SIGNAL_FIELD("dtc", SIGNAL_MODULE_DTC, TELEMETRY_U8, 1),
+    TELEMETRY_SIGNAL_FIELD("crc_failures", SIGNAL_MODULE_CRC_FAILURES, TELEMETRY_U8, 1),
+    {"balancing", "", TELEMETRY_U16, 1.0f, 1}, // bit i: cell i
+};
+
+#undef TELEMETRY_SIGNAL_FIELD
+
+#define TELEMETRY_FIELDS(a) a, static_cast<uint8_t>(sizeof(a) / sizeof(a[0]))
+
+static constexpr TelemetryLayout kTelemetryLayouts[TELEMETRY_GROUP_COUNT] = {
+    {"cells", TELEMETRY_FIELDS(kTelemetryCellFields), TELEMETRY_FIELDS(kTelemetryCellBlockFields), MODULES_PER_PACK},
+    {"temperatures", nullptr, 0, TELEMETRY_FIELDS(kTelemetryTemperatureBlockFields), MODULES_PER_PACK},
+    {"shunt", TELEMETRY_FIELDS(kTelemetryShuntFields), nullptr, 0, 0},
+    {"limits", TELEMETRY_FIELDS(kTelemetryLimitFields), nullptr, 0, 0},
+    {"states", TELEMETRY_FIELDS(kTelemetryStateFields), TELEMETRY_FIELDS(kTelemetryStateBlockFields), MODULES_PER_PACK},
+};
+
+#undef TELEMETRY_FIELDS
+
+static constexpr size_t telemetry_fields_size(const TelemetryField *fields, uint8_t count)
+{
+    size_t size = 0U;
+    for (uint8_t i = 0; i < count; ++i)
+    {
+        size += telemetry_type_size(fields[i].type) * fields[i].count;
+    }
+    return size;
+}
+
+// Largest payload of a group (all blocks present)
+static constexpr size_t telemetry_max_payload_size(const TelemetryLayout &layout)
+{
+    return telemetry_fields_size(layout.fields, layout.field_count) +
+           ((layout.block_fields != nullptr)
+                ? 1U + layout.max_blocks * telemetry_fields_size(layout.block_fields, layout.block_field_count)
+                : 0U);
+}
+
+// Largest encoded frame of a group, delimiter included
+static constexpr size_t telemetry_max_frame_size(TelemetryGroup group)
+{
+    return cobs_max_encoded_size(kTelemetryHeaderBytes + telemetry_max_payload_size(kTelemetryLayouts[group]) +
+                                 kTelemetryCrcBytes) +
+           1U;
+}
+
+static constexpr size_t telemetry_largest_frame_size()
+{
+    size_t size = 0U;
+    for (uint8_t g = 0; g < TELEMETRY_GROUP_COUNT; ++g)
+    {
+        const size_t frame = telemetry_max_frame_size(static_cast<TelemetryGroup>(g));
+        size = (frame > size) ? frame : size;
+    }
+    return size;
+}
+
+static inline int64_t telemetry_read_value(TelemetryType type, const uint8_t *data)
+{
+    uint32_t raw = 0U;
+    for (size_t i = telemetry_type_size(type); i > 0U; --i)
+    {
+        raw = (raw << 8) | data[i - 1U];
+    }
+    switch (type)
+    {
+    case TELEMETRY_I8:
+        return static_cast<int8_t>(raw);
+    case TELEMETRY_I16:
+        return static_cast<int16_t>(raw);
+    case TELEMETRY_I32:
+        return static_cast<int32_t>(raw);
+    default:
+        return raw;
+    }
+}
+
+// Decoded frame (after COBS), checked for version, group and CRC
+struct TelemetryFrameView
+{
+    TelemetryGroup group;
+    uint16_t sequence;
+    uint32_t time_us;
+    const uint8_t *payload;
+    size_t payload_size;
+};
+
+static inline bool telemetry_parse_frame(const uint8_t *frame, size_t size, TelemetryFrameView *view)
+{
+    if (size < kTelemetryHeaderBytes + kTelemetryCrcBytes || frame[0] != kTelemetryVersion ||
+        frame[1] >= TELEMETRY_GROUP_COUNT)
+    {
+        return false;
+    }
+    const size_t crc_pos = size - kTelemetryCrcBytes;
+    const uint32_t crc = static_cast<uint32_t>(telemetry_read_value(TELEMETRY_U32, frame + crc_pos));
+    if (crc != crc32_ieee(frame, crc_pos))
+    {
+        return false;
+    }
+    view->group = static_cast<TelemetryGroup>(frame[1]);
+    view->sequence = static_cast<uint16_t>(telemetry_read_value(TELEMETRY_U16, frame + 2));
+    view->time_us = static_cast<uint32_t>(telemetry_read_value(TELEMETRY_U32, frame + 4));
+    view->payload = frame + kTelemetryHeaderBytes;
+    view->payload_size = crc_pos - kTelemetryHeaderBytes;
+    return true;
+}
+
+// Calls visit(field, block, index, raw) for every value of the payload in
+// order; block is -1 outside the blocks, index counts the field's repeats.
+// Returns false if the payload does not match the layout.
+template <typename Visit>
+bool telemetry_for_each_value(const TelemetryFrameView &view, Visit visit)
+{
+    const TelemetryLayout &layout = kTelemetryLayouts[view.group];
+    size_t pos = 0U;
+    const auto visit_fields = [&](const TelemetryField *fields, uint8_t count, int block) {
+        for (uint8_t f = 0; f < count; ++f)
+        {
+            const size_t size = telemetry_type_size(fields[f].type);
+            for (uint8_t i = 0; i < fields[f].count; ++i)
+            {
+                if (pos + size > view.payload_size)
+                {
+                    return false;
+                }
+                visit(fields[f], block, i, telemetry_read_value(fields[f].type, view.payload + pos));
+                pos += size;
+            }
+        }
+        return true;
+    };
+    if (!visit_fields(layout.fields, layout.field_count, -1))
+    {
+        return false;
+    }
+    if (layout.block_fields != nullptr)
+    {
+        if (pos >= view.payload_size || view.payload[pos] > layout.max_blocks)
+        {
+            return false;
+        }
+        const uint8_t blocks = view.payload[pos++];
+        for (uint8_t b = 0; b < blocks; ++b)
+        {
+            if (!visit_fields(layout.block_fields, layout.block_field_count, b))
+            {
+                return false;
+            }
+        }
+    }
+    return pos == view.payload_size;
+}
+
+#endif // TELEMETRY_PROTOCOL_H
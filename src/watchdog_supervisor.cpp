@@ -0,0 +1,107 @@
+#include "watchdog_supervisor.h"
+
+#include <string.h>
+
+#include "utils/crc32.h"
+
+#if defined(__IMXRT1062__)
+#include <Arduino.h>
+// DMAMEM (OCRAM) is not cleared by the startup code and keeps its contents
+// across a watchdog or software reset. It is cached, so writes are flushed
+// before the reset.
+#define WATCHDOG_NOINIT DMAMEM
+#else
+#define WATCHDOG_NOINIT
+#endif
+
+static WatchdogFreezeFrame noinit_freeze_frame WATCHDOG_NOINIT;
+static uint32_t noinit_boot_request[2] WATCHDOG_NOINIT; // request, ~request
+
+static WatchdogFreezeFrame boot_freeze_frame;
+static bool boot_freeze_frame_valid = false;
+
+static void flush_noinit(void *data, size_t size)
+{
+#if defined(__IMXRT1062__)
+    arm_dcache_flush(data, size);
+#else
+    (void)data;
+    (void)size;
+#endif
+}
+
+static uint32_t freeze_frame_crc(const WatchdogFreezeFrame &frame)
+{
+    return crc32_ieee(&frame, offsetof(WatchdogFreezeFrame, crc));
+}
+
+void record_watchdog_freeze_frame(const HeartbeatSupervisor &supervisor, uint32_t now_ms)
+{
+    WatchdogFreezeFrame &frame = noinit_freeze_frame;
+    memset(&frame, 0, sizeof(frame));
+    frame.magic = WatchdogFreezeFrame::kMagic;
+
+    uint32_t overdue_ms = 0U;
+    const size_t late = supervisor.most_overdue(now_ms, &overdue_ms);
+    if (late != HeartbeatSupervisor::kNone)
+    {
+        const Heartbeat &heartbeat = supervisor.get(late);
+        strncpy(frame.task, heartbeat.name, WatchdogFreezeFrame::kNameLength - 1U);
+        frame.overdue_ms = overdue_ms;
+        frame.deadline_ms = heartbeat.deadline_ms;
+    }
+    else
+    {
+        strncpy(frame.task, "none", WatchdogFreezeFrame::kNameLength - 1U);
+    }
+    frame.stale_mask = supervisor.stale_mask(now_ms);
+    frame.supervisor_age_ms = now_ms - supervisor.last_supervised();
+    frame.uptime_ms = now_ms;
+    frame.crc = freeze_frame_crc(frame);
+    flush_noinit(&frame, sizeof(frame));
+}
+
+void capture_watchdog_freeze_frame()
+{
+    WatchdogFreezeFrame &frame = noinit_freeze_frame;
+    boot_freeze_frame_valid = frame.magic == WatchdogFreezeFrame::kMagic && frame.crc == freeze_frame_crc(frame);
+    if (boot_freeze_frame_valid)
+    {
+        boot_freeze_frame = frame;
+        boot_freeze_frame.task[WatchdogFreezeFrame::kNameLength - 1U] = '\0';
+    }
+    frame.magic = 0U;
+    flush_noinit(&frame, sizeof(frame));
+}
+
+const WatchdogFreezeFrame *boot_watchdog_freeze_frame()
+{
+    return boot_freeze_frame_valid ? &boot_freeze_frame : nullptr;
+}
+
+void request_reboot(BootRequest request)
+{
+    noinit_boot_request[0] = request;
+    noinit_boot_request[1] = ~static_cast<uint32_t>(request);
+    flush_noinit(noinit_boot_request, sizeof(noinit_boot_request));
+#if defined(__IMXRT1062__)
+    SCB_AIRCR = 0x05FA0004; // SYSRESETREQ
+    while (true)
+    {
+    }
+#endif
+}
+
+BootRequest take_boot_request()
+{
+    const uint32_t request = noinit_boot_request[0];
+    const bool valid = noinit_boot_request[1] == ~request;
+    noinit_boot_request[0] = BOOT_REQUEST_NONE;
+    noinit_boot_request[1] = 0U;
+    flush_noinit(noinit_boot_request, sizeof(noinit_boot_request));
+    if (valid && request == BOOT_REQUEST_CONFIGURE_SHUNT)
+    {
+        return BOOT_REQUEST_CONFIGURE_SHUNT;
+    }
+    return BOOT_REQUEST_NONE;
+}
@@ -0,0 +1,161 @@
+#ifndef WATCHDOG_SUPERVISOR_H
+#define WATCHDOG_SUPERVISOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Heartbeat supervision for the WDT3 watchdog.
+//
+// Every critical runnable checks in with check_in() each time it runs. The
+// real-time tier calls supervise() once per millisecond and only feeds the
+// watchdog while every heartbeat is younger than its deadline, so one stalled
+// runnable resets the controller just like a blocked loop(). A supervise()
+// pass is one subtraction and compare per heartbeat.
+//
+// Not interrupt-safe except for most_overdue(), which the WDT3 callback uses
+// to name the late runnable in the freeze-frame.
+
+struct Heartbeat
+{
+    const char *name;
+    uint32_t deadline_ms;
+    uint32_t last_ms;
+};
+
+class HeartbeatSupervisor
+{
+public:
+    static constexpr size_t kNone = SIZE_MAX;
+
+    HeartbeatSupervisor(Heartbeat *_heartbeats, size_t _count)
+        : heartbeats(_heartbeats),
+          count(_count)
+    {
+    }
+
+    // Marks every heartbeat fresh, e.g. after the blocking init in setup().
+    void start(uint32_t now_ms)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            heartbeats[i].last_ms = now_ms;
+        }
+        last_supervised_ms = now_ms;
+        fed_count = 0U;
+        starved_count = 0U;
+    }
+
+    void check_in(size_t id, uint32_t now_ms)
+    {
+        heartbeats[id].last_ms = now_ms;
+    }
+
+    // For runnables whose rate changes (low-activity profile). The heartbeat
+    // restarts at now_ms, so a shorter deadline does not apply to time spent
+    // under the longer one.
+    void set_deadline(size_t id, uint32_t deadline_ms, uint32_t now_ms)
+    {
+        heartbeats[id].deadline_ms = deadline_ms;
+        heartbeats[id].last_ms = now_ms;
+    }
+
+    // Heartbeat furthest past its deadline, kNone when all are fresh.
+    size_t most_overdue(uint32_t now_ms, uint32_t *overdue_ms = nullptr) const
+    {
+        size_t worst = kNone;
+        uint32_t worst_overdue = 0U;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const uint32_t age = now_ms - heartbeats[i].last_ms;
+            if (age > heartbeats[i].deadline_ms && (worst == kNone || age - heartbeats[i].deadline_ms > worst_overdue))
+            {
+                worst = i;
+                worst_overdue = age - heartbeats[i].deadline_ms;
+            }
+        }
+        if (overdue_ms != nullptr)
+        {
+            *overdue_ms = worst_overdue;
+        }
+        return worst;
+    }
+
+    // Bit i set when heartbeat i is past its deadline.
+    uint32_t stale_mask(uint32_t now_ms) const
+    {
+        uint32_t mask = 0U;
+        for (size_t i = 0; i < count && i < 32U; ++i)
+        {
+            if (now_ms - heartbeats[i].last_ms > heartbeats[i].deadline_ms)
+            {
+                mask |= 1UL << i;
+            }
+        }
+        return mask;
+    }
+
+    // true when the watchdog may be fed.
+    bool supervise(uint32_t now_ms)
+    {
+        last_supervised_ms = now_ms;
+        if (most_overdue(now_ms) != kNone)
+        {
+            ++starved_count;
+            return false;
+        }
+        ++fed_count;
+        return true;
+    }
+
+    const Heartbeat &get(size_t id) const { return heartbeats[id]; }
+    size_t size() const { return count; }
+    uint32_t last_supervised() const { return last_supervised_ms; }
+    uint32_t fed() const { return fed_count; }
+    uint32_t starved() const { return starved_count; }
+
+private:
+    Heartbeat *heartbeats;
+    size_t count;
+    uint32_t last_supervised_ms = 0U;
+    uint32_t fed_count = 0U;
+    uint32_t starved_count = 0U;
+};
+
+// Written by the WDT3 callback into RAM that startup code does not clear and
+// read back on the next boot. The CRC rejects power-on garbage.
+struct WatchdogFreezeFrame
+{
+    static constexpr uint32_t kMagic = 0x57445446UL; // "WDTF"
+    static constexpr size_t kNameLength = 16U;
+
+    uint32_t magic;
+    char task[kNameLength]; // heartbeat furthest past its deadline
+    uint32_t overdue_ms;    // how far past the deadline
+    uint32_t deadline_ms;
+    uint32_t stale_mask;    // every late heartbeat, bit = heartbeat index
+    uint32_t supervisor_age_ms; // since the last supervise(); large when loop() itself was blocked
+    uint32_t uptime_ms;
+    uint32_t crc;
+};
+
+// WDT3 callback: record which heartbeat starved the watchdog.
+void record_watchdog_freeze_frame(const HeartbeatSupervisor &supervisor, uint32_t now_ms);
+// Early in setup(): take over the frame of the previous reset (if any) and
+// clear it, so it is reported for this boot only.
+void capture_watchdog_freeze_frame();
+// Frame captured at boot, nullptr if the last reset was not a recorded
+// watchdog reset.
+const WatchdogFreezeFrame *boot_watchdog_freeze_frame();
+
+// Work that must run in setup() before the watchdog starts (it would starve
+// it otherwise). request_reboot() stores the request in the same RAM and
+// resets; take_boot_request() returns and clears it.
+enum BootRequest : uint32_t
+{
+    BOOT_REQUEST_NONE = 0,
+    BOOT_REQUEST_CONFIGURE_SHUNT = 0x43534854UL, // "CSHT"
+};
+void request_reboot(BootRequest request);
+BootRequest take_boot_request();
+
+#endif // WATCHDOG_SUPERVISOR_H
@@ -0,0 +1,3 @@
+#include "work_queue.h"
+
+WorkQueue deferred_work;
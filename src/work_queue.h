@@ -0,0 +1,86 @@
+#ifndef WORK_QUEUE_H
+#define WORK_QUEUE_H
+
+#include <Arduino.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Deferred work for CAN receive callbacks.
+//
+// Callbacks only decode; anything heavier (EEPROM commits, starting a
+// black-box dump) is posted here and run by the real-time tier after the
+// receive dispatch, within a time budget. A function/context pair that is
+// already pending is not queued twice, so a burst of identical requests
+// costs one run. Not interrupt-safe: post() and run() are both called from
+// loop() context.
+class WorkQueue
+{
+public:
+    typedef void (*Work)(void *context);
+
+    static constexpr size_t kCapacity = 16U;
+
+    // false when the queue is full (counted in dropped())
+    bool post(Work work, void *context)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            const Item &item = items[(head + i) % kCapacity];
+            if (item.work == work && item.context == context)
+            {
+                return true;
+            }
+        }
+        if (count == kCapacity)
+        {
+            ++dropped_count;
+            return false;
+        }
+        items[(head + count) % kCapacity] = Item{work, context};
+        ++count;
+        max_count = (count > max_count) ? count : max_count;
+        return true;
+    }
+
+    // Runs pending work oldest first until the queue is empty or budget_us
+    // has passed; at least one item runs per call.
+    size_t run(uint32_t budget_us)
+    {
+        const uint32_t start = micros();
+        size_t done = 0;
+        while (count > 0U)
+        {
+            if (done > 0U && (micros() - start) >= budget_us)
+            {
+                break;
+            }
+            const Item item = items[head];
+            head = (head + 1U) % kCapacity;
+            --count;
+            item.work(item.context);
+            ++done;
+        }
+        return done;
+    }
+
+    size_t pending() const { return count; }
+    size_t max_pending() const { return max_count; }
+    uint32_t dropped() const { return dropped_count; }
+
+private:
+    struct Item
+    {
+        Work work;
+        void *context;
+    };
+
+    Item items[kCapacity] = {};
+    size_t head = 0;
+    size_t count = 0;
+    size_t max_count = 0;
+    uint32_t dropped_count = 0;
+};
+
+extern WorkQueue deferred_work;
+
+#endif // WORK_QUEUE_H
@@ -1,6 +1,6 @@
 #include <Arduino.h>
 #include <Wire.h>
-#include "at24c_async.h"
+#include "utils/at24c_async.h"
 
 // Change these if your AT24C uses 1-byte memory addressing or a different I2C address.
 static const uint8_t kAt24cI2cAddr = 0x50;
@@ -0,0 +1,25 @@
+#pragma once
+
+// Host stand-in for the parts of the Arduino core that blackbox_recorder.h
+// and the AT24C driver use. micros()/millis() read a simulated clock that the
+// emulated I2C bus (Wire.h next to this file) advances on every transfer.
+
+#include <stdint.h>
+#include <string.h>
+
+inline uint32_t sim_micros = 0U;
+
+inline uint32_t micros()
+{
+    return sim_micros;
+}
+
+inline uint32_t millis()
+{
+    return sim_micros / 1000U;
+}
+
+inline void delay(uint32_t ms)
+{
+    sim_micros += ms * 1000U;
+}
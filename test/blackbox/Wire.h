@@ -0,0 +1,167 @@
+#pragma once
+
+// Emulated I2C bus with one AT24C EEPROM for test/blackbox.
+//
+// Every transfer costs 9 bit times per byte (plus the address byte) at the
+// configured clock. A page write latches the data at the STOP condition and
+// starts the internal write cycle (tWR); until it ends the device does not
+// acknowledge its address, like the real part. Data written past the end of
+// a page wraps to the start of that page. tear_next_write keeps only the
+// first bytes of the next page write to model a power cut during tWR.
+
+#include "Arduino.h"
+
+struct EmulatedAt24c
+{
+    static constexpr size_t kMaxBytes = 4096U;
+
+    uint8_t address = 0x50;
+    uint8_t address_bytes = 2U;
+    uint16_t size = 4096U;
+    uint16_t page = 32U;
+    uint32_t write_cycle_us = 5000U;
+
+    uint8_t m[kMaxBytes];
+    uint32_t page_wear[kMaxBytes / 8U] = {};
+    uint32_t busy_until = 0U;
+    uint16_t pointer = 0U;
+    uint32_t page_writes = 0U;
+    int tear_next_write = -1; // bytes kept of the next page write, -1: none
+
+    EmulatedAt24c()
+    {
+        memset(m, 0xFF, sizeof(m));
+    }
+
+    bool busy() const
+    {
+        return static_cast<int32_t>(sim_micros - busy_until) < 0;
+    }
+};
+
+inline EmulatedAt24c at24c;
+
+class TwoWire
+{
+public:
+    static constexpr size_t BUFFER_LENGTH = 136U; // Teensy 4 Wire
+
+    void begin()
+    {
+    }
+
+    void setClock(uint32_t hz)
+    {
+        bit_ns = 1000000000UL / hz;
+    }
+
+    void beginTransmission(uint8_t address)
+    {
+        target = address;
+        tx_len = 0U;
+    }
+
+    size_t write(uint8_t value)
+    {
+        if (tx_len == BUFFER_LENGTH)
+        {
+            return 0U;
+        }
+        tx[tx_len++] = value;
+        return 1U;
+    }
+
+    size_t write(const uint8_t *data, size_t n)
+    {
+        size_t written = 0U;
+        while (written < n && write(data[written]) == 1U)
+        {
+            ++written;
+        }
+        return written;
+    }
+
+    uint8_t endTransmission(bool stop = true)
+    {
+        bus_time(1U + tx_len);
+        if (target != at24c.address || at24c.busy())
+        {
+            return 2; // address NACK
+        }
+        if (tx_len < at24c.address_bytes)
+        {
+            return 0; // acknowledge poll
+        }
+
+        uint16_t pointer = tx[0];
+        if (at24c.address_bytes == 2U)
+        {
+            pointer = static_cast<uint16_t>((pointer << 8) | tx[1]);
+        }
+        at24c.pointer = static_cast<uint16_t>(pointer % at24c.size);
+
+        const size_t data_len = tx_len - at24c.address_bytes;
+        if (data_len > 0U && stop)
+        {
+            const uint16_t page_base = static_cast<uint16_t>(at24c.pointer - (at24c.pointer % at24c.page));
+            size_t keep = data_len;
+            if (at24c.tear_next_write >= 0)
+            {
+                keep = (static_cast<size_t>(at24c.tear_next_write) < keep) ? at24c.tear_next_write : keep;
+                at24c.tear_next_write = -1;
+            }
+            for (size_t i = 0; i < keep; ++i)
+            {
+                const uint16_t offset = static_cast<uint16_t>((at24c.pointer % at24c.page + i) % at24c.page);
+                at24c.m[page_base + offset] = tx[at24c.address_bytes + i];
+            }
+            ++at24c.page_writes;
+            ++at24c.page_wear[page_base / at24c.page];
+            at24c.busy_until = sim_micros + at24c.write_cycle_us;
+        }
+        return 0;
+    }
+
+    uint8_t requestFrom(uint8_t address, uint8_t n)
+    {
+        bus_time(1U + n);
+        rx_len = 0U;
+        rx_pos = 0U;
+        if (address != at24c.address || at24c.busy())
+        {
+            return 0;
+        }
+        for (size_t i = 0; i < n; ++i)
+        {
+            rx[rx_len++] = at24c.m[at24c.pointer];
+            at24c.pointer = static_cast<uint16_t>((at24c.pointer + 1U) % at24c.size);
+        }
+        return n;
+    }
+
+    int read()
+    {
+        return (rx_pos < rx_len) ? rx[rx_pos++] : -1;
+    }
+
+    int available()
+    {
+        return static_cast<int>(rx_len - rx_pos);
+    }
+
+private:
+    uint32_t bit_ns = 2500U; // 400 kHz
+    uint8_t target = 0U;
+    uint8_t tx[BUFFER_LENGTH];
+    size_t tx_len = 0U;
+    uint8_t rx[256];
+    size_t rx_len = 0U;
+    size_t rx_pos = 0U;
+
+    void bus_time(size_t bytes)
+    {
+        sim_micros += static_cast<uint32_t>((bytes * 9U * bit_ns + 999U) / 1000U);
+    }
+};
+
+inline TwoWire Wire;
@@ -0,0 +1,461 @@
+// Host test for the black-box recorder on an emulated AT24C32.
+//
+// The I2C bus and the EEPROM are emulated with bus time per byte at 400 kHz,
+// a 5 ms internal write cycle during which the device NACKs, page wrap and
+// torn page writes (see Wire.h in this directory); micros() is the simulated
+// clock they advance. service() is called once per simulated 10 ms tick.
+//
+// 1) Round trip: events and snapshots written from an erased device are
+//    dumped back oldest first with consecutive sequence numbers.
+// 2) Reboot: a new recorder finds the newest record and continues behind it.
+// 3) Wrap: many laps of the ring; after a reboot the dump holds exactly the
+//    newest capacity records.
+// 4) Torn write: a page write cut short by a reset loses only the records of
+//    that write.
+// 5) Timing: worst service() time per tick against blocking byte writes,
+//    sustained record rate and page writes per record.
+// 6) Overflow and a missing device: records are dropped, nothing blocks.
+// 7) Snapshot quantisation error.
+// 8) Flush before a reset: request_flush() writes a partial page at once
+//    instead of after kFlushDelayMs, and flushed() reports when it is done.
+//
+// Build: pio run -e native_blackbox_test && .pio/build/native_blackbox_test/program
+
+#include <cmath>
+#include <cstdio>
+#include <deque>
+#include <random>
+#include <vector>
+
+#include "blackbox_recorder.h"
+
+namespace
+{
+int failures = 0;
+
+void check(bool ok, const char *what)
+{
+    if (!ok)
+    {
+        std::printf("  FAIL: %s\n", what);
+        ++failures;
+    }
+}
+
+// Logged record as the test expects to read it back.
+struct Expected
+{
+    uint8_t type;
+    uint32_t time_ms;
+    uint8_t data[8];
+};
+
+struct Dump
+{
+    std::vector<BlackBoxRecorder::Record> records;
+};
+
+void collect(const BlackBoxRecorder::Record &record, void *context)
+{
+    static_cast<Dump *>(context)->records.push_back(record);
+}
+
+void tick(BlackBoxRecorder &recorder, uint32_t &worst_us)
+{
+    sim_micros = (sim_micros / 10000U + 1U) * 10000U;
+    const uint32_t t0 = micros();
+    recorder.service();
+    const uint32_t elapsed = micros() - t0;
+    worst_us = (elapsed > worst_us) ? elapsed : worst_us;
+}
+
+void run_until_idle(BlackBoxRecorder &recorder, uint32_t &worst_us)
+{
+    for (int i = 0; i < 100000 && (!recorder.ready() || recorder.queued_records() > 0U || recorder.dumping()); ++i)
+    {
+        tick(recorder, worst_us);
+    }
+}
+
+std::vector<BlackBoxRecorder::Record> dump(BlackBoxRecorder &recorder)
+{
+    Dump out;
+    uint32_t worst = 0U;
+    run_until_idle(recorder, worst);
+    recorder.start_dump(&collect, &out);
+    run_until_idle(recorder, worst);
+    return out.records;
+}
+
+// Log one record of a random type and remember what it should read back as.
+void log_random(BlackBoxRecorder &recorder, std::mt19937 &rng, std::deque<Expected> &model)
+{
+    std::uniform_int_distribution<int> kind(0, 4);
+    std::uniform_int_distribution<int> u16(0, 65535);
+    Expected e = {};
+    e.time_ms = millis();
+    switch (kind(rng))
+    {
+    case 0:
+    {
+        const uint16_t old_dtc = static_cast<uint16_t>(u16(rng));
+        const uint16_t new_dtc = static_cast<uint16_t>(u16(rng));
+        recorder.log_dtc(BlackBoxRecorder::DTC_SOURCE_SHUNT, 3U, old_dtc, new_dtc);
+        e.type = BlackBoxRecorder::RECORD_DTC;
+        const uint8_t d[8] = {BlackBoxRecorder::DTC_SOURCE_SHUNT, 3U, static_cast<uint8_t>(old_dtc),
+                              static_cast<uint8_t>(old_dtc >> 8), static_cast<uint8_t>(new_dtc),
+                              static_cast<uint8_t>(new_dtc >> 8), 0U, 0U};
+        memcpy(e.data, d, 8);
+        break;
+    }
+    case 1:
+    {
+        recorder.log_state(1U, 3U, -1, true);
+        e.type = BlackBoxRecorder::RECORD_STATE;
+        const uint8_t d[8] = {1U, 3U, 0xFFU, 1U, 0U, 0U, 0U, 0U};
+        memcpy(e.data, d, 8);
+        break;
+    }
+    case 2:
+    {
+        recorder.log_contactor(2U, 4U, 0x08U, -12.3f, 350.5f);
+        e.type = BlackBoxRecorder::RECORD_CONTACTOR;
+        const int16_t current = -123;
+        const uint8_t d[8] = {2U, 4U, 0x08U, 0U, static_cast<uint8_t>(current & 0xFF),
+                              static_cast<uint8_t>((current >> 8) & 0xFF), 0xB1U, 0x0DU}; // 3505
+        memcpy(e.data, d, 8);
+        break;
+    }
+    case 3:
+    {
+        const uint32_t flags = static_cast<uint32_t>(u16(rng)) << 8;
+        recorder.log_boot(flags);
+        e.type = BlackBoxRecorder::RECORD_BOOT;
+        memcpy(e.data, &flags, 4);
+        break;
+    }
+    default:
+    {
+        BlackBoxRecorder::Snapshot s = {static_cast<float>(u16(rng) % 4000) - 2000.0f, 3.6f, 3.65f, 0.5f, 12.0f,
+                                        25.0f};
+        recorder.log_snapshot(s);
+        e.type = BlackBoxRecorder::RECORD_SNAPSHOT;
+        BlackBoxRecorder::encode_snapshot(s, e.data);
+        break;
+    }
+    }
+    model.push_back(e);
+}
+
+bool matches(const BlackBoxRecorder::Record &record, const Expected &e)
+{
+    return record.type == e.type && record.time_ms == e.time_ms && memcmp(record.data, e.data, 8) == 0;
+}
+
+// Records must match the model tail in order with consecutive sequences.
+bool dump_matches(const std::vector<BlackBoxRecorder::Record> &records, const std::deque<Expected> &model)
+{
+    if (records.size() != model.size())
+    {
+        std::printf("  dump holds %zu records, expected %zu\n", records.size(), model.size());
+        return false;
+    }
+    for (size_t i = 0; i < records.size(); ++i)
+    {
+        if (!matches(records[i], model[i]) ||
+            (i > 0U && records[i].sequence != static_cast<uint16_t>(records[i - 1U].sequence + 1U)))
+        {
+            std::printf("  record %zu differs (sequence %u)\n", i, static_cast<unsigned>(records[i].sequence));
+            return false;
+        }
+    }
+    return true;
+}
+
+void reset_device()
+{
+    at24c = EmulatedAt24c();
+    sim_micros = 0U;
+}
+
+void test_round_trip_and_reboot()
+{
+    reset_device();
+    std::mt19937 rng(1);
+    std::deque<Expected> model;
+    {
+        BlackBoxRecorder recorder;
+        recorder.begin();
+        for (int i = 0; i < 7; ++i)
+        {
+            log_random(recorder, rng, model);
+        }
+        const std::vector<BlackBoxRecorder::Record> records = dump(recorder);
+        check(dump_matches(records, model), "round trip from an erased device");
+        check(!records.empty() && records.front().sequence == 0U, "first sequence is 0");
+    }
+
+    {
+        BlackBoxRecorder recorder;
+        recorder.begin();
+        for (int i = 0; i < 5; ++i)
+        {
+            log_random(recorder, rng, model);
+        }
+        const std::vector<BlackBoxRecorder::Record> records = dump(recorder);
+        check(dump_matches(records, model), "reboot continues behind the newest record");
+        check(recorder.sequence() == 12U, "sequence continues after reboot");
+    }
+}
+
+void test_wrap()
+{
+    reset_device();
+    std::mt19937 rng(2);
+    std::deque<Expected> model;
+    uint16_t capacity = 0U;
+    uint32_t worst = 0U;
+    for (int boot = 0; boot < 6; ++boot)
+    {
+        BlackBoxRecorder recorder;
+        recorder.begin();
+        capacity = recorder.capacity_records();
+        run_until_idle(recorder, worst);
+        for (int i = 0; i < 200; ++i)
+        {
+            log_random(recorder, rng, model);
+            for (int k = 0; k < 3; ++k)
+            {
+                tick(recorder, worst);
+            }
+        }
+        run_until_idle(recorder, worst);
+    }
+    while (model.size() > capacity)
+    {
+        model.pop_front();
+    }
+
+    BlackBoxRecorder recorder;
+    recorder.begin();
+    check(dump_matches(dump(recorder), model), "wrapped ring dumps the newest capacity records");
+    std::printf("Wrap: 1200 records over %u-record ring and 6 reboots, dump returns the newest %zu\n",
+                static_cast<unsigned>(capacity), model.size());
+}
+
+void test_torn_write()
+{
+    reset_device();
+    std::mt19937 rng(3);
+    std::deque<Expected> model;
+    uint32_t worst = 0U;
+    {
+        BlackBoxRecorder recorder;
+        recorder.begin();
+        for (int i = 0; i < 10; ++i)
+        {
+            log_random(recorder, rng, model);
+        }
+        run_until_idle(recorder, worst);
+
+        // The next write (one full page of two records) is cut after 20
+        // bytes by a reset: the first record is complete, the second torn
+        // and the third never leaves the queue.
+        std::deque<Expected> lost;
+        log_random(recorder, rng, lost);
+        log_random(recorder, rng, lost);
+        log_random(recorder, rng, lost);
+        at24c.tear_next_write = 20;
+        for (int i = 0; i < 3 && at24c.tear_next_write >= 0; ++i)
+        {
+            tick(recorder, worst);
+        }
+        model.push_back(lost.front());
+    }
+
+    BlackBoxRecorder recorder;
+    recorder.begin();
+    log_random(recorder, rng, model);
+    check(dump_matches(dump(recorder), model), "torn page write loses only its own records");
+}
+
+void test_timing()
+{
+    // Baseline: one record as blocking byte writes with write-cycle waits.
+    reset_device();
+    At24cAsync blocking(0x50, 2, 32, 32);
+    for (uint16_t i = 0; i < BlackBoxRecorder::kRecordBytes; ++i)
+    {
+        blocking.WriteByte(i, static_cast<uint8_t>(i));
+        while (!blocking.WaitReady(10))
+        {
+        }
+    }
+    const uint32_t blocking_us = micros();
+
+    reset_device();
+    std::mt19937 rng(4);
+    std::deque<Expected> model;
+    uint32_t worst = 0U;
+
+    BlackBoxRecorder recorder;
+    recorder.begin();
+    run_until_idle(recorder, worst);
+    const uint32_t scan_ms = millis();
+
+    // Burst: 30 events in one tick, then steady snapshots at 10 Hz.
+    worst = 0U;
+    const uint32_t writes0 = at24c.page_writes;
+    const uint32_t t0 = millis();
+    for (int i = 0; i < 30; ++i)
+    {
+        log_random(recorder, rng, model);
+    }
+    run_until_idle(recorder, worst);
+    const uint32_t burst_ms = millis() - t0;
+
+    for (int i = 0; i < 500; ++i)
+    {
+        log_random(recorder, rng, model);
+        for (int k = 0; k < 10; ++k)
+        {
+            tick(recorder, worst);
+        }
+    }
+    run_until_idle(recorder, worst);
+    const float writes_per_record = static_cast<float>(at24c.page_writes - writes0) / 530.0f;
+
+    std::printf("Timing: startup scan %u ms, worst service() %u us (budget %u us), 30-record burst written in %u ms,\n"
+                "  %.2f page writes per record; blocking byte writes take %u us per record\n",
+                static_cast<unsigned>(scan_ms), static_cast<unsigned>(worst),
+                static_cast<unsigned>(BlackBoxRecorder::kServiceBudgetUs), static_cast<unsigned>(burst_ms),
+                writes_per_record, static_cast<unsigned>(blocking_us));
+    check(worst < 1500U, "one page transaction per tick at most");
+    check(recorder.dropped_records() == 0U && recorder.write_error_count() == 0U, "no drops, no errors");
+    check(writes_per_record < 0.75f, "records share page writes");
+
+    Dump out;
+    worst = 0U;
+    const uint32_t d0 = millis();
+    recorder.start_dump(&collect, &out);
+    run_until_idle(recorder, worst);
+    std::printf("Dump: %zu records in %u ms, worst service() %u us\n", out.records.size(),
+                static_cast<unsigned>(millis() - d0), static_cast<unsigned>(worst));
+    check(out.records.size() == recorder.capacity_records(), "dump of a full ring");
+}
+
+void test_overflow_and_offline()
+{
+    reset_device();
+    std::mt19937 rng(5);
+    std::deque<Expected> model;
+    {
+        BlackBoxRecorder recorder;
+        recorder.begin();
+        for (size_t i = 0; i < BlackBoxRecorder::kQueueRecords + 10U; ++i)
+        {
+            log_random(recorder, rng, model);
+        }
+        check(recorder.dropped_records() == 10U, "full queue drops new records");
+    }
+
+    reset_device();
+    at24c.address = 0x51; // nothing at 0x50
+    BlackBoxRecorder recorder;
+    recorder.begin();
+    uint32_t worst = 0U;
+    for (int i = 0; i < 10; ++i)
+    {
+        log_random(recorder, rng, model);
+        tick(recorder, worst);
+    }
+    Dump out;
+    check(!recorder.online() && recorder.queued_records() == 0U && !recorder.start_dump(&collect, &out),
+          "missing device goes offline");
+    check(recorder.flushed(), "offline device counts as flushed");
+    check(worst < 1000U, "missing device does not block");
+}
+
+void test_flush()
+{
+    reset_device();
+    std::mt19937 rng(7);
+    std::deque<Expected> model;
+    int ticks = 0;
+    {
+        BlackBoxRecorder recorder;
+        recorder.begin();
+        uint32_t worst = 0U;
+        run_until_idle(recorder, worst);
+        log_random(recorder, rng, model);
+        log_random(recorder, rng, model);
+        const bool queued = !recorder.flushed();
+        recorder.request_flush();
+        while (!recorder.flushed() && ticks < 1000)
+        {
+            tick(recorder, worst);
+            ++ticks;
+        }
+        check(queued && recorder.flushed(), "flushed() follows the queue");
+        check(ticks * 10 < static_cast<int>(BlackBoxRecorder::kFlushDelayMs) / 2, "flush does not wait for the page");
+    }
+
+    BlackBoxRecorder rebooted;
+    rebooted.begin();
+    check(dump_matches(dump(rebooted), model), "flushed records survive a reset");
+    std::printf("Flush: %d ticks of 10 ms for a partial page\n", ticks);
+}
+
+void test_snapshot()
+{
+    std::mt19937 rng(6);
+    std::uniform_real_distribution<float> current(-400.0f, 400.0f);
+    std::uniform_real_distribution<float> cell(3.0f, 4.15f);
+    std::uniform_real_distribution<float> spread(0.0f, 0.2f);
+    std::uniform_real_distribution<float> soc(0.0f, 1.0f);
+    std::uniform_real_distribution<float> temp(-20.0f, 50.0f);
+    float err[5] = {};
+    for (int i = 0; i < 10000; ++i)
+    {
+        BlackBoxRecorder::Snapshot s;
+        s.current_A = current(rng);
+        s.cell_min_V = cell(rng);
+        s.cell_max_V = s.cell_min_V + spread(rng);
+        s.soc = soc(rng);
+        s.temp_min_C = temp(rng);
+        s.temp_max_C = s.temp_min_C + 5.0f;
+        BlackBoxRecorder::Record r = {};
+        BlackBoxRecorder::encode_snapshot(s, r.data);
+        const BlackBoxRecorder::Snapshot d = BlackBoxRecorder::decode_snapshot(r);
+        err[0] = std::fmax(err[0], std::fabs(d.current_A - s.current_A));
+        err[1] = std::fmax(err[1], std::fabs(d.cell_min_V - s.cell_min_V));
+        err[2] = std::fmax(err[2], std::fabs(d.cell_max_V - s.cell_max_V));
+        err[3] = std::fmax(err[3], std::fabs(d.soc - s.soc));
+        err[4] = std::fmax(err[4], std::fabs(d.temp_max_C - s.temp_max_C));
+    }
+    std::printf("Snapshot (8 bytes): max error current %.3f A, cell min %.4f V, cell max %.4f V, soc %.4f, "
+                "temp %.2f C\n",
+                err[0], err[1], err[2], err[3], err[4]);
+    check(err[0] <= 0.051f && err[1] <= 0.00051f && err[2] <= 0.0011f && err[3] <= 0.0026f && err[4] <= 0.51f,
+          "snapshot quantisation");
+
+    char line[128];
+    BlackBoxRecorder::Record r = {};
+    r.type = BlackBoxRecorder::RECORD_SNAPSHOT;
+    check(BlackBoxRecorder::format_record(r, line, sizeof(line)) > 0, "format_record");
+}
+} // namespace
+
+int main()
+{
+    test_round_trip_and_reboot();
+    test_wrap();
+    test_torn_write();
+    test_timing();
+    test_overflow_and_offline();
+    test_snapshot();
+    test_flush();
+
+    std::printf("%s\n", failures == 0 ? "Black-box recorder test PASSED" : "Black-box recorder test FAILED");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+// Host stand-in for the CANMessage of ACAN_T4, as far as
+// utils/can_capture.h uses it.
+
+#include <stdint.h>
+
+class CANMessage
+{
+public:
+    uint32_t id = 0;
+    bool ext = false;
+    bool rtr = false;
+    uint8_t idx = 0;
+    uint8_t len = 0;
+    union
+    {
+        uint64_t data64;
+        uint8_t data[8];
+    };
+
+    CANMessage()
+        : data64(0)
+    {
+    }
+};
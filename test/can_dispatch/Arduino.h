@@ -0,0 +1,38 @@
+#pragma once
+
+// Host stand-in for the parts of the Arduino core that bms/current.h, the
+// receive dispatcher and the work queue use. micros()/millis() read a
+// simulated clock that the test advances; Serial output is discarded.
+
+#include <stdint.h>
+#include <string.h>
+
+#define HEX 16
+
+inline uint32_t sim_micros = 0U;
+
+inline uint32_t micros()
+{
+    return sim_micros;
+}
+
+inline uint32_t millis()
+{
+    return sim_micros / 1000U;
+}
+
+inline void delay(uint32_t ms)
+{
+    sim_micros += ms * 1000U;
+}
+
+struct NullSerial
+{
+    template <typename T>
+    void print(const T &, int = 10) {}
+    template <typename T>
+    void println(const T &, int = 10) {}
+    void println() {}
+};
+
+inline NullSerial Serial;
@@ -0,0 +1,384 @@
+// Host test for the CAN receive dispatch and the deferred work queue.
+//
+// The ACAN_T4 stand-in next to this file applies the acceptance filters and
+// callbacks registered at begin() and keeps the arrival time of every frame,
+// so recorded traffic can be replayed through the firmware's callback path.
+//
+// 1) Filters: the shunt filter table of comms_bms.cpp sends result frames to
+//    Shunt_IVTS::DecodeCAN(), keeps command responses away from it and
+//    rejects foreign IDs.
+// 2) Burst: at most kMaxFramesPerPass frames per dispatch() call.
+// 3) Latency replay: 5 s of shunt and i3 module traffic. The polled wiring
+//    (shunt drained per loop() pass, one battery frame per 2 ms task) against
+//    dispatch on every real-time tier pass: true arrival-to-decode age per
+//    bus, receive buffer overflows, and the dispatcher's age bound, which must
+//    never be below the true age.
+// 4) Work queue: FIFO order, coalescing, capacity and time budget.
+//
+// Build: pio run -e native_can_dispatch_test && .pio/build/native_can_dispatch_test/program
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "bms/current.h"
+#include "utils/can_rx_dispatch.h"
+#include "work_queue.h"
+
+WorkQueue deferred_work;
+
+namespace
+{
+int failures = 0;
+
+void check(bool ok, const char *what)
+{
+    if (!ok)
+    {
+        std::printf("  FAIL: %s\n", what);
+        ++failures;
+    }
+}
+
+Shunt_IVTS shunt;
+
+// As registered by enable_update_shunt()
+uint32_t shunt_callback_frames = 0U;
+uint32_t shunt_true_age_max_us = 0U;
+uint32_t battery_true_age_max_us = 0U;
+uint32_t battery_frames = 0U;
+
+void record_true_age(ACAN_T4 &bus, uint32_t &worst)
+{
+    const uint32_t age = sim_micros - bus.last_arrival_us;
+    worst = (age > worst) ? age : worst;
+}
+
+void on_shunt_frame(const CANMessage &message)
+{
+    ++shunt_callback_frames;
+    record_true_age(ACAN_T4::ISA_SHUNT_CAN, shunt_true_age_max_us);
+    shunt.DecodeCAN(message);
+}
+
+void on_battery_frame(const CANMessage &message)
+{
+    (void)message;
+    ++battery_frames;
+    record_true_age(ACAN_T4::BATTERY_CAN, battery_true_age_max_us);
+    sim_micros += 3U; // module decode
+}
+
+void begin_shunt_bus()
+{
+    const ACANPrimaryFilter filters[] = {
+        ACANPrimaryFilter(kData, kStandard, Shunt_IVTS::CAN_RESULT_MASK, Shunt_IVTS::CAN_RESULT_ACCEPTANCE, &on_shunt_frame),
+        ACANPrimaryFilter(kData, kStandard, Shunt_IVTS::CAN_RESPONSE_ID),
+    };
+    ACAN_T4_Settings settings(500 * 1000);
+    ACAN_T4::ISA_SHUNT_CAN.begin(settings, filters, 2);
+}
+
+// As registered by BatteryPack::initialize()
+void begin_battery_bus()
+{
+    const ACANPrimaryFilter filters[] = {
+        ACANPrimaryFilter(kData, kStandard, 0x780, 0x100, &on_battery_frame),
+    };
+    ACAN_T4_Settings settings(500 * 1000);
+    ACAN_T4::BATTERY_CAN.begin(settings, filters, 1);
+}
+
+CANMessage shunt_frame(uint32_t id, int32_t value, uint8_t counter)
+{
+    CANMessage frame;
+    frame.id = id;
+    frame.len = 6;
+    frame.data[0] = static_cast<uint8_t>(id & 0x0F);
+    frame.data[1] = counter & 0x0F;
+    const uint32_t raw = static_cast<uint32_t>(value);
+    frame.data[2] = static_cast<uint8_t>(raw);
+    frame.data[3] = static_cast<uint8_t>(raw >> 8);
+    frame.data[4] = static_cast<uint8_t>(raw >> 16);
+    frame.data[5] = static_cast<uint8_t>(raw >> 24);
+    return frame;
+}
+
+CANMessage plain_frame(uint32_t id)
+{
+    CANMessage frame;
+    frame.id = id;
+    frame.len = 8;
+    return frame;
+}
+
+void test_filters()
+{
+    std::printf("Shunt filters\n");
+    sim_micros = 1000000U;
+    shunt.initialise();
+    begin_shunt_bus();
+    CanRxDispatcher dispatcher(ACAN_T4::ISA_SHUNT_CAN, "shunt RX age");
+    shunt_callback_frames = 0U;
+    dispatcher.dispatch(); // empty pass: ages are bounded from here on
+
+    ACAN_T4::ISA_SHUNT_CAN.deliver(shunt_frame(0x521, -12500, 1)); // 12.5 A charge
+    ACAN_T4::ISA_SHUNT_CAN.deliver(shunt_frame(0x522, 398200, 1));
+    ACAN_T4::ISA_SHUNT_CAN.deliver(plain_frame(0x511));            // command response
+    ACAN_T4::ISA_SHUNT_CAN.deliver(plain_frame(0x41A));            // foreign
+    ACAN_T4::ISA_SHUNT_CAN.deliver(plain_frame(0x530));            // outside the result range
+    sim_micros += 50U;
+    const uint32_t frames = dispatcher.dispatch();
+
+    std::printf("  dispatched %lu, decoded %lu, rejected %lu\n",
+                static_cast<unsigned long>(frames),
+                static_cast<unsigned long>(shunt_callback_frames),
+                static_cast<unsigned long>(ACAN_T4::ISA_SHUNT_CAN.rejected));
+    check(frames == 3U, "results and the response pass the filters");
+    check(shunt_callback_frames == 2U, "only result frames reach DecodeCAN()");
+    check(ACAN_T4::ISA_SHUNT_CAN.rejected == 2U, "foreign IDs rejected by the filters");
+    check(shunt.current_A() == 12.5f && shunt.u1_V() == 398.2f, "decoded values");
+    check(shunt.state() == ShuntState::OPERATING, "shunt operating after the first current frame");
+    check(dispatcher.frame_age().get_count() == 3U, "one age sample per frame");
+}
+
+void test_burst()
+{
+    std::printf("Burst\n");
+    begin_battery_bus();
+    ACAN_T4::BATTERY_CAN.receive_capacity = 256U;
+    CanRxDispatcher dispatcher(ACAN_T4::BATTERY_CAN, "battery RX age");
+    for (int i = 0; i < 100; ++i)
+    {
+        ACAN_T4::BATTERY_CAN.deliver(plain_frame(0x120 + (i % 8)));
+    }
+    const uint32_t first = dispatcher.dispatch();
+    const uint32_t second = dispatcher.dispatch();
+    const uint32_t third = dispatcher.dispatch();
+    const uint32_t fourth = dispatcher.dispatch();
+    const uint32_t fifth = dispatcher.dispatch();
+    std::printf("  passes: %lu %lu %lu %lu %lu\n",
+                static_cast<unsigned long>(first), static_cast<unsigned long>(second),
+                static_cast<unsigned long>(third), static_cast<unsigned long>(fourth),
+                static_cast<unsigned long>(fifth));
+    check(first == CanRxDispatcher::kMaxFramesPerPass && second == CanRxDispatcher::kMaxFramesPerPass &&
+              third == CanRxDispatcher::kMaxFramesPerPass && fourth == 4U && fifth == 0U,
+          "burst split into passes of kMaxFramesPerPass");
+    check(dispatcher.frames() == 100U, "all frames dispatched");
+}
+
+// i3 modules: 0x10m every 50 ms, 0x12m..0x17m every 100 ms, for 8 modules;
+// IVT-S: current every 10 ms, U1/U2/U3/T every 100 ms.
+struct TrafficSource
+{
+    ACAN_T4 *bus;
+    CANMessage frame;
+    uint32_t period_us;
+    uint32_t next_us;
+};
+
+std::vector<TrafficSource> traffic(uint32_t start_us)
+{
+    std::vector<TrafficSource> sources;
+    uint32_t phase = 0U;
+    for (uint32_t module = 0; module < 8U; ++module)
+    {
+        const uint32_t types[] = {0x00, 0x20, 0x30, 0x40, 0x50, 0x60, 0x70};
+        for (uint32_t type : types)
+        {
+            const uint32_t period = (type == 0x00) ? 50000U : 100000U;
+            sources.push_back({&ACAN_T4::BATTERY_CAN, plain_frame(0x100 + type + module), period,
+                               start_us + (phase * 1543U) % period});
+            ++phase;
+        }
+    }
+    const uint32_t ids[] = {0x522, 0x523, 0x524, 0x525};
+    sources.push_back({&ACAN_T4::ISA_SHUNT_CAN, shunt_frame(0x521, -20000, 0), 10000U, start_us + 700U});
+    for (uint32_t i = 0; i < 4U; ++i)
+    {
+        sources.push_back({&ACAN_T4::ISA_SHUNT_CAN, shunt_frame(ids[i], 250, 0), 100000U, start_us + 3100U + 997U * i});
+    }
+    return sources;
+}
+
+struct ReplayResult
+{
+    uint32_t shunt_age_max_us;
+    uint32_t battery_age_max_us;
+    uint32_t battery_frames;
+    uint32_t battery_accepted;
+    uint32_t battery_overflows;
+    float battery_bound_max_us;
+    float shunt_bound_max_us;
+};
+
+// dispatch == false: the polled wiring before this change.
+ReplayResult replay(bool dispatch)
+{
+    sim_micros = 2000000U;
+    shunt.initialise();
+    begin_shunt_bus();
+    begin_battery_bus();
+    CanRxDispatcher shunt_rx(ACAN_T4::ISA_SHUNT_CAN, "shunt RX age");
+    CanRxDispatcher battery_rx(ACAN_T4::BATTERY_CAN, "battery RX age");
+    shunt_true_age_max_us = 0U;
+    battery_true_age_max_us = 0U;
+    battery_frames = 0U;
+
+    std::vector<TrafficSource> sources = traffic(sim_micros);
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<uint32_t> pass_us(60U, 400U); // one loop() pass, real-time tier included
+    uint32_t next_2ms = sim_micros;
+    const uint32_t end = sim_micros + 5000000U;
+    while (static_cast<int32_t>(sim_micros - end) < 0)
+    {
+        const uint32_t pass_end = sim_micros + pass_us(rng);
+        // Frames arriving while the rest of the pass runs
+        for (TrafficSource &source : sources)
+        {
+            while (static_cast<int32_t>(pass_end - source.next_us) > 0)
+            {
+                const uint32_t now = sim_micros;
+                sim_micros = source.next_us;
+                source.bus->deliver(source.frame);
+                sim_micros = now;
+                source.next_us += source.period_us;
+            }
+        }
+        sim_micros = pass_end;
+
+        if (dispatch)
+        {
+            shunt_rx.dispatch();
+            battery_rx.dispatch();
+        }
+        else
+        {
+            // loop(): drain the shunt; 2 ms task: one battery frame
+            CANMessage message;
+            while (ACAN_T4::ISA_SHUNT_CAN.receive(message))
+            {
+                if (message.idx == 0U)
+                {
+                    on_shunt_frame(message);
+                }
+            }
+            if (static_cast<int32_t>(sim_micros - next_2ms) >= 0)
+            {
+                next_2ms += 2000U;
+                if (ACAN_T4::BATTERY_CAN.receive(message))
+                {
+                    on_battery_frame(message);
+                }
+            }
+        }
+    }
+
+    ReplayResult result;
+    result.shunt_age_max_us = shunt_true_age_max_us;
+    result.battery_age_max_us = battery_true_age_max_us;
+    result.battery_frames = battery_frames;
+    result.battery_accepted = ACAN_T4::BATTERY_CAN.accepted;
+    result.battery_overflows = ACAN_T4::BATTERY_CAN.overflows;
+    result.battery_bound_max_us = battery_rx.frame_age().max_us();
+    result.shunt_bound_max_us = shunt_rx.frame_age().max_us();
+    return result;
+}
+
+void test_replay()
+{
+    std::printf("Latency replay (5 s, 640 battery frames/s, 140 shunt frames/s)\n");
+    const ReplayResult polled = replay(false);
+    const ReplayResult dispatched = replay(true);
+    std::printf("  polled:     shunt age max %6lu us, battery age max %8lu us, battery frames %5lu, overflows %lu\n",
+                static_cast<unsigned long>(polled.shunt_age_max_us),
+                static_cast<unsigned long>(polled.battery_age_max_us),
+                static_cast<unsigned long>(polled.battery_frames),
+                static_cast<unsigned long>(polled.battery_overflows));
+    std::printf("  dispatched: shunt age max %6lu us, battery age max %8lu us, battery frames %5lu, overflows %lu\n",
+                static_cast<unsigned long>(dispatched.shunt_age_max_us),
+                static_cast<unsigned long>(dispatched.battery_age_max_us),
+                static_cast<unsigned long>(dispatched.battery_frames),
+                static_cast<unsigned long>(dispatched.battery_overflows));
+    std::printf("  dispatcher bound: shunt max %.0f us, battery max %.0f us\n",
+                dispatched.shunt_bound_max_us, dispatched.battery_bound_max_us);
+
+    check(polled.battery_overflows > 0U, "polled: one frame per 2 ms cannot keep up with the modules");
+    check(dispatched.battery_overflows == 0U, "dispatched: no receive buffer overflow");
+    check(dispatched.battery_frames + ACAN_T4::BATTERY_CAN.receiveBufferCount() == dispatched.battery_accepted,
+          "dispatched: every module frame decoded");
+    check(dispatched.battery_age_max_us < 1000U, "dispatched: battery frames decoded within one loop pass");
+    check(dispatched.shunt_age_max_us <= polled.shunt_age_max_us, "dispatched: shunt age not worse than polled");
+    check(dispatched.battery_bound_max_us >= static_cast<float>(dispatched.battery_age_max_us) &&
+              dispatched.shunt_bound_max_us >= static_cast<float>(dispatched.shunt_age_max_us),
+          "age bound never below the true age");
+    check(shunt.current_A() == 20.0f, "replayed current decoded");
+}
+
+struct WorkLog
+{
+    std::vector<int> order;
+};
+
+WorkLog work_log;
+
+void work_a(void *context)
+{
+    work_log.order.push_back(*static_cast<int *>(context));
+}
+
+void work_slow(void *context)
+{
+    work_log.order.push_back(*static_cast<int *>(context));
+    sim_micros += 300U;
+}
+
+void test_work_queue()
+{
+    std::printf("Work queue\n");
+    WorkQueue queue;
+    int values[WorkQueue::kCapacity + 2];
+    for (size_t i = 0; i < WorkQueue::kCapacity + 2; ++i)
+    {
+        values[i] = static_cast<int>(i);
+    }
+
+    check(queue.post(&work_a, &values[0]) && queue.post(&work_a, &values[1]), "post");
+    check(queue.post(&work_a, &values[0]) && queue.pending() == 2U, "pending duplicate coalesced");
+    work_log.order.clear();
+    check(queue.run(1000U) == 2U && work_log.order.size() == 2U && work_log.order[0] == 0 && work_log.order[1] == 1,
+          "runs oldest first");
+
+    for (size_t i = 0; i < WorkQueue::kCapacity; ++i)
+    {
+        queue.post(&work_a, &values[i]);
+    }
+    check(!queue.post(&work_a, &values[WorkQueue::kCapacity]) && queue.dropped() == 1U, "full queue drops and counts");
+    queue.run(1000U);
+    check(queue.pending() == 0U && queue.max_pending() == WorkQueue::kCapacity, "drained, high-water mark kept");
+
+    for (int i = 0; i < 5; ++i)
+    {
+        queue.post(&work_slow, &values[i]);
+    }
+    work_log.order.clear();
+    const size_t first = queue.run(500U);
+    const size_t second = queue.run(0U);
+    std::printf("  budget 500 us: %lu items, budget 0: %lu item\n",
+                static_cast<unsigned long>(first), static_cast<unsigned long>(second));
+    check(first == 2U, "budget stops the run after the item that exceeded it");
+    check(second == 1U, "at least one item per run");
+    check(queue.pending() == 2U, "rest stays queued");
+}
+} // namespace
+
+int main()
+{
+    test_filters();
+    test_burst();
+    test_replay();
+    test_work_queue();
+
+    std::printf("%s\n", failures == 0 ? "CAN dispatch test PASSED" : "CAN dispatch test FAILED");
+    return failures == 0 ? 0 : 1;
+}
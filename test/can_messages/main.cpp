@@ -0,0 +1,604 @@
+// Host test for the CAN codecs generated from src/can_messages.dbc
+// (can_messages.h).
+//
+// 1) Every message: random payloads decode and re-encode to the same used
+//    bits, CRC-protected frames get a valid checksum, and decode(encode(m))
+//    gives m back.
+// 2) Physical values: raw -> value -> raw is exact over the raw range,
+//    out-of-range and NaN inputs clamp to the DBC range.
+// 3) The generated codecs against the code they replaced: the runtime
+//    unpack() float loop for the CMU frames, the hand-written IVT-S parser,
+//    the hand-packed 0x41A..0x41E frames (within one LSB, since encoding
+//    now rounds instead of truncating) and the VCU command parser.
+// 4) Encode and decode cost per message, and the CMU voltage frame against
+//    the unpack() loop.
+//
+// Build: pio run -e native_can_messages_test && .pio/build/native_can_messages_test/program
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "can_messages.h"
+
+namespace
+{
+int failures = 0;
+
+void check(bool ok, const char *what)
+{
+    if (!ok)
+    {
+        std::printf("  FAIL: %s\n", what);
+        ++failures;
+    }
+}
+
+uint32_t rng_state = 0x2545F491U;
+
+uint32_t next_random()
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+void random_payload(uint8_t data[8])
+{
+    const uint32_t low = next_random();
+    const uint32_t high = next_random();
+    memcpy(data, &low, 4);
+    memcpy(data + 4, &high, 4);
+}
+
+uint64_t bits_of(const uint8_t data[8])
+{
+    uint64_t bits;
+    memcpy(&bits, data, sizeof(bits));
+    return bits;
+}
+
+// ---------------------------------------------------------------------------
+// 1) Bit-exact round trip of every message
+// ---------------------------------------------------------------------------
+
+template <typename M>
+void round_trip_message()
+{
+    static constexpr uint64_t kCrcSlot = 0xFF00000000000000ULL;
+    const uint64_t compared = (M::kChecksum == CAN_CHECKSUM_CRC8) ? (M::kUsedMask & ~kCrcSlot) : M::kUsedMask;
+    bool bits_ok = true;
+    bool message_ok = true;
+    bool checksum_ok = true;
+    bool stable_ok = true;
+    for (int i = 0; i < 20000; ++i)
+    {
+        uint8_t payload[8];
+        random_payload(payload);
+        M message = M::decode(payload);
+
+        uint8_t encoded[8];
+        message.encode(encoded);
+        bits_ok &= (bits_of(encoded) & compared) == (bits_of(payload) & compared);
+        bits_ok &= (bits_of(encoded) & ~M::kUsedMask) == 0U;
+
+        const M again = M::decode(encoded);
+        if constexpr (M::kChecksum == CAN_CHECKSUM_CRC8)
+        {
+            checksum_ok &= M::checksum_ok(encoded);
+            message.crc = encoded[7];
+        }
+        message_ok &= (again == message);
+
+        uint8_t twice[8];
+        again.encode(twice);
+        stable_ok &= memcmp(encoded, twice, sizeof(twice)) == 0;
+    }
+
+    char what[96];
+    std::snprintf(what, sizeof(what), "%s: used bits survive decode/encode", M::kName);
+    check(bits_ok, what);
+    std::snprintf(what, sizeof(what), "%s: decode(encode(m)) == m", M::kName);
+    check(message_ok, what);
+    std::snprintf(what, sizeof(what), "%s: encode is stable", M::kName);
+    check(stable_ok, what);
+    if (M::kChecksum == CAN_CHECKSUM_CRC8)
+    {
+        std::snprintf(what, sizeof(what), "%s: encoded checksum is valid", M::kName);
+        check(checksum_ok, what);
+    }
+}
+
+void test_round_trip()
+{
+    std::printf("Round trip of every message\n");
+    int messages = 0;
+#define ROUND_TRIP(M)       \
+    round_trip_message<M>(); \
+    ++messages;
+    CAN_MESSAGE_LIST(ROUND_TRIP)
+#undef ROUND_TRIP
+    std::printf("  %d messages\n", messages);
+
+    // A flipped bit anywhere in a CRC-protected frame is caught
+    CanBmsVoltage voltage;
+    voltage.set_pack_voltage(398.7f);
+    voltage.counter = 9;
+    uint8_t data[8];
+    voltage.encode(data);
+    bool all_caught = CanBmsVoltage::checksum_ok(data);
+    for (int bit = 0; bit < 64; ++bit)
+    {
+        data[bit / 8] ^= static_cast<uint8_t>(1U << (bit % 8));
+        all_caught &= !CanBmsVoltage::checksum_ok(data);
+        data[bit / 8] ^= static_cast<uint8_t>(1U << (bit % 8));
+    }
+    check(all_caught, "single bit errors fail checksum_ok()");
+}
+
+// ---------------------------------------------------------------------------
+// 2) Physical conversions
+// ---------------------------------------------------------------------------
+
+// raw -> value -> raw over [lo, hi] in steps of step
+#define CHECK_PHYSICAL(M, signal, lo, hi, step)                                           \
+    do                                                                                    \
+    {                                                                                     \
+        bool exact = true;                                                                \
+        for (int64_t raw = (lo); raw <= (hi); raw += (step))                              \
+        {                                                                                 \
+            const auto typed = static_cast<decltype(M{}.signal)>(raw);                    \
+            exact &= M::signal##_raw(M::signal##_value(typed)) == typed;                  \
+        }                                                                                 \
+        check(exact, #M "::" #signal ": raw -> value -> raw is exact");                   \
+    } while (0)
+
+void test_physical()
+{
+    std::printf("Physical conversions\n");
+    CHECK_PHYSICAL(CanCmuVoltage0to2, cell_voltage0, 0, 32767, 1);
+    CHECK_PHYSICAL(CanCmuTotalVoltage, module_voltage, 0, 65535, 1);
+    CHECK_PHYSICAL(CanCmuTemperatures, temperature0, 0, 255, 1);
+    CHECK_PHYSICAL(CanIvtResultI, result, -4194304, 4194304, 1); // float is exact to 2^22
+    CHECK_PHYSICAL(CanIvtResultT, result, -4194304, 4194304, 1);
+    CHECK_PHYSICAL(CanBmsVoltage, pack_voltage, 0, 6500, 1);
+    CHECK_PHYSICAL(CanBmsVoltage, pack_current, 0, 10000, 1);
+    CHECK_PHYSICAL(CanBmsVoltage, min_cell_voltage, 0, 255, 1);
+    CHECK_PHYSICAL(CanBmsCellTemp, min_cell_temp, 0, 167, 1);
+    CHECK_PHYSICAL(CanBmsCellTemp, cell_voltage_delta, 0, 255, 1);
+    CHECK_PHYSICAL(CanBmsCellTemp, pack_power, 0, 50000, 1);
+    CHECK_PHYSICAL(CanBmsLimitsFault, max_charge_current, 0, 65535, 1);
+    CHECK_PHYSICAL(CanBmsSocSoh, soc, 0, 10000, 1);
+    CHECK_PHYSICAL(CanBmsHmi, avg_energy_per_hour, -32767, 32767, 1);
+    CHECK_PHYSICAL(CanBmsHmi, remaining_time, 0, 65535, 1);
+
+    // Rounding to nearest, not truncating
+    check(CanBmsVoltage::pack_voltage_raw(398.26f) == 3983U, "398.26 V -> 398.3 V");
+    check(CanBmsVoltage::pack_current_raw(-0.04f) == 5000U && CanBmsVoltage::pack_current_raw(-0.06f) == 4999U,
+          "current rounds to the nearest 0.1 A both sides of 0");
+    check(CanBmsHmi::avg_energy_per_hour_raw(-1.006f) == -101, "negative values round away from zero");
+    check(CanCmuVoltage0to2::cell_voltage0_value(3712U) == 3.712f, "3712 mV decodes to 3.712f");
+    check(CanIvtResultI::result_value(-12500) == -12.5f, "-12500 mA decodes to -12.5f");
+
+    // Clamping to the DBC range
+    check(CanBmsVoltage::pack_voltage_raw(700.0f) == 6500U && CanBmsVoltage::pack_voltage_raw(-3.0f) == 0U,
+          "pack voltage clamps to [0, 650] V");
+    check(CanBmsVoltage::pack_current_raw(612.0f) == 10000U && CanBmsVoltage::pack_current_raw(-612.0f) == 0U,
+          "pack current clamps to [-500, 500] A");
+    check(CanBmsCellTemp::min_cell_temp_raw(150.0f) == 167U && CanBmsCellTemp::min_cell_temp_raw(-60.0f) == 0U,
+          "cell temperature clamps to [-40, 127] degC");
+    check(CanBmsCellTemp::pack_power_raw(250.0f) == 50000U, "pack power clamps to 200 kW");
+    check(CanBmsSocSoh::soc_raw(104.0f) == 10000U, "SOC clamps to 100 %");
+    check(CanBmsHmi::avg_energy_per_hour_raw(-400.0f) == -32767 && CanBmsHmi::avg_energy_per_hour_raw(400.0f) == 32767,
+          "energy per hour clamps to +-327.67 kWh");
+    check(CanBmsHmi::remaining_time_raw(1.0e9f) == 65535U, "remaining time saturates");
+    check(CanIvtResultI::result_raw(1.0e9f) == 2147483647 && CanIvtResultI::result_raw(-1.0e9f) == (-2147483647 - 1),
+          "32-bit signals clamp without overflowing the conversion");
+    check(CanBmsVoltage::pack_voltage_raw(NAN) == 0U && CanBmsHmi::avg_energy_per_hour_raw(NAN) == -32767,
+          "NaN gives the lower bound");
+    CanBmsContactorTelemetry telemetry;
+    telemetry.set_positive_state(9U);
+    check(telemetry.positive_state == 5U, "enum signals clamp to the DBC range");
+
+    // Usable in constant expressions
+    static_assert(CanBmsVoltage::pack_voltage_raw(400.0f) == 4000U, "constexpr encode");
+    static_assert(CanBmsCellTemp::min_cell_temp_value(65U) == 25.0f, "constexpr decode");
+}
+
+// ---------------------------------------------------------------------------
+// 3) Against the code the generated codecs replaced
+// ---------------------------------------------------------------------------
+
+// utils/can_packer.cpp unpack(), little-endian path. Out of line, as it was
+// in its own translation unit.
+__attribute__((noinline)) float legacy_unpack(const uint8_t data[8], uint8_t start_bit, uint8_t bit_len, float scale, float offset)
+{
+    const uint64_t mask = ((1ULL << bit_len) - 1ULL) << start_bit;
+    const uint64_t shifted = (bits_of(data) & mask) >> start_bit;
+    return shifted * scale + offset;
+}
+
+__attribute__((noinline)) bool legacy_unpack(const uint8_t data[8], uint8_t start_bit, uint8_t bit_len)
+{
+    const uint64_t mask = ((1ULL << bit_len) - 1ULL) << start_bit;
+    return ((bits_of(data) & mask) >> start_bit) > 0;
+}
+
+bool within_ulp(float a, float b)
+{
+    return a == b || std::nextafter(a, b) == b;
+}
+
+void test_cmu_against_unpack()
+{
+    bool voltages = true;
+    bool flags = true;
+    bool temperatures = true;
+    for (int i = 0; i < 100000; ++i)
+    {
+        uint8_t data[8];
+        random_payload(data);
+
+        const CanCmuVoltage6to8 cells = CanCmuVoltage6to8::decode(data);
+        voltages &= within_ulp(cells.get_cell_voltage6(), legacy_unpack(data, 0, 15, 0.001f, 0.0f));
+        voltages &= within_ulp(cells.get_cell_voltage7(), legacy_unpack(data, 16, 15, 0.001f, 0.0f));
+        voltages &= within_ulp(cells.get_cell_voltage8(), legacy_unpack(data, 32, 15, 0.001f, 0.0f));
+        flags &= cells.cell_balance6 == legacy_unpack(data, 15, 1) && cells.cell_balance7 == legacy_unpack(data, 31, 1) &&
+                 cells.cell_balance8 == legacy_unpack(data, 47, 1);
+        voltages &= within_ulp(CanCmuTotalVoltage::decode(data).get_module_voltage(), legacy_unpack(data, 0, 16, 0.001f, 0.0f));
+
+        const CanCmuErrorBalanceStatus status = CanCmuErrorBalanceStatus::decode(data);
+        flags &= (status.cmu_error > 0) == legacy_unpack(data, 0, 32) && status.balance_direction0 == legacy_unpack(data, 32, 1) &&
+                 status.balance_direction11 == legacy_unpack(data, 43, 1);
+
+        const CanCmuTemperatures temps = CanCmuTemperatures::decode(data);
+        temperatures &= temps.get_temperature0() == legacy_unpack(data, 0, 8, 1.0f, -40.0f) &&
+                        temps.get_temperature3() == legacy_unpack(data, 24, 8, 1.0f, -40.0f) &&
+                        temps.get_temperature_internal() == legacy_unpack(data, 32, 8, 1.0f, -40.0f);
+    }
+    check(voltages, "CMU voltages within 1 ulp of unpack()");
+    check(flags, "CMU flags equal unpack()");
+    check(temperatures, "CMU temperatures equal unpack()");
+}
+
+void test_ivts_against_parser()
+{
+    bool values = true;
+    bool status = true;
+    for (int i = 0; i < 100000; ++i)
+    {
+        uint8_t d[8];
+        random_payload(d);
+        // Shunt_IVTS::readS32_le() and parseStatus_() before the generated codec
+        const int32_t raw = static_cast<int32_t>((static_cast<uint32_t>(d[5]) << 24) | (static_cast<uint32_t>(d[4]) << 16) |
+                                                 (static_cast<uint32_t>(d[3]) << 8) | static_cast<uint32_t>(d[2]));
+        const uint8_t hi = static_cast<uint8_t>(d[1] >> 4);
+
+        const CanIvtResultI frame = CanIvtResultI::decode(d);
+        values &= frame.result == raw && frame.mux_id == d[0];
+        values &= -CanIvtResultI::result_value(frame.result) == -raw / 1000.0f;
+        values &= CanIvtResultT::result_value(frame.result) == raw / 10.0f;
+        values &= -CanIvtResultW::result_value(frame.result) == -static_cast<float>(raw);
+        status &= frame.counter == (d[1] & 0x0F) && frame.ocs == ((hi & 0x01) != 0) &&
+                  frame.this_result_error == ((hi & 0x02) != 0) && frame.any_measurement_error == ((hi & 0x04) != 0) &&
+                  frame.system_error == ((hi & 0x08) != 0);
+    }
+    check(values, "IVT-S results equal the previous parser");
+    check(status, "IVT-S status bits equal the previous parser");
+}
+
+// BMS::send_battery_status_message() before the generated codecs
+struct BmsInputs
+{
+    float pack_voltage, current, min_cell, max_cell;
+    float min_temp, max_temp, balancing_voltage, delta, power_w;
+    float max_discharge, max_charge;
+    uint8_t contactor_state, dtc;
+    float soc, soh;
+    uint8_t balancing_status, bms_state;
+    float energy, time_s, wh;
+    uint8_t counter;
+};
+
+void legacy_encode(const BmsInputs &in, uint8_t out[5][8])
+{
+    memset(out, 0, 5 * 8);
+    uint16_t pack_v = (uint16_t)(in.pack_voltage * 10.0f);
+    uint16_t pack_i = (uint16_t)((in.current * 10.0f) + 5000.0f);
+    out[0][0] = pack_v & 0xFF;
+    out[0][1] = pack_v >> 8;
+    out[0][2] = pack_i & 0xFF;
+    out[0][3] = pack_i >> 8;
+    out[0][4] = (uint8_t)(in.min_cell * 50.0f);
+    out[0][5] = (uint8_t)(in.max_cell * 50.0f);
+
+    out[1][0] = (uint8_t)(in.min_temp + 40.0f);
+    out[1][1] = (uint8_t)(in.max_temp + 40.0f);
+    out[1][2] = static_cast<uint8_t>(std::fmin(std::fmax(in.balancing_voltage, 0.0f), 5.1f) * 50.0f);
+    out[1][3] = static_cast<uint8_t>(std::fmin(std::fmax(in.delta * 500.0f, 0.0f), 255.0f));
+    uint16_t pack_power = (uint16_t)((in.power_w / 1000.0f) * 100.0f + 30000.0f);
+    out[1][4] = pack_power & 0xFF;
+    out[1][5] = pack_power >> 8;
+
+    uint16_t max_d = (uint16_t)(in.max_discharge * 10.0f);
+    uint16_t max_c = (uint16_t)(in.max_charge * 10.0f);
+    out[2][0] = max_d & 0xFF;
+    out[2][1] = max_d >> 8;
+    out[2][2] = max_c & 0xFF;
+    out[2][3] = max_c >> 8;
+    out[2][4] = in.contactor_state;
+    out[2][5] = in.dtc;
+
+    uint16_t soc16 = static_cast<uint16_t>(std::fmin(std::fmax(in.soc * 100.0f, 0.0f), 100.0f) * 100.0f);
+    uint16_t soh16 = static_cast<uint16_t>(std::fmin(std::fmax(in.soh * 100.0f, 0.0f), 100.0f) * 100.0f);
+    out[3][0] = soc16 & 0xFF;
+    out[3][1] = soc16 >> 8;
+    out[3][2] = soh16 & 0xFF;
+    out[3][3] = soh16 >> 8;
+    out[3][4] = in.balancing_status;
+    out[3][5] = in.bms_state;
+
+    const int16_t energy = static_cast<int16_t>(std::fmin(std::fmax(in.energy, -327.67f), 327.67f) * 100.0f);
+    const uint16_t time_left = static_cast<uint16_t>(std::fmin(std::fmax(in.time_s, 0.0f), 65535.0f));
+    const uint16_t wh_left = static_cast<uint16_t>(std::fmin(std::fmax(in.wh, 0.0f), 65535.0f));
+    out[4][0] = static_cast<uint8_t>(energy & 0xFF);
+    out[4][1] = static_cast<uint8_t>((energy >> 8) & 0xFF);
+    out[4][2] = static_cast<uint8_t>(time_left & 0xFF);
+    out[4][3] = static_cast<uint8_t>(time_left >> 8);
+    out[4][4] = static_cast<uint8_t>(wh_left & 0xFF);
+    out[4][5] = static_cast<uint8_t>(wh_left >> 8);
+
+    for (int m = 0; m < 5; ++m)
+    {
+        out[m][6] = in.counter & 0x0F;
+        out[m][7] = can_crc8(out[m]);
+    }
+}
+
+// The same as BMS::send_battery_status_message() does now
+void generated_encode(const BmsInputs &in, uint8_t out[5][8])
+{
+    CanBmsVoltage voltage;
+    voltage.set_pack_voltage(in.pack_voltage);
+    voltage.set_pack_current(in.current);
+    voltage.set_min_cell_voltage(in.min_cell);
+    voltage.set_max_cell_voltage(in.max_cell);
+    voltage.counter = in.counter;
+    voltage.encode(out[0]);
+
+    CanBmsCellTemp cell_temp;
+    cell_temp.set_min_cell_temp(in.min_temp);
+    cell_temp.set_max_cell_temp(in.max_temp);
+    cell_temp.set_balancing_target_voltage(in.balancing_voltage);
+    cell_temp.set_cell_voltage_delta(in.delta);
+    cell_temp.set_pack_power(in.power_w / 1000.0f);
+    cell_temp.counter = in.counter;
+    cell_temp.encode(out[1]);
+
+    CanBmsLimitsFault limits;
+    limits.set_max_discharge_current(in.max_discharge);
+    limits.set_max_charge_current(in.max_charge);
+    limits.set_contactor_state(in.contactor_state);
+    limits.fault_code = in.dtc;
+    limits.counter = in.counter;
+    limits.encode(out[2]);
+
+    CanBmsSocSoh soc_soh;
+    soc_soh.set_soc(in.soc * 100.0f);
+    soc_soh.set_soh(in.soh * 100.0f);
+    soc_soh.set_balancing_status(in.balancing_status);
+    soc_soh.bms_status = in.bms_state;
+    soc_soh.counter = in.counter;
+    soc_soh.encode(out[3]);
+
+    CanBmsHmi hmi;
+    hmi.set_avg_energy_per_hour(in.energy);
+    hmi.set_remaining_time(in.time_s);
+    hmi.set_remaining_energy(in.wh);
+    hmi.counter = in.counter;
+    hmi.encode(out[4]);
+}
+
+float uniform(float lo, float hi)
+{
+    return lo + (hi - lo) * static_cast<float>(next_random() >> 8) / 16777216.0f;
+}
+
+void test_bms_against_hand_packing()
+{
+    // Field widths of 0x41A..0x41E bytes 0-5, 0 = single byte of a 16-bit pair
+    static const uint8_t kWidth[5][6] = {
+        {2, 0, 2, 0, 1, 1}, {1, 1, 1, 1, 2, 0}, {2, 0, 2, 0, 1, 1}, {2, 0, 2, 0, 1, 1}, {2, 0, 2, 0, 2, 0}};
+    bool within_lsb = true;
+    bool counters = true;
+    bool crcs = true;
+    for (int i = 0; i < 100000; ++i)
+    {
+        BmsInputs in;
+        in.pack_voltage = uniform(0.0f, 650.0f);
+        in.current = uniform(-499.0f, 499.0f);
+        in.min_cell = uniform(0.0f, 5.0f);
+        in.max_cell = uniform(0.0f, 5.0f);
+        in.min_temp = uniform(-39.0f, 126.0f);
+        in.max_temp = uniform(-39.0f, 126.0f);
+        in.balancing_voltage = uniform(0.0f, 5.0f);
+        in.delta = uniform(0.0f, 0.5f);
+        in.power_w = uniform(-299000.0f, 199000.0f);
+        in.max_discharge = uniform(0.0f, 6500.0f);
+        in.max_charge = uniform(0.0f, 6500.0f);
+        in.contactor_state = static_cast<uint8_t>(next_random() % 8U);
+        in.dtc = static_cast<uint8_t>(next_random());
+        in.soc = uniform(0.0f, 1.0f);
+        in.soh = uniform(0.0f, 1.0f);
+        in.balancing_status = static_cast<uint8_t>(next_random() % 3U);
+        in.bms_state = static_cast<uint8_t>(next_random() % 3U);
+        in.energy = uniform(-327.0f, 327.0f);
+        in.time_s = uniform(0.0f, 65000.0f);
+        in.wh = uniform(0.0f, 65000.0f);
+        in.counter = static_cast<uint8_t>(i);
+
+        uint8_t legacy[5][8];
+        uint8_t generated[5][8];
+        legacy_encode(in, legacy);
+        generated_encode(in, generated);
+        for (int m = 0; m < 5; ++m)
+        {
+            for (int b = 0; b < 6; ++b)
+            {
+                int32_t a = legacy[m][b];
+                int32_t g = generated[m][b];
+                if (kWidth[m][b] == 0)
+                {
+                    continue;
+                }
+                if (kWidth[m][b] == 2)
+                {
+                    a |= legacy[m][b + 1] << 8;
+                    g |= generated[m][b + 1] << 8;
+                    if (m == 4 && b == 0) // int16 energy
+                    {
+                        a = static_cast<int16_t>(a);
+                        g = static_cast<int16_t>(g);
+                    }
+                }
+                within_lsb &= std::abs(a - g) <= 1;
+            }
+            counters &= generated[m][6] == legacy[m][6];
+            crcs &= CanBmsVoltage::checksum_ok(generated[m]); // same CRC for every CanCrc8 frame
+        }
+    }
+    check(within_lsb, "0x41A..0x41E within 1 LSB of the hand-packed frames");
+    check(counters, "counter byte unchanged");
+    check(crcs, "CRC byte valid");
+}
+
+void test_vcu_against_parser()
+{
+    bool same = true;
+    int accepted = 0;
+    for (int i = 0; i < 100000; ++i)
+    {
+        uint8_t data[8];
+        random_payload(data);
+        if ((i & 1) != 0)
+        {
+            data[7] = 0;
+            data[7] = can_crc8(data);
+        }
+        // BMS::process_vcu_message() before the generated codec
+        uint8_t tmp[8];
+        memcpy(tmp, data, 8);
+        tmp[7] = 0;
+        const bool legacy_ok = can_crc8(tmp) == data[7];
+
+        same &= CanVcuCommand::checksum_ok(data) == legacy_ok;
+        if (legacy_ok)
+        {
+            const CanVcuCommand command = CanVcuCommand::decode(data);
+            same &= command.vehicle_operating_mode == static_cast<int8_t>(data[0]);
+            same &= command.request_bms_shutdown == data[1] && command.request_contactor_close == data[2];
+            same &= command.counter == (data[6] & 0x0F);
+            ++accepted;
+        }
+    }
+    check(same, "VCU command decodes as before");
+    check(accepted >= 50000, "frames with a valid CRC accepted");
+}
+
+// ---------------------------------------------------------------------------
+// 4) Cost
+// ---------------------------------------------------------------------------
+
+constexpr int kBenchmarkFrames = 1 << 20;
+constexpr int kPayloads = 256;
+uint8_t bench_payloads[kPayloads][8];
+volatile uint32_t bench_sink;
+
+template <typename Function>
+double ns_per_frame(Function function)
+{
+    const auto start = std::chrono::steady_clock::now();
+    uint32_t sum = 0;
+    for (int i = 0; i < kBenchmarkFrames; ++i)
+    {
+        sum += function(i & (kPayloads - 1));
+    }
+    bench_sink = sum;
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / kBenchmarkFrames;
+}
+
+template <typename M>
+void benchmark_message()
+{
+    static M messages[kPayloads];
+    for (int i = 0; i < kPayloads; ++i)
+    {
+        messages[i] = M::decode(bench_payloads[i]);
+    }
+    const double decode_ns =
+        ns_per_frame([](int i) { return static_cast<uint32_t>(M::decode(bench_payloads[i]) == messages[i ^ 1]); });
+    const double encode_ns = ns_per_frame([](int i) {
+        uint8_t out[8];
+        messages[i].encode(out);
+        return static_cast<uint32_t>(out[0] ^ out[7]);
+    });
+    std::printf("  0x%03X %-24s decode %5.1f ns  encode %5.1f ns\n",
+                static_cast<unsigned>(M::kId),
+                M::kName,
+                decode_ns,
+                encode_ns);
+    check(decode_ns > 0.0 && decode_ns < 1000.0 && encode_ns > 0.0 && encode_ns < 1000.0, "codec cost is plausible");
+}
+
+void test_benchmark()
+{
+    std::printf("Cost per frame\n");
+    for (auto &payload : bench_payloads)
+    {
+        random_payload(payload);
+    }
+#define BENCHMARK(M) benchmark_message<M>();
+    CAN_MESSAGE_LIST(BENCHMARK)
+#undef BENCHMARK
+
+    // BatteryModule::process_message() voltage frame: 6 unpack() calls before
+    const double legacy_ns = ns_per_frame([](int i) {
+        const uint8_t *data = bench_payloads[i];
+        float cells[3];
+        bool balance[3];
+        cells[0] = legacy_unpack(data, 0, 15, 0.001f, 0.0f);
+        balance[0] = legacy_unpack(data, 15, 1);
+        cells[1] = legacy_unpack(data, 16, 15, 0.001f, 0.0f);
+        balance[1] = legacy_unpack(data, 31, 1);
+        cells[2] = legacy_unpack(data, 32, 15, 0.001f, 0.0f);
+        balance[2] = legacy_unpack(data, 47, 1);
+        return static_cast<uint32_t>(cells[0] + cells[1] + cells[2]) + balance[0] + balance[1] + balance[2];
+    });
+    const double generated_ns = ns_per_frame([](int i) {
+        const CanCmuVoltage0to2 frame = CanCmuVoltage0to2::decode(bench_payloads[i]);
+        const float cells[3] = {frame.get_cell_voltage0(), frame.get_cell_voltage1(), frame.get_cell_voltage2()};
+        return static_cast<uint32_t>(cells[0] + cells[1] + cells[2]) + frame.cell_balance0 + frame.cell_balance1 +
+               frame.cell_balance2;
+    });
+    std::printf("  CMU voltage frame to floats: unpack() %.1f ns, generated %.1f ns\n", legacy_ns, generated_ns);
+    check(generated_ns < 2.0 * legacy_ns + 5.0, "generated decode is not slower than unpack()");
+}
+} // namespace
+
+int main()
+{
+    test_round_trip();
+    test_physical();
+    std::printf("Against the replaced code\n");
+    test_cmu_against_unpack();
+    test_ivts_against_parser();
+    test_bms_against_hand_packing();
+    test_vcu_against_parser();
+    test_benchmark();
+
+    std::printf("%s\n", failures == 0 ? "CAN messages test PASSED" : "CAN messages test FAILED");
+    return failures == 0 ? 0 : 1;
+}
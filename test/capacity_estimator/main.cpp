@@ -0,0 +1,153 @@
+// Host Monte-Carlo harness for CapacityEstimator.
+//
+// Simulates charge cycles between a low and a high OCV anchor with noisy
+// anchor SOC (OCV lookup error), shunt charge noise and occasional anchor
+// outliers, and compares the capacity error of the weighted TLS estimator
+// against the previous two-point EMA:
+//   - "EMA x1":  one EMA update per anchor pair (idealised),
+//   - "EMA rest": EMA applied once per second during a 60 s rest in the high
+//                 region, which is what the 1 s BMS task used to do.
+// Capacity is normalised to the rated capacity. The second scenario ages the
+// cell linearly to check that the forgetting factor tracks the drift.
+//
+// Build: pio run -e native_capacity_estimator_test && .pio/build/native_capacity_estimator_test/program
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+#include "bms/capacity_estimator.h"
+
+namespace
+{
+constexpr int kRuns = 500;
+constexpr int kCycles = 60;
+constexpr int kRestUpdates = 60;
+constexpr float kAlphaC = 0.10f;
+constexpr float kQInit = 1.0f;
+constexpr float kOutlierProb = 0.05f;
+constexpr float kOutlierSoc = 0.10f;
+
+const int kReportCycles[] = {1, 3, 5, 10, 20, 40, 60};
+
+struct Scenario
+{
+    const char *name;
+    float q_start;
+    float q_end;
+};
+
+const Scenario kScenarios[] = {
+    {"constant Q=0.85", 0.85f, 0.85f},
+    {"ageing 0.88->0.85", 0.88f, 0.85f},
+};
+
+float clampf(float x, float lo, float hi)
+{
+    return (x < lo) ? lo : ((x > hi) ? hi : x);
+}
+
+float ema_update(float c, float c_new)
+{
+    c_new = clampf(c_new, 0.30f, 1.50f);
+    c = (1.0f - kAlphaC) * c + kAlphaC * c_new;
+    return clampf(c, 0.50f, 1.20f);
+}
+
+struct Stats
+{
+    double sq[kCycles] = {};
+    int covered[kCycles] = {};
+};
+} // namespace
+
+int main()
+{
+    int failures = 0;
+
+    for (const Scenario &sc : kScenarios)
+    {
+        std::mt19937 rng(4242);
+        std::normal_distribution<float> soc_noise(0.0f, CC_CAP_EST_SIGMA_SOC);
+        std::normal_distribution<float> q_noise(0.0f, CC_CAP_EST_SIGMA_Q);
+        std::uniform_real_distribution<float> u01(0.0f, 1.0f);
+
+        Stats tls;
+        Stats ema1;
+        Stats ema_rest;
+
+        for (int run = 0; run < kRuns; ++run)
+        {
+            CapacityEstimator est;
+            est.initialise(CapacityEstimatorStats{}, kQInit);
+            float c_ema1 = kQInit;
+            float c_ema_rest = kQInit;
+
+            for (int cycle = 0; cycle < kCycles; ++cycle)
+            {
+                const float q_true =
+                    sc.q_start + (sc.q_end - sc.q_start) * static_cast<float>(cycle) / (kCycles - 1);
+
+                const float soc_lo = 0.05f + 0.15f * u01(rng);
+                const float soc_hi = 0.80f + 0.18f * u01(rng);
+                float soc_lo_meas = soc_lo + soc_noise(rng);
+                float soc_hi_meas = soc_hi + soc_noise(rng);
+                if (u01(rng) < kOutlierProb)
+                {
+                    soc_hi_meas += (u01(rng) < 0.5f) ? kOutlierSoc : -kOutlierSoc;
+                }
+
+                const float dq = q_true * (soc_hi - soc_lo) + q_noise(rng);
+                const float dsoc = soc_hi_meas - soc_lo_meas;
+                const float c_pair = dq / dsoc;
+
+                if (c_pair >= 0.30f && c_pair <= 1.50f)
+                {
+                    est.add_pair(dq, dsoc, CC_CAP_EST_SIGMA_DSOC);
+                }
+                c_ema1 = ema_update(c_ema1, c_pair);
+                for (int i = 0; i < kRestUpdates; ++i)
+                {
+                    c_ema_rest = ema_update(c_ema_rest, c_pair);
+                }
+
+                const float e_tls = est.q() - q_true;
+                tls.sq[cycle] += e_tls * e_tls;
+                tls.covered[cycle] += (std::fabs(e_tls) <= 2.0f * est.sigma_q()) ? 1 : 0;
+                ema1.sq[cycle] += (c_ema1 - q_true) * (c_ema1 - q_true);
+                ema_rest.sq[cycle] += (c_ema_rest - q_true) * (c_ema_rest - q_true);
+            }
+        }
+
+        std::printf("Scenario: %s (%d runs)\n", sc.name, kRuns);
+        std::printf("%6s %12s %12s %12s %12s\n", "cycle", "TLS_rms%", "EMAx1_rms%", "EMArest_rms%", "TLS_2sig_cov");
+        for (int c : kReportCycles)
+        {
+            const int i = c - 1;
+            std::printf("%6d %12.2f %12.2f %12.2f %11.0f%%\n",
+                        c,
+                        100.0 * std::sqrt(tls.sq[i] / kRuns),
+                        100.0 * std::sqrt(ema1.sq[i] / kRuns),
+                        100.0 * std::sqrt(ema_rest.sq[i] / kRuns),
+                        100.0 * tls.covered[i] / kRuns);
+        }
+
+        // From cycle 10 on the TLS estimate must beat both EMA variants and
+        // stay within 2 % RMS of the true capacity.
+        for (int i = 9; i < kCycles; ++i)
+        {
+            const double rms_tls = std::sqrt(tls.sq[i] / kRuns);
+            const double rms_ema1 = std::sqrt(ema1.sq[i] / kRuns);
+            const double rms_rest = std::sqrt(ema_rest.sq[i] / kRuns);
+            if (rms_tls > 0.02 || rms_tls >= rms_ema1 || rms_tls >= rms_rest)
+            {
+                std::printf("  FAIL: %s cycle %d\n", sc.name, i + 1);
+                ++failures;
+                break;
+            }
+        }
+    }
+
+    std::printf("%s\n", failures == 0 ? "Capacity estimator test PASSED" : "Capacity estimator test FAILED");
+    return failures == 0 ? 0 : 1;
+}
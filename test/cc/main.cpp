@@ -13,24 +13,10 @@ static float clampf(float v, float lo, float hi) {
     return v;
 }
 
-static float soc_from_ocv(float temp_c, float ocv_v) {
-    return SOC_FROM_OCV_TEMP(temp_c, ocv_v) / 100.0f;
-}
-
 static float ocv_from_soc(float temp_c, float target_soc) {
-    const float soc = clampf(target_soc, 0.0f, 1.0f);
-    float best_v = 3.2f;
-    float best_err = 1.0e9f;
-    for (float v = 3.2f; v <= 4.2f; v += 0.002f) {
-        float s = soc_from_ocv(temp_c, v);
-        float err = std::fabs(s - soc);
-        if (err < best_err) {
-            best_err = err;
-            best_v = v;
-        }
-    }
-    return best_v;
+    return ocvFromSocTemp(temp_c, clampf(target_soc, 0.0f, 1.0f) * 100.0f);
 }
+
 struct CcPersist {
     float b_as = 0.0f;
     float C_as = 0.0f;
@@ -39,6 +25,7 @@ struct CcPersist {
     float q_low_as = 0.0f;
     float soc_low_anchor = 0.0f;
     bool was_above_high_set = false;
+    CapacityEstimatorStats cap_stats;
 };
 
 static CcPersist persist;
@@ -213,6 +200,7 @@ void loop() {
         persist.q_low_as = param::q_low_as;
         persist.soc_low_anchor = param::soc_low_anchor;
         persist.was_above_high_set = param::was_above_high_set;
+        persist.cap_stats = cc.capacity_stats();
 
         cc = CoulombCounting();
         cc.initialise(persist.b_as,
@@ -221,7 +209,8 @@ void loop() {
                       persist.have_low_anchor,
                       persist.q_low_as,
                       persist.soc_low_anchor,
-                      persist.was_above_high_set);
+                      persist.was_above_high_set,
+                      persist.cap_stats);
         reset_done = true;
     }
 
@@ -0,0 +1,303 @@
+// Host test for the console output ring (utils/console_ring.h).
+//
+// 1) Deferred printf output matches snprintf byte for byte for the formats
+//    the console uses.
+// 2) Lines longer than the old 128-byte printf buffer are not truncated.
+// 3) Reads of any size reproduce the same stream.
+// 4) A full ring drops whole records, counts them and marks the gap in the
+//    output at the point of the loss.
+// 5) A producer and a consumer thread run concurrently without losing or
+//    reordering anything the ring accepted.
+// 6) Cost of an enqueue compared with formatting on the spot.
+//
+// Build: pio run -e native_console_ring_test && .pio/build/native_console_ring_test/program
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include "utils/console_ring.h"
+
+namespace
+{
+int failures = 0;
+
+void check(bool ok, const char *what)
+{
+    if (!ok)
+    {
+        std::printf("  FAIL: %s\n", what);
+        ++failures;
+    }
+}
+
+template <size_t N>
+std::string read_all(ConsoleRing<N> &ring, size_t chunk = 64U)
+{
+    std::string out;
+    char buffer[256];
+    size_t count = 0U;
+    while ((count = ring.read(buffer, chunk)) > 0U)
+    {
+        out.append(buffer, count);
+    }
+    return out;
+}
+
+template <typename... Args>
+std::string expected(const char *format, Args... args)
+{
+    char buffer[1024];
+    std::snprintf(buffer, sizeof(buffer), format, args...);
+    return buffer;
+}
+
+enum TestState : uint8_t
+{
+    TEST_STATE_RUN = 3
+};
+
+template <typename... Args>
+void check_format(const char *format, Args... args)
+{
+    ConsoleRing<4096> ring;
+    ring.write_format(format, args...);
+    const std::string out = read_all(ring);
+    const std::string want = expected(format, args...);
+    if (out != want)
+    {
+        std::printf("  '%s' -> '%s', expected '%s'\n", format, out.c_str(), want.c_str());
+    }
+    check(out == want, "deferred output matches snprintf");
+}
+
+void test_formats()
+{
+    std::printf("Deferred formatting\n");
+    check_format("plain text, no arguments\n");
+    check_format("%-16s %5lums %7lu %8.1f %8.1f %4lu\n", "BMS 100ms", 100UL, 123456UL, 12.345f, 1234.56, 7UL);
+    check_format("CPU load %.1f%% (max %.1f%%)\n", 12.34f, 99.96f);
+    check_format("dtc=0x%02X v=%u t=%d\n", static_cast<uint8_t>(0x4A), 1U, -40);
+    check_format("crc %08lX id 0x%03x\n", 0xDEADBEEFUL, 0x1a5U);
+    check_format("%.6g %e %g\n", 3.14159265, 1.5e-7, 100000.0);
+    check_format("%c%c %s|%10s|%-6s|\n", 'O', 'K', "", "right", "left");
+    check_format("%lld %llu %ld\n", -9000000000LL, 18000000000ULL, -5L);
+    check_format("%+d % d %05d %-5d|\n", 5, 5, -42, 42);
+    check_format("%.3s|%.0f|%#x|%o\n", "truncate", 2.5, 255U, 8U);
+    check_format("state %d, flag %d\n", TEST_STATE_RUN, true);
+    check_format("%u of %u\n", static_cast<uint16_t>(65535U), static_cast<unsigned>(16384U));
+    check_format("%%s is literal, %%%% too\n");
+
+    std::string temporary = "copied at enqueue";
+    ConsoleRing<256> ring;
+    ring.write_format("[%s]", temporary.c_str());
+    temporary.assign(temporary.size(), 'x');
+    check(read_all(ring) == "[copied at enqueue]", "string arguments are copied");
+
+    const char *none = nullptr;
+    ring.write_format("%s %d", none);
+    check(read_all(ring) == "(null) (?)", "null string and missing argument are visible");
+}
+
+void test_long_lines()
+{
+    std::printf("Long lines\n");
+    ConsoleRing<4096> ring;
+    std::string cells;
+    char part[32];
+    for (int c = 0; c < 96; ++c)
+    {
+        std::snprintf(part, sizeof(part), " c%d=%.3f", c, 3.6 + c * 0.001);
+        cells += part;
+    }
+    // The CMU_IMPLAUSIBLE dump: one line per module, far longer than 128 bytes
+    ring.write_format("  cellV_all:%s\n", cells.c_str());
+    std::string line = "  cellV_all:";
+    line.append(cells, 0, ConsoleRing<4096>::kMaxStringBytes);
+    line += "\n";
+
+    std::string text(3000, '-');
+    ring.write_text(text.data(), text.size());
+    const std::string out = read_all(ring);
+    std::printf("  %zu bytes out\n", out.size());
+    check(out == line + text, "no truncation below the per-argument limit");
+
+    for (int c = 0; c < 96; ++c)
+    {
+        ring.write_format(" c%d=%.3f", c, 3.6 + c * 0.001);
+    }
+    check(read_all(ring) == cells, "a line built from many printf calls is complete");
+}
+
+void test_chunked_reads()
+{
+    std::printf("Chunked reads\n");
+    ConsoleRing<1024> ring;
+    std::string reference;
+    for (size_t chunk = 1U; chunk <= 7U; ++chunk)
+    {
+        std::string out;
+        for (int line = 0; line < 20; ++line)
+        {
+            ring.write_format("line %2d: %-12s %8.3f\n", line, "module", line * 0.125);
+            ring.write_text("text record\n", 12U);
+            out += read_all(ring, chunk);
+        }
+        if (chunk == 1U)
+        {
+            reference = out;
+        }
+        check(out == reference && !out.empty(), "same stream for every read size");
+    }
+    check(ring.empty() && ring.used() == 0U, "ring empty after reading");
+}
+
+void test_overflow()
+{
+    std::printf("Overflow\n");
+    ConsoleRing<256> ring;
+    size_t stored = 0U;
+    for (int i = 0; i < 40; ++i)
+    {
+        if (ring.write_format("record %02d\n", i))
+        {
+            ++stored;
+        }
+    }
+    const std::string out = read_all(ring);
+    ring.write_text("after\n", 6U);
+    const std::string resumed = read_all(ring);
+    std::printf("  %zu of 40 stored, %lu bytes in %lu records dropped, max used %zu\n",
+                stored,
+                static_cast<unsigned long>(ring.dropped_bytes()),
+                static_cast<unsigned long>(ring.dropped_records()),
+                ring.max_used());
+    check(stored > 0U && stored < 40U, "ring fills up");
+    check(ring.dropped_records() == 40U - stored, "every dropped record is counted");
+    check(ring.max_used() <= 256U, "never more than the capacity");
+
+    // Stored records are complete and in order, the marker follows them
+    std::string want;
+    for (size_t i = 0; i < stored; ++i)
+    {
+        want += expected("record %02d\n", static_cast<int>(i));
+    }
+    check(out == want, "stored records complete and in order");
+    want = expected("\n[console: %lu bytes dropped]\n", static_cast<unsigned long>(ring.dropped_bytes())) + "after\n";
+    check(resumed == want, "drop marker at the point of the loss, output after it intact");
+
+    ring.write_text("ok\n", 3U);
+    check(read_all(ring) == "ok\n", "one marker per gap");
+}
+
+void test_threads()
+{
+    std::printf("Producer and consumer threads\n");
+    static ConsoleRing<1024> ring;
+    constexpr int kRecords = 200000;
+    std::string out;
+    out.reserve(kRecords * 16U);
+    std::thread consumer([&out]() {
+        char buffer[37];
+        while (true)
+        {
+            const size_t count = ring.read(buffer, sizeof(buffer));
+            out.append(buffer, count);
+            if (count == 0U && out.size() >= 3U && out.compare(out.size() - 3U, 3U, "end") == 0)
+            {
+                break;
+            }
+        }
+    });
+    for (int i = 0; i < kRecords; ++i)
+    {
+        while (!ring.write_format("%d,", i))
+        {
+            std::this_thread::yield();
+        }
+    }
+    while (!ring.write_text("end", 3U))
+    {
+        std::this_thread::yield();
+    }
+    consumer.join();
+
+    // The producer retries rejected records; each gap shows up as a marker
+    bool ordered = true;
+    int next = 0;
+    size_t pos = 0U;
+    while (pos < out.size() && out.compare(pos, 3U, "end") != 0)
+    {
+        if (out[pos] == '\n')
+        {
+            pos = out.find(']', pos) + 2U; // drop marker
+            continue;
+        }
+        const int value = std::atoi(out.c_str() + pos);
+        ordered = ordered && (value == next);
+        next = value + 1;
+        pos = out.find(',', pos) + 1U;
+    }
+    std::printf("  %zu bytes, %lu dropped and retried\n", out.size(), static_cast<unsigned long>(ring.dropped_records()));
+    check(ordered && next == kRecords, "every accepted record arrives once, in order");
+}
+
+void test_cost()
+{
+    std::printf("Enqueue cost\n");
+    constexpr int kCalls = 200000;
+    ConsoleRing<16384> ring;
+    constexpr int kBatch = 64;
+    char sink[64];
+    double enqueue_ns = 0.0;
+    double drain_ns = 0.0;
+    size_t bytes = 0U;
+    for (int i = 0; i < kCalls; i += kBatch)
+    {
+        // Producer side (the runnable) and consumer side (the drain) timed apart
+        const auto start = std::chrono::steady_clock::now();
+        for (int j = i; j < i + kBatch; ++j)
+        {
+            ring.write_format("%-16s %7lu %8.1f %8.1f\n", "BMS 100ms", static_cast<unsigned long>(j), j * 0.5, 3.25);
+        }
+        const auto enqueued = std::chrono::steady_clock::now();
+        size_t count = 0U;
+        while ((count = ring.read(sink, sizeof(sink))) > 0U)
+        {
+            bytes += count;
+        }
+        enqueue_ns += std::chrono::duration<double, std::nano>(enqueued - start).count();
+        drain_ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - enqueued).count();
+    }
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kCalls; ++i)
+    {
+        char line[128];
+        std::snprintf(line, sizeof(line), "%-16s %7lu %8.1f %8.1f\n", "BMS 100ms", static_cast<unsigned long>(i), i * 0.5, 3.25);
+        sink[i & 63] = line[i & 63];
+    }
+    const double eager_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    std::printf("  per printf: %.1f ns enqueue, %.1f ns drain, %.1f ns snprintf on the spot (%zu bytes)\n",
+                enqueue_ns / kCalls,
+                drain_ns / kCalls,
+                eager_ns / kCalls,
+                bytes);
+    check(ring.dropped_bytes() == 0U, "nothing dropped while draining keeps up");
+    check(enqueue_ns < eager_ns, "enqueue is cheaper than formatting in the caller");
+}
+} // namespace
+
+int main()
+{
+    test_formats();
+    test_long_lines();
+    test_chunked_reads();
+    test_overflow();
+    test_threads();
+    test_cost();
+
+    std::printf("%s\n", failures == 0 ? "Console ring test PASSED" : "Console ring test FAILED");
+    return failures == 0 ? 0 : 1;
+}
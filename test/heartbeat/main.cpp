@@ -0,0 +1,222 @@
+// Host test for the heartbeat supervisor and the watchdog freeze-frame.
+//
+// The real-time tier is modelled as a 1 ms supervise() tick with the four
+// heartbeats of comms_bms.cpp checking in at their task periods. A stalled
+// runnable and a blocked loop() are injected and the simulated WDT3 (150 ms
+// after the last feed) "resets" by calling the freeze-frame callback and
+// capture_watchdog_freeze_frame() as the next boot would.
+//
+// 1) All tasks running: the watchdog is fed every tick.
+// 2) One runnable stalls: feeding stops at its deadline, the freeze-frame
+//    names it.
+// 3) loop() blocked (e.g. a busy-wait): every heartbeat goes stale, the
+//    frame shows how long the supervisor itself has not run.
+// 4) The frame is reported for one boot only.
+// 5) Boot requests survive the reset once.
+// 6) Overhead of one supervise() pass.
+//
+// Build: pio run -e native_heartbeat_test && .pio/build/native_heartbeat_test/program
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#include "watchdog_supervisor.h"
+
+namespace
+{
+int failures = 0;
+
+void check(bool ok, const char *what)
+{
+    if (!ok)
+    {
+        std::printf("  FAIL: %s\n", what);
+        ++failures;
+    }
+}
+
+enum
+{
+    PACK_RX,
+    SHUNT_TIMEOUT,
+    CONTACTORS,
+    BMS_100MS,
+    COUNT
+};
+
+constexpr uint32_t kWatchdogTimeoutMs = 150U;
+const uint32_t kPeriodMs[COUNT] = {2U, 10U, 20U, 100U};
+
+Heartbeat heartbeats[COUNT] = {
+    {"pack RX", 20, 0},
+    {"shunt timeout", 50, 0},
+    {"contactors", 100, 0},
+    {"BMS 100ms", 300, 0},
+};
+
+struct Run
+{
+    bool reset;
+    uint32_t reset_ms;
+    uint32_t last_feed_ms;
+};
+
+// stalled: heartbeat that stops checking in at stall_ms (COUNT: none)
+// blocked: loop() does not run at all from stall_ms on
+Run simulate(HeartbeatSupervisor &supervisor, int stalled, bool blocked, uint32_t stall_ms, uint32_t end_ms)
+{
+    const uint32_t boot_ms = 5000U; // after the blocking init in setup()
+    supervisor.start(boot_ms);
+    Run run = {false, 0U, boot_ms};
+    for (uint32_t now = boot_ms; now < boot_ms + end_ms; ++now)
+    {
+        const bool stalled_now = now >= boot_ms + stall_ms;
+        if (now - run.last_feed_ms >= kWatchdogTimeoutMs)
+        {
+            record_watchdog_freeze_frame(supervisor, now);
+            run.reset = true;
+            run.reset_ms = now - boot_ms;
+            return run;
+        }
+        if (blocked && stalled_now)
+        {
+            continue;
+        }
+        for (int i = 0; i < COUNT; ++i)
+        {
+            if ((now - boot_ms) % kPeriodMs[i] == 0U && !(i == stalled && stalled_now))
+            {
+                supervisor.check_in(static_cast<size_t>(i), now);
+            }
+        }
+        if (supervisor.supervise(now))
+        {
+            run.last_feed_ms = now;
+        }
+    }
+    return run;
+}
+
+void test_all_running()
+{
+    std::printf("All runnables running\n");
+    HeartbeatSupervisor supervisor(heartbeats, COUNT);
+    const Run run = simulate(supervisor, COUNT, false, 0U, 10000U);
+    std::printf("  fed %lu, starved %lu\n",
+                static_cast<unsigned long>(supervisor.fed()),
+                static_cast<unsigned long>(supervisor.starved()));
+    check(!run.reset, "no reset");
+    check(supervisor.starved() == 0U && supervisor.fed() == 10000U, "fed on every tick");
+}
+
+void test_stalled_runnable()
+{
+    std::printf("Contactor update stalls\n");
+    HeartbeatSupervisor supervisor(heartbeats, COUNT);
+    capture_watchdog_freeze_frame(); // clear leftovers
+    const Run run = simulate(supervisor, CONTACTORS, false, 1000U, 10000U);
+    capture_watchdog_freeze_frame(); // next boot
+    const WatchdogFreezeFrame *frame = boot_watchdog_freeze_frame();
+    std::printf("  reset %lu ms after the stall\n", static_cast<unsigned long>(run.reset_ms - 1000U));
+    check(run.reset, "watchdog reset");
+    // Last check-in at 980 ms, stale after 100 ms, reset 150 ms later
+    check(run.reset_ms == 980U + 101U + kWatchdogTimeoutMs - 1U, "reset one watchdog timeout after the deadline");
+    check(frame != nullptr, "freeze-frame recorded");
+    if (frame != nullptr)
+    {
+        std::printf("  %s late by %lu ms, stale 0x%02lX, supervisor age %lu ms\n",
+                    frame->task,
+                    static_cast<unsigned long>(frame->overdue_ms),
+                    static_cast<unsigned long>(frame->stale_mask),
+                    static_cast<unsigned long>(frame->supervisor_age_ms));
+        check(std::strcmp(frame->task, "contactors") == 0, "frame names the stalled runnable");
+        check(frame->deadline_ms == 100U && frame->overdue_ms == kWatchdogTimeoutMs, "overdue by the watchdog timeout");
+        check(frame->stale_mask == (1U << CONTACTORS), "only the stalled heartbeat is stale");
+        check(frame->supervisor_age_ms <= 1U, "supervisor kept running");
+    }
+}
+
+void test_blocked_loop()
+{
+    std::printf("loop() blocked\n");
+    HeartbeatSupervisor supervisor(heartbeats, COUNT);
+    const Run run = simulate(supervisor, COUNT, true, 2001U, 10000U);
+    capture_watchdog_freeze_frame();
+    const WatchdogFreezeFrame *frame = boot_watchdog_freeze_frame();
+    check(run.reset && run.reset_ms == 2000U + kWatchdogTimeoutMs, "reset one watchdog timeout after the last pass");
+    check(frame != nullptr, "freeze-frame recorded");
+    if (frame != nullptr)
+    {
+        std::printf("  %s late by %lu ms, stale 0x%02lX, supervisor age %lu ms\n",
+                    frame->task,
+                    static_cast<unsigned long>(frame->overdue_ms),
+                    static_cast<unsigned long>(frame->stale_mask),
+                    static_cast<unsigned long>(frame->supervisor_age_ms));
+        check(std::strcmp(frame->task, "pack RX") == 0, "shortest deadline is furthest overdue");
+        check(frame->supervisor_age_ms == kWatchdogTimeoutMs, "frame shows the supervisor did not run");
+        check(frame->stale_mask == (1U << PACK_RX) + (1U << SHUNT_TIMEOUT) + (1U << CONTACTORS),
+              "all heartbeats with deadlines below the blocked time are stale");
+    }
+}
+
+void test_frame_lifetime()
+{
+    std::printf("Freeze-frame lifetime\n");
+    HeartbeatSupervisor supervisor(heartbeats, COUNT);
+    simulate(supervisor, BMS_100MS, false, 0U, 10000U);
+    capture_watchdog_freeze_frame();
+    check(boot_watchdog_freeze_frame() != nullptr, "reported on the boot after the reset");
+    capture_watchdog_freeze_frame();
+    check(boot_watchdog_freeze_frame() == nullptr, "not reported again on the following boot");
+
+    record_watchdog_freeze_frame(supervisor, 100000U);
+    capture_watchdog_freeze_frame();
+    check(std::strcmp(boot_watchdog_freeze_frame()->task, "BMS 100ms") == 0, "frame names the late runnable");
+    HeartbeatSupervisor empty(heartbeats, 0);
+    record_watchdog_freeze_frame(empty, 5U);
+    capture_watchdog_freeze_frame();
+    check(boot_watchdog_freeze_frame() != nullptr && std::strcmp(boot_watchdog_freeze_frame()->task, "none") == 0,
+          "frame without a late heartbeat says so");
+}
+
+void test_boot_request()
+{
+    std::printf("Boot requests\n");
+    check(take_boot_request() == BOOT_REQUEST_NONE, "no request by default");
+    request_reboot(BOOT_REQUEST_CONFIGURE_SHUNT); // returns on the host
+    check(take_boot_request() == BOOT_REQUEST_CONFIGURE_SHUNT, "request survives the reset");
+    check(take_boot_request() == BOOT_REQUEST_NONE, "request runs once");
+}
+
+void test_overhead()
+{
+    std::printf("Overhead\n");
+    HeartbeatSupervisor supervisor(heartbeats, COUNT);
+    supervisor.start(0U);
+    constexpr uint32_t kPasses = 1000000U;
+    uint32_t fed = 0U;
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t now = 1U; now <= kPasses; ++now)
+    {
+        supervisor.check_in(now & 3U, now);
+        fed += supervisor.supervise(now) ? 1U : 0U;
+    }
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / kPasses;
+    std::printf("  %.1f ns per check-in + supervise pass (%lu fed)\n", ns, static_cast<unsigned long>(fed));
+    check(ns < 1000.0, "well below a microsecond per tick");
+}
+} // namespace
+
+int main()
+{
+    test_all_running();
+    test_stalled_runnable();
+    test_blocked_loop();
+    test_frame_lifetime();
+    test_boot_request();
+    test_overhead();
+
+    std::printf("%s\n", failures == 0 ? "Heartbeat supervisor test PASSED" : "Heartbeat supervisor test FAILED");
+    return failures == 0 ? 0 : 1;
+}
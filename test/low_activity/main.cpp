@@ -0,0 +1,339 @@
+// Host model of the low-activity profile (vehicle state SLEEP).
+//
+// The rate tables of comms_bms.cpp run with assumed execution times and the
+// CAN frames each runnable sends. Every CMU poll is answered with 7 frames
+// that the receive dispatch decodes.
+//
+// 1) Work and frames per second in the full and in the low-activity profile,
+//    simulated and cross-checked against analyse_rate_table().
+// 2) Wake-up: the VCU leaves SLEEP at every phase of the reduced schedule.
+//    The RX tick switches back, and the next CMU poll follows within one
+//    CMU cycle (8 modules x 13 ms).
+// 3) The heartbeat of the 100 ms group keeps the watchdog fed through
+//    entering and leaving the profile.
+//
+// Build: pio run -e native_low_activity_test && .pio/build/native_low_activity_test/program
+
+#include <cstdio>
+
+#include "utils/rate_schedule.h"
+#include "watchdog_supervisor.h"
+
+namespace
+{
+int failures = 0;
+
+void check(bool ok, const char *what)
+{
+    if (!ok)
+    {
+        std::printf("  FAIL: %s\n", what);
+        ++failures;
+    }
+}
+
+constexpr uint16_t kPollDivider = 10U;     // LOW_ACTIVITY_POLL_DIVIDER
+constexpr uint16_t kBms100msDivider = 10U; // LOW_ACTIVITY_BMS_100MS_DIVIDER
+constexpr uint32_t kCmuCycleMs = 8U * 13U;
+
+enum
+{
+    RX_TICK,
+    CONTACTORS,
+    SHUNT_10MS,
+    BATTERY_POLL,
+    BMS_100MS,
+    BMS_1000MS,
+    HEARTBEAT_CHECK,
+    BMS_10MS,
+    MONITOR_100MS,
+    SYSTEM_LOAD,
+    LED_BLINK,
+    TASK_COUNT
+};
+
+// Assumed execution times (us) and frames sent per run. The RX tick no
+// longer decodes; decoding is counted per answer frame.
+const float cost_us[TASK_COUNT] = {10.0f, 25.0f, 10.0f, 15.0f, 300.0f, 900.0f, 1.0f, 20.0f, 15.0f, 30.0f, 2.0f};
+constexpr uint32_t kAnswerFrames = 7U; // 0x1x5..0x1x7 of the polled module
+constexpr float kDecodeUs = 5.0f;
+const uint32_t frames_full[TASK_COUNT] = {0U, 0U, 0U, 1U, 5U, 0U, 0U, 0U, 1U, 1U, 0U};
+const uint32_t frames_low[TASK_COUNT] = {0U, 0U, 0U, 1U, 4U, 0U, 0U, 0U, 1U, 0U, 0U}; // no HMI, no task profile frame
+
+uint32_t sim_ms = 0U;
+bool vehicle_sleep = false;
+bool low_activity = false;
+uint32_t runs[TASK_COUNT];
+double work_us = 0.0;
+uint32_t frames = 0U;
+uint32_t received = 0U;
+uint32_t last_poll_ms = 0U;
+
+HeartbeatSupervisor *supervisor = nullptr;
+bool watchdog_starved = false;
+
+void on_activity_change(bool enable);
+
+template <int I>
+void body()
+{
+    ++runs[I];
+    work_us += cost_us[I];
+    frames += low_activity ? frames_low[I] : frames_full[I];
+    if (I == BATTERY_POLL)
+    {
+        last_poll_ms = sim_ms;
+        received += kAnswerFrames;
+        work_us += kAnswerFrames * kDecodeUs;
+    }
+    if (I == BMS_100MS && supervisor != nullptr)
+    {
+        supervisor->check_in(0U, sim_ms);
+    }
+    if (I == RX_TICK && vehicle_sleep != low_activity)
+    {
+        on_activity_change(vehicle_sleep);
+    }
+    if (I == HEARTBEAT_CHECK && supervisor != nullptr && !supervisor->supervise(sim_ms))
+    {
+        watchdog_starved = true;
+    }
+}
+
+TaskProfile profiles[TASK_COUNT] = {
+    {"RX tick", 2},
+    {"contactors", 20},
+    {"shunt 10ms", 10},
+    {"battery poll", 13},
+    {"BMS 100ms", 100},
+    {"BMS 1000ms", 1000},
+    {"heartbeat check", 1},
+    {"BMS 10ms", 10},
+    {"monitor 100ms", 100},
+    {"system load", 100},
+    {"led blink", 1000},
+};
+
+// Tables of comms_bms.cpp
+constexpr RateTask realtime_entries[] = {
+    {"RX tick", &body<RX_TICK>, 2, 0, &profiles[RX_TICK], 1, 0},
+    {"contactors", &body<CONTACTORS>, 20, 1, &profiles[CONTACTORS], 1, 0},
+    {"shunt 10ms", &body<SHUNT_10MS>, 10, 3, &profiles[SHUNT_10MS], 1, 0},
+    {"battery poll", &body<BATTERY_POLL>, 13, 5, &profiles[BATTERY_POLL], kPollDivider, 0},
+    {"BMS 100ms", &body<BMS_100MS>, 100, 7, &profiles[BMS_100MS], kBms100msDivider, 0},
+    {"BMS 1000ms", &body<BMS_1000MS>, 1000, 9, &profiles[BMS_1000MS], 1, 0},
+    {"heartbeat check", &body<HEARTBEAT_CHECK>, 1, 0, &profiles[HEARTBEAT_CHECK], 1, 0},
+};
+constexpr auto realtime_table = make_rate_table(realtime_entries);
+
+constexpr RateTask best_effort_entries[] = {
+    {"BMS 10ms", &body<BMS_10MS>, 10, 0, &profiles[BMS_10MS], 1, 1000},
+    {"monitor 100ms", &body<MONITOR_100MS>, 100, 2, &profiles[MONITOR_100MS], RateTask::kSuspended, 100},
+    {"system load", &body<SYSTEM_LOAD>, 100, 4, &profiles[SYSTEM_LOAD], 10, 50},
+    {"led blink", &body<LED_BLINK>, 1000, 6, &profiles[LED_BLINK], RateTask::kSuspended, 20},
+    {"monitor 1000ms", nullptr, 1000, 8, nullptr, 1, 100},
+    {"print debug", nullptr, 1000, 8, nullptr, 1, 100},
+};
+constexpr auto best_effort_table = make_rate_table(best_effort_entries);
+
+RateScheduler<realtime_table.kCapacity> realtime_schedule(realtime_table, 1000U);
+RateScheduler<best_effort_table.kCapacity> best_effort_schedule(best_effort_table, 1000U);
+
+constexpr uint32_t kBms100msDeadlineMs = 300U;
+Heartbeat heartbeats[1] = {{"BMS 100ms", kBms100msDeadlineMs, 0}};
+
+// update_activity_profile() of comms_bms.cpp
+void on_activity_change(bool enable)
+{
+    if (supervisor != nullptr)
+    {
+        supervisor->set_deadline(0U, enable ? kBms100msDeadlineMs * kBms100msDivider : kBms100msDeadlineMs, sim_ms);
+    }
+    realtime_schedule.set_low_activity(enable);
+    best_effort_schedule.set_low_activity(enable);
+    low_activity = enable;
+}
+
+void reset_counters()
+{
+    for (uint32_t &count : runs)
+    {
+        count = 0U;
+    }
+    work_us = 0.0;
+    frames = 0U;
+    received = 0U;
+}
+
+// Loop passes every 100 us of simulated time
+void run_until(uint32_t end_ms)
+{
+    for (uint32_t us = sim_ms * 1000U; us < end_ms * 1000U; us += 100U)
+    {
+        sim_ms = us / 1000U;
+        realtime_schedule.execute(us);
+        best_effort_schedule.execute(us);
+    }
+    sim_ms = end_ms;
+}
+
+void start(bool sleep)
+{
+    sim_ms = 0U;
+    vehicle_sleep = sleep;
+    low_activity = false;
+    realtime_schedule.set_low_activity(false);
+    best_effort_schedule.set_low_activity(false);
+    realtime_schedule.start(0U);
+    best_effort_schedule.start(0U);
+    for (TaskProfile &profile : profiles)
+    {
+        profile.reset();
+    }
+    reset_counters();
+}
+
+struct Rates
+{
+    double work_us_per_s;
+    double frames_per_s;
+    double received_per_s;
+    double polls_per_s;
+    double runs_per_s;
+};
+
+Rates measure(bool sleep)
+{
+    constexpr uint32_t kSeconds = 60U;
+    start(sleep);
+    run_until(1000U); // settle into the profile
+    reset_counters();
+    run_until(1000U + kSeconds * 1000U);
+
+    uint32_t total_runs = 0U;
+    for (uint32_t count : runs)
+    {
+        total_runs += count;
+    }
+    return {work_us / kSeconds, static_cast<double>(frames) / kSeconds, static_cast<double>(received) / kSeconds,
+            static_cast<double>(runs[BATTERY_POLL]) / kSeconds, static_cast<double>(total_runs) / kSeconds};
+}
+
+void test_work_per_second()
+{
+    std::printf("Work per second\n");
+    const Rates full = measure(false);
+    const Rates low = measure(true);
+    std::printf("                     full      SLEEP\n");
+    std::printf("  work us/s      %9.0f %10.0f\n", full.work_us_per_s, low.work_us_per_s);
+    std::printf("  runnables/s    %9.0f %10.0f\n", full.runs_per_s, low.runs_per_s);
+    std::printf("  CMU polls/s    %9.1f %10.1f\n", full.polls_per_s, low.polls_per_s);
+    std::printf("  frames sent/s  %9.1f %10.1f\n", full.frames_per_s, low.frames_per_s);
+    std::printf("  frames recv/s  %9.1f %10.1f\n", full.received_per_s, low.received_per_s);
+    std::printf("  reduction: work %.1f %%, CMU polls %.1f %%, frames %.1f %%\n",
+                100.0 * (1.0 - low.work_us_per_s / full.work_us_per_s),
+                100.0 * (1.0 - low.polls_per_s / full.polls_per_s),
+                100.0 * (1.0 - (low.frames_per_s + low.received_per_s) / (full.frames_per_s + full.received_per_s)));
+
+    check(low.polls_per_s * kPollDivider > full.polls_per_s - 1.0 &&
+              low.polls_per_s * kPollDivider < full.polls_per_s + 1.0,
+          "CMU poll rate divided by the poll divider");
+    // What remains is mostly the 1 and 2 ms groups that keep their rate
+    check(low.work_us_per_s < full.work_us_per_s * 0.7, "less than 70 % of the work");
+    check(low.frames_per_s < full.frames_per_s / 5.0, "less than a fifth of the frames");
+    check(runs[MONITOR_100MS] == 0U && runs[LED_BLINK] == 0U, "telemetry and LED suspended");
+    check(runs[BMS_1000MS] == 60U && runs[CONTACTORS] == 3000U, "limits at 1 s, contactors at full rate");
+
+    // The console report uses the analysis; it must agree with the simulation
+    float cost[realtime_table.kCapacity];
+    for (size_t i = 0; i < realtime_table.count; ++i)
+    {
+        cost[i] = cost_us[i];
+    }
+    cost[BATTERY_POLL] += kAnswerFrames * kDecodeUs;
+    float best_effort_cost[best_effort_table.kCapacity];
+    for (size_t i = 0; i < best_effort_table.count; ++i)
+    {
+        best_effort_cost[i] = cost_us[BMS_10MS + i];
+    }
+    const double analysed_full = 1000.0 * (analyse_rate_table(realtime_table, cost).average_us +
+                                           analyse_rate_table(best_effort_table, best_effort_cost).average_us);
+    const double analysed_low = 1000.0 * (analyse_rate_table(realtime_table, cost, true).average_us +
+                                          analyse_rate_table(best_effort_table, best_effort_cost, true).average_us);
+    std::printf("  analysis: %.0f us/s full, %.0f us/s SLEEP\n", analysed_full, analysed_low);
+    check(analysed_full > full.work_us_per_s * 0.99 && analysed_full < full.work_us_per_s * 1.01,
+          "analysis matches the full profile");
+    check(analysed_low > low.work_us_per_s * 0.99 && analysed_low < low.work_us_per_s * 1.01,
+          "analysis matches the low-activity profile");
+}
+
+void test_wake_up()
+{
+    std::printf("Wake-up latency\n");
+    uint32_t worst_ms = 0U;
+    for (uint32_t wake_ms = 5000U; wake_ms < 5000U + 2U * kCmuCycleMs * kPollDivider; wake_ms += 7U)
+    {
+        start(true);
+        run_until(wake_ms);
+        check(low_activity, "in the low-activity profile before the wake-up");
+        vehicle_sleep = false; // VCU frame decoded at wake_ms
+        const uint32_t polls = runs[BATTERY_POLL];
+        while (runs[BATTERY_POLL] == polls)
+        {
+            run_until(sim_ms + 1U);
+        }
+        const uint32_t latency = last_poll_ms - wake_ms;
+        worst_ms = (latency > worst_ms) ? latency : worst_ms;
+        // From then on the full rate
+        const uint32_t next = runs[BATTERY_POLL] + 8U;
+        run_until(sim_ms + kCmuCycleMs);
+        check(runs[BATTERY_POLL] == next, "one CMU cycle at full rate after the first poll");
+    }
+    std::printf("  worst first poll %lu ms after the VCU frame (CMU cycle %lu ms)\n",
+                static_cast<unsigned long>(worst_ms), static_cast<unsigned long>(kCmuCycleMs));
+    check(worst_ms < kCmuCycleMs, "full rate within one CMU cycle");
+    check(worst_ms <= 2U + 13U, "at most one RX tick and one poll slot");
+}
+
+void test_heartbeat()
+{
+    std::printf("Heartbeat across profile changes\n");
+    HeartbeatSupervisor heartbeat(heartbeats, 1U);
+    supervisor = &heartbeat;
+    start(false);
+    heartbeat.start(0U);
+    watchdog_starved = false;
+    for (uint32_t cycle = 0U; cycle < 20U; ++cycle)
+    {
+        vehicle_sleep = true;
+        run_until(sim_ms + 3000U + 37U * cycle);
+        vehicle_sleep = false;
+        run_until(sim_ms + 500U + 11U * cycle);
+    }
+    std::printf("  fed %lu, starved %lu\n",
+                static_cast<unsigned long>(heartbeat.fed()),
+                static_cast<unsigned long>(heartbeat.starved()));
+    check(!watchdog_starved, "watchdog fed through every transition");
+
+    // Without stretching the deadline the 1 s group would starve it
+    start(true);
+    heartbeat.start(0U);
+    run_until(10U);
+    heartbeat.set_deadline(0U, kBms100msDeadlineMs, sim_ms);
+    watchdog_starved = false;
+    run_until(3000U);
+    check(watchdog_starved, "the 300 ms deadline alone is too short in SLEEP");
+    supervisor = nullptr;
+}
+
+} // namespace
+
+int main()
+{
+    test_work_per_second();
+    test_wake_up();
+    test_heartbeat();
+
+    std::printf("%s\n", failures == 0 ? "Low-activity test PASSED" : "Low-activity test FAILED");
+    return failures == 0 ? 0 : 1;
+}
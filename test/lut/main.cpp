@@ -0,0 +1,812 @@
+// Host test and benchmark for the constexpr lookup tables (utils/lut.h).
+//
+// - Builder: static_asserts below check that descending axes are normalised
+//   at compile time; build with -DLUT_TEST_NON_MONOTONIC to see a broken axis
+//   rejected.
+// - RAM: the legacy wrappers kept a static Map2D/Map3D copy of every table
+//   plus an init flag; the constexpr tables live in flash only.
+// - Accuracy: every table wrapper is compared against a naive reference
+//   (linear scan, double precision, clamped) on a dense grid that includes
+//   out-of-range inputs.
+// - Speed: time per lookup for the legacy Map2D/Map3D path and the constexpr
+//   path (ns, plus TSC ticks on x86 hosts).
+// - Inverse OCV table: SOC -> OCV -> SOC round-trip error bound, monotonicity
+//   and cost against the forward lookup and a brute-force inversion.
+// - int16_t/Q15 storage: per-table max error against the reference, flash
+//   size and time per lookup against the float tables.
+// - Uniform-axis fast path, fixed-temperature slices and the batch API must
+//   match the scalar lookup bit for bit; each is benchmarked against it.
+//
+// Build: pio run -e native_lut_test && .pio/build/native_lut_test/program
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring> // Map2D3D.h relies on Arduino.h for memcpy
+#include <random>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define LUT_BENCH_HAVE_TSC 1
+#endif
+
+#include "utils/Map2D3D.h"
+#include "utils/current_limit_lookup.h"
+#include "utils/resistance_lookup.h"
+#include "utils/soc_lookup.h"
+
+namespace
+{
+int failures = 0;
+
+void check(bool ok, const char *what)
+{
+    if (!ok)
+    {
+        std::printf("  FAIL: %s\n", what);
+        ++failures;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Reference interpolation (direction agnostic, double precision)
+//-----------------------------------------------------------------------------
+
+template <int N>
+double ref_bracket(const float (&xs)[N], double x, int &i)
+{
+    const bool asc = xs[N - 1] > xs[0];
+    const double lo = asc ? xs[0] : xs[N - 1];
+    const double hi = asc ? xs[N - 1] : xs[0];
+    x = std::fmin(std::fmax(x, lo), hi);
+    for (i = 0; i < N - 2; ++i)
+    {
+        const double a = xs[i];
+        const double b = xs[i + 1];
+        if ((x >= std::fmin(a, b)) && (x <= std::fmax(a, b)))
+        {
+            break;
+        }
+    }
+    return (x - xs[i]) / (static_cast<double>(xs[i + 1]) - xs[i]);
+}
+
+template <int N>
+double ref_1d(const float (&xs)[N], const float (&ys)[N], double x)
+{
+    int i;
+    const double t = ref_bracket(xs, x, i);
+    return ys[i] + t * (static_cast<double>(ys[i + 1]) - ys[i]);
+}
+
+template <int R, int C>
+double ref_2d(const float (&x1s)[R], const float (&x2s)[C], const float (&ys)[R][C], double x1, double x2)
+{
+    int i;
+    int j;
+    const double t1 = ref_bracket(x1s, x1, i);
+    const double t2 = ref_bracket(x2s, x2, j);
+    const double y0 = ys[i][j] + t2 * (static_cast<double>(ys[i][j + 1]) - ys[i][j]);
+    const double y1 = ys[i + 1][j] + t2 * (static_cast<double>(ys[i + 1][j + 1]) - ys[i + 1][j]);
+    return y0 + t1 * (y1 - y0);
+}
+
+//-----------------------------------------------------------------------------
+// Compile-time checks of the LUT builder
+//-----------------------------------------------------------------------------
+
+constexpr float kAscX[4] = {0.0f, 1.0f, 2.0f, 4.0f};
+constexpr float kAscY[4] = {0.0f, 10.0f, 30.0f, 40.0f};
+constexpr float kDescX[4] = {4.0f, 2.0f, 1.0f, 0.0f};
+constexpr float kDescY[4] = {40.0f, 30.0f, 10.0f, 0.0f};
+constexpr float kGrid[2][4] = {{0.0f, 1.0f, 2.0f, 3.0f}, {10.0f, 11.0f, 12.0f, 13.0f}};
+constexpr float kGridDesc[2][4] = {{13.0f, 12.0f, 11.0f, 10.0f}, {3.0f, 2.0f, 1.0f, 0.0f}};
+constexpr float kRowsAsc[2] = {0.0f, 1.0f};
+constexpr float kRowsDesc[2] = {1.0f, 0.0f};
+
+constexpr Lut1D<4> kAscLut = make_lut1d(kAscX, kAscY);
+constexpr Lut1D<4> kDescLut = make_lut1d(kDescX, kDescY);
+static_assert(kDescLut.axis.x[0] == 0.0f && kDescLut.axis.x[3] == 4.0f, "descending axis normalised");
+static_assert(kDescLut.y[1] == 10.0f, "y reversed with its axis");
+static_assert(kDescLut.f(1.5f) == kAscLut.f(1.5f) && kDescLut.f(1.5f) == 20.0f, "same interpolation");
+static_assert(kDescLut.f(-5.0f) == 0.0f && kDescLut.f(9.0f) == 40.0f, "clamped at both ends");
+
+constexpr Lut2D<2, 4> kGridAsc = make_lut2d(kRowsAsc, kAscX, kGrid);
+constexpr Lut2D<2, 4> kGridBothDesc = make_lut2d(kRowsDesc, kDescX, kGridDesc);
+static_assert(kGridAsc.f(0.5f, 1.5f) == kGridBothDesc.f(0.5f, 1.5f), "2D rows and columns reversed");
+
+static_assert(kSocLut.axis2.x[0] == -25.0f && kSocLut.axis2.x[3] == 40.0f, "SOC temperature axis normalised");
+static_assert(kResistance413ALut.axis1.x[0] == 5.0f, "resistance SOC axis normalised");
+static_assert(kChargePeakCurrentLut.axis.x[0] == -40.0f, "current limit temperature axis normalised");
+
+static_assert(kSocLut.axis1.uniform, "kVoltageLevels is a uniform grid");
+static_assert(!kSocLut.axis2.uniform && !kChargePeakCurrentLut.axis.uniform, "irregular axes use bisection");
+
+// Same table with the fast path disabled, for the uniform-grid benchmark.
+template <int R, int C>
+constexpr Lut2D<R, C> without_fast_path(Lut2D<R, C> lut)
+{
+    lut.axis1.uniform = false;
+    lut.axis2.uniform = false;
+    return lut;
+}
+
+constexpr Lut2D<17, 4> kSocLutBisect = without_fast_path(kSocLut);
+
+// int16_t/Q15 variants of every production table.
+constexpr Lut1D<18, int16_t> kChargePeakQ = make_lut1d<int16_t>(kCurrentLimitTemps, kChargeCurrentLimitPeak);
+constexpr Lut1D<18, int16_t> kChargeContQ = make_lut1d<int16_t>(kCurrentLimitTemps, kChargeCurrentLimitContinuous);
+constexpr Lut1D<18, int16_t> kDischargePeakQ = make_lut1d<int16_t>(kCurrentLimitTemps, kDischargeCurrentLimitPeak);
+constexpr Lut1D<18, int16_t> kDischargeContQ =
+    make_lut1d<int16_t>(kCurrentLimitTemps, kDischargeCurrentLimitContinuous);
+constexpr Lut2D<17, 4, int16_t> kSocQ = make_lut2d<int16_t>(kVoltageLevels, kTemperatureLevels, kSocTable);
+constexpr Lut2D<12, 4, int16_t> kR413AQ =
+    make_lut2d<int16_t>(kResistanceSocLevels, kResistanceTemperatureLevels, kResistanceTable413A);
+constexpr Lut2D<12, 4, int16_t> kR294AQ =
+    make_lut2d<int16_t>(kResistanceSocLevels, kResistanceTemperatureLevels, kResistanceTable294A);
+
+static_assert(kSocQ.f(3.35f, 25.0f) == kSocQ.q.offset + kSocQ.q.scale * -32767.0f, "Q15 table evaluates at compile time");
+
+#ifdef LUT_TEST_NON_MONOTONIC
+// Must not compile: the builder rejects non-monotonic axes.
+constexpr float kBadX[3] = {0.0f, 2.0f, 1.0f};
+constexpr Lut1D<3> kBadLut = make_lut1d(kBadX, kBadX);
+#endif
+
+//-----------------------------------------------------------------------------
+// Legacy wrappers (static Map2D/Map3D RAM copy, as before utils/lut.h)
+//-----------------------------------------------------------------------------
+
+struct LegacyMaps
+{
+    Map2D<18, float, float> charge_peak;
+    Map2D<18, float, float> charge_cont;
+    Map2D<18, float, float> discharge_peak;
+    Map2D<18, float, float> discharge_cont;
+    Map3D<17, 4, float, float> soc;
+    Map3D<12, 4, float, float> r413;
+    Map3D<12, 4, float, float> r294;
+
+    LegacyMaps()
+    {
+        charge_peak.setXs(kCurrentLimitTemps);
+        charge_peak.setYs(kChargeCurrentLimitPeak);
+        charge_cont.setXs(kCurrentLimitTemps);
+        charge_cont.setYs(kChargeCurrentLimitContinuous);
+        discharge_peak.setXs(kCurrentLimitTemps);
+        discharge_peak.setYs(kDischargeCurrentLimitPeak);
+        discharge_cont.setXs(kCurrentLimitTemps);
+        discharge_cont.setYs(kDischargeCurrentLimitContinuous);
+        soc.setX1s(kVoltageLevels);
+        soc.setX2s(kTemperatureLevels);
+        soc.setYs(&kSocTable[0][0]);
+        r413.setX1s(kResistanceSocLevels);
+        r413.setX2s(kResistanceTemperatureLevels);
+        r413.setYs(&kResistanceTable413A[0][0]);
+        r294.setX1s(kResistanceSocLevels);
+        r294.setX2s(kResistanceTemperatureLevels);
+        r294.setYs(&kResistanceTable294A[0][0]);
+    }
+};
+
+LegacyMaps legacy;
+
+// Legacy Map2D/Map3D on ascending copies of the tables: what the old code
+// costs when used as intended (for a fair speed comparison).
+template <int N>
+void reversed(const float (&in)[N], float (&out)[N])
+{
+    for (int i = 0; i < N; ++i)
+    {
+        out[i] = in[N - 1 - i];
+    }
+}
+
+struct LegacyAscendingMaps
+{
+    Map2D<18, float, float> charge_cont;
+    Map3D<17, 4, float, float> soc;
+    Map3D<12, 4, float, float> r413;
+
+    LegacyAscendingMaps()
+    {
+        float temps[18];
+        float ys[18];
+        reversed(kCurrentLimitTemps, temps);
+        reversed(kChargeCurrentLimitContinuous, ys);
+        charge_cont.setXs(temps);
+        charge_cont.setYs(ys);
+
+        float soc_t[4];
+        float soc_y[17][4];
+        reversed(kTemperatureLevels, soc_t);
+        for (int i = 0; i < 17; ++i)
+        {
+            reversed(kSocTable[i], soc_y[i]);
+        }
+        soc.setX1s(kVoltageLevels);
+        soc.setX2s(soc_t);
+        soc.setYs(&soc_y[0][0]);
+
+        float r_soc[12];
+        float r_y[12][4];
+        reversed(kResistanceSocLevels, r_soc);
+        for (int i = 0; i < 12; ++i)
+        {
+            for (int j = 0; j < 4; ++j)
+            {
+                r_y[i][j] = kResistanceTable413A[11 - i][j];
+            }
+        }
+        r413.setX1s(r_soc);
+        r413.setX2s(kResistanceTemperatureLevels);
+        r413.setYs(&r_y[0][0]);
+    }
+};
+
+LegacyAscendingMaps legacy_asc;
+
+//-----------------------------------------------------------------------------
+// Benchmark helper
+//-----------------------------------------------------------------------------
+
+volatile float sink;
+
+// Pack layout used by the batch tests (settings.h: 8 modules x 12 cells).
+constexpr int MODULES = 8;
+constexpr int CELLS_PER_MOD = 12;
+constexpr int CELLS = MODULES * CELLS_PER_MOD;
+
+struct BenchResult
+{
+    double ns;
+    double ticks;
+};
+
+template <typename Fn>
+BenchResult bench(const std::vector<float> &a, const std::vector<float> &b, Fn fn)
+{
+    const int reps = 50;
+    const auto t0 = std::chrono::steady_clock::now();
+#ifdef LUT_BENCH_HAVE_TSC
+    const unsigned long long c0 = __rdtsc();
+#endif
+    float acc = 0.0f;
+    for (int r = 0; r < reps; ++r)
+    {
+        for (size_t k = 0; k < a.size(); ++k)
+        {
+            acc += fn(a[k], b[k]);
+        }
+    }
+#ifdef LUT_BENCH_HAVE_TSC
+    const unsigned long long c1 = __rdtsc();
+#endif
+    const auto t1 = std::chrono::steady_clock::now();
+    sink = acc;
+
+    const double n = static_cast<double>(reps) * a.size();
+    BenchResult res{};
+    res.ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / n;
+#ifdef LUT_BENCH_HAVE_TSC
+    res.ticks = static_cast<double>(c1 - c0) / n;
+#endif
+    return res;
+}
+
+void print_bench(const char *name, BenchResult legacy_res, BenchResult new_res)
+{
+    std::printf("  %-28s legacy %6.2f ns (%6.1f tsc)   constexpr %6.2f ns (%6.1f tsc)   x%.2f\n",
+                name, legacy_res.ns, legacy_res.ticks, new_res.ns, new_res.ticks,
+                legacy_res.ns / new_res.ns);
+}
+
+//-----------------------------------------------------------------------------
+// Sections
+//-----------------------------------------------------------------------------
+
+void report_memory()
+{
+    const size_t legacy_ram = 4 * sizeof(Map2D<18, float, float>) +
+                              sizeof(Map3D<17, 4, float, float>) +
+                              2 * sizeof(Map3D<12, 4, float, float>) +
+                              7 * sizeof(bool);
+    const size_t flash = sizeof(kChargePeakCurrentLut) + sizeof(kChargeContinuousCurrentLut) +
+                         sizeof(kDischargePeakCurrentLut) + sizeof(kDischargeContinuousCurrentLut) +
+                         sizeof(kSocLut) + sizeof(kResistance413ALut) + sizeof(kResistance294ALut);
+
+    std::printf("Memory:\n");
+    std::printf("  legacy RAM copies + init flags: %zu bytes (host layout)\n", legacy_ram);
+    std::printf("  constexpr tables: 0 bytes RAM, %zu bytes flash (incl. reciprocals)\n", flash);
+    std::printf("  inverse OCV table: %zu bytes flash\n", sizeof(kOcvLut));
+}
+
+void check_accuracy()
+{
+    double err_limits = 0.0;
+    double err_soc = 0.0;
+    double err_r = 0.0;
+
+    for (float t = -50.0f; t <= 70.0f; t += 0.25f)
+    {
+        err_limits = std::fmax(err_limits, std::fabs(chargePeakCurrentLimit(t) -
+                                                     ref_1d(kCurrentLimitTemps, kChargeCurrentLimitPeak, t)));
+        err_limits = std::fmax(err_limits, std::fabs(chargeContinuousCurrentLimit(t) -
+                                                     ref_1d(kCurrentLimitTemps, kChargeCurrentLimitContinuous, t)));
+        err_limits = std::fmax(err_limits, std::fabs(dischargePeakCurrentLimit(t) -
+                                                     ref_1d(kCurrentLimitTemps, kDischargeCurrentLimitPeak, t)));
+        err_limits = std::fmax(err_limits, std::fabs(dischargeContinuousCurrentLimit(t) -
+                                                     ref_1d(kCurrentLimitTemps, kDischargeCurrentLimitContinuous, t)));
+
+        for (float v = 3.30f; v <= 4.20f; v += 0.0025f)
+        {
+            err_soc = std::fmax(err_soc, std::fabs(socFromOcvTemp(t, v) -
+                                                   ref_2d(kVoltageLevels, kTemperatureLevels, kSocTable, v, t)));
+        }
+        for (float s = 0.0f; s <= 105.0f; s += 0.5f)
+        {
+            err_r = std::fmax(err_r, std::fabs(resistanceFromSocTemp(t, s, 0) -
+                                               ref_2d(kResistanceSocLevels, kResistanceTemperatureLevels,
+                                                      kResistanceTable413A, s, t)));
+            err_r = std::fmax(err_r, std::fabs(resistanceFromSocTemp(t, s, 1) -
+                                               ref_2d(kResistanceSocLevels, kResistanceTemperatureLevels,
+                                                      kResistanceTable294A, s, t)));
+        }
+    }
+
+    std::printf("Accuracy vs reference (max abs error):\n");
+    std::printf("  current limits: %.2e A\n", err_limits);
+    std::printf("  SOC(OCV,T):     %.2e %%\n", err_soc);
+    std::printf("  R(SOC,T):       %.2e mOhm\n", err_r);
+    check(err_limits < 1e-3, "current limit lookups");
+    check(err_soc < 1e-3, "SOC lookup");
+    check(err_r < 1e-4, "resistance lookups");
+
+    // The legacy Map2D/Map3D required ascending axes; show what the
+    // descending tables returned before.
+    std::printf("  legacy deviation: charge peak @-20C %.1f A (ref %.1f), SOC @3.70V/25C %.2f %% (ref %.2f)\n",
+                legacy.charge_peak.f(-20.0f), ref_1d(kCurrentLimitTemps, kChargeCurrentLimitPeak, -20.0),
+                legacy.soc.f(3.70f, 25.0f), ref_2d(kVoltageLevels, kTemperatureLevels, kSocTable, 3.70, 25.0));
+}
+
+void bench_lookups()
+{
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> temp(-30.0f, 50.0f);
+    std::uniform_real_distribution<float> volt(3.35f, 4.15f);
+    std::uniform_real_distribution<float> soc(5.0f, 100.0f);
+
+    const size_t n = 4096;
+    std::vector<float> t(n), v(n), s(n);
+    for (size_t k = 0; k < n; ++k)
+    {
+        t[k] = temp(rng);
+        v[k] = volt(rng);
+        s[k] = soc(rng);
+    }
+
+    std::printf("Per-lookup time (legacy = Map2D/Map3D on ascending copies):\n");
+    print_bench("current limit (1D, 18)",
+                bench(t, t, [](float a, float) { return legacy_asc.charge_cont.f(a); }),
+                bench(t, t, [](float a, float) { return chargeContinuousCurrentLimit(a); }));
+    print_bench("SOC(OCV,T) (2D, 17x4)",
+                bench(v, t, [](float a, float b) { return legacy_asc.soc.f(a, b); }),
+                bench(v, t, [](float a, float b) { return socFromOcvTemp(b, a); }));
+    print_bench("R413A(SOC,T) (2D, 12x4)",
+                bench(s, t, [](float a, float b) { return legacy_asc.r413.f(a, b); }),
+                bench(s, t, [](float a, float b) { return resistanceFromSocTemp413A(b, a); }));
+}
+template <int N>
+int uniform_axes(const LutAxis<N> &a)
+{
+    return a.uniform ? 1 : 0;
+}
+
+void check_fast_path()
+{
+    // The uniform fast path and the slice API must return exactly what the
+    // plain bisection path returns.
+    bool same = true;
+    for (float t = -40.0f; t <= 60.0f; t += 0.5f)
+    {
+        const SocOcvSlice slice = socOcvSliceAtTemp(t);
+        const ResistanceSocSlice r_slice = resistanceSliceAtTemp(t, 1);
+        for (float v = 3.30f; v <= 4.20f; v += 0.0005f)
+        {
+            const float a = kSocLut.f(v, t);
+            same = same && (a == kSocLutBisect.f(v, t)) && (a == slice.f(v));
+        }
+        for (float soc = 0.0f; soc <= 105.0f; soc += 0.25f)
+        {
+            same = same && (r_slice.f(soc) == resistanceFromSocTemp294A(t, soc));
+        }
+    }
+    check(same, "uniform fast path / slices identical to bisection");
+}
+
+void bench_fast_path()
+{
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> temp(-30.0f, 50.0f);
+    std::uniform_real_distribution<float> volt(3.35f, 4.15f);
+    std::uniform_real_distribution<float> soc(5.0f, 100.0f);
+
+    const size_t n = 4096;
+    std::vector<float> t(n), v(n), s(n);
+    for (size_t k = 0; k < n; ++k)
+    {
+        t[k] = temp(rng);
+        v[k] = volt(rng);
+        s[k] = soc(rng);
+    }
+
+    std::printf("Axis fast path (uniform axes per table):\n");
+    std::printf("  current limits 1D: %d/1, SOC 2D: %d/2, R413A/R294A 2D: %d/2\n",
+                uniform_axes(kChargePeakCurrentLut.axis),
+                uniform_axes(kSocLut.axis1) + uniform_axes(kSocLut.axis2),
+                uniform_axes(kResistance413ALut.axis1) + uniform_axes(kResistance413ALut.axis2));
+
+    std::printf("Per-table lookup time (bisection only vs. current):\n");
+    const BenchResult soc_bisect = bench(v, t, [](float a, float b) { return kSocLutBisect.f(a, b); });
+    const BenchResult soc_fast = bench(v, t, [](float a, float b) { return kSocLut.f(a, b); });
+    std::printf("  %-28s bisection %6.2f ns   fast path %6.2f ns   x%.2f\n",
+                "SOC(OCV,T)", soc_bisect.ns, soc_fast.ns, soc_bisect.ns / soc_fast.ns);
+    const char *names_1d[4] = {"charge peak limit", "charge cont limit", "discharge peak limit", "discharge cont limit"};
+    const BenchResult r1d[4] = {
+        bench(t, t, [](float a, float) { return chargePeakCurrentLimit(a); }),
+        bench(t, t, [](float a, float) { return chargeContinuousCurrentLimit(a); }),
+        bench(t, t, [](float a, float) { return dischargePeakCurrentLimit(a); }),
+        bench(t, t, [](float a, float) { return dischargeContinuousCurrentLimit(a); })};
+    for (int k = 0; k < 4; ++k)
+    {
+        std::printf("  %-28s bisection %6.2f ns   (irregular axis)\n", names_1d[k], r1d[k].ns);
+    }
+    std::printf("  %-28s bisection %6.2f ns   (irregular axes)\n", "R413A(SOC,T)",
+                bench(s, t, [](float a, float b) { return resistanceFromSocTemp413A(b, a); }).ns);
+    std::printf("  %-28s bisection %6.2f ns   (irregular axes)\n", "R294A(SOC,T)",
+                bench(s, t, [](float a, float b) { return resistanceFromSocTemp294A(b, a); }).ns);
+
+    // Multi-call patterns: two voltages per temperature (CoulombCounting
+    // v_min/v_max) and 96 cells per temperature.
+    std::printf("Shared-temperature patterns (per SOC value):\n");
+    for (int group : {2, 96})
+    {
+        const int reps = 200;
+        float acc = 0.0f;
+        const auto t0 = std::chrono::steady_clock::now();
+        for (int r = 0; r < reps; ++r)
+        {
+            for (size_t k = 0; k + group <= n; k += group)
+            {
+                for (int c = 0; c < group; ++c)
+                {
+                    acc += socFromOcvTemp(t[k], v[k + c]);
+                }
+            }
+        }
+        const auto t1 = std::chrono::steady_clock::now();
+        for (int r = 0; r < reps; ++r)
+        {
+            for (size_t k = 0; k + group <= n; k += group)
+            {
+                const SocOcvSlice slice = socOcvSliceAtTemp(t[k]);
+                for (int c = 0; c < group; ++c)
+                {
+                    acc += slice.f(v[k + c]);
+                }
+            }
+        }
+        const auto t2 = std::chrono::steady_clock::now();
+        sink = acc;
+
+        const double calls = static_cast<double>(reps) * (n / group) * group;
+        const double scalar_ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / calls;
+        const double slice_ns = std::chrono::duration<double, std::nano>(t2 - t1).count() / calls;
+        std::printf("  %2d voltages/temperature: scalar %6.2f ns   slice %6.2f ns   x%.2f\n",
+                    group, scalar_ns, slice_ns, scalar_ns / slice_ns);
+    }
+}
+void check_batch()
+{
+    // Voltages/SOCs across and beyond the table range plus NaN, module
+    // temperatures across and beyond both temperature axes.
+    const int n = CELLS;
+    float v[n], s[n], t_mod[MODULES], out[n];
+    for (int k = 0; k < n; ++k)
+    {
+        v[k] = 3.2f + 1.1f * static_cast<float>(k) / (n - 1);
+        s[k] = -5.0f + 115.0f * static_cast<float>(k) / (n - 1);
+    }
+    v[5] = NAN;
+    for (int m = 0; m < MODULES; ++m)
+    {
+        t_mod[m] = -45.0f + 14.0f * static_cast<float>(m);
+    }
+
+    bool same = true;
+    for (int m = 0; m < MODULES; ++m)
+    {
+        socFromOcvTempBatch(t_mod[m], v, out, n);
+        for (int k = 0; k < n; ++k)
+        {
+            same = same && (out[k] == socFromOcvTemp(t_mod[m], v[k]));
+        }
+        for (int c = 0; c < 2; ++c)
+        {
+            resistanceFromSocTempBatch(t_mod[m], s, out, n, c);
+            for (int k = 0; k < n; ++k)
+            {
+                same = same && (out[k] == resistanceFromSocTemp(t_mod[m], s[k], c));
+            }
+        }
+    }
+
+    socFromOcvTempBatch(t_mod, CELLS_PER_MOD, v, out, n);
+    for (int k = 0; k < n; ++k)
+    {
+        same = same && (out[k] == socFromOcvTemp(t_mod[k / CELLS_PER_MOD], v[k]));
+    }
+    resistanceFromSocTempBatch(t_mod, CELLS_PER_MOD, s, out, n, 1);
+    for (int k = 0; k < n; ++k)
+    {
+        same = same && (out[k] == resistanceFromSocTemp294A(t_mod[k / CELLS_PER_MOD], s[k]));
+    }
+    check(same, "batch lookups identical to scalar lookups");
+}
+
+void bench_batch()
+{
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> temp(-20.0f, 45.0f);
+    std::uniform_real_distribution<float> volt(3.35f, 4.15f);
+    std::uniform_real_distribution<float> soc(5.0f, 100.0f);
+
+    const int packs = 64;
+    std::vector<float> v(packs * CELLS), s(packs * CELLS), t(packs * MODULES), out(CELLS);
+    for (float &x : v)
+    {
+        x = volt(rng);
+    }
+    for (float &x : s)
+    {
+        x = soc(rng);
+    }
+    for (float &x : t)
+    {
+        x = temp(rng);
+    }
+
+    // Time one full-pack evaluation (96 cells, 8 module temperatures) with
+    // scalar calls and with one batch call.
+    auto run = [&](auto fn) {
+        const int reps = 500;
+        float acc = 0.0f;
+        const auto t0 = std::chrono::steady_clock::now();
+        for (int r = 0; r < reps; ++r)
+        {
+            for (int p = 0; p < packs; ++p)
+            {
+                fn(&t[p * MODULES], &v[p * CELLS], &s[p * CELLS], out.data());
+                acc += out[r % CELLS];
+            }
+        }
+        const auto t1 = std::chrono::steady_clock::now();
+        sink = acc;
+        return std::chrono::duration<double, std::micro>(t1 - t0).count() / (reps * packs);
+    };
+
+    std::printf("Pack of %d cells, %d module temperatures (us per pack):\n", CELLS, MODULES);
+    const double soc_scalar = run([](const float *tm, const float *vc, const float *, float *o) {
+        for (int k = 0; k < CELLS; ++k)
+        {
+            o[k] = socFromOcvTemp(tm[k / CELLS_PER_MOD], vc[k]);
+        }
+    });
+    const double soc_batch = run([](const float *tm, const float *vc, const float *, float *o) {
+        socFromOcvTempBatch(tm, CELLS_PER_MOD, vc, o, CELLS);
+    });
+    std::printf("  SOC(OCV,T) %d scalar calls %6.3f us   batch %6.3f us   x%.2f\n",
+                CELLS, soc_scalar, soc_batch, soc_scalar / soc_batch);
+
+    const double r_scalar = run([](const float *tm, const float *, const float *sc, float *o) {
+        for (int k = 0; k < CELLS; ++k)
+        {
+            o[k] = resistanceFromSocTemp(tm[k / CELLS_PER_MOD], sc[k], 0);
+        }
+    });
+    const double r_batch = run([](const float *tm, const float *, const float *sc, float *o) {
+        resistanceFromSocTempBatch(tm, CELLS_PER_MOD, sc, o, CELLS, 0);
+    });
+    std::printf("  R(SOC,T)   %d scalar calls %6.3f us   batch %6.3f us   x%.2f\n",
+                CELLS, r_scalar, r_batch, r_scalar / r_batch);
+}
+// What test/cc used to do: scan OCV in 2 mV steps for the closest SOC.
+float ocv_brute_force(float temp_c, float soc)
+{
+    float best_v = 3.2f;
+    float best_err = 1.0e9f;
+    for (float v = 3.2f; v <= 4.2f; v += 0.002f)
+    {
+        const float err = std::fabs(socFromOcvTemp(temp_c, v) - soc);
+        if (err < best_err)
+        {
+            best_err = err;
+            best_v = v;
+        }
+    }
+    return best_v;
+}
+
+void check_inverse_ocv()
+{
+    static_assert(kOcvLut.axis1.uniform, "1 % SOC grid uses the fast path");
+
+    // At the measured temperatures the inverse is exact on the grid points and
+    // only the grid resolution limits the round trip in between.
+    double err_grid = 0.0;
+    double err_column = 0.0;
+    double err_between = 0.0;
+    bool monotonic = true;
+    for (float t = -40.0f; t <= 60.0f; t += 0.25f)
+    {
+        const bool column = (t == 40.0f || t == 25.0f || t == -10.0f || t == -25.0f);
+        float prev = 0.0f;
+        for (int k = 0; k <= 10000; ++k)
+        {
+            const float soc = 0.01f * static_cast<float>(k);
+            const float ocv = ocvFromSocTemp(t, soc);
+            const double err = std::fabs(socFromOcvTemp(t, ocv) - soc);
+            if (column)
+            {
+                err_column = std::fmax(err_column, err);
+                if (k % 100 == 0)
+                {
+                    err_grid = std::fmax(err_grid, err);
+                }
+            }
+            else
+            {
+                err_between = std::fmax(err_between, err);
+            }
+            monotonic = monotonic && (k == 0 || ocv >= prev);
+            prev = ocv;
+        }
+    }
+
+    std::printf("Inverse OCV(SOC,T) round trip SOC->OCV->SOC (max abs error):\n");
+    std::printf("  grid points at table temperatures: %.2e %%\n", err_grid);
+    std::printf("  table temperatures:                %.3f %%\n", err_column);
+    std::printf("  between table temperatures:        %.3f %%\n", err_between);
+    check(err_grid < 1.0e-3, "inverse OCV exact on grid points");
+    check(err_column < 0.2, "inverse OCV round trip at table temperatures");
+    check(err_between < 0.5, "inverse OCV round trip between table temperatures");
+    check(monotonic, "inverse OCV monotonic in SOC");
+    check(ocvFromSocTemp(25.0f, -10.0f) == ocvFromSocTemp(25.0f, 0.0f) &&
+              ocvFromSocTemp(25.0f, 120.0f) == kVoltageLevels[16],
+          "inverse OCV clamps");
+
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> temp(-30.0f, 50.0f);
+    std::uniform_real_distribution<float> soc(0.0f, 100.0f);
+    std::uniform_real_distribution<float> volt(3.35f, 4.15f);
+    const size_t n = 4096;
+    std::vector<float> t(n), s(n), v(n);
+    for (size_t k = 0; k < n; ++k)
+    {
+        t[k] = temp(rng);
+        s[k] = soc(rng);
+        v[k] = volt(rng);
+    }
+    const BenchResult fwd = bench(v, t, [](float a, float b) { return socFromOcvTemp(b, a); });
+    const BenchResult inv = bench(s, t, [](float a, float b) { return ocvFromSocTemp(b, a); });
+    std::vector<float> s_small(s.begin(), s.begin() + 64), t_small(t.begin(), t.begin() + 64);
+    const BenchResult brute = bench(s_small, t_small, [](float a, float b) { return ocv_brute_force(b, a); });
+    std::printf("  SOC(OCV,T) %.2f ns   OCV(SOC,T) %.2f ns   brute-force inversion %.0f ns\n",
+                fwd.ns, inv.ns, brute.ns);
+}
+struct FixedReport
+{
+    const char *name;
+    const char *unit;
+    double max_err;
+    double step;
+    size_t bytes_float;
+    size_t bytes_q15;
+    BenchResult t_float;
+    BenchResult t_q15;
+};
+
+template <int N>
+FixedReport fixed_report_1d(const char *name, const Lut1D<N> &lf, const Lut1D<N, int16_t> &lq,
+                            const float (&xs)[N], const float (&ys)[N], const std::vector<float> &t)
+{
+    FixedReport r{name, "A", 0.0, lq.q.scale, sizeof(lf), sizeof(lq), {}, {}};
+    for (float x = -50.0f; x <= 70.0f; x += 0.01f)
+    {
+        r.max_err = std::fmax(r.max_err, std::fabs(lq.f(x) - ref_1d(xs, ys, x)));
+    }
+    r.t_float = bench(t, t, [&](float a, float) { return lf.f(a); });
+    r.t_q15 = bench(t, t, [&](float a, float) { return lq.f(a); });
+    return r;
+}
+
+template <int R, int C>
+FixedReport fixed_report_2d(const char *name, const char *unit, const Lut2D<R, C> &lf,
+                            const Lut2D<R, C, int16_t> &lq, const float (&x1s)[R], const float (&x2s)[C],
+                            const float (&ys)[R][C], float lo, float hi, const std::vector<float> &x1,
+                            const std::vector<float> &t)
+{
+    FixedReport r{name, unit, 0.0, lq.q.scale, sizeof(lf), sizeof(lq), {}, {}};
+    for (float x2 = -50.0f; x2 <= 70.0f; x2 += 0.25f)
+    {
+        for (float u = lo; u <= hi; u += (hi - lo) / 2000.0f)
+        {
+            r.max_err = std::fmax(r.max_err, std::fabs(lq.f(u, x2) - ref_2d(x1s, x2s, ys, u, x2)));
+        }
+    }
+    r.t_float = bench(x1, t, [&](float a, float b) { return lf.f(a, b); });
+    r.t_q15 = bench(x1, t, [&](float a, float b) { return lq.f(a, b); });
+    return r;
+}
+
+void check_fixed_point()
+{
+    std::mt19937 rng(17);
+    std::uniform_real_distribution<float> temp(-30.0f, 50.0f);
+    std::uniform_real_distribution<float> volt(3.35f, 4.15f);
+    std::uniform_real_distribution<float> soc(5.0f, 100.0f);
+    const size_t n = 4096;
+    std::vector<float> t(n), v(n), s(n);
+    for (size_t k = 0; k < n; ++k)
+    {
+        t[k] = temp(rng);
+        v[k] = volt(rng);
+        s[k] = soc(rng);
+    }
+
+    const FixedReport reports[] = {
+        fixed_report_1d("charge peak limit", kChargePeakCurrentLut, kChargePeakQ, kCurrentLimitTemps,
+                        kChargeCurrentLimitPeak, t),
+        fixed_report_1d("charge cont limit", kChargeContinuousCurrentLut, kChargeContQ, kCurrentLimitTemps,
+                        kChargeCurrentLimitContinuous, t),
+        fixed_report_1d("discharge peak limit", kDischargePeakCurrentLut, kDischargePeakQ, kCurrentLimitTemps,
+                        kDischargeCurrentLimitPeak, t),
+        fixed_report_1d("discharge cont limit", kDischargeContinuousCurrentLut, kDischargeContQ,
+                        kCurrentLimitTemps, kDischargeCurrentLimitContinuous, t),
+        fixed_report_2d("SOC(OCV,T)", "%", kSocLut, kSocQ, kVoltageLevels, kTemperatureLevels, kSocTable,
+                        3.30f, 4.20f, v, t),
+        fixed_report_2d("R413A(SOC,T)", "mOhm", kResistance413ALut, kR413AQ, kResistanceSocLevels,
+                        kResistanceTemperatureLevels, kResistanceTable413A, 0.0f, 105.0f, s, t),
+        fixed_report_2d("R294A(SOC,T)", "mOhm", kResistance294ALut, kR294AQ, kResistanceSocLevels,
+                        kResistanceTemperatureLevels, kResistanceTable294A, 0.0f, 105.0f, s, t),
+    };
+
+    std::printf("int16_t/Q15 tables (max abs error vs reference, flash, time per lookup):\n");
+    for (const FixedReport &r : reports)
+    {
+        std::printf("  %-22s err %.2e %-4s (step %.1e)   %4zu -> %4zu B   float %5.2f ns (%5.1f tsc)   "
+                    "Q15 %5.2f ns (%5.1f tsc)\n",
+                    r.name, r.max_err, r.unit, r.step, r.bytes_float, r.bytes_q15, r.t_float.ns,
+                    r.t_float.ticks, r.t_q15.ns, r.t_q15.ticks);
+        // Quantisation (step / 2) plus rounding of the two Q15 lerps.
+        check(r.max_err <= 2.0 * r.step, r.name);
+    }
+}
+} // namespace
+
+int main()
+{
+    report_memory();
+    check_accuracy();
+    bench_lookups();
+    check_fast_path();
+    bench_fast_path();
+    check_batch();
+    bench_batch();
+    check_inverse_ocv();
+    check_fixed_point();
+
+    std::printf("%s\n", failures == 0 ? "LUT test PASSED" : "LUT test FAILED");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,126 @@
+// Host harness for OcvRelaxationFitter.
+//
+// Feeds synthetic relaxation traces (single and double exponential, with CMU
+// noise and 1 mV quantisation) sampled at the 100 ms BMS task rate and reports
+// time-to-anchor and the resulting SOC error against the true OCV. The legacy
+// rule (raw voltage after CC_REST_TIME_MIN_S of rest) is reported alongside.
+//
+// Build: pio run -e native_ocv_relaxation_test && .pio/build/native_ocv_relaxation_test/program
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+#include "bms/ocv_relaxation.h"
+#include "utils/soc_lookup.h"
+
+// Mirrors bms/coulomb_counting.h (not host-includable because of Arduino deps).
+#define CC_REST_TIME_MIN_S 15.0f
+
+struct Trace
+{
+    const char *name;
+    float v_inf;
+    float a1;
+    float tau1_s;
+    float a2;
+    float tau2_s;
+};
+
+static const Trace kTraces[] = {
+    {"discharge tau=3s", 3.650f, -0.030f, 3.0f, 0.0f, 1.0f},
+    {"discharge tau=8s", 3.650f, -0.040f, 8.0f, 0.0f, 1.0f},
+    {"discharge tau=20s", 3.700f, -0.040f, 20.0f, 0.0f, 1.0f},
+    {"charge tau=8s", 3.950f, 0.035f, 8.0f, 0.0f, 1.0f},
+    {"low SOC tau=10s", 3.480f, -0.060f, 10.0f, 0.0f, 1.0f},
+    {"high SOC tau=10s", 4.020f, 0.050f, 10.0f, 0.0f, 1.0f},
+    {"2RC 4s/40s", 3.600f, -0.030f, 4.0f, -0.010f, 40.0f},
+    {"2RC 5s/300s", 3.600f, -0.030f, 5.0f, -0.006f, 300.0f},
+    {"2RC charge 4s/40s", 3.900f, 0.030f, 4.0f, 0.010f, 40.0f},
+};
+
+static float quantise_mv(float v)
+{
+    return std::round(v * 1000.0f) / 1000.0f;
+}
+
+static float soc_pct(float v)
+{
+    return socFromOcvTemp(25.0f, v);
+}
+
+int main()
+{
+    std::mt19937 rng(12345);
+    std::normal_distribution<float> noise(0.0f, 0.0005f);
+
+    const float dt_s = 0.1f;
+    const float horizon_s = 60.0f;
+    int failures = 0;
+
+    std::printf("%-20s %9s %9s %9s %9s %9s %10s %10s\n",
+                "trace", "t_anchor", "tau_fit", "V_err_mV", "SOC_err%", "stderr_mV",
+                "legacy_t", "legacySOC%");
+
+    for (const Trace &tr : kTraces)
+    {
+        OcvRelaxationFitter fitter;
+        float t_anchor = -1.0f;
+        float v_anchor = 0.0f;
+        float tau_anchor = 0.0f;
+        float se_anchor = 0.0f;
+        float v_legacy = 0.0f;
+
+        for (float t = dt_s; t <= horizon_s; t += dt_s)
+        {
+            const float v_true = tr.v_inf + tr.a1 * std::exp(-t / tr.tau1_s) +
+                                 tr.a2 * std::exp(-t / tr.tau2_s);
+            const float v_meas = quantise_mv(v_true + noise(rng));
+            fitter.add_sample(t, v_meas);
+
+            if (t_anchor < 0.0f && fitter.converged())
+            {
+                t_anchor = t;
+                v_anchor = fitter.v_inf();
+                tau_anchor = fitter.tau_s();
+                se_anchor = fitter.std_err_v();
+            }
+            if (v_legacy == 0.0f && t > CC_REST_TIME_MIN_S)
+            {
+                v_legacy = v_meas;
+            }
+        }
+
+        const float soc_true = soc_pct(tr.v_inf);
+        const float v_err_mv = (t_anchor < 0.0f) ? NAN : (v_anchor - tr.v_inf) * 1000.0f;
+        const float soc_err = (t_anchor < 0.0f) ? NAN : soc_pct(v_anchor) - soc_true;
+        const float legacy_err = soc_pct(v_legacy) - soc_true;
+
+        std::printf("%-20s %8.1fs %8.0fs %9.2f %9.2f %9.2f %9.1fs %10.2f\n",
+                    tr.name, t_anchor, tau_anchor, v_err_mv, soc_err, se_anchor * 1000.0f,
+                    CC_REST_TIME_MIN_S, legacy_err);
+
+        // Single-exponential traces up to tau = 10 s must anchor within 1 % SOC.
+        if (tr.a2 == 0.0f && tr.tau1_s <= 10.0f)
+        {
+            if (t_anchor < 0.0f || std::fabs(soc_err) > 1.0f)
+            {
+                std::printf("  FAIL: %s\n", tr.name);
+                ++failures;
+            }
+        }
+
+        // A two time constant trace fits one exponential with a small standard
+        // error long before V_inf is right. Whenever the fit declares
+        // convergence, its anchor must be no worse than the legacy one.
+        if (tr.a2 != 0.0f && t_anchor >= 0.0f && std::fabs(soc_err) > std::fabs(legacy_err))
+        {
+            std::printf("  FAIL: %s anchors %.2f %% SOC off at %.1f s (legacy %.2f %%)\n",
+                        tr.name, soc_err, t_anchor, legacy_err);
+            ++failures;
+        }
+    }
+
+    std::printf("%s\n", failures == 0 ? "OCV relaxation test PASSED" : "OCV relaxation test FAILED");
+    return failures == 0 ? 0 : 1;
+}
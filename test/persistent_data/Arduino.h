@@ -0,0 +1,17 @@
+#pragma once
+
+// Host stand-in for the parts of the Arduino core that
+// persistent_data_storage.h uses. micros() is a simulated clock that the
+// emulated EEPROM (EEPROM.h next to this file) advances on every write.
+
+#include <stdint.h>
+#include <string.h>
+
+#define E2END 0x10BB // Teensy 4.1 EEPROM emulation: 4284 bytes
+
+inline uint32_t sim_micros = 0U;
+
+inline uint32_t micros()
+{
+    return sim_micros;
+}
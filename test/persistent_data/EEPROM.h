@@ -0,0 +1,78 @@
+#pragma once
+
+// Emulated EEPROM with injected write latency for test/persistent_data.
+//
+// Every byte that actually changes costs byte_write_us of simulated time and
+// every erase_every programmed bytes one write additionally costs erase_us,
+// mimicking the flash sector erase of the Teensy 4 EEPROM emulation.
+// Unchanged bytes are skipped like eeprom_write_byte() does on target.
+
+#include "Arduino.h"
+
+struct EmulatedEEPROM
+{
+    uint8_t m[E2END + 1];
+    uint32_t byte_write_us = 40U;
+    uint32_t erase_every = 512U;
+    uint32_t erase_us = 8000U;
+    uint32_t programmed = 0U;
+    uint32_t reads = 0U;
+    uint32_t wear[E2END + 1] = {}; // programs per byte
+
+    EmulatedEEPROM()
+    {
+        memset(m, 0xFF, sizeof(m));
+    }
+
+    uint8_t read(int address)
+    {
+        ++reads;
+        return m[address];
+    }
+
+    void update(int address, uint8_t value)
+    {
+        if (m[address] == value)
+        {
+            return;
+        }
+        m[address] = value;
+        ++wear[address];
+        ++programmed;
+        sim_micros += byte_write_us;
+        if (erase_every != 0U && (programmed % erase_every) == 0U)
+        {
+            sim_micros += erase_us;
+        }
+    }
+
+    void write(int address, uint8_t value)
+    {
+        update(address, value);
+    }
+
+    template <typename T>
+    T &get(int address, T &t)
+    {
+        memcpy(&t, m + address, sizeof(T));
+        return t;
+    }
+
+    template <typename T>
+    const T &put(int address, const T &t)
+    {
+        const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&t);
+        for (size_t i = 0; i < sizeof(T); ++i)
+        {
+            update(address + static_cast<int>(i), bytes[i]);
+        }
+        return t;
+    }
+
+    uint16_t length()
+    {
+        return sizeof(m);
+    }
+};
+
+inline EmulatedEEPROM EEPROM;
@@ -0,0 +1,598 @@
+// Host test for the PersistentDataStorage journal and write-behind commit.
+//
+// The EEPROM is emulated with injected per-byte write latency, periodic
+// sector-erase stalls and per-byte wear counters (see EEPROM.h in this
+// directory); micros() is the simulated clock it advances.
+//
+// 1) CRC-32 check value.
+// 2) Stall: a synchronous commit (save + flush) against save() plus one
+//    service() per 10 ms tick. Reports the worst task stall and the number
+//    of ticks a commit takes.
+// 3) Queueing: saves issued while an entry is being written are coalesced
+//    and the last one wins after a reboot.
+// 4) Power cut: the write of a delta and of a checkpoint is interrupted after
+//    every possible byte; a reboot must load the previous or the new record.
+// 5) Soak: thousands of randomised saves with random power cuts and reboots
+//    over many laps of the ring. Every reboot must restore exactly the last
+//    completed save. Reports bytes per save, per-byte wear and the startup
+//    scan cost.
+// 6) Migration: a record of the v13 slot ring loads with the fields it had,
+//    the next save turns it into a current checkpoint, and TLV fields
+//    unknown to this firmware are skipped.
+//
+// Build: pio run -e native_persistent_data_test && .pio/build/native_persistent_data_test/program
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+#include "persistent_data_storage.h"
+
+namespace
+{
+int failures = 0;
+
+void check(bool ok, const char *what)
+{
+    if (!ok)
+    {
+        std::printf("  FAIL: %s\n", what);
+        ++failures;
+    }
+}
+
+PersistentDataStorage::PersistentData make_record(uint32_t k)
+{
+    PersistentDataStorage::PersistentData d;
+    d.b_as = 100.0f + static_cast<float>(k);
+    d.C_as = 300000.0f - static_cast<float>(k);
+    d.soh = 1.0f - 0.001f * static_cast<float>(k);
+    d.have_low_anchor = static_cast<uint8_t>(k & 1U);
+    d.cap_pairs = static_cast<uint16_t>(k);
+    d.usage.charge_mAh = 1000U * k;
+    d.usage.dod_half_cycles[k % USAGE_DOD_BINS] = k;
+    return d;
+}
+
+bool same(const PersistentDataStorage::PersistentData &a, const PersistentDataStorage::PersistentData &b)
+{
+    bool eq = a.energy_initial_Wh == b.energy_initial_Wh && a.measured_capacity_Wh == b.measured_capacity_Wh &&
+              a.b_as == b.b_as && a.C_as == b.C_as && a.soh == b.soh && a.have_low_anchor == b.have_low_anchor &&
+              a.q_low_as == b.q_low_as && a.soc_low_anchor == b.soc_low_anchor &&
+              a.was_above_high_set == b.was_above_high_set &&
+              a.contactor_precharge_strategy == b.contactor_precharge_strategy &&
+              a.contactor_positive_open_current_limit_A == b.contactor_positive_open_current_limit_A &&
+              a.cap_c1 == b.cap_c1 && a.cap_c2 == b.cap_c2 && a.cap_c3 == b.cap_c3 && a.cap_pairs == b.cap_pairs &&
+              a.usage.charge_mAh == b.usage.charge_mAh && a.usage.discharge_mAh == b.usage.discharge_mAh &&
+              a.usage.charge_Wh == b.usage.charge_Wh && a.usage.discharge_Wh == b.usage.discharge_Wh;
+    for (int i = 0; i < USAGE_DOD_BINS; ++i)
+    {
+        eq = eq && a.usage.dod_half_cycles[i] == b.usage.dod_half_cycles[i];
+    }
+    for (int i = 0; i < USAGE_TEMP_BINS; ++i)
+    {
+        eq = eq && a.usage.temp_time_s[i] == b.usage.temp_time_s[i];
+    }
+    for (int i = 0; i < USAGE_CRATE_BINS; ++i)
+    {
+        eq = eq && a.usage.crate_time_s[i] == b.usage.crate_time_s[i];
+    }
+    return eq;
+}
+
+// Fresh instance scanning the current EEPROM contents, i.e. after a reset.
+PersistentDataStorage::PersistentData reboot_and_load()
+{
+    PersistentDataStorage storage;
+    storage.begin();
+    return storage.load();
+}
+
+void test_crc32()
+{
+    check(crc32_ieee("123456789", 9) == 0xCBF43926UL, "CRC-32 check value");
+    check(crc32_ieee("56789", 5, crc32_ieee("1234", 4)) == 0xCBF43926UL, "CRC-32 running update");
+}
+
+void test_stall()
+{
+    EEPROM = EmulatedEEPROM();
+    const int commits = 48; // three laps of the slot ring
+
+    uint32_t sync_worst = 0U;
+    {
+        PersistentDataStorage storage;
+        storage.begin();
+        for (int k = 0; k < commits; ++k)
+        {
+            const uint32_t t0 = micros();
+            storage.save(make_record(static_cast<uint32_t>(k)));
+            storage.flush();
+            const uint32_t stall = micros() - t0;
+            sync_worst = (stall > sync_worst) ? stall : sync_worst;
+        }
+    }
+
+    EEPROM = EmulatedEEPROM();
+    uint32_t save_worst = 0U;
+    uint32_t tick_worst = 0U;
+    uint32_t ticks_worst = 0U;
+    bool reload_ok = true;
+    {
+        PersistentDataStorage storage;
+        storage.begin();
+        for (int k = 0; k < commits; ++k)
+        {
+            const PersistentDataStorage::PersistentData record = make_record(static_cast<uint32_t>(k));
+            uint32_t t0 = micros();
+            storage.save(record);
+            const uint32_t save_stall = micros() - t0;
+            save_worst = (save_stall > save_worst) ? save_stall : save_worst;
+            reload_ok = reload_ok && same(storage.load(), record);
+
+            uint32_t ticks = 0U;
+            while (storage.busy())
+            {
+                t0 = micros();
+                storage.service();
+                const uint32_t stall = micros() - t0;
+                tick_worst = (stall > tick_worst) ? stall : tick_worst;
+                ++ticks;
+                sim_micros += 10000U; // rest of the 10 ms tick
+            }
+            ticks_worst = (ticks > ticks_worst) ? ticks : ticks_worst;
+            reload_ok = reload_ok && same(reboot_and_load(), record);
+        }
+    }
+
+    std::printf("Journal %u bytes, checkpoint %u bytes, latency %u us/byte, %u us erase every %u bytes\n",
+                static_cast<unsigned>(PersistentDataStorage::kJournalBytes),
+                static_cast<unsigned>(PersistentDataStorage::checkpoint_bytes()),
+                static_cast<unsigned>(EEPROM.byte_write_us), static_cast<unsigned>(EEPROM.erase_us),
+                static_cast<unsigned>(EEPROM.erase_every));
+    std::printf("Worst task stall: synchronous commit %u us, save() %u us, service() %u us "
+                "(budget %u us), commit takes <= %u ticks\n",
+                static_cast<unsigned>(sync_worst), static_cast<unsigned>(save_worst),
+                static_cast<unsigned>(tick_worst),
+                static_cast<unsigned>(PersistentDataStorage::kServiceBudgetUs),
+                static_cast<unsigned>(ticks_worst));
+
+    check(save_worst == 0U, "save() does not touch the EEPROM");
+    // One byte may start inside the budget and hit a sector erase.
+    check(tick_worst < PersistentDataStorage::kServiceBudgetUs + EEPROM.byte_write_us + EEPROM.erase_us,
+          "service() stall bounded by budget + one byte write");
+    check(tick_worst < sync_worst, "service() stalls less than a synchronous commit");
+    check(reload_ok, "every committed record reloads after reboot");
+}
+
+void test_queueing()
+{
+    EEPROM = EmulatedEEPROM();
+    PersistentDataStorage storage;
+    storage.begin();
+
+    storage.save(make_record(1U));
+    storage.service();
+    storage.save(make_record(2U));
+    storage.save(make_record(3U)); // replaces 2 in the queue
+    check(same(storage.load(), make_record(3U)), "load() returns the latest save while writing");
+    check(same(reboot_and_load(), PersistentDataStorage::PersistentData{}), "nothing valid before commit");
+
+    int ticks = 0;
+    while (storage.busy() && ticks < 10000)
+    {
+        storage.service();
+        ++ticks;
+    }
+    check(same(reboot_and_load(), make_record(3U)), "last queued save wins after reboot");
+    std::printf("Queued saves: 3 saves -> 2 records written in %d ticks\n", ticks + 1);
+}
+
+// Cut power after every byte of the entry written for `next`, starting
+// from an EEPROM holding `prev` committed on top of `history` saves.
+int power_cut_sweep(int history, const PersistentDataStorage::PersistentData &next, size_t &entry_bytes)
+{
+    EEPROM = EmulatedEEPROM();
+    EEPROM.erase_every = 0U;
+    {
+        PersistentDataStorage storage;
+        storage.begin();
+        for (int k = 0; k <= history; ++k)
+        {
+            storage.save(make_record(static_cast<uint32_t>(k)));
+            storage.flush();
+        }
+    }
+    const PersistentDataStorage::PersistentData prev = make_record(static_cast<uint32_t>(history));
+    const EmulatedEEPROM before = EEPROM;
+
+    int wrong = 0;
+    entry_bytes = 0U;
+    for (size_t cut = 0;; ++cut)
+    {
+        EEPROM = before;
+        PersistentDataStorage storage;
+        storage.begin();
+        storage.save(next);
+        for (size_t k = 0; k < cut; ++k)
+        {
+            storage.service(0U); // exactly one byte
+        }
+
+        const bool complete = !storage.busy();
+        wrong += same(reboot_and_load(), complete ? next : prev) ? 0 : 1;
+        if (complete)
+        {
+            entry_bytes = cut;
+            break;
+        }
+    }
+    return wrong;
+}
+
+void test_power_cut()
+{
+    // Record 1 on top of record 0 is a delta; the save after
+    // kCheckpointInterval deltas is a checkpoint.
+    size_t delta_bytes = 0U;
+    size_t checkpoint_bytes = 0U;
+    const int wrong_delta = power_cut_sweep(0, make_record(100U), delta_bytes);
+    const int wrong_checkpoint =
+        power_cut_sweep(PersistentDataStorage::kCheckpointInterval, make_record(100U), checkpoint_bytes);
+
+    std::printf("Power cut after each byte: delta (%u bytes) %d wrong reloads, checkpoint (%u bytes) %d wrong reloads\n",
+                static_cast<unsigned>(delta_bytes), wrong_delta, static_cast<unsigned>(checkpoint_bytes),
+                wrong_checkpoint);
+    check(wrong_delta == 0 && wrong_checkpoint == 0, "interrupted entry keeps the previous record");
+    check(delta_bytes < checkpoint_bytes && checkpoint_bytes == PersistentDataStorage::checkpoint_bytes(),
+          "delta smaller than checkpoint");
+}
+
+// Typical save: the capacity model moves, usage counters occasionally.
+void mutate(std::mt19937 &rng, PersistentDataStorage::PersistentData &d)
+{
+    std::uniform_real_distribution<float> u01(0.0f, 1.0f);
+    d.b_as += 1.0f + u01(rng);
+    if (u01(rng) < 0.3f)
+    {
+        d.C_as -= u01(rng);
+        d.soh = d.C_as / 300000.0f;
+    }
+    if (u01(rng) < 0.2f)
+    {
+        d.have_low_anchor = static_cast<uint8_t>(!d.have_low_anchor);
+        d.q_low_as = d.b_as;
+        d.soc_low_anchor = u01(rng);
+    }
+    if (u01(rng) < 0.1f)
+    {
+        d.cap_c1 += u01(rng);
+        d.cap_c2 += u01(rng);
+        d.cap_c3 += u01(rng);
+        ++d.cap_pairs;
+    }
+    if (u01(rng) < 0.05f)
+    {
+        d.usage.charge_mAh += 1000U;
+        d.usage.discharge_mAh += 900U;
+        d.usage.charge_Wh += 400U;
+        d.usage.discharge_Wh += 350U;
+        ++d.usage.dod_half_cycles[rng() % USAGE_DOD_BINS];
+        d.usage.temp_time_s[rng() % USAGE_TEMP_BINS] += 900U;
+        d.usage.crate_time_s[rng() % USAGE_CRATE_BINS] += 900U;
+    }
+    if (u01(rng) < 0.01f)
+    {
+        d.contactor_precharge_strategy = static_cast<uint8_t>(rng() % 2U);
+    }
+}
+
+void test_soak()
+{
+    EEPROM = EmulatedEEPROM();
+    EEPROM.erase_every = 0U;
+
+    std::mt19937 rng(36);
+    std::uniform_real_distribution<float> u01(0.0f, 1.0f);
+
+    const int saves = 20000;
+    PersistentDataStorage::PersistentData current{};
+    PersistentDataStorage::PersistentData committed{};
+    PersistentDataStorage *storage = new PersistentDataStorage();
+    storage->begin();
+
+    int cuts = 0;
+    int reboots = 0;
+    int wrong = 0;
+    uint16_t max_replayed = 0U;
+    double max_scan_us = 0.0;
+    uint32_t scan_reads = 0U;
+    uint32_t completed = 0U;
+
+    auto reboot = [&]() {
+        delete storage;
+        const uint32_t reads0 = EEPROM.reads;
+        const auto t0 = std::chrono::steady_clock::now();
+        storage = new PersistentDataStorage();
+        storage->begin();
+        const auto t1 = std::chrono::steady_clock::now();
+        scan_reads = EEPROM.reads - reads0;
+        max_scan_us = std::fmax(max_scan_us, std::chrono::duration<double, std::micro>(t1 - t0).count());
+        max_replayed = (storage->replayed_deltas() > max_replayed) ? storage->replayed_deltas() : max_replayed;
+        ++reboots;
+        current = storage->load();
+        wrong += same(current, committed) ? 0 : 1;
+    };
+
+    for (int k = 0; k < saves; ++k)
+    {
+        mutate(rng, current);
+        storage->save(current);
+
+        if (u01(rng) < 0.05f)
+        {
+            // Power cut somewhere in (or just after) the entry.
+            const int bytes = static_cast<int>(rng() % (PersistentDataStorage::checkpoint_bytes() + 8U));
+            for (int b = 0; b < bytes && storage->busy(); ++b)
+            {
+                storage->service(0U);
+            }
+            if (!storage->busy())
+            {
+                committed = current;
+                ++completed;
+            }
+            ++cuts;
+            reboot();
+            continue;
+        }
+
+        storage->flush();
+        committed = current;
+        ++completed;
+        if (u01(rng) < 0.02f)
+        {
+            reboot();
+        }
+    }
+    reboot();
+    delete storage;
+
+    uint32_t max_wear = 0U;
+    uint64_t total_wear = 0U;
+    for (size_t i = 0; i < PersistentDataStorage::kJournalBytes; ++i)
+    {
+        max_wear = (EEPROM.wear[i] > max_wear) ? EEPROM.wear[i] : max_wear;
+        total_wear += EEPROM.wear[i];
+    }
+    const double mean_wear = static_cast<double>(total_wear) / PersistentDataStorage::kJournalBytes;
+    const double bytes_per_save = static_cast<double>(EEPROM.programmed) / saves;
+
+    std::printf("Soak: %d saves (%u completed), %d power cuts, %d reboots, %d wrong reloads\n", saves,
+                static_cast<unsigned>(completed), cuts, reboots, wrong);
+    std::printf("  programmed %.1f bytes/save (checkpoint %u), wear max %u mean %.1f programs/byte\n",
+                bytes_per_save, static_cast<unsigned>(PersistentDataStorage::checkpoint_bytes()),
+                static_cast<unsigned>(max_wear), mean_wear);
+    std::printf("  startup scan: %u EEPROM reads, worst %.1f us on host, up to %u deltas replayed\n",
+                static_cast<unsigned>(scan_reads), max_scan_us, static_cast<unsigned>(max_replayed));
+
+    check(wrong == 0, "every reboot restores the last completed save");
+    check(scan_reads == PersistentDataStorage::kJournalBytes, "startup scan reads the ring once");
+    check(max_replayed <= PersistentDataStorage::kCheckpointInterval, "replay bounded by checkpoint interval");
+    check(max_wear < 2.0 * mean_wear + 1.0, "wear spread over the ring");
+}
+// Stored layouts of older firmware, mirrored here independently of the
+// migration tables in persistent_data_storage.h.
+struct LegacySlotHeader
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t payload_size;
+    uint32_t sequence;
+    uint32_t crc;
+};
+
+struct JournalHeader
+{
+    uint16_t magic;
+    uint8_t type;
+    uint8_t reserved;
+    uint16_t version;
+    uint16_t length;
+    uint32_t sequence;
+    uint32_t crc;
+};
+
+template <typename T>
+void put_bytes(uint8_t *buf, size_t &pos, T value)
+{
+    memcpy(buf + pos, &value, sizeof(T));
+    pos += sizeof(T);
+}
+
+// Copy the fields of `from` that a v13 record (payload 40) holds into `to`;
+// with `payload` set, serialise them in the v13 struct layout instead.
+void legacy_fields(const PersistentDataStorage::PersistentData &from, PersistentDataStorage::PersistentData &to,
+                   uint8_t *payload = nullptr)
+{
+    auto field = [&](size_t offset, auto &dst, const auto &src) {
+        if (payload != nullptr)
+        {
+            memcpy(payload + offset, &src, sizeof(src));
+        }
+        else
+        {
+            memcpy(&dst, &src, sizeof(src));
+        }
+    };
+    field(0, to.energy_initial_Wh, from.energy_initial_Wh);
+    field(4, to.measured_capacity_Wh, from.measured_capacity_Wh);
+    field(8, to.b_as, from.b_as);
+    field(12, to.C_as, from.C_as);
+    field(16, to.soh, from.soh);
+    field(20, to.have_low_anchor, from.have_low_anchor);
+    field(24, to.q_low_as, from.q_low_as);
+    field(28, to.soc_low_anchor, from.soc_low_anchor);
+    field(32, to.was_above_high_set, from.was_above_high_set);
+    field(33, to.contactor_precharge_strategy, from.contactor_precharge_strategy);
+    field(36, to.contactor_positive_open_current_limit_A, from.contactor_positive_open_current_limit_A);
+}
+
+// Every field set to a value that differs from its default.
+PersistentDataStorage::PersistentData make_full_record(uint32_t k)
+{
+    PersistentDataStorage::PersistentData d = make_record(k);
+    d.energy_initial_Wh = 1234.0f + static_cast<float>(k);
+    d.measured_capacity_Wh = 25000.0f;
+    d.q_low_as = 5000.0f;
+    d.soc_low_anchor = 0.1f;
+    d.was_above_high_set = 1U;
+    d.contactor_precharge_strategy = 2U;
+    d.contactor_positive_open_current_limit_A = 3.5f;
+    d.cap_c1 = 1.5f;
+    d.cap_c2 = 2.5f;
+    d.cap_c3 = 3.5f;
+    d.cap_pairs = 9U;
+    d.usage.temp_time_s[3] = 600U;
+    d.usage.crate_time_s[1] = 700U;
+    d.usage.discharge_mAh = 800U;
+    d.usage.charge_Wh = 900U;
+    d.usage.discharge_Wh = 950U;
+    return d;
+}
+
+// Slot `slot` of a v13 ring holding `data`.
+void write_legacy_slot(size_t slot, uint32_t sequence, const PersistentDataStorage::PersistentData &data)
+{
+    const uint16_t payload_size = 40U;
+    uint8_t payload[payload_size] = {};
+    PersistentDataStorage::PersistentData unused;
+    legacy_fields(data, unused, payload);
+
+    LegacySlotHeader header = {0x54564355UL, 13U, payload_size, sequence, 0U};
+    uint32_t hash = 2166136261UL;
+    const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&header);
+    for (size_t i = 0; i < sizeof(header); ++i)
+    {
+        hash = (hash ^ bytes[i]) * 16777619UL;
+    }
+    for (size_t i = 0; i < payload_size; ++i)
+    {
+        hash = (hash ^ payload[i]) * 16777619UL;
+    }
+    header.crc = hash;
+
+    const size_t base = slot * (sizeof(header) + payload_size);
+    EEPROM.put(static_cast<int>(base), header);
+    for (size_t i = 0; i < payload_size; ++i)
+    {
+        EEPROM.update(static_cast<int>(base + sizeof(header) + i), payload[i]);
+    }
+}
+
+// Journal entry at address; returns its size.
+size_t write_journal_entry(size_t address, uint8_t type, uint16_t version, uint32_t sequence, const uint8_t *payload,
+                           size_t len)
+{
+    JournalHeader header = {0x4A54U, type, 0U, version, static_cast<uint16_t>(len), sequence, 0U};
+    header.crc = crc32_ieee(payload, len, crc32_ieee(&header, sizeof(header)));
+    EEPROM.put(static_cast<int>(address), header);
+    for (size_t i = 0; i < len; ++i)
+    {
+        EEPROM.update(static_cast<int>(address + sizeof(header) + i), payload[i]);
+    }
+    return sizeof(header) + len;
+}
+
+// Load, then check the next save writes a current checkpoint that reloads.
+bool loads_and_upgrades(const PersistentDataStorage::PersistentData &expected, uint16_t expected_version)
+{
+    PersistentDataStorage storage;
+    storage.begin();
+    bool ok = same(storage.load(), expected) && storage.source_version() == expected_version;
+    storage.save(storage.load());
+    storage.flush();
+
+    PersistentDataStorage reloaded;
+    reloaded.begin();
+    return ok && same(reloaded.load(), expected) && reloaded.source_version() == PersistentDataStorage::kVersion;
+}
+
+void test_migration()
+{
+    const PersistentDataStorage::PersistentData older = make_full_record(1U);
+    const PersistentDataStorage::PersistentData newest = make_full_record(2U);
+
+    // Slot ring: the newest slot wins, fields v13 lacked keep defaults.
+    PersistentDataStorage::PersistentData expected;
+    legacy_fields(newest, expected);
+    EEPROM = EmulatedEEPROM();
+    write_legacy_slot(15U, 40U, older);
+    write_legacy_slot(0U, 41U, newest);
+    check(loads_and_upgrades(expected, 13U), "v13 slot record migrated");
+
+    // A power cut during the first checkpoint keeps the imported slot.
+    const EmulatedEEPROM slots = EEPROM;
+    int wrong_cut = 0;
+    for (size_t cut = 0; cut < PersistentDataStorage::checkpoint_bytes(); ++cut)
+    {
+        EEPROM = slots;
+        PersistentDataStorage storage;
+        storage.begin();
+        storage.save(storage.load());
+        for (size_t k = 0; k < cut; ++k)
+        {
+            storage.service(0U);
+        }
+        wrong_cut += same(reboot_and_load(), expected) ? 0 : 1;
+    }
+    check(wrong_cut == 0, "interrupted migration keeps the slot record");
+
+    // Current TLV journal: unknown ids and fields of another size are skipped.
+    PersistentDataStorage::PersistentData current;
+    current.b_as = 55.0f;
+    current.C_as = 270000.0f;
+    uint8_t payload[64];
+    size_t len = 0U;
+    payload[len++] = 3U;
+    payload[len++] = 4U;
+    put_bytes(payload, len, current.b_as);
+    payload[len++] = 200U; // field of a newer firmware
+    payload[len++] = 3U;
+    put_bytes(payload, len, uint16_t{0xBEEF});
+    payload[len++] = 0xAAU;
+    payload[len++] = 5U; // soh, resized by a newer firmware
+    payload[len++] = 2U;
+    put_bytes(payload, len, uint16_t{1});
+    payload[len++] = 4U;
+    payload[len++] = 4U;
+    put_bytes(payload, len, current.C_as);
+
+    EEPROM = EmulatedEEPROM();
+    write_legacy_slot(15U, 1000U, newest); // stale, the journal wins
+    write_journal_entry(0U, 1U, PersistentDataStorage::kVersion, 1U, payload, len);
+    {
+        PersistentDataStorage storage;
+        storage.begin();
+        check(same(storage.load(), current) && storage.source_version() == PersistentDataStorage::kVersion,
+              "TLV record with unknown fields loaded");
+    }
+
+    std::printf("Migration: v13 slots and TLV with unknown fields loaded, "
+                "%d wrong reloads after interrupted migration\n",
+                wrong_cut);
+}
+} // namespace
+
+int main()
+{
+    test_crc32();
+    test_stall();
+    test_queueing();
+    test_power_cut();
+    test_soak();
+    test_migration();
+
+    std::printf("%s\n", failures == 0 ? "Persistent data test PASSED" : "Persistent data test FAILED");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,413 @@
+// Host test for the static rate-group executive.
+//
+// 1) make_rate_table() drops hooks without a function at compile time.
+// 2) Every runnable runs exactly on its slots (tick % period == offset) over
+//    one hyperperiod of the real-time table of comms_bms.cpp.
+// 3) A late execute() runs each runnable with a slot in the gap once and
+//    stays on the grid afterwards.
+// 4) Worst-case tick report for the real-time table with the execution
+//    times of the two-tier model.
+// 5) Scheduler overhead per second: the previous wiring (13 TaskScheduler
+//    tasks in two schedulers, including the separate 2 ms pack and BMS tasks
+//    and two empty ones) against the two rate tables, with the loop polling
+//    every 2 us of simulated time. The TaskScheduler side is a model of its
+//    execute() walk (one time read, enable and interval check per task per
+//    pass), not the library itself. Time inside execute() is measured with
+//    the task profiler in 1 ms blocks; the runnables are empty and their
+//    own profiling is subtracted, so the rest is scheduling overhead.
+// 6) Budgets: a runnable that overruns its budget loses slots until the
+//    excess is repaid, a single stall costs at most kMaxDebtSlots slots, and
+//    the yield hook runs before every budgeted runnable.
+//
+// Build: pio run -e native_rate_schedule_test && .pio/build/native_rate_schedule_test/program
+
+#include <cstdio>
+#include <vector>
+
+#include "utils/rate_schedule.h"
+
+namespace
+{
+int failures = 0;
+
+void check(bool ok, const char *what)
+{
+    if (!ok)
+    {
+        std::printf("  FAIL: %s\n", what);
+        ++failures;
+    }
+}
+
+uint32_t sim_us = 0U;
+uint32_t current_tick = 0U;
+uint32_t runs[16];
+uint32_t off_slot[16];
+uint16_t periods[16];
+uint16_t offsets[16];
+
+template <int I>
+void body()
+{
+    ++runs[I];
+    if (current_tick % periods[I] != offsets[I])
+    {
+        ++off_slot[I];
+    }
+}
+
+TaskProfile profiles[7] = {
+    {"RX tick", 2},
+    {"contactors", 20},
+    {"shunt 10ms", 10},
+    {"battery poll", 13},
+    {"BMS 100ms", 100},
+    {"BMS 1000ms", 1000},
+    {"heartbeat check", 1},
+};
+
+// Real-time table of comms_bms.cpp
+constexpr RateTask realtime_entries[] = {
+    {"RX tick", &body<0>, 2, 0, &profiles[0], 1, 0},
+    {"contactors", &body<1>, 20, 1, &profiles[1], 1, 0},
+    {"shunt 10ms", &body<2>, 10, 3, &profiles[2], 1, 0},
+    {"battery poll", &body<3>, 13, 5, &profiles[3], 10, 0},
+    {"BMS 100ms", &body<4>, 100, 7, &profiles[4], 10, 0},
+    {"BMS 1000ms", &body<5>, 1000, 9, &profiles[5], 1, 0},
+    {"heartbeat check", &body<6>, 1, 0, &profiles[6], 1, 0},
+};
+constexpr auto realtime_table = make_rate_table(realtime_entries);
+
+constexpr RateTask best_effort_entries[] = {
+    {"BMS 10ms", &body<7>, 10, 0, nullptr, 1, 1000},
+    {"monitor 100ms", &body<8>, 100, 2, nullptr, RateTask::kSuspended, 100},
+    {"system load", &body<9>, 100, 4, nullptr, 10, 50},
+    {"led blink", &body<10>, 1000, 6, nullptr, RateTask::kSuspended, 20},
+    {"monitor 1000ms", nullptr, 1000, 8, nullptr, 1, 100},
+    {"print debug", nullptr, 1000, 8, nullptr, 1, 100},
+};
+constexpr auto best_effort_table = make_rate_table(best_effort_entries);
+
+static_assert(realtime_table.count == 7U, "all real-time runnables kept");
+static_assert(best_effort_table.count == 4U, "hooks without work are dropped at compile time");
+
+template <size_t N>
+void prepare(const RateTable<N> &table, int first)
+{
+    for (size_t i = 0; i < table.count; ++i)
+    {
+        periods[first + i] = table.tasks[i].period_ticks;
+        offsets[first + i] = table.tasks[i].offset_ticks;
+        runs[first + i] = 0U;
+        off_slot[first + i] = 0U;
+    }
+}
+
+void test_compaction()
+{
+    std::printf("Table compaction\n");
+    check(best_effort_table.tasks[3].run == &body<10>, "order of the remaining entries kept");
+    check(best_effort_table.tasks[4].run == nullptr, "tail is empty");
+}
+
+void test_slots()
+{
+    std::printf("Slots over one hyperperiod\n");
+    prepare(realtime_table, 0);
+    RateScheduler<realtime_table.kCapacity> schedule(realtime_table, 1000U);
+    schedule.start(0U);
+    const uint32_t hyperperiod = 13000U;
+    for (sim_us = 0U; sim_us < hyperperiod * 1000U; sim_us += 50U)
+    {
+        current_tick = sim_us / 1000U;
+        schedule.execute(sim_us);
+    }
+    bool exact = true;
+    for (size_t i = 0; i < realtime_table.count; ++i)
+    {
+        exact = exact && runs[i] == hyperperiod / periods[i] && off_slot[i] == 0U;
+        std::printf("  %-16s %5lu runs\n", realtime_table.tasks[i].name, static_cast<unsigned long>(runs[i]));
+    }
+    check(schedule.get_ticks() == hyperperiod, "one base tick per millisecond");
+    check(exact, "every runnable runs on each of its slots and nowhere else");
+}
+
+void test_late_execute()
+{
+    std::printf("Late execute\n");
+    prepare(realtime_table, 0);
+    RateScheduler<realtime_table.kCapacity> schedule(realtime_table, 1000U);
+    schedule.start(0U);
+    current_tick = 0U;
+    schedule.execute(0U); // tick 0
+    check(runs[0] == 1U && runs[6] == 1U && runs[1] == 0U, "tick 0 runs only the 0-offset groups");
+
+    // Ticks 1..35 in one call: everything with a slot in them runs once
+    current_tick = 35U;
+    const uint32_t ticks = schedule.execute(35000U);
+    check(ticks == 35U, "elapsed ticks processed at once");
+    check(runs[0] == 2U && runs[6] == 2U, "2 ms and 1 ms groups run once, not 17 or 35 times");
+    check(runs[1] == 1U && runs[2] == 1U && runs[3] == 1U && runs[4] == 1U && runs[5] == 1U,
+          "groups with a slot in the gap run once");
+    for (uint32_t &count : off_slot)
+    {
+        count = 0U; // the late runs themselves
+    }
+
+    // Back on the grid: contactors next at tick 41, shunt at 43
+    for (uint32_t tick = 36U; tick <= 43U; ++tick)
+    {
+        current_tick = tick;
+        schedule.execute(tick * 1000U + 10U);
+    }
+    check(runs[1] == 2U && runs[2] == 2U, "next runs on their regular slots");
+    check(off_slot[1] == 0U && off_slot[2] == 0U, "no run off the grid after catching up");
+}
+
+void test_report()
+{
+    std::printf("Worst-case tick report\n");
+    // Pessimistic execution times of the two-tier model (us)
+    const float cost_us[] = {60.0f, 25.0f, 10.0f, 15.0f, 300.0f, 900.0f, 1.0f};
+    const RateScheduleReport report = analyse_rate_table(realtime_table, cost_us);
+    std::printf("  hyperperiod %lu ticks, worst tick %lu: %.1f us (average %.1f us):",
+                static_cast<unsigned long>(report.hyperperiod_ticks),
+                static_cast<unsigned long>(report.worst_tick),
+                report.worst_us,
+                report.average_us);
+    for (size_t i = 0; i < realtime_table.count; ++i)
+    {
+        if (report.worst_tasks & (1UL << i))
+        {
+            std::printf(" %s", realtime_table.tasks[i].name);
+        }
+    }
+    std::printf("\n");
+    check(report.hyperperiod_ticks == 13000U, "hyperperiod of 1/2/10/13/20/100/1000 ticks");
+    check(report.worst_us == 916.0f, "worst tick: 1000 ms group with the 13 ms poll and the heartbeat check");
+    check((report.worst_tasks & (1U << 0)) == 0U, "odd offsets keep the slow groups off the RX tick");
+
+    // The same periods all at offset 0 would stack every group on tick 0
+    RateTask aligned[7];
+    for (size_t i = 0; i < 7U; ++i)
+    {
+        aligned[i] = realtime_table.tasks[i];
+        aligned[i].offset_ticks = 0U;
+    }
+    const RateScheduleReport stacked = analyse_rate_tasks(aligned, 7U, cost_us);
+    std::printf("  all offsets 0: worst tick %.1f us\n", stacked.worst_us);
+    check(stacked.worst_us > report.worst_us + 300.0f, "offsets spread the load");
+}
+
+uint32_t spin_us = 0U;
+uint32_t budget_runs = 0U;
+uint32_t yields = 0U;
+
+void spin_body()
+{
+    ++budget_runs;
+    const uint32_t start = task_profiler_cycles();
+    while (task_profiler_cycles() - start < spin_us * task_profiler_cycles_per_us())
+    {
+    }
+}
+
+void count_yield()
+{
+    ++yields;
+}
+
+constexpr RateTask budget_entries[] = {
+    {"budgeted", &spin_body, 1, 0, nullptr, 1, 100},
+};
+constexpr auto budget_table = make_rate_table(budget_entries);
+
+// Runs a runnable gets out of `slots` when its first run takes first_run_us
+// and every later one run_us.
+// Same admit/charge sequence as RateScheduler::execute(), timing given.
+uint32_t budgeted_runs(RateBudget &budget, uint32_t slots, uint32_t first_run_us, uint32_t run_us)
+{
+    uint32_t runs = 0U;
+    for (uint32_t slot = 0U; slot < slots; ++slot)
+    {
+        if (budget.admit())
+        {
+            budget.charge((runs == 0U) ? first_run_us : run_us);
+            ++runs;
+        }
+    }
+    return runs;
+}
+
+void test_budget()
+{
+    std::printf("Budgets\n");
+
+    // Slot accounting with exact run times
+    RateBudget within(100U);
+    check(budgeted_runs(within, 300U, 20U, 20U) == 300U && within.throttled == 0U,
+          "a runnable within budget keeps every slot");
+
+    RateBudget over(100U);
+    const uint32_t over_runs = budgeted_runs(over, 300U, 300U, 300U);
+    std::printf("  300 us runs on a 100 us budget: %lu of 300 slots, %lu throttled\n",
+                static_cast<unsigned long>(over_runs),
+                static_cast<unsigned long>(over.throttled));
+    check(over_runs == 100U, "an overrunning runnable gets budget / run time of its slots");
+    check(over.overruns == over_runs && over.throttled == 300U - over_runs, "overruns and skipped slots counted");
+
+    RateBudget stall(100U);
+    const uint32_t stall_runs = budgeted_runs(stall, 100U, 50000U, 0U);
+    check(stall.throttled == RateBudget::kMaxDebtSlots, "debt of a single stall is capped");
+    check(stall_runs == 100U - RateBudget::kMaxDebtSlots, "full rate again after the capped debt");
+
+    // Through the executive, timed with the host clock. A preempted run can
+    // only take longer, so only checks that survive that are made here.
+    RateScheduler<budget_table.kCapacity> schedule(budget_table, 1000U);
+    schedule.set_yield_hook(&count_yield);
+    schedule.start(0U);
+    budget_runs = 0U;
+    yields = 0U;
+    spin_us = 300U;
+    for (uint32_t tick = 0U; tick < 300U; ++tick)
+    {
+        schedule.execute(tick * 1000U);
+    }
+    const RateBudget &budget = schedule.get_budget(0);
+    check(yields == budget_runs, "the yield hook runs before every budgeted runnable");
+    check(budget_runs <= 100U && budget.overruns == budget_runs && budget.throttled == 300U - budget_runs,
+          "the executive throttles an overrunning runnable");
+}
+
+// Model of TaskScheduler's execute() walk
+struct ModelTask
+{
+    void (*callback)();
+    uint32_t interval_ms;
+    uint32_t previous_ms;
+    bool enabled;
+    ModelTask *next;
+};
+
+__attribute__((noinline)) uint32_t model_millis()
+{
+    return *static_cast<volatile uint32_t *>(&sim_us) / 1000U;
+}
+
+struct ModelScheduler
+{
+    ModelTask *first = nullptr;
+
+    void add(ModelTask &task)
+    {
+        task.next = first;
+        first = &task;
+    }
+
+    __attribute__((noinline)) void execute()
+    {
+        for (ModelTask *task = first; task != nullptr; task = task->next)
+        {
+            const uint32_t m = model_millis();
+            if (!task->enabled || m - task->previous_ms < task->interval_ms)
+            {
+                continue;
+            }
+            task->previous_ms += task->interval_ms;
+            task->callback();
+        }
+    }
+};
+
+void empty_task() {}
+
+void test_overhead()
+{
+    std::printf("Scheduler overhead\n");
+    constexpr uint32_t kSimulatedUs = 10000000U;
+    constexpr uint32_t kLoopPassUs = 2U;
+
+    // Previous wiring: 7 real-time and 6 best-effort tasks
+    const uint32_t old_realtime[] = {10U, 20U, 2U, 13U, 2U, 100U, 1000U};
+    const uint32_t old_best_effort[] = {10U, 100U, 1000U, 1000U, 1000U, 100U};
+    std::vector<ModelTask> tasks;
+    tasks.reserve(13);
+    ModelScheduler old_rt, old_be;
+    for (uint32_t interval : old_realtime)
+    {
+        tasks.push_back({&empty_task, interval, 0U, true, nullptr});
+        old_rt.add(tasks.back());
+    }
+    for (uint32_t interval : old_best_effort)
+    {
+        tasks.push_back({&empty_task, interval, 0U, true, nullptr});
+        old_be.add(tasks.back());
+    }
+    // One record per simulated millisecond, so the clock reads of the
+    // measurement are negligible against the 500 passes in between
+    constexpr uint32_t kBlockUs = 1000U;
+
+    TaskProfile old_profile("TaskScheduler", 0);
+    for (sim_us = 0U; sim_us < kSimulatedUs;)
+    {
+        const uint32_t start = task_profiler_cycles();
+        for (const uint32_t block_end = sim_us + kBlockUs; sim_us < block_end; sim_us += kLoopPassUs)
+        {
+            old_rt.execute();
+            old_be.execute();
+            old_rt.execute();
+        }
+        old_profile.record(start, task_profiler_cycles());
+    }
+
+    prepare(realtime_table, 0);
+    prepare(best_effort_table, 7);
+    RateScheduler<realtime_table.kCapacity> rt(realtime_table, 1000U);
+    RateScheduler<best_effort_table.kCapacity> be(best_effort_table, 1000U);
+    rt.start(0U);
+    be.start(0U);
+    TaskProfile new_profile("rate tables", 0);
+    for (sim_us = 0U; sim_us < kSimulatedUs;)
+    {
+        const uint32_t start = task_profiler_cycles();
+        for (const uint32_t block_end = sim_us + kBlockUs; sim_us < block_end; sim_us += kLoopPassUs)
+        {
+            current_tick = sim_us / 1000U;
+            rt.execute(sim_us);
+            be.execute(sim_us);
+            rt.execute(sim_us);
+        }
+        new_profile.record(start, task_profiler_cycles());
+    }
+    // The rate executive also profiles the real-time runnables; that time
+    // belongs to the runnables, not to scheduling
+    uint64_t task_cycles = 0U;
+    for (const TaskProfile &profile : profiles)
+    {
+        task_cycles += profile.busy_cycles();
+    }
+
+    const double seconds = kSimulatedUs / 1e6;
+    const double old_us_per_s = old_profile.busy_cycles() / 1000.0 / seconds;
+    const double new_us_per_s = (new_profile.busy_cycles() - task_cycles) / 1000.0 / seconds;
+    std::printf("  %lu loop passes per simulated second\n", static_cast<unsigned long>(1000000U / kLoopPassUs));
+    std::printf("  TaskScheduler model: %8.1f us/s (%.1f ns per pass)\n", old_us_per_s, old_us_per_s * 1000.0 * kLoopPassUs / 1e6);
+    std::printf("  rate tables:         %8.1f us/s (%.1f ns per pass)\n", new_us_per_s, new_us_per_s * 1000.0 * kLoopPassUs / 1e6);
+    std::printf("  reduction %.1f %%\n", 100.0 * (old_us_per_s - new_us_per_s) / old_us_per_s);
+    check(new_us_per_s < old_us_per_s / 2.0, "rate tables spend less than half the time scheduling");
+    check(runs[0] == kSimulatedUs / 2000U && runs[7] == kSimulatedUs / 10000U, "same work done");
+}
+} // namespace
+
+int main()
+{
+    test_compaction();
+    test_slots();
+    test_late_execute();
+    test_report();
+    test_overhead();
+    test_budget();
+
+    std::printf("%s\n", failures == 0 ? "Rate schedule test PASSED" : "Rate schedule test FAILED");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,143 @@
+// Host test for the signal registry (signal_registry.h).
+//
+// 1) Enumerates every registered signal and prints the table.
+// 2) IDs are dense, names are unique snake_case, units and types are set,
+//    integer signals have scale 1 and array signals a count above 1.
+// 3) signal_find() maps every name back to its ID, also at compile time.
+// 4) signal_read() reaches the accessor of each ID and element and returns
+//    0 past the end of an array.
+// 5) Flash footprint of the metadata (table and strings).
+//
+// Build: pio run -e native_signal_registry_test && .pio/build/native_signal_registry_test/program
+
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+
+#include "signal_registry.h"
+
+static_assert(signal_find("soc") == SIGNAL_SOC, "compile-time lookup");
+static_assert(signal_find("no_such_signal") == SIGNAL_COUNT, "unknown name");
+static_assert(kSignalInfo[SIGNAL_CELL_VOLTAGE].count == MODULES_PER_PACK * CELLS_PER_MODULE, "cell array");
+
+// Stand-in accessors: element i of signal id reads id * 1000 + i
+#define SIGNAL_TEST_READER(id, name, unit, type, scale, count, read) \
+    static float read_##id(uint16_t i)                               \
+    {                                                                \
+        return static_cast<float>(SIGNAL_##id * 1000 + i);           \
+    }
+SIGNAL_LIST(SIGNAL_TEST_READER)
+#undef SIGNAL_TEST_READER
+
+const SignalReader signal_readers[SIGNAL_COUNT] = {
+#define SIGNAL_TEST_READER_ENTRY(id, name, unit, type, scale, count, read) &read_##id,
+    SIGNAL_LIST(SIGNAL_TEST_READER_ENTRY)
+#undef SIGNAL_TEST_READER_ENTRY
+};
+
+namespace
+{
+int failures = 0;
+
+void check(bool ok, const char *what, int id)
+{
+    if (!ok)
+    {
+        std::printf("  FAIL: %s (signal %d)\n", what, id);
+        ++failures;
+    }
+}
+
+bool is_snake_case(const char *name)
+{
+    if (!std::islower(static_cast<unsigned char>(name[0])))
+    {
+        return false;
+    }
+    for (const char *c = name; *c != '\0'; ++c)
+    {
+        if (!std::islower(static_cast<unsigned char>(*c)) && !std::isdigit(static_cast<unsigned char>(*c)) && *c != '_')
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void test_enumerate()
+{
+    std::printf("   id signal                       unit type     n scale\n");
+    size_t values = 0U;
+    for (int id = 0; id < SIGNAL_COUNT; ++id)
+    {
+        const SignalInfo &info = kSignalInfo[id];
+        std::printf("  %3d %-28s %-4s %-4s %5u %g\n",
+                    id,
+                    info.name,
+                    info.unit,
+                    signal_type_name(info.type),
+                    static_cast<unsigned>(info.count),
+                    static_cast<double>(info.scale));
+        values += info.count;
+
+        check(info.name != nullptr && is_snake_case(info.name), "snake_case name", id);
+        check(info.unit != nullptr, "unit set (may be empty)", id);
+        check(info.count >= 1U, "count", id);
+        check(info.scale > 0.0f, "positive scale", id);
+        check(info.type == SIGNAL_TYPE_F32 || info.scale == 1.0f, "integer signal has scale 1", id);
+        for (int other = 0; other < id; ++other)
+        {
+            check(std::strcmp(kSignalInfo[other].name, info.name) != 0, "unique name", id);
+        }
+    }
+    std::printf("  %d signals, %zu values\n", static_cast<int>(SIGNAL_COUNT), values);
+}
+
+void test_lookup()
+{
+    for (int id = 0; id < SIGNAL_COUNT; ++id)
+    {
+        check(signal_find(kSignalInfo[id].name) == id, "name maps back to its ID", id);
+    }
+    check(signal_find("") == SIGNAL_COUNT, "empty name", -1);
+    check(signal_find("cell") == SIGNAL_COUNT, "a prefix is not a name", -1);
+}
+
+void test_read()
+{
+    for (int id = 0; id < SIGNAL_COUNT; ++id)
+    {
+        const SignalId signal = static_cast<SignalId>(id);
+        const uint16_t count = kSignalInfo[id].count;
+        check(signal_read(signal) == static_cast<float>(id * 1000), "first element", id);
+        check(signal_read(signal, count - 1U) == static_cast<float>(id * 1000 + count - 1), "last element", id);
+        check(signal_read(signal, count) == 0.0f, "past the end reads 0", id);
+    }
+}
+
+void test_footprint()
+{
+    size_t strings = 0U;
+    for (const SignalInfo &info : kSignalInfo)
+    {
+        strings += std::strlen(info.name) + 1U + std::strlen(info.unit) + 1U;
+    }
+    const size_t table = sizeof(kSignalInfo) + sizeof(signal_readers);
+    std::printf("  flash: %zu bytes of tables, at most %zu bytes of strings (%zu bytes per signal)\n",
+                table,
+                strings,
+                (table + strings) / SIGNAL_COUNT);
+    check(table + strings < 4096U, "registry under 4 KB of flash", -1);
+}
+} // namespace
+
+int main()
+{
+    test_enumerate();
+    test_lookup();
+    test_read();
+    test_footprint();
+
+    std::printf("%s\n", failures == 0 ? "Signal registry test PASSED" : "Signal registry test FAILED");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,213 @@
+// Host test for the runnable profiler.
+//
+// On the host the cycle counter is steady_clock nanoseconds, so record() is
+// fed synthetic start/end values in ns and the results are checked in us.
+//
+// 1) Execution-time statistics: min/avg/max exact, p99 from the histogram
+//    within one bin (at most 25 % above the exact order statistic) for a
+//    spread-out random distribution.
+// 2) Start jitter: largest late and early deviation from the period, also
+//    across a wrap of the 32-bit counter.
+// 3) Overruns and missed slots, none across a resync().
+// 4) Histogram saturation: counts are halved, percentiles stay put.
+// 5) Loop work (period 0) and reset().
+// 6) TaskProfileScope around real work.
+//
+// Build: pio run -e native_task_profiler_test && .pio/build/native_task_profiler_test/program
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "utils/task_profiler.h"
+
+namespace
+{
+int failures = 0;
+
+void check(bool ok, const char *what)
+{
+    if (!ok)
+    {
+        std::printf("  FAIL: %s\n", what);
+        ++failures;
+    }
+}
+
+bool near(float value, float expected, float tolerance)
+{
+    return std::fabs(value - expected) <= tolerance;
+}
+
+constexpr uint32_t kNsPerMs = 1000000U;
+
+float to_float_us(uint32_t cycles)
+{
+    return static_cast<float>(cycles) / static_cast<float>(task_profiler_cycles_per_us());
+}
+
+void test_statistics()
+{
+    std::printf("Execution-time statistics\n");
+    TaskProfile profile("test", 10);
+    std::mt19937 rng(7);
+    std::lognormal_distribution<double> exec_us(std::log(200.0), 0.6);
+
+    std::vector<uint32_t> samples;
+    uint64_t sum = 0;
+    uint32_t start = 0;
+    for (int i = 0; i < 5000; ++i)
+    {
+        const uint32_t cycles = static_cast<uint32_t>(exec_us(rng) * 1000.0);
+        samples.push_back(cycles);
+        sum += cycles;
+        profile.record(start, start + cycles);
+        start += 10U * kNsPerMs;
+    }
+    std::sort(samples.begin(), samples.end());
+    const uint32_t exact_p99 = samples[static_cast<size_t>(0.99 * samples.size() + 0.5) - 1U];
+    const uint32_t p99 = profile.percentile_cycles(0.99f);
+
+    std::printf("  runs %lu, min %.1f us, avg %.1f us, max %.1f us\n",
+                static_cast<unsigned long>(profile.get_count()),
+                profile.min_us(), profile.avg_us(), profile.max_us());
+    std::printf("  p99 %.1f us (exact %.1f us, +%.1f %%)\n",
+                p99 / 1000.0, exact_p99 / 1000.0, 100.0 * (p99 - exact_p99) / exact_p99);
+
+    check(profile.get_count() == 5000U, "run count");
+    check(near(profile.min_us(), samples.front() / 1000.0f, 0.01f), "min");
+    check(near(profile.max_us(), samples.back() / 1000.0f, 0.01f), "max");
+    check(near(profile.avg_us(), static_cast<float>(sum / 5000.0 / 1000.0), 0.1f), "avg");
+    check(p99 >= exact_p99 && p99 <= exact_p99 + exact_p99 / 4U, "p99 within one bin above the exact value");
+    check(profile.percentile_cycles(1.0f) == samples.back(), "p100 is the max");
+    check(profile.get_overruns() == 0U && profile.get_missed() == 0U, "no overruns or missed slots");
+    check(profile.late_us() == 0.0f && profile.early_us() == 0.0f, "no jitter on an exact period");
+}
+
+void test_jitter()
+{
+    std::printf("Start jitter\n");
+    TaskProfile profile("test", 2);
+    const uint32_t period = 2U * kNsPerMs;
+    // Starts straddle the 32-bit wrap of the counter.
+    uint32_t nominal = UINT32_MAX - 5U * period;
+    const int32_t offsets[] = {0, 150000, -80000, 20000, 300000, -200000, 0, 0, 10000, 0};
+    for (int32_t offset : offsets)
+    {
+        const uint32_t start = nominal + static_cast<uint32_t>(offset);
+        profile.record(start, start + 50000U);
+        nominal += period;
+    }
+
+    // Deviations between consecutive starts, not against the nominal grid.
+    std::printf("  late %.1f us, early %.1f us\n", profile.late_us(), profile.early_us());
+    check(near(profile.late_us(), 280.0f, 0.01f), "late: +20 us followed by +300 us");
+    check(near(profile.early_us(), -500.0f, 0.01f), "early: +300 us followed by -200 us");
+    check(profile.get_missed() == 0U, "no missed slots across the counter wrap");
+}
+
+void test_overruns_and_missed()
+{
+    std::printf("Overruns and missed slots\n");
+    TaskProfile profile("test", 10);
+    const uint32_t period = 10U * kNsPerMs;
+    uint32_t start = 1000U;
+    profile.record(start, start + 1000000U);
+    start += period;
+    profile.record(start, start + 12000000U); // runs into the next slot
+    start += 2U * period;                     // the next start was skipped
+    profile.record(start, start + 1000000U);
+    start += period;
+    profile.record(start, start + 1000000U);
+    start += 4U * period;
+    profile.record(start, start + 1000000U);
+
+    std::printf("  overruns %lu, missed %lu, late %.1f us\n",
+                static_cast<unsigned long>(profile.get_overruns()),
+                static_cast<unsigned long>(profile.get_missed()),
+                profile.late_us());
+    check(profile.get_overruns() == 1U, "one overrun");
+    check(profile.get_missed() == 2U, "two gaps of two or more periods");
+    check(near(profile.late_us(), 30000.0f, 0.01f), "late covers the longest gap");
+
+    // Slots skipped on purpose (low-activity profile) are not missed
+    start += 10U * period;
+    profile.resync();
+    profile.record(start, start + 1000000U);
+    start += period;
+    profile.record(start, start + 1000000U);
+    check(profile.get_missed() == 2U && near(profile.late_us(), 30000.0f, 0.01f),
+          "no missed slot or lateness across a resync");
+}
+
+void test_saturation()
+{
+    std::printf("Histogram saturation\n");
+    TaskProfile profile("test", 0);
+    for (uint32_t i = 0; i < 200000U; ++i)
+    {
+        profile.record(0U, 100000U);
+        if (i % 100U == 0U)
+        {
+            profile.record(0U, 900000U);
+        }
+    }
+    const float p99 = profile.p99_us();
+    const float p999 = to_float_us(profile.percentile_cycles(0.999f));
+    std::printf("  runs %lu, p99 %.1f us, p99.9 %.1f us\n",
+                static_cast<unsigned long>(profile.get_count()), p99, p999);
+    check(profile.get_count() == 202000U, "count is not affected by halving");
+    check(p99 >= 100.0f && p99 <= 125.0f, "p99 in the bin of the common case");
+    check(p999 >= 900.0f && p999 <= 1125.0f, "p99.9 in the bin of the slow case");
+}
+
+void test_loop_and_reset()
+{
+    std::printf("Loop work and reset\n");
+    TaskProfile profile("loop", 0);
+    profile.record(0U, 3000U);
+    profile.record(5U, 5005U);            // irregular starts are not jitter
+    profile.record(4000000000U, 4000001000U);
+    check(profile.get_count() == 3U, "loop runs counted");
+    check(profile.late_us() == 0.0f && profile.early_us() == 0.0f, "no jitter for period 0");
+    check(profile.get_overruns() == 0U && profile.get_missed() == 0U, "no overruns for period 0");
+    check(profile.busy_cycles() == 9000U, "busy cycles summed");
+
+    profile.reset();
+    check(profile.get_count() == 0U && profile.busy_cycles() == 0U, "reset clears counts");
+    check(profile.min_us() == 0.0f && profile.max_us() == 0.0f && profile.p99_us() == 0.0f, "reset clears times");
+}
+
+void test_scope()
+{
+    std::printf("Scope\n");
+    TaskProfile profile("scope", 0);
+    volatile uint32_t sink = 0;
+    for (int run = 0; run < 3; ++run)
+    {
+        TaskProfileScope scope(profile);
+        for (uint32_t i = 0; i < 200000U; ++i)
+        {
+            sink = sink + i;
+        }
+    }
+    std::printf("  runs %lu, avg %.1f us\n", static_cast<unsigned long>(profile.get_count()), profile.avg_us());
+    check(profile.get_count() == 3U, "one record per scope");
+    check(profile.min_us() > 0.0f && profile.max_us() < 1000000.0f, "plausible scope time");
+}
+} // namespace
+
+int main()
+{
+    test_statistics();
+    test_jitter();
+    test_overruns_and_missed();
+    test_saturation();
+    test_loop_and_reset();
+    test_scope();
+
+    std::printf("%s\n", failures == 0 ? "Task profiler test PASSED" : "Task profiler test FAILED");
+    return failures == 0 ? 0 : 1;
+}
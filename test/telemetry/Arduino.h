@@ -0,0 +1,65 @@
+#pragma once
+
+// Host stand-in for the parts of the Arduino core that telemetry_stream.h
+// uses: a Print whose transmit buffer the test fills and empties.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <vector>
+
+class Print
+{
+public:
+    virtual ~Print() = default;
+    virtual size_t write(uint8_t value) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size)
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            write(buffer[i]);
+        }
+        return size;
+    }
+    virtual int availableForWrite() { return 0; }
+};
+
+// USB transmit buffer of kCapacity bytes; host_read() is the host taking
+// bytes out. A write that does not fit would block on the target, so it is
+// counted here.
+class SimPort : public Print
+{
+public:
+    static constexpr size_t kCapacity = 2048U;
+
+    std::vector<uint8_t> received;
+    size_t fill = 0U;
+    uint32_t blocking_writes = 0U;
+
+    size_t write(uint8_t value) override
+    {
+        return write(&value, 1U);
+    }
+
+    size_t write(const uint8_t *buffer, size_t size) override
+    {
+        if (size > kCapacity - fill)
+        {
+            ++blocking_writes;
+        }
+        fill += size;
+        received.insert(received.end(), buffer, buffer + size);
+        return size;
+    }
+
+    int availableForWrite() override
+    {
+        return (fill >= kCapacity) ? 0 : static_cast<int>(kCapacity - fill);
+    }
+
+    void host_read(size_t bytes)
+    {
+        fill = (bytes < fill) ? fill - bytes : 0U;
+    }
+};
@@ -0,0 +1,412 @@
+// Host test for the binary telemetry stream (telemetry_stream.h).
+//
+// 1) COBS: encoded data has no zero byte and decodes to the input for all
+//    lengths around the 254-byte block size; corrupt input is rejected.
+// 2) Every group round-trips through the writer, COBS, CRC and the shared
+//    decoder, to within half a step of its resolution; out-of-range values
+//    clamp.
+// 3) A sampler that does not match its layout is rejected, not sent.
+// 4) Group periods are kept over 10 s of service() calls.
+// 5) Flow control: with a slow host no write exceeds the free buffer,
+//    skipped slots are counted and show up as sequence gaps.
+// 6) Throughput: encode and decode cost per frame and the link bandwidth
+//    of the default configuration.
+//
+// Build: pio run -e native_telemetry_test && .pio/build/native_telemetry_test/program
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "telemetry_stream.h"
+
+namespace
+{
+int failures = 0;
+
+void check(bool ok, const char *what)
+{
+    if (!ok)
+    {
+        std::printf("  FAIL: %s\n", what);
+        ++failures;
+    }
+}
+
+// Simulated pack: value of field f, repeat i, block b in group g, anywhere
+// in the range of the field type and 0.3 steps off the resolution
+const TelemetryField &layout_field(TelemetryGroup group, int block, uint8_t field)
+{
+    const TelemetryLayout &layout = kTelemetryLayouts[group];
+    return (block < 0) ? layout.fields[field] : layout.block_fields[field];
+}
+
+float sample_value(TelemetryGroup group, int block, uint8_t field, uint8_t index)
+{
+    const TelemetryField &f = layout_field(group, block, field);
+    const int32_t n = (block + 2) * 7919 + field * 104729 + index * 1299709 + group;
+    int32_t raw = 0;
+    switch (f.type)
+    {
+    case TELEMETRY_U8:
+        raw = n % 256;
+        break;
+    case TELEMETRY_I8:
+        raw = n % 256 - 128;
+        break;
+    case TELEMETRY_U16:
+        raw = n % 65536;
+        break;
+    case TELEMETRY_I16:
+        raw = n % 65536 - 32768;
+        break;
+    default:
+        raw = n * 3 - 2000000; // float resolution limits the test range
+        break;
+    }
+    if (f.scale == 1.0f)
+    {
+        return static_cast<float>(raw);
+    }
+    return (static_cast<float>(raw) + 0.3f) * f.scale;
+}
+
+template <TelemetryGroup G>
+void sample(TelemetryFrameWriter &writer)
+{
+    const TelemetryLayout &layout = kTelemetryLayouts[G];
+    const auto put_fields = [&](const TelemetryField *fields, uint8_t count, int block) {
+        for (uint8_t f = 0; f < count; ++f)
+        {
+            for (uint8_t i = 0; i < fields[f].count; ++i)
+            {
+                if (fields[f].scale == 1.0f)
+                {
+                    writer.put_raw(static_cast<int32_t>(sample_value(G, block, f, i)));
+                }
+                else
+                {
+                    writer.put(sample_value(G, block, f, i));
+                }
+            }
+        }
+    };
+    put_fields(layout.fields, layout.field_count, -1);
+    if (layout.block_fields != nullptr)
+    {
+        writer.begin_blocks(layout.max_blocks);
+        for (int b = 0; b < layout.max_blocks; ++b)
+        {
+            put_fields(layout.block_fields, layout.block_field_count, b);
+        }
+    }
+}
+
+void sample_short(TelemetryFrameWriter &writer)
+{
+    writer.put(1.0f); // shunt group has 11 fields
+}
+
+const TelemetryStream::Sample kSamplers[TELEMETRY_GROUP_COUNT] = {
+    &sample<TELEMETRY_CELL_VOLTAGES>,
+    &sample<TELEMETRY_TEMPERATURES>,
+    &sample<TELEMETRY_SHUNT>,
+    &sample<TELEMETRY_LIMITS>,
+    &sample<TELEMETRY_STATES>,
+};
+
+const uint16_t kDefaultPeriods[TELEMETRY_GROUP_COUNT] = {
+    TELEMETRY_CELL_VOLTAGES_PERIOD,
+    TELEMETRY_TEMPERATURES_PERIOD,
+    TELEMETRY_SHUNT_PERIOD,
+    TELEMETRY_LIMITS_PERIOD,
+    TELEMETRY_STATES_PERIOD,
+};
+
+// Splits a byte stream at the delimiters and decodes every frame
+struct Capture
+{
+    std::vector<TelemetryFrameView> frames;
+    std::vector<std::vector<uint8_t>> storage;
+    uint32_t bad = 0U;
+
+    explicit Capture(const std::vector<uint8_t> &stream)
+    {
+        std::vector<uint8_t> encoded;
+        for (uint8_t byte : stream)
+        {
+            if (byte != 0U)
+            {
+                encoded.push_back(byte);
+                continue;
+            }
+            std::vector<uint8_t> decoded(encoded.size());
+            const size_t size = cobs_decode(encoded.data(), encoded.size(), decoded.data(), decoded.size());
+            decoded.resize(size);
+            storage.push_back(decoded);
+            encoded.clear();
+        }
+        for (const std::vector<uint8_t> &frame : storage)
+        {
+            TelemetryFrameView view;
+            if (telemetry_parse_frame(frame.data(), frame.size(), &view))
+            {
+                frames.push_back(view);
+            }
+            else
+            {
+                ++bad;
+            }
+        }
+    }
+};
+
+void test_cobs()
+{
+    std::printf("COBS\n");
+    bool ok = true;
+    uint32_t seed = 1U;
+    for (size_t size = 0U; size <= 1030U; ++size)
+    {
+        std::vector<uint8_t> data(size);
+        for (uint8_t &byte : data)
+        {
+            seed = seed * 1103515245U + 12345U;
+            // Plenty of zeros and long runs without one
+            byte = (size % 3U == 0U) ? static_cast<uint8_t>(seed >> 24) : ((seed >> 28) == 0U ? 0U : 0xA5U);
+        }
+        std::vector<uint8_t> encoded(cobs_max_encoded_size(size) + 1U);
+        CobsEncoder encoder;
+        encoder.begin(encoded.data(), encoded.size());
+        encoder.put(data.data(), data.size());
+        const size_t encoded_size = encoder.finish();
+        ok = ok && encoded_size != 0U && encoded[encoded_size - 1U] == 0U;
+        for (size_t i = 0; ok && i + 1U < encoded_size; ++i)
+        {
+            ok = encoded[i] != 0U;
+        }
+        std::vector<uint8_t> decoded(size + 1U);
+        ok = ok && cobs_decode(encoded.data(), encoded_size - 1U, decoded.data(), decoded.size()) == size &&
+             std::equal(data.begin(), data.end(), decoded.begin());
+    }
+    check(ok, "round trip, no zero inside a frame, within the worst-case size");
+
+    uint8_t out[8];
+    const uint8_t truncated[] = {0x05, 0x11, 0x22};
+    check(cobs_decode(truncated, sizeof(truncated), out, sizeof(out)) == 0U, "block past the end rejected");
+    uint8_t small[4];
+    CobsEncoder encoder;
+    encoder.begin(small, sizeof(small));
+    encoder.put(truncated, sizeof(truncated));
+    check(encoder.finish() == 0U, "encoder reports a buffer that is too small");
+}
+
+void test_round_trip()
+{
+    std::printf("Group round trip\n");
+    SimPort port;
+    static const uint16_t every_10ms[TELEMETRY_GROUP_COUNT] = {10, 10, 10, 10, 10};
+    TelemetryStream stream(kSamplers, every_10ms);
+    stream.begin(port);
+    stream.service(1000U, 1000000U);
+
+    Capture capture(port.received);
+    check(capture.bad == 0U && capture.frames.size() == TELEMETRY_GROUP_COUNT, "one valid frame per group");
+    for (const TelemetryFrameView &view : capture.frames)
+    {
+        float worst = 0.0f;
+        size_t values = 0U;
+        const bool layout_ok =
+            telemetry_for_each_value(view, [&](const TelemetryField &field, int block, uint8_t index, int64_t raw) {
+                const uint8_t f = static_cast<uint8_t>(&field - ((block < 0) ? kTelemetryLayouts[view.group].fields
+                                                                              : kTelemetryLayouts[view.group].block_fields));
+                const float sent = sample_value(view.group, block, f, index);
+                const float error = std::fabs(static_cast<float>(raw) * field.scale - sent) / field.scale;
+                worst = (error > worst) ? error : worst;
+                ++values;
+            });
+        std::printf("  %-12s %3zu values, %3zu byte payload, worst error %.3f steps\n",
+                    kTelemetryLayouts[view.group].name,
+                    values,
+                    view.payload_size,
+                    worst);
+        check(layout_ok, "payload matches the layout");
+        check(worst <= 0.5001f, "values within half a step");
+        check(view.time_us == 1000000U && view.sequence == 0U, "header fields");
+    }
+
+    // Clamping and NaN
+    uint8_t frame[64];
+    TelemetryFrameWriter writer;
+    writer.begin(frame, sizeof(frame), TELEMETRY_LIMITS, 7U, 42U);
+    writer.put(1.0e6f);
+    writer.put(-1.0e6f);
+    writer.put(NAN);
+    for (int i = 3; i < 15; ++i)
+    {
+        writer.put(-5.0f); // unsigned fields clamp to 0
+    }
+    const size_t size = writer.finish();
+    Capture clamped(std::vector<uint8_t>(frame, frame + size));
+    std::vector<int64_t> raws;
+    check(clamped.frames.size() == 1U &&
+              telemetry_for_each_value(clamped.frames[0],
+                                       [&](const TelemetryField &, int, uint8_t, int64_t raw) { raws.push_back(raw); }),
+          "clamped frame decodes");
+    check(raws.size() == 15U && raws[0] == INT16_MAX && raws[1] == INT16_MIN && raws[2] == 0 && raws[8] == 0,
+          "out-of-range values clamp, NaN is sent as 0");
+
+    // A flipped bit fails the CRC
+    std::vector<uint8_t> corrupt = clamped.storage[0];
+    corrupt[10] ^= 0x04U;
+    TelemetryFrameView view;
+    check(!telemetry_parse_frame(corrupt.data(), corrupt.size(), &view), "CRC rejects a corrupt frame");
+}
+
+void test_rejected()
+{
+    std::printf("Sampler not matching its layout\n");
+    static const TelemetryStream::Sample samplers[TELEMETRY_GROUP_COUNT] = {nullptr, nullptr, &sample_short, nullptr, nullptr};
+    static const uint16_t periods[TELEMETRY_GROUP_COUNT] = {10, 10, 10, 10, 10};
+    SimPort port;
+    TelemetryStream stream(samplers, periods);
+    stream.begin(port);
+    stream.service(0U, 0U);
+    check(port.received.empty() && stream.get_stats(TELEMETRY_SHUNT).rejected == 1U, "incomplete frame not sent");
+}
+
+void test_rates()
+{
+    std::printf("Group periods\n");
+    SimPort port;
+    TelemetryStream stream(kSamplers, kDefaultPeriods);
+    stream.begin(port);
+    stream.set_period(TELEMETRY_TEMPERATURES, 0U);
+    constexpr uint32_t kDurationMs = 10000U;
+    for (uint32_t now = 0U; now < kDurationMs; now += TELEMETRY_TICK_MS)
+    {
+        stream.service(now, now * 1000U);
+        port.host_read(SimPort::kCapacity);
+    }
+    bool ok = true;
+    for (int g = 0; g < TELEMETRY_GROUP_COUNT; ++g)
+    {
+        const TelemetryGroup group = static_cast<TelemetryGroup>(g);
+        const uint16_t period = stream.get_period(group);
+        const uint32_t expected = (period == 0U) ? 0U : kDurationMs / period;
+        std::printf("  %-12s %5u ms: %lu frames\n",
+                    kTelemetryLayouts[g].name,
+                    static_cast<unsigned>(period),
+                    static_cast<unsigned long>(stream.get_stats(group).frames));
+        ok = ok && stream.get_stats(group).frames == expected && stream.get_stats(group).skipped == 0U;
+    }
+    check(ok, "frames sent at the group periods, disabled group silent");
+    check(Capture(port.received).bad == 0U, "all frames valid");
+}
+
+void test_flow_control()
+{
+    std::printf("Slow host\n");
+    SimPort port;
+    static const uint16_t fast[TELEMETRY_GROUP_COUNT] = {10, 10, 10, 10, 10};
+    TelemetryStream stream(kSamplers, fast);
+    stream.begin(port);
+    for (uint32_t now = 0U; now < 10000U; now += TELEMETRY_TICK_MS)
+    {
+        stream.service(now, now * 1000U);
+        port.host_read(300U); // 30 kB/s, less than the ~60 kB/s produced
+    }
+    uint32_t skipped = 0U;
+    for (int g = 0; g < TELEMETRY_GROUP_COUNT; ++g)
+    {
+        skipped += stream.get_stats(static_cast<TelemetryGroup>(g)).skipped;
+    }
+    // Sequence gaps seen by the decoder equal the skipped slots
+    Capture capture(port.received);
+    uint16_t next[TELEMETRY_GROUP_COUNT] = {};
+    uint32_t gaps = 0U;
+    for (const TelemetryFrameView &view : capture.frames)
+    {
+        gaps += static_cast<uint16_t>(view.sequence - next[view.group]);
+        next[view.group] = static_cast<uint16_t>(view.sequence + 1U);
+    }
+    for (int g = 0; g < TELEMETRY_GROUP_COUNT; ++g)
+    {
+        gaps += 1000U - next[g]; // slots after the last frame sent
+    }
+    std::printf("  %zu frames, %lu slots skipped, %lu sequence gaps, %lu blocking writes\n",
+                capture.frames.size(),
+                static_cast<unsigned long>(skipped),
+                static_cast<unsigned long>(gaps),
+                static_cast<unsigned long>(port.blocking_writes));
+    check(port.blocking_writes == 0U, "never writes more than the buffer takes");
+    check(skipped > 0U && gaps == skipped, "skipped slots counted and visible as sequence gaps");
+    check(capture.bad == 0U, "frames stay intact");
+}
+
+void test_throughput()
+{
+    std::printf("Throughput\n");
+    constexpr int kFrames = 200000;
+    uint8_t frame[TelemetryStream::kFrameBufferBytes];
+    TelemetryFrameWriter writer;
+    size_t size = 0U;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kFrames; ++i)
+    {
+        writer.begin(frame, sizeof(frame), TELEMETRY_CELL_VOLTAGES, static_cast<uint16_t>(i), static_cast<uint32_t>(i));
+        sample<TELEMETRY_CELL_VOLTAGES>(writer);
+        size = writer.finish();
+    }
+    const double encode_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / kFrames;
+
+    uint8_t decoded[sizeof(frame)];
+    int64_t sum = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kFrames; ++i)
+    {
+        const size_t decoded_size = cobs_decode(frame, size - 1U, decoded, sizeof(decoded));
+        TelemetryFrameView view;
+        if (telemetry_parse_frame(decoded, decoded_size, &view))
+        {
+            telemetry_for_each_value(view, [&sum](const TelemetryField &, int, uint8_t, int64_t raw) { sum += raw; });
+        }
+    }
+    const double decode_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / kFrames;
+
+    double bytes_per_s = 0.0;
+    for (int g = 0; g < TELEMETRY_GROUP_COUNT; ++g)
+    {
+        if (kDefaultPeriods[g] != 0U)
+        {
+            bytes_per_s += telemetry_max_frame_size(static_cast<TelemetryGroup>(g)) * 1000.0 / kDefaultPeriods[g];
+        }
+    }
+    std::printf("  96-cell frame: %zu bytes, encode %.0f ns (%.1f MB/s), decode %.0f ns (%.1f MB/s) [%lld]\n",
+                size,
+                encode_ns,
+                size * 1000.0 / encode_ns,
+                decode_ns,
+                size * 1000.0 / decode_ns,
+                static_cast<long long>(sum % 10));
+    std::printf("  default rates: %.1f kB/s, %.2f%% of USB full speed (12 Mbit/s)\n",
+                bytes_per_s / 1000.0,
+                bytes_per_s * 8.0 / 12.0e6 * 100.0);
+    check(size <= telemetry_max_frame_size(TELEMETRY_CELL_VOLTAGES), "frame within the flow-control reservation");
+    check(bytes_per_s * 8.0 < 12.0e6 * 0.1, "default configuration uses under 10 % of the link");
+}
+} // namespace
+
+int main()
+{
+    test_cobs();
+    test_round_trip();
+    test_rejected();
+    test_rates();
+    test_flow_control();
+    test_throughput();
+
+    std::printf("%s\n", failures == 0 ? "Telemetry stream test PASSED" : "Telemetry stream test FAILED");
+    return failures == 0 ? 0 : 1;
+}
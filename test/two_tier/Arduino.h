@@ -0,0 +1,126 @@
+#pragma once
+
+// Host stand-in for the parts of the Arduino core that console_printer.h
+// uses. micros()/millis() read a simulated clock; Serial models the USB
+// transmit buffer of the Teensy and a host that empties it at a fixed rate.
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+inline uint32_t sim_micros = 0U;
+
+inline uint32_t micros()
+{
+    return sim_micros;
+}
+
+inline uint32_t millis()
+{
+    return sim_micros / 1000U;
+}
+
+class Print
+{
+public:
+    virtual ~Print() = default;
+    virtual size_t write(uint8_t value) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size)
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            write(buffer[i]);
+        }
+        return size;
+    }
+
+    size_t print(const char *text)
+    {
+        return write(reinterpret_cast<const uint8_t *>(text), strlen(text));
+    }
+    size_t print(unsigned long value)
+    {
+        char buf[16];
+        snprintf(buf, sizeof(buf), "%lu", value);
+        return print(buf);
+    }
+    size_t println(const char *text)
+    {
+        return print(text) + print("\r\n");
+    }
+};
+
+// USB serial transmit buffer. The host reads one byte per drain_us (0: the
+// host is not reading). write() blocks like the Teensy core when the buffer
+// is full; availableForWrite() costs one simulated microsecond.
+class SimSerial
+{
+public:
+    static constexpr uint32_t kCapacity = 4096U;
+
+    uint32_t drain_us = 10U;
+    uint32_t fill = 0U;
+    uint32_t delivered = 0U;
+
+    void reset(uint32_t _drain_us)
+    {
+        drain_us = _drain_us;
+        fill = 0U;
+        delivered = 0U;
+        last_drain = sim_micros;
+    }
+
+    void flush() {}
+
+    int availableForWrite()
+    {
+        sim_micros += 1U;
+        drain();
+        return static_cast<int>(kCapacity - fill);
+    }
+
+    size_t write(const uint8_t *buffer, size_t size)
+    {
+        (void)buffer;
+        sim_micros += 1U + static_cast<uint32_t>(size) / 32U;
+        for (size_t i = 0; i < size; ++i)
+        {
+            drain();
+            while (fill == kCapacity && drain_us != 0U)
+            {
+                sim_micros += 1U;
+                drain();
+            }
+            if (fill < kCapacity)
+            {
+                ++fill;
+            }
+        }
+        return size;
+    }
+
+private:
+    uint32_t last_drain = 0U;
+
+    void drain()
+    {
+        if (drain_us == 0U)
+        {
+            last_drain = sim_micros;
+            return;
+        }
+        const uint32_t bytes = (sim_micros - last_drain) / drain_us;
+        if (bytes == 0U)
+        {
+            return;
+        }
+        last_drain += bytes * drain_us;
+        const uint32_t taken = (bytes < fill) ? bytes : fill;
+        fill -= taken;
+        delivered += taken;
+    }
+};
+
+inline SimSerial Serial;
@@ -0,0 +1,303 @@
+// Host simulation of safety-task latency under console load.
+//
+// The runnables of comms_bms.cpp are modelled with their periods and a
+// pessimistic execution time each; a scheduler pass runs every due task once
+// and reschedules it one period after its previous due time, like
+// TaskScheduler. The console prints a ~5 KB report (boot diagnostics plus BMS
+// status) every 25 ms into the USB buffer model of Arduino.h.
+//
+// Single tier: the original loop(): one scheduler for everything, then the
+//    console writing straight to Serial (blocking when the buffer is full).
+// Two tier: loop() as in main.cpp: the real-time tier first, the best-effort
+//    scheduler, the real-time tier again, then the console into the real
+//    ConsolePrinter ring, drained at the end of the pass within the budget
+//    of comms_bms.cpp.
+//
+// Reported per real-time task: worst start latency (start - due) and missed
+// slots over 5 s of simulated time, for a fast host, a slow host (slower
+// than the report rate, so output is dropped) and a host that stopped
+// reading.
+//
+// Build: pio run -e native_two_tier_test && .pio/build/native_two_tier_test/program
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "console_printer.h"
+
+namespace
+{
+int failures = 0;
+
+void check(bool ok, const char *what)
+{
+    if (!ok)
+    {
+        std::printf("  FAIL: %s\n", what);
+        ++failures;
+    }
+}
+
+struct SimTask
+{
+    const char *name;
+    uint32_t period_us;
+    uint32_t cost_us;
+    uint32_t next_due;
+    uint32_t worst_latency_us;
+    uint32_t missed;
+};
+
+struct SimScheduler
+{
+    std::vector<SimTask> tasks;
+
+    void start()
+    {
+        for (SimTask &task : tasks)
+        {
+            task.next_due = sim_micros;
+            task.worst_latency_us = 0U;
+            task.missed = 0U;
+        }
+    }
+
+    void execute()
+    {
+        for (SimTask &task : tasks)
+        {
+            if (static_cast<int32_t>(sim_micros - task.next_due) < 0)
+            {
+                continue;
+            }
+            const uint32_t latency = sim_micros - task.next_due;
+            task.worst_latency_us = (latency > task.worst_latency_us) ? latency : task.worst_latency_us;
+            task.missed += latency / task.period_us;
+            sim_micros += task.cost_us;
+            task.next_due += task.period_us;
+        }
+    }
+};
+
+// Hard real-time tier of comms_bms.cpp
+std::vector<SimTask> realtime_tasks()
+{
+    return {
+        {"battery CAN", 2000U, 40U, 0U, 0U, 0U},
+        {"BMS 2ms", 2000U, 20U, 0U, 0U, 0U},
+        {"shunt 10ms", 10000U, 10U, 0U, 0U, 0U},
+        {"battery poll", 13000U, 15U, 0U, 0U, 0U},
+        {"contactors", 20000U, 25U, 0U, 0U, 0U},
+        {"BMS 100ms", 100000U, 300U, 0U, 0U, 0U},
+        {"BMS 1000ms", 1000000U, 900U, 0U, 0U, 0U},
+    };
+}
+
+// Best-effort tier
+std::vector<SimTask> best_effort_tasks()
+{
+    return {
+        {"BMS 10ms", 10000U, 250U, 0U, 0U, 0U},
+        {"monitor 100ms", 100000U, 40U, 0U, 0U, 0U},
+        {"monitor 1000ms", 1000000U, 2U, 0U, 0U, 0U},
+        {"print debug", 1000000U, 1U, 0U, 0U, 0U},
+        {"led blink", 1000000U, 2U, 0U, 0U, 0U},
+        {"system load", 100000U, 30U, 0U, 0U, 0U},
+    };
+}
+
+constexpr uint32_t kSimulatedUs = 5000000U;
+constexpr uint32_t kCommandPeriodUs = 25000U;
+constexpr int kReportLines = 80;
+constexpr uint32_t kLineFormatUs = 2U;
+const char kReportLine[] = "  Module 3: 3.912V 3.905V 3.921V 3.917V  T 24.5C 25.0C  bal 0x00\n";
+
+SimScheduler realtime_scheduler;
+SimScheduler scheduler;
+std::unique_ptr<ConsolePrinter> printer;
+
+constexpr size_t kDrainBudgetBytes = 512U;
+constexpr uint32_t kDrainBudgetUs = 200U;
+
+void run_realtime_tier()
+{
+    realtime_scheduler.execute();
+}
+
+void print_report_blocking()
+{
+    for (int line = 0; line < kReportLines; ++line)
+    {
+        sim_micros += kLineFormatUs;
+        Serial.write(reinterpret_cast<const uint8_t *>(kReportLine), sizeof(kReportLine) - 1U);
+    }
+}
+
+void print_report_console()
+{
+    for (int line = 0; line < kReportLines; ++line)
+    {
+        sim_micros += kLineFormatUs;
+        printer->print(kReportLine);
+    }
+}
+
+struct Result
+{
+    std::vector<SimTask> tasks;
+    uint32_t delivered;
+    uint32_t dropped;
+    uint32_t reports;
+};
+
+Result run(bool two_tier, uint32_t drain_us, bool console_load)
+{
+    sim_micros = 1000U;
+    Serial.reset(drain_us);
+    printer.reset(new ConsolePrinter());
+    realtime_scheduler.tasks = realtime_tasks();
+    scheduler.tasks = best_effort_tasks();
+    if (!two_tier)
+    {
+        // Original wiring: every runnable on one scheduler
+        scheduler.tasks.insert(scheduler.tasks.begin(), realtime_scheduler.tasks.begin(), realtime_scheduler.tasks.end());
+        realtime_scheduler.tasks.clear();
+    }
+    realtime_scheduler.start();
+    scheduler.start();
+
+    uint32_t next_command = sim_micros;
+    uint32_t reports = 0U;
+    const uint32_t end = sim_micros + kSimulatedUs;
+    while (static_cast<int32_t>(sim_micros - end) < 0)
+    {
+        if (two_tier)
+        {
+            run_realtime_tier();
+        }
+        scheduler.execute();
+        if (two_tier)
+        {
+            run_realtime_tier();
+        }
+        if (console_load && static_cast<int32_t>(sim_micros - next_command) >= 0)
+        {
+            next_command += kCommandPeriodUs;
+            ++reports;
+            if (two_tier)
+            {
+                print_report_console();
+            }
+            else
+            {
+                print_report_blocking();
+            }
+        }
+        if (two_tier)
+        {
+            printer->drain(kDrainBudgetBytes, kDrainBudgetUs);
+        }
+        sim_micros += 1U; // loop() overhead
+    }
+
+    Result result;
+    result.tasks = two_tier ? realtime_scheduler.tasks : scheduler.tasks;
+    result.tasks.resize(realtime_tasks().size());
+    result.delivered = Serial.delivered;
+    result.dropped = printer->dropped_bytes();
+    result.reports = reports;
+    return result;
+}
+
+void print_result(const char *label, const Result &result)
+{
+    std::printf("  %s: %lu reports, %lu bytes delivered, %lu dropped\n",
+                label,
+                static_cast<unsigned long>(result.reports),
+                static_cast<unsigned long>(result.delivered),
+                static_cast<unsigned long>(result.dropped));
+    for (const SimTask &task : result.tasks)
+    {
+        std::printf("    %-13s period %7.1f ms  worst latency %8.1f us  missed %lu\n",
+                    task.name,
+                    task.period_us / 1000.0,
+                    static_cast<double>(task.worst_latency_us),
+                    static_cast<unsigned long>(task.missed));
+    }
+}
+
+uint32_t worst_2ms_latency(const Result &result)
+{
+    return (result.tasks[0].worst_latency_us > result.tasks[1].worst_latency_us) ? result.tasks[0].worst_latency_us
+                                                                                   : result.tasks[1].worst_latency_us;
+}
+
+bool no_missed_slots(const Result &result)
+{
+    for (const SimTask &task : result.tasks)
+    {
+        if (task.missed != 0U || task.worst_latency_us >= task.period_us)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void test_idle_console()
+{
+    std::printf("No console load\n");
+    const Result single = run(false, 2U, false);
+    const Result two = run(true, 2U, false);
+    print_result("single tier", single);
+    print_result("two tier", two);
+    check(no_missed_slots(single) && no_missed_slots(two), "no missed slots without console load");
+}
+
+// host_keeps_up: the host reads faster than reports are produced
+void test_host_reading(const char *label, uint32_t drain_us, bool host_keeps_up)
+{
+    std::printf("%s (%lu us/byte)\n", label, static_cast<unsigned long>(drain_us));
+    const Result single = run(false, drain_us, true);
+    const Result two = run(true, drain_us, true);
+    print_result("single tier", single);
+    print_result("two tier", two);
+    std::printf("  worst 2 ms task latency: %lu us single tier, %lu us two tier\n",
+                static_cast<unsigned long>(worst_2ms_latency(single)),
+                static_cast<unsigned long>(worst_2ms_latency(two)));
+    check(no_missed_slots(two), "two tier: every real-time task starts within its period");
+    check(worst_2ms_latency(two) <= worst_2ms_latency(single), "two tier is not worse than single tier");
+    if (host_keeps_up)
+    {
+        check(two.dropped == 0U, "two tier: nothing dropped while the host keeps up");
+    }
+    else
+    {
+        check(two.dropped > 0U, "two tier: excess output is dropped instead of waiting for the host");
+        check(two.reports >= kSimulatedUs / kCommandPeriodUs - 1U, "console keeps serving commands");
+    }
+    check(two.delivered + SimSerial::kCapacity >= single.delivered, "two tier: console throughput kept");
+}
+
+void test_host_stalled()
+{
+    std::printf("Host not reading\n");
+    const Result two = run(true, 0U, true);
+    print_result("two tier", two);
+    check(no_missed_slots(two), "two tier: every real-time task starts within its period");
+    check(two.dropped > 0U, "output is dropped instead of waiting for the host");
+    check(two.reports >= kSimulatedUs / kCommandPeriodUs - 1U, "console keeps serving commands");
+}
+} // namespace
+
+int main()
+{
+    test_idle_console();
+    test_host_reading("Fast host", 2U, true);
+    test_host_reading("Slow host", 20U, false);
+    test_host_stalled();
+
+    std::printf("%s\n", failures == 0 ? "Two-tier scheduling test PASSED" : "Two-tier scheduling test FAILED");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,249 @@
+// Host test for UsageStatistics.
+//
+// 1) ASTM E1049 worked example (-2 1 -3 5 -1 3 -4 4 -2), scaled to SOC.
+// 2) Random SOC profiles (random walk with drive/charge segments and sensor
+//    noise) sampled at 1 Hz: the streaming rainflow histogram plus residue
+//    must match an offline reference that extracts reversals from the whole
+//    profile and runs the textbook rainflow on a std::vector.
+// 3) Throughput and time-histogram bookkeeping against direct sums.
+//
+// Build: pio run -e native_usage_statistics_test && .pio/build/native_usage_statistics_test/program
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "bms/usage_statistics.h"
+
+namespace
+{
+int failures = 0;
+
+void check(bool ok, const char *what)
+{
+    if (!ok)
+    {
+        std::printf("  FAIL: %s\n", what);
+        ++failures;
+    }
+}
+
+// Offline peak/valley extraction with the same hysteresis definition.
+std::vector<float> reference_reversals(const std::vector<float> &x)
+{
+    std::vector<float> out;
+    if (x.empty())
+    {
+        return out;
+    }
+    out.push_back(x[0]);
+
+    size_t i = 1;
+    int dir = 0;
+    float ext = x[0];
+    for (; i < x.size() && dir == 0; ++i)
+    {
+        if (std::fabs(x[i] - x[0]) >= USAGE_RAINFLOW_HYST)
+        {
+            dir = (x[i] > x[0]) ? 1 : -1;
+            ext = x[i];
+        }
+    }
+    for (; i < x.size(); ++i)
+    {
+        if (dir * (x[i] - ext) > 0.0f)
+        {
+            ext = x[i];
+        }
+        else if (std::fabs(ext - x[i]) >= USAGE_RAINFLOW_HYST)
+        {
+            out.push_back(ext);
+            dir = -dir;
+            ext = x[i];
+        }
+    }
+    if (dir != 0)
+    {
+        out.push_back(ext);
+    }
+    return out;
+}
+
+// Textbook ASTM E1049 rainflow on the full reversal list, half-cycle units.
+void reference_rainflow(const std::vector<float> &rev, uint32_t hist[USAGE_DOD_BINS])
+{
+    std::vector<float> s;
+    for (float p : rev)
+    {
+        s.push_back(p);
+        while (s.size() >= 3)
+        {
+            const size_t n = s.size();
+            const float X = std::fabs(s[n - 1] - s[n - 2]);
+            const float Y = std::fabs(s[n - 2] - s[n - 3]);
+            if (X < Y)
+            {
+                break;
+            }
+            if (n == 3)
+            {
+                hist[UsageStatistics::dod_bin(Y)] += 1;
+                s.erase(s.begin());
+            }
+            else
+            {
+                hist[UsageStatistics::dod_bin(Y)] += 2;
+                s.erase(s.end() - 3, s.end() - 1);
+            }
+        }
+    }
+    for (size_t k = 1; k < s.size(); ++k)
+    {
+        hist[UsageStatistics::dod_bin(std::fabs(s[k] - s[k - 1]))] += 1;
+    }
+}
+
+void streaming_histogram(const UsageStatistics &us, uint32_t hist[USAGE_DOD_BINS])
+{
+    for (int b = 0; b < USAGE_DOD_BINS; ++b)
+    {
+        hist[b] = us.data().dod_half_cycles[b];
+    }
+    us.residue_half_cycles(hist);
+}
+
+void test_astm_example()
+{
+    const float pts[] = {-2, 1, -3, 5, -1, 3, -4, 4, -2};
+    UsageStatistics us;
+    us.restore(UsageStatisticsData{}, 94.0f);
+    for (float p : pts)
+    {
+        us.add_soc_sample(0.5f + 0.04f * p);
+    }
+
+    uint32_t hist[USAGE_DOD_BINS] = {};
+    streaming_histogram(us, hist);
+
+    // ASTM result: range 3 -> 0.5, 4 -> 1.5, 6 -> 0.5, 8 -> 1.0, 9 -> 0.5 cycles.
+    // Scaled by 0.04: 0.12/0.16 -> bin 1, 0.24 -> bin 2, 0.32/0.36 -> bin 3.
+    const uint32_t expected[USAGE_DOD_BINS] = {0, 4, 1, 3, 0, 0, 0, 0, 0, 0};
+    bool ok = true;
+    for (int b = 0; b < USAGE_DOD_BINS; ++b)
+    {
+        ok = ok && (hist[b] == expected[b]);
+    }
+    std::printf("ASTM example: bins[1..3] = %u %u %u half cycles\n",
+                static_cast<unsigned>(hist[1]), static_cast<unsigned>(hist[2]),
+                static_cast<unsigned>(hist[3]));
+    check(ok, "ASTM E1049 example");
+}
+
+void test_random_profiles()
+{
+    std::mt19937 rng(2024);
+    std::uniform_real_distribution<float> u01(0.0f, 1.0f);
+    std::normal_distribution<float> noise(0.0f, 0.002f);
+
+    const int profiles = 200;
+    int mismatches = 0;
+    uint32_t max_depth = 0U;
+    uint64_t total_half = 0U;
+
+    for (int p = 0; p < profiles; ++p)
+    {
+        std::vector<float> soc;
+        float s = 0.2f + 0.6f * u01(rng);
+        const int segments = 20 + static_cast<int>(u01(rng) * 200.0f);
+        for (int seg = 0; seg < segments; ++seg)
+        {
+            // Mix of short regen/drive wiggles and long charge/discharge ramps.
+            const bool ramp = u01(rng) < 0.2f;
+            const float rate = (ramp ? 0.0003f : 0.0015f) * (u01(rng) < 0.5f ? -1.0f : 1.0f);
+            const int len = 5 + static_cast<int>(u01(rng) * (ramp ? 2000.0f : 60.0f));
+            for (int k = 0; k < len; ++k)
+            {
+                s = std::fmin(1.0f, std::fmax(0.0f, s + rate * (0.5f + u01(rng))));
+                soc.push_back(s + noise(rng));
+            }
+        }
+
+        UsageStatistics us;
+        us.restore(UsageStatisticsData{}, 94.0f);
+        for (float v : soc)
+        {
+            us.add_soc_sample(v);
+            if (us.residue_depth() > max_depth)
+            {
+                max_depth = us.residue_depth();
+            }
+        }
+
+        uint32_t got[USAGE_DOD_BINS] = {};
+        uint32_t ref[USAGE_DOD_BINS] = {};
+        streaming_histogram(us, got);
+        reference_rainflow(reference_reversals(soc), ref);
+
+        bool same = us.residue_overflows() == 0U;
+        for (int b = 0; b < USAGE_DOD_BINS; ++b)
+        {
+            same = same && (got[b] == ref[b]);
+            total_half += got[b];
+        }
+        mismatches += same ? 0 : 1;
+    }
+
+    std::printf("Random profiles: %d/%d match reference, %llu half cycles, max residue depth %u/%d\n",
+                profiles - mismatches, profiles, static_cast<unsigned long long>(total_half),
+                static_cast<unsigned>(max_depth), USAGE_RAINFLOW_STACK);
+    check(mismatches == 0, "streaming rainflow matches reference");
+}
+
+void test_throughput_and_exposure()
+{
+    UsageStatistics us;
+    us.restore(UsageStatisticsData{}, 94.0f);
+
+    // 1 h charge at 47 A (0.5C) / 400 V / 25 degC, 30 min discharge at 188 A (2C) / 380 V / -25 degC.
+    for (int i = 0; i < 3600; ++i)
+    {
+        us.update(1.0f, 0.5f, 47.0f, 400.0f, 25.0f);
+    }
+    for (int i = 0; i < 1800; ++i)
+    {
+        us.update(1.0f, 0.5f, -188.0f, 380.0f, -25.0f);
+    }
+
+    const UsageStatisticsData &d = us.data();
+    std::printf("Throughput: charge %u mAh / %u Wh, discharge %u mAh / %u Wh\n",
+                static_cast<unsigned>(d.charge_mAh), static_cast<unsigned>(d.charge_Wh),
+                static_cast<unsigned>(d.discharge_mAh), static_cast<unsigned>(d.discharge_Wh));
+
+    check(d.charge_mAh >= 46990U && d.charge_mAh <= 47000U, "charge mAh");
+    check(d.discharge_mAh >= 93990U && d.discharge_mAh <= 94000U, "discharge mAh");
+    check(d.charge_Wh >= 18799U && d.charge_Wh <= 18800U, "charge Wh");
+    check(d.discharge_Wh >= 35719U && d.discharge_Wh <= 35720U, "discharge Wh");
+    check(d.temp_time_s[UsageStatistics::temp_bin(25.0f)] == 3600U, "time at 20..30 degC");
+    check(d.temp_time_s[UsageStatistics::temp_bin(-25.0f)] == 1800U, "time at -30..-20 degC");
+    check(d.crate_time_s[UsageStatistics::crate_bin(0.5f)] == 3600U, "time at 0.5..1C charge");
+    check(d.crate_time_s[UsageStatistics::crate_bin(-2.0f)] == 1800U, "time at 2..3C discharge");
+    check(UsageStatistics::temp_bin(-40.0f) == 0U && UsageStatistics::temp_bin(70.0f) == USAGE_TEMP_BINS - 1,
+          "temperature bins open ended");
+    check(UsageStatistics::crate_bin(0.0f) == 5U, "rest C-rate bin");
+}
+} // namespace
+
+int main()
+{
+    std::printf("sizeof(UsageStatisticsData) = %u bytes, sizeof(UsageStatistics) = %u bytes\n",
+                static_cast<unsigned>(sizeof(UsageStatisticsData)),
+                static_cast<unsigned>(sizeof(UsageStatistics)));
+
+    test_astm_example();
+    test_random_profiles();
+    test_throughput_and_exposure();
+
+    std::printf("%s\n", failures == 0 ? "Usage statistics test PASSED" : "Usage statistics test FAILED");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,201 @@
+#pragma once
+
+// Host stand-in for ACAN_T4 used by the replay engine: acceptance filters
+// with callbacks, a receive buffer that deliver() fills the way the FlexCAN
+// interrupt does (a rejected or overflowing frame is counted, not queued),
+// receive() and dispatchReceivedMessage() with the library's semantics.
+// Transmitted frames go to on_transmit when set.
+
+#include <Arduino.h>
+#include <stdint.h>
+
+#include <deque>
+#include <vector>
+
+enum tFrameKind
+{
+    kData,
+    kRemote,
+    kDataAndRemote
+};
+
+enum tFrameFormat
+{
+    kStandard,
+    kExtended
+};
+
+class CANMessage
+{
+public:
+    uint32_t id = 0;
+    bool ext = false;
+    bool rtr = false;
+    uint8_t idx = 0;
+    uint8_t len = 0;
+    uint16_t timestamp = 0;
+    union
+    {
+        uint64_t data64;
+        uint8_t data[8];
+    };
+
+    CANMessage()
+        : data64(0)
+    {
+    }
+};
+
+typedef void (*ACANCallBackRoutine)(const CANMessage &inMessage);
+
+class ACANPrimaryFilter
+{
+public:
+    ACANPrimaryFilter(tFrameKind inKind, tFrameFormat inFormat, ACANCallBackRoutine inCallBackRoutine = nullptr)
+        : kind(inKind), format(inFormat), mask(0U), acceptance(0U), callback(inCallBackRoutine)
+    {
+    }
+    ACANPrimaryFilter(tFrameKind inKind, tFrameFormat inFormat, uint32_t inIdentifier,
+                      ACANCallBackRoutine inCallBackRoutine = nullptr)
+        : kind(inKind), format(inFormat), mask(0x1FFFFFFFU), acceptance(inIdentifier), callback(inCallBackRoutine)
+    {
+    }
+    ACANPrimaryFilter(tFrameKind inKind, tFrameFormat inFormat, uint32_t inMask, uint32_t inAcceptance,
+                      ACANCallBackRoutine inCallBackRoutine = nullptr)
+        : kind(inKind), format(inFormat), mask(inMask), acceptance(inAcceptance), callback(inCallBackRoutine)
+    {
+    }
+
+    bool matches(const CANMessage &message) const
+    {
+        const bool kind_ok = (kind == kDataAndRemote) || ((kind == kRemote) == message.rtr);
+        const bool format_ok = (format == kExtended) == message.ext;
+        return kind_ok && format_ok && ((message.id & mask) == (acceptance & mask));
+    }
+
+    tFrameKind kind;
+    tFrameFormat format;
+    uint32_t mask;
+    uint32_t acceptance;
+    ACANCallBackRoutine callback;
+};
+
+class ACAN_T4_Settings
+{
+public:
+    explicit ACAN_T4_Settings(uint32_t inWhishedBitRate)
+        : bitrate(inWhishedBitRate)
+    {
+    }
+
+    uint32_t actualBitRate() const { return bitrate; }
+    bool exactBitRate() const { return true; }
+    int32_t ppmFromWishedBitRate() const { return 0; }
+    uint32_t samplePointFromBitStart() const { return 75U; }
+
+    uint32_t bitrate;
+    uint32_t mReceiveBufferSize = 32;
+    uint32_t mTransmitBufferSize = 16;
+    uint32_t mBitRatePrescaler = 0;
+    uint32_t mPropagationSegment = 0;
+    uint32_t mPhaseSegment1 = 0;
+    uint32_t mPhaseSegment2 = 0;
+    uint32_t mRJW = 0;
+    bool mTripleSampling = false;
+};
+
+class ACAN_T4;
+typedef void (*ACANTransmitHook)(const ACAN_T4 &bus, const CANMessage &message);
+
+class ACAN_T4
+{
+public:
+    uint32_t begin(const ACAN_T4_Settings &inSettings, const ACANPrimaryFilter inPrimaryFilters[] = nullptr,
+                   uint32_t inPrimaryFilterCount = 0)
+    {
+        receive_capacity = inSettings.mReceiveBufferSize;
+        filters.assign(inPrimaryFilters, inPrimaryFilters + inPrimaryFilterCount);
+        rx.clear();
+        started = true;
+        return 0U;
+    }
+
+    // Replay side: a frame arrives on the bus (the receive interrupt).
+    void deliver(CANMessage message)
+    {
+        if (!filters.empty())
+        {
+            size_t i = 0;
+            while (i < filters.size() && !filters[i].matches(message))
+            {
+                ++i;
+            }
+            if (i == filters.size())
+            {
+                ++rejected;
+                return;
+            }
+            message.idx = static_cast<uint8_t>(i);
+        }
+        if (rx.size() >= receive_capacity)
+        {
+            ++overflows;
+            return;
+        }
+        message.timestamp = static_cast<uint16_t>(micros());
+        rx.push_back(message);
+        ++accepted;
+    }
+
+    bool receive(CANMessage &outMessage)
+    {
+        if (rx.empty())
+        {
+            return false;
+        }
+        outMessage = rx.front();
+        rx.pop_front();
+        return true;
+    }
+
+    bool dispatchReceivedMessage()
+    {
+        CANMessage message;
+        const bool received = receive(message);
+        if (received && message.idx < filters.size() && filters[message.idx].callback != nullptr)
+        {
+            filters[message.idx].callback(message);
+        }
+        return received;
+    }
+
+    bool tryToSend(const CANMessage &inMessage)
+    {
+        ++transmitted;
+        if (on_transmit != nullptr)
+        {
+            on_transmit(*this, inMessage);
+        }
+        return true;
+    }
+
+    uint32_t receiveBufferCount() const { return static_cast<uint32_t>(rx.size()); }
+
+    std::vector<ACANPrimaryFilter> filters;
+    std::deque<CANMessage> rx;
+    uint32_t receive_capacity = 32U;
+    bool started = false;
+    uint32_t accepted = 0U;
+    uint32_t rejected = 0U;
+    uint32_t overflows = 0U;
+    uint32_t transmitted = 0U;
+    ACANTransmitHook on_transmit = nullptr;
+
+    static ACAN_T4 can1;
+    static ACAN_T4 can2;
+    static ACAN_T4 can3;
+};
+
+inline ACAN_T4 ACAN_T4::can1;
+inline ACAN_T4 ACAN_T4::can2;
+inline ACAN_T4 ACAN_T4::can3;
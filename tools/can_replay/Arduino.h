@@ -0,0 +1,234 @@
+#pragma once
+
+// Host shim for the parts of the Arduino/Teensy core the firmware uses, so
+// the decode and BMS layers build and run on Linux (see main.cpp).
+//
+// - Time is virtual: micros()/millis() read replay_time_us, which only the
+//   replay engine advances. delay() advances it too.
+// - Pins keep their level; the replay engine drives the contactor feedback
+//   inputs with replay_drive_pin().
+// - Serial and SerialUSB1 write to a FILE (nullptr discards) and never have
+//   input.
+
+#include <math.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+
+typedef uint8_t byte;
+typedef uint32_t u_int32_t;
+
+#define HEX 16
+#define DEC 10
+#define LOW 0
+#define HIGH 1
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define LED_BUILTIN 13
+#define PROGMEM
+#define FASTRUN
+#define DMAMEM
+#define lowByte(w) ((uint8_t)((w) & 0xff))
+#define highByte(w) ((uint8_t)((w) >> 8))
+
+#define F_CPU 600000000u
+#define F_CPU_ACTUAL 600000000u
+#define E2END 0x10BB
+
+inline void *memcpy_P(void *destination, const void *source, size_t size)
+{
+    return memcpy(destination, source, size);
+}
+inline void __disable_irq() {}
+inline void __enable_irq() {}
+
+// Virtual clock in µs since boot
+inline uint64_t replay_time_us = 0U;
+
+inline uint32_t micros()
+{
+    return static_cast<uint32_t>(replay_time_us);
+}
+
+inline uint32_t millis()
+{
+    return static_cast<uint32_t>(replay_time_us / 1000U);
+}
+
+inline void delay(uint32_t ms)
+{
+    replay_time_us += static_cast<uint64_t>(ms) * 1000U;
+}
+
+inline void delayMicroseconds(uint32_t us)
+{
+    replay_time_us += us;
+}
+
+inline void yield() {}
+
+static constexpr int kReplayPinCount = 64;
+inline uint8_t replay_pin_levels[kReplayPinCount] = {};
+inline bool replay_pin_driven[kReplayPinCount] = {}; // by the replay engine, pull-ups have no effect
+
+inline void pinMode(int pin, int mode)
+{
+    if (pin >= 0 && pin < kReplayPinCount && mode == INPUT_PULLUP && !replay_pin_driven[pin])
+    {
+        replay_pin_levels[pin] = HIGH;
+    }
+}
+
+// Replay side: an external signal drives an input pin
+inline void replay_drive_pin(int pin, int level)
+{
+    if (pin >= 0 && pin < kReplayPinCount)
+    {
+        replay_pin_driven[pin] = true;
+        replay_pin_levels[pin] = (level != LOW) ? HIGH : LOW;
+    }
+}
+
+inline void digitalWrite(int pin, int level)
+{
+    if (pin >= 0 && pin < kReplayPinCount)
+    {
+        replay_pin_levels[pin] = (level != LOW) ? HIGH : LOW;
+    }
+}
+
+inline int digitalRead(int pin)
+{
+    return (pin >= 0 && pin < kReplayPinCount) ? replay_pin_levels[pin] : LOW;
+}
+
+class String : public std::string
+{
+public:
+    String(const char *text = "")
+        : std::string(text)
+    {
+    }
+    String(const std::string &text)
+        : std::string(text)
+    {
+    }
+    String(char c)
+        : std::string(1, c)
+    {
+    }
+    void remove(size_t index) { erase(index); }
+    size_t length() const { return size(); }
+};
+
+class Print;
+
+class Printable
+{
+public:
+    virtual ~Printable() = default;
+    virtual size_t printTo(Print &p) const = 0;
+};
+
+class Print
+{
+public:
+    virtual ~Print() = default;
+    virtual size_t write(uint8_t value) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size)
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            write(buffer[i]);
+        }
+        return size;
+    }
+    virtual int availableForWrite() { return 0; }
+
+    size_t print(const char *text) { return write(reinterpret_cast<const uint8_t *>(text), strlen(text)); }
+    size_t print(const String &text) { return write(reinterpret_cast<const uint8_t *>(text.c_str()), text.size()); }
+    size_t print(char c) { return write(static_cast<uint8_t>(c)); }
+    size_t print(int value, int base = DEC) { return print(static_cast<long>(value), base); }
+    size_t print(unsigned value, int base = DEC) { return print(static_cast<unsigned long>(value), base); }
+    size_t print(long value, int base = DEC)
+    {
+        return (base == DEC) ? printf("%ld", value) : print(static_cast<unsigned long>(value), base);
+    }
+    size_t print(unsigned long value, int base = DEC) { return printf((base == HEX) ? "%lX" : "%lu", value); }
+    size_t print(double value, int digits = 2) { return printf("%.*f", digits, value); }
+    size_t print(const Printable &printable) { return printable.printTo(*this); }
+
+    template <typename T>
+    size_t println(const T &value)
+    {
+        return print(value) + println();
+    }
+    template <typename T>
+    size_t println(const T &value, int format)
+    {
+        return print(value, format) + println();
+    }
+    size_t println() { return print("\r\n"); }
+
+    size_t printf(const char *format, ...)
+    {
+        char buffer[256];
+        va_list args;
+        va_start(args, format);
+        const int length = vsnprintf(buffer, sizeof(buffer), format, args);
+        va_end(args);
+        if (length <= 0)
+        {
+            return 0;
+        }
+        return write(reinterpret_cast<const uint8_t *>(buffer),
+                     (static_cast<size_t>(length) < sizeof(buffer)) ? static_cast<size_t>(length) : sizeof(buffer) - 1U);
+    }
+};
+
+class Stream : public Print
+{
+public:
+    virtual int available() { return 0; }
+    virtual int read() { return -1; }
+    virtual int peek() { return -1; }
+};
+
+// USB serial: output goes to sink, input is empty
+class ReplaySerial : public Stream
+{
+public:
+    FILE *sink = nullptr;
+
+    void begin(uint32_t) {}
+    void flush() {}
+    explicit operator bool() const { return true; }
+
+    using Print::write;
+    size_t write(uint8_t value) override
+    {
+        if (sink != nullptr)
+        {
+            fputc(value, sink);
+        }
+        return 1;
+    }
+    size_t write(const uint8_t *buffer, size_t size) override
+    {
+        if (sink != nullptr)
+        {
+            fwrite(buffer, 1, size, sink);
+        }
+        return size;
+    }
+    int availableForWrite() override { return 4096; }
+};
+
+inline ReplaySerial Serial;
+inline ReplaySerial SerialUSB1;
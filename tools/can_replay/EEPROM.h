@@ -0,0 +1,38 @@
+#pragma once
+
+// Emulated Teensy 4.1 EEPROM in RAM, erased (0xFF) at start, so every replay
+// begins from the firmware defaults.
+
+#include <Arduino.h>
+
+class EEPROMClass
+{
+public:
+    EEPROMClass()
+    {
+        memset(m, 0xFF, sizeof(m));
+    }
+
+    uint8_t read(int address) { return m[address]; }
+    void write(int address, uint8_t value) { m[address] = value; }
+    void update(int address, uint8_t value) { m[address] = value; }
+    uint16_t length() { return sizeof(m); }
+
+    template <typename T>
+    T &get(int address, T &value)
+    {
+        memcpy(&value, m + address, sizeof(value));
+        return value;
+    }
+    template <typename T>
+    const T &put(int address, const T &value)
+    {
+        memcpy(m + address, &value, sizeof(value));
+        return value;
+    }
+
+private:
+    uint8_t m[E2END + 1];
+};
+
+inline EEPROMClass EEPROM;
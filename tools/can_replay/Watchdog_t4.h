@@ -0,0 +1,33 @@
+#pragma once
+
+// Watchdog that never bites: the replay clock is virtual, so a slow host
+// step must not count as a firmware stall.
+
+#include <Arduino.h>
+
+struct WDT_timings_t
+{
+    uint32_t timeout = 1000;
+    uint32_t window = 0;
+    uint32_t trigger = 0;
+    void (*callback)() = nullptr;
+    int pin = 0;
+};
+
+enum
+{
+    WDT1,
+    WDT2,
+    WDT3
+};
+
+template <int N>
+class WDT_T4
+{
+public:
+    void begin(WDT_timings_t) {}
+    void feed() { ++feeds; }
+    void reset() {}
+
+    uint32_t feeds = 0U;
+};
@@ -0,0 +1,22 @@
+#pragma once
+
+// I2C bus without devices: every address is NACKed, so the external AT24C
+// is reported offline and the blackbox keeps its records in RAM.
+
+#include <Arduino.h>
+
+class TwoWire
+{
+public:
+    void begin() {}
+    void setClock(uint32_t) {}
+    void beginTransmission(uint8_t) {}
+    size_t write(uint8_t) { return 1U; }
+    size_t write(const uint8_t *, size_t n) { return n; }
+    uint8_t endTransmission(bool = true) { return 2; } // address NACK
+    uint8_t requestFrom(uint8_t, uint8_t) { return 0; }
+    int read() { return -1; }
+    int available() { return 0; }
+};
+
+inline TwoWire Wire;
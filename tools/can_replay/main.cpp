@@ -0,0 +1,727 @@
+// Host replay of recorded CAN traffic through the production firmware.
+//
+// All of src/ except main.cpp is built for Linux against the shim headers
+// in this directory (Arduino core, ACAN_T4, EEPROM, Wire, WDT_T4). The
+// replay runs the setup() sequence of main.cpp, then delivers each logged
+// frame to its ACAN_T4 bus at the logged time, so the frames take the same
+// path as on target: acceptance filters, receive buffer, raw capture, the
+// decoders (BatteryModule, Shunt_IVTS, BMS) and the rate tables.
+//
+// Time is virtual: micros()/millis() follow the log timestamps and loop()
+// runs on every 1 ms tick and after every frame, so a replay gives the same
+// result at any speed. The contactor feedback inputs follow their coil
+// outputs and the negative contactor and contactor supply read as present;
+// there is no I2C EEPROM and the internal EEPROM starts erased.
+//
+// Input formats (bus from the interface name or ASC channel: can1/1 is the
+// shunt bus, can2/2 the battery bus, can3/3 the BMS bus, as exported by the
+// 'X c' console command; -b maps other names):
+//   candump -l     (1700000000.123456) can0 123#1122334455667788
+//   candump -ta    (1700000000.123456)  can0  123   [8]  11 22 33 44 55 66 77 88
+//   Vector ASC     0.012345 1  123   Rx   d 8 11 22 33 44 55 66 77 88
+//
+// Output: a CSV trace of the scalar signals of the signal registry every
+// trace period (-a adds the cell and module arrays), optionally the frames
+// the firmware transmitted as a candump log, and a report of the decode
+// throughput and the final states on stderr.
+//
+// Build: pio run -e native_can_replay
+// Usage: program [options] log.candump|log.asc ('-' reads stdin)
+//   -x factor   speed: 1 real time, 10 ten times faster, 0 as fast as possible (default)
+//   -o file     trace CSV (default replay_trace.csv, '-' disables)
+//   -p ms       trace period (default 100)
+//   -a          trace the array signals too
+//   -T file     write the transmitted frames as a candump log
+//   -b name=N   replay interface or channel 'name' on canN
+//   -t ms       keep running after the last frame (default 0)
+//   -v          console output to stderr
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Arduino.h>
+#include <ACAN_T4.h>
+#include <Watchdog_t4.h>
+
+#include "settings.h"
+#include "bms/battery i3/pack.h"
+#include "bms/battery_manager.h"
+#include "bms/contactor_manager.h"
+#include "bms/hv_monitor.h"
+#include "comms_bms.h"
+#include "serial_console.h"
+#include "signal_registry.h"
+
+// Globals of main.cpp
+WDT_T4<WDT3> wdt;
+BatteryPack batteryPack(MODULES_PER_PACK);
+Shunt_IVTS shunt;
+Contactormanager contactor_manager;
+HVMonitor hv_monitor;
+BMS battery_manager(batteryPack, shunt, contactor_manager);
+
+namespace
+{
+constexpr uint32_t kTickUs = 1000U;
+
+struct Frame
+{
+    uint64_t time_us; // log time
+    ACAN_T4 *bus;
+    CANMessage message;
+};
+
+struct Alias
+{
+    std::string name;
+    ACAN_T4 *bus;
+};
+
+struct Options
+{
+    double speed = 0.0;
+    const char *trace_path = "replay_trace.csv";
+    uint32_t trace_period_ms = 100U;
+    bool trace_arrays = false;
+    const char *tx_path = nullptr;
+    uint32_t tail_ms = 0U;
+    bool verbose = false;
+    std::vector<Alias> aliases;
+};
+
+ACAN_T4 *const kBuses[] = {&ACAN_T4::can1, &ACAN_T4::can2, &ACAN_T4::can3};
+
+ACAN_T4 *bus_by_number(long number)
+{
+    return (number >= 1 && number <= 3) ? kBuses[number - 1] : nullptr;
+}
+
+const char *bus_name(const ACAN_T4 *bus)
+{
+    for (size_t i = 0; i < 3U; ++i)
+    {
+        if (kBuses[i] == bus)
+        {
+            static const char *const names[] = {"can1", "can2", "can3"};
+            return names[i];
+        }
+    }
+    return "?";
+}
+
+ACAN_T4 *resolve_bus(const Options &options, const std::string &name)
+{
+    for (const Alias &alias : options.aliases)
+    {
+        if (alias.name == name)
+        {
+            return alias.bus;
+        }
+    }
+    if (name.size() == 4U && name.compare(0, 3, "can") == 0)
+    {
+        return bus_by_number(name[3] - '0');
+    }
+    char *end = nullptr;
+    const long channel = std::strtol(name.c_str(), &end, 10);
+    return (end != name.c_str() && *end == '\0') ? bus_by_number(channel) : nullptr;
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------
+// Log parsing
+//---------------------------------------------------------------------------------------------------------------------------------------------
+struct LogReader
+{
+    const Options &options;
+    uint32_t lines = 0U;
+    uint32_t skipped = 0U;   // frame lines with an unknown bus or bad syntax
+    bool asc_hex = true;     // ASC "base hex|dec"
+
+    static int hex_digit(char c)
+    {
+        if (c >= '0' && c <= '9')
+        {
+            return c - '0';
+        }
+        if (c >= 'A' && c <= 'F')
+        {
+            return c - 'A' + 10;
+        }
+        if (c >= 'a' && c <= 'f')
+        {
+            return c - 'a' + 10;
+        }
+        return -1;
+    }
+
+    static bool parse_bytes(const char *text, CANMessage *message)
+    {
+        message->len = 0U;
+        while (*text != '\0' && *text != '\n' && *text != '\r')
+        {
+            if (*text == ' ')
+            {
+                ++text;
+                continue;
+            }
+            const int high = hex_digit(text[0]);
+            const int low = (high >= 0) ? hex_digit(text[1]) : -1;
+            if (low < 0 || message->len == 8U)
+            {
+                return false;
+            }
+            message->data[message->len++] = static_cast<uint8_t>((high << 4) | low);
+            text += 2;
+        }
+        return true;
+    }
+
+    // (seconds.micros) iface ID#DATA  or  (seconds.micros) iface ID [len] DATA
+    bool parse_candump(const char *line, Frame *frame)
+    {
+        unsigned long long seconds = 0U;
+        unsigned long micros_part = 0U;
+        char interface[32];
+        int consumed = 0;
+        if (std::sscanf(line, " (%llu.%lu) %31s %n", &seconds, &micros_part, interface, &consumed) != 3)
+        {
+            return false;
+        }
+        frame->time_us = seconds * 1000000ULL + micros_part;
+        frame->bus = resolve_bus(options, interface);
+
+        const char *rest = line + consumed;
+        char *end = nullptr;
+        const unsigned long id = std::strtoul(rest, &end, 16);
+        const size_t id_digits = static_cast<size_t>(end - rest);
+        if (id_digits == 0U)
+        {
+            return false;
+        }
+        frame->message.id = static_cast<uint32_t>(id);
+        frame->message.ext = (id_digits > 3U);
+        if (*end == '#')
+        {
+            if (end[1] == 'R')
+            {
+                frame->message.rtr = true;
+                return true;
+            }
+            return parse_bytes(end + 1, &frame->message);
+        }
+        unsigned len = 0U;
+        if (std::sscanf(end, " [%u] %n", &len, &consumed) != 1 || len > 8U)
+        {
+            return false;
+        }
+        if (std::strstr(end, "remote request") != nullptr)
+        {
+            frame->message.rtr = true;
+            frame->message.len = static_cast<uint8_t>(len);
+            return true;
+        }
+        return parse_bytes(end + consumed, &frame->message) && frame->message.len == len;
+    }
+
+    // time channel ID[x] Rx|Tx d|r len bytes...
+    bool parse_asc(const char *line, Frame *frame)
+    {
+        double seconds = 0.0;
+        char channel[16];
+        char id_text[16];
+        char direction[8];
+        char kind = 0;
+        unsigned len = 0U;
+        int consumed = 0;
+        if (std::sscanf(line, " %lf %15s %15s %7s %c %x%n", &seconds, channel, id_text, direction, &kind, &len, &consumed) !=
+                6 ||
+            (kind != 'd' && kind != 'r') || len > 8U)
+        {
+            return false;
+        }
+        frame->time_us = static_cast<uint64_t>(seconds * 1.0e6 + 0.5);
+        frame->bus = resolve_bus(options, channel);
+        const size_t id_length = std::strlen(id_text);
+        frame->message.ext = (id_length > 0U && (id_text[id_length - 1U] == 'x' || id_text[id_length - 1U] == 'X'));
+        char *end = nullptr;
+        frame->message.id = static_cast<uint32_t>(std::strtoul(id_text, &end, asc_hex ? 16 : 10));
+        if (kind == 'r')
+        {
+            frame->message.rtr = true;
+            frame->message.len = static_cast<uint8_t>(len);
+            return true;
+        }
+        // Data bytes, then optional fields (Length = ..., BitCount = ...)
+        const char *text = line + consumed;
+        for (unsigned i = 0; i < len; ++i)
+        {
+            unsigned value = 0U;
+            int used = 0;
+            if (std::sscanf(text, " %x%n", &value, &used) != 1 || value > 0xFFU)
+            {
+                return false;
+            }
+            frame->message.data[i] = static_cast<uint8_t>(value);
+            text += used;
+        }
+        frame->message.len = static_cast<uint8_t>(len);
+        return true;
+    }
+
+    // Returns true and fills frame for a frame line.
+    bool parse(const char *line, Frame *frame)
+    {
+        ++lines;
+        *frame = Frame{};
+        const char *text = line;
+        while (*text == ' ' || *text == '\t')
+        {
+            ++text;
+        }
+        if (*text == '\0' || *text == '\n' || *text == '\r' || *text == '/' || *text == '#')
+        {
+            return false;
+        }
+        if (*text == '(')
+        {
+            if (parse_candump(text, frame) && frame->bus != nullptr)
+            {
+                return true;
+            }
+            ++skipped;
+            return false;
+        }
+        if (std::strncmp(text, "base ", 5) == 0)
+        {
+            asc_hex = (std::strstr(text, "hex") != nullptr);
+            return false;
+        }
+        if (*text < '0' || *text > '9')
+        {
+            return false; // ASC header and event lines (date, triggerblock, ...)
+        }
+        if (parse_asc(text, frame))
+        {
+            if (frame->bus != nullptr)
+            {
+                return true;
+            }
+            ++skipped;
+        }
+        // Other ASC events (ErrorFrame, statistics, ...) are not frames
+        return false;
+    }
+};
+
+//---------------------------------------------------------------------------------------------------------------------------------------------
+// Firmware
+//---------------------------------------------------------------------------------------------------------------------------------------------
+FILE *tx_log = nullptr;
+
+void log_transmit(const ACAN_T4 &bus, const CANMessage &message)
+{
+    if (tx_log == nullptr)
+    {
+        return;
+    }
+    CanCaptureRecord record = {};
+    record.time_us = micros();
+    record.id = message.id;
+    record.len = message.len;
+    record.flags = (message.ext ? CanCaptureRecord::kExtended : 0U) | (message.rtr ? CanCaptureRecord::kRemote : 0U);
+    memcpy(record.data, message.data, sizeof(record.data));
+    char line[80];
+    if (can_capture_format_candump(record, bus_name(&bus), line, sizeof(line)) > 0U)
+    {
+        std::fputs(line, tx_log);
+    }
+}
+
+// Contactor feedback and supply inputs (settings.h)
+void update_contactor_plant()
+{
+    const int closed = CONTACTOR_CLOSED_STATE;
+    const int open = (CONTACTOR_CLOSED_STATE == LOW) ? HIGH : LOW;
+    replay_drive_pin(CONTACTOR_POS_IN_PIN, (digitalRead(CONTACTOR_POS_OUT_PIN) == HIGH) ? closed : open);
+    replay_drive_pin(CONTACTOR_PRCHG_IN_PIN, (digitalRead(CONTACTOR_PRCHG_OUT_PIN) == HIGH) ? closed : open);
+    replay_drive_pin(CONTACTOR_NEG_IN_PIN, closed);
+    replay_drive_pin(CONTACTOR_POWER_SUPPLY_IN_PIN, closed);
+}
+
+// setup() of main.cpp without the blocking shunt configuration
+void setup_firmware()
+{
+    for (ACAN_T4 *bus : kBuses)
+    {
+        bus->on_transmit = &log_transmit;
+    }
+    update_contactor_plant();
+    enable_BMS_monitor();
+    enable_update_shunt();
+    enable_update_contactors();
+    enable_handle_battery_CAN_messages();
+    enable_serial_console();
+    start_rate_schedules();
+    reset_task_profiles();
+    start_heartbeat_supervisor();
+}
+
+void loop_firmware()
+{
+    update_contactor_plant();
+    run_realtime_tier();
+    run_best_effort_tier();
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------
+// Trace
+//---------------------------------------------------------------------------------------------------------------------------------------------
+int decimals(float scale)
+{
+    int digits = 0;
+    while (scale < 0.999f && digits < 6)
+    {
+        scale *= 10.0f;
+        ++digits;
+    }
+    return digits;
+}
+
+bool traced(const Options &options, size_t id)
+{
+    return kSignalInfo[id].count == 1U || options.trace_arrays;
+}
+
+void write_trace_header(FILE *file, const Options &options)
+{
+    std::fputs("time_s", file);
+    for (size_t id = 0; id < SIGNAL_COUNT; ++id)
+    {
+        if (!traced(options, id))
+        {
+            continue;
+        }
+        const SignalInfo &info = kSignalInfo[id];
+        for (uint16_t i = 0; i < info.count; ++i)
+        {
+            std::fprintf(file, ",%s", info.name);
+            if (info.count > 1U)
+            {
+                std::fprintf(file, "%u", static_cast<unsigned>(i));
+            }
+            if (info.unit[0] != '\0')
+            {
+                std::fprintf(file, "_%s", info.unit);
+            }
+        }
+    }
+    std::fputc('\n', file);
+}
+
+void write_trace_row(FILE *file, const Options &options)
+{
+    std::fprintf(file, "%.3f", static_cast<double>(replay_time_us) / 1.0e6);
+    for (size_t id = 0; id < SIGNAL_COUNT; ++id)
+    {
+        if (!traced(options, id))
+        {
+            continue;
+        }
+        const SignalInfo &info = kSignalInfo[id];
+        for (uint16_t i = 0; i < info.count; ++i)
+        {
+            const float value = signal_read(static_cast<SignalId>(id), i);
+            if (info.type == SIGNAL_TYPE_F32)
+            {
+                std::fprintf(file, ",%.*f", decimals(info.scale), static_cast<double>(value));
+            }
+            else
+            {
+                std::fprintf(file, ",%lu", static_cast<unsigned long>(value));
+            }
+        }
+    }
+    std::fputc('\n', file);
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------
+// Replay
+//---------------------------------------------------------------------------------------------------------------------------------------------
+struct Replay
+{
+    const Options &options;
+    FILE *trace = nullptr;
+    uint64_t next_tick_us = 0U;
+    uint64_t next_trace_us = 0U;
+    uint64_t first_virtual_us = 0U;
+    std::chrono::steady_clock::time_point wall_start{};
+    uint32_t trace_rows = 0U;
+
+    // Real-time pacing: virtual time t is due at wall_start + t / speed
+    void pace()
+    {
+        if (options.speed <= 0.0)
+        {
+            return;
+        }
+        const auto due = wall_start + std::chrono::microseconds(static_cast<int64_t>(
+                                          static_cast<double>(replay_time_us - first_virtual_us) / options.speed));
+        std::this_thread::sleep_until(due);
+    }
+
+    void tick()
+    {
+        pace();
+        loop_firmware();
+        if (trace != nullptr && replay_time_us >= next_trace_us)
+        {
+            write_trace_row(trace, options);
+            ++trace_rows;
+            next_trace_us += static_cast<uint64_t>(options.trace_period_ms) * 1000U;
+        }
+    }
+
+    // Runs every 1 ms tick up to and including virtual time target
+    void advance_to(uint64_t target_us)
+    {
+        while (next_tick_us <= target_us)
+        {
+            replay_time_us = next_tick_us;
+            next_tick_us += kTickUs;
+            tick();
+        }
+        replay_time_us = (target_us > replay_time_us) ? target_us : replay_time_us;
+    }
+
+    void deliver(const Frame &frame)
+    {
+        frame.bus->deliver(frame.message);
+        pace();
+        loop_firmware(); // the main loop spins between ticks
+    }
+};
+
+int usage(const char *program)
+{
+    std::fprintf(stderr,
+                 "usage: %s [-x factor] [-o trace.csv|-] [-p ms] [-a] [-T tx.log] [-b name=N]... [-t ms] [-v] "
+                 "log.candump|log.asc|-\n",
+                 program);
+    return 2;
+}
+
+void print_report(const LogReader &reader, uint32_t frames, uint32_t out_of_order, double wall_s, double decode_s)
+{
+    const double virtual_s = static_cast<double>(replay_time_us) / 1.0e6;
+    std::fprintf(stderr,
+                 "%lu lines, %lu frames replayed, %lu skipped (unknown bus or syntax), %lu out of order\n",
+                 static_cast<unsigned long>(reader.lines),
+                 static_cast<unsigned long>(frames),
+                 static_cast<unsigned long>(reader.skipped),
+                 static_cast<unsigned long>(out_of_order));
+    std::fprintf(stderr, "bus   accepted  rejected  overflow  transmitted\n");
+    for (ACAN_T4 *bus : kBuses)
+    {
+        std::fprintf(stderr,
+                     "%-5s %8lu  %8lu  %8lu  %11lu\n",
+                     bus_name(bus),
+                     static_cast<unsigned long>(bus->accepted),
+                     static_cast<unsigned long>(bus->rejected),
+                     static_cast<unsigned long>(bus->overflows),
+                     static_cast<unsigned long>(bus->transmitted));
+    }
+    const TaskProfile &rx = task_profiles[TASK_PROFILE_CAN_RX];
+    std::fprintf(stderr,
+                 "virtual %.3f s in %.3f s wall (x%.0f), %.0f frames/s\n",
+                 virtual_s,
+                 wall_s,
+                 (wall_s > 0.0) ? virtual_s / wall_s : 0.0,
+                 (wall_s > 0.0) ? frames / wall_s : 0.0);
+    std::fprintf(stderr,
+                 "decode: %lu RX passes avg %.2f us p99 %.2f us max %.2f us, %.0f frames/s of decode time\n",
+                 static_cast<unsigned long>(rx.get_count()),
+                 static_cast<double>(rx.avg_us()),
+                 static_cast<double>(rx.p99_us()),
+                 static_cast<double>(rx.max_us()),
+                 (decode_s > 0.0) ? frames / decode_s : 0.0);
+    std::fprintf(stderr, "final state:\n");
+    for (size_t id = 0; id < SIGNAL_COUNT; ++id)
+    {
+        const SignalInfo &info = kSignalInfo[id];
+        if (info.count != 1U)
+        {
+            continue;
+        }
+        const float value = signal_read(static_cast<SignalId>(id));
+        if (info.type == SIGNAL_TYPE_F32)
+        {
+            std::fprintf(stderr, "  %-28s %.*f %s\n", info.name, decimals(info.scale), static_cast<double>(value), info.unit);
+        }
+        else if (info.type == SIGNAL_TYPE_BITS)
+        {
+            std::fprintf(stderr, "  %-28s 0x%lX\n", info.name, static_cast<unsigned long>(value));
+        }
+        else
+        {
+            std::fprintf(stderr, "  %-28s %lu\n", info.name, static_cast<unsigned long>(value));
+        }
+    }
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Options options;
+    const char *input = "-";
+    for (int i = 1; i < argc; ++i)
+    {
+        const bool has_value = (i + 1 < argc);
+        if (std::strcmp(argv[i], "-x") == 0 && has_value)
+        {
+            options.speed = std::atof(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "-o") == 0 && has_value)
+        {
+            options.trace_path = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "-p") == 0 && has_value)
+        {
+            options.trace_period_ms = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "-a") == 0)
+        {
+            options.trace_arrays = true;
+        }
+        else if (std::strcmp(argv[i], "-T") == 0 && has_value)
+        {
+            options.tx_path = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "-t") == 0 && has_value)
+        {
+            options.tail_ms = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "-b") == 0 && has_value)
+        {
+            const char *mapping = argv[++i];
+            const char *equals = std::strchr(mapping, '=');
+            ACAN_T4 *bus = (equals != nullptr) ? bus_by_number(std::strtol(equals + 1, nullptr, 10)) : nullptr;
+            if (bus == nullptr)
+            {
+                return usage(argv[0]);
+            }
+            options.aliases.push_back(Alias{std::string(mapping, equals), bus});
+        }
+        else if (std::strcmp(argv[i], "-v") == 0)
+        {
+            options.verbose = true;
+        }
+        else if (argv[i][0] == '-' && argv[i][1] != '\0')
+        {
+            return usage(argv[0]);
+        }
+        else
+        {
+            input = argv[i];
+        }
+    }
+    if (options.trace_period_ms == 0U)
+    {
+        return usage(argv[0]);
+    }
+
+    FILE *in = (std::strcmp(input, "-") == 0) ? stdin : std::fopen(input, "r");
+    if (in == nullptr)
+    {
+        std::perror(input);
+        return 1;
+    }
+    Replay replay{options};
+    if (std::strcmp(options.trace_path, "-") != 0)
+    {
+        replay.trace = std::fopen(options.trace_path, "w");
+        if (replay.trace == nullptr)
+        {
+            std::perror(options.trace_path);
+            return 1;
+        }
+        write_trace_header(replay.trace, options);
+    }
+    if (options.tx_path != nullptr)
+    {
+        tx_log = std::fopen(options.tx_path, "w");
+        if (tx_log == nullptr)
+        {
+            std::perror(options.tx_path);
+            return 1;
+        }
+    }
+    Serial.sink = options.verbose ? stderr : nullptr;
+
+    setup_firmware();
+    // The first frame arrives on the next tick after setup
+    replay.next_tick_us = replay_time_us;
+    replay.next_trace_us = replay_time_us;
+    replay.first_virtual_us = replay_time_us;
+    replay.wall_start = std::chrono::steady_clock::now();
+
+    LogReader reader{options};
+    bool have_base = false;
+    uint64_t log_base_us = 0U;
+    uint64_t virtual_base_us = 0U;
+    uint64_t last_log_us = 0U;
+    uint32_t frames = 0U;
+    uint32_t out_of_order = 0U;
+    char line[512];
+    while (std::fgets(line, sizeof(line), in) != nullptr)
+    {
+        Frame frame;
+        if (!reader.parse(line, &frame))
+        {
+            continue;
+        }
+        if (!have_base)
+        {
+            have_base = true;
+            log_base_us = frame.time_us;
+            virtual_base_us = replay_time_us + kTickUs;
+            last_log_us = frame.time_us;
+        }
+        // Frames that go back in time (merged logs) are delivered at once
+        if (frame.time_us < last_log_us)
+        {
+            ++out_of_order;
+            frame.time_us = last_log_us;
+        }
+        last_log_us = frame.time_us;
+        replay.advance_to(virtual_base_us + (frame.time_us - log_base_us));
+        replay.deliver(frame);
+        ++frames;
+    }
+    replay.advance_to(replay_time_us + static_cast<uint64_t>(options.tail_ms) * 1000U);
+    const double wall_s =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - replay.wall_start).count();
+    if (in != stdin)
+    {
+        std::fclose(in);
+    }
+    if (replay.trace != nullptr)
+    {
+        std::fclose(replay.trace);
+        std::fprintf(stderr, "%lu trace rows -> %s\n", static_cast<unsigned long>(replay.trace_rows), options.trace_path);
+    }
+    if (tx_log != nullptr)
+    {
+        std::fclose(tx_log);
+    }
+
+    const TaskProfile &rx = task_profiles[TASK_PROFILE_CAN_RX];
+    const double decode_s = static_cast<double>(rx.busy_cycles()) / task_profiler_cycles_per_us() / 1.0e6;
+    print_report(reader, frames, out_of_order, wall_s, decode_s);
+    return 0;
+}
@@ -0,0 +1,275 @@
+// Host decoder for the binary telemetry stream on SerialUSB1
+// (src/utils/telemetry_protocol.h). Reads a capture file or the serial
+// device and writes one CSV file per group:
+//
+//   <prefix>_<group>.csv: time_s, sequence, then one column per value in
+//   layout order, named [m<block>_]<field>[<index>][_<unit>], physical units
+//
+// Frames failing COBS, the version or the CRC are counted and skipped; the
+// stream resynchronises at the next delimiter. A sequence gap (the firmware
+// skipped slots while the host was not reading fast enough) is counted as
+// lost frames.
+//
+// Build: pio run -e native_telemetry_decode
+// Usage: stty -F /dev/ttyACM1 raw && program [-o prefix] /dev/ttyACM1
+//        program [-o prefix] capture.bin      ('-' or nothing reads stdin)
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "utils/cobs.h"
+#include "utils/telemetry_protocol.h"
+
+namespace
+{
+struct GroupOutput
+{
+    FILE *file = nullptr;
+    uint32_t frames = 0U;
+    uint32_t lost = 0U;
+    uint32_t layout_errors = 0U;
+    bool have_sequence = false;
+    uint16_t next_sequence = 0U;
+};
+
+struct Decoder
+{
+    std::string prefix;
+    GroupOutput groups[TELEMETRY_GROUP_COUNT];
+    uint32_t bad_frames = 0U;
+    uint64_t bytes = 0U;
+    uint64_t time_base_us = 0U;
+    uint32_t last_time_us = 0U;
+    bool have_time = false;
+
+    std::vector<uint8_t> encoded;
+    std::vector<uint8_t> decoded;
+
+    static int decimals(float scale)
+    {
+        int digits = 0;
+        while (scale < 0.999f && digits < 6)
+        {
+            scale *= 10.0f;
+            ++digits;
+        }
+        return digits;
+    }
+
+    static void column_name(const TelemetryField &field, int block, uint8_t index, std::string *out)
+    {
+        char name[64];
+        const char *unit_sep = (field.unit[0] != '\0') ? "_" : "";
+        if (block >= 0)
+        {
+            std::snprintf(name, sizeof(name), "m%d_", block);
+            *out += name;
+        }
+        *out += field.name;
+        if (field.count > 1U)
+        {
+            std::snprintf(name, sizeof(name), "%u", static_cast<unsigned>(index));
+            *out += name;
+        }
+        std::snprintf(name, sizeof(name), "%s%s", unit_sep, field.unit);
+        *out += name;
+    }
+
+    FILE *open_group(TelemetryGroup group, const TelemetryFrameView &view)
+    {
+        GroupOutput &output = groups[group];
+        if (output.file != nullptr)
+        {
+            return output.file;
+        }
+        const std::string path = prefix + "_" + kTelemetryLayouts[group].name + ".csv";
+        output.file = std::fopen(path.c_str(), "w");
+        if (output.file == nullptr)
+        {
+            std::perror(path.c_str());
+            return nullptr;
+        }
+        // Header from the first frame (the block count of a group is fixed)
+        std::string header = "time_s,sequence";
+        telemetry_for_each_value(view, [&header](const TelemetryField &field, int block, uint8_t index, int64_t) {
+            header += ",";
+            column_name(field, block, index, &header);
+        });
+        std::fprintf(output.file, "%s\n", header.c_str());
+        return output.file;
+    }
+
+    void frame(const uint8_t *data, size_t size)
+    {
+        decoded.resize(size);
+        const size_t decoded_size = cobs_decode(data, size, decoded.data(), decoded.size());
+        TelemetryFrameView view;
+        if (decoded_size == 0U || !telemetry_parse_frame(decoded.data(), decoded_size, &view))
+        {
+            ++bad_frames;
+            return;
+        }
+
+        // Unwrap the 32-bit µs clock (about 71 minutes)
+        if (have_time && view.time_us < last_time_us && last_time_us - view.time_us > 0x80000000UL)
+        {
+            time_base_us += 0x100000000ULL;
+        }
+        last_time_us = view.time_us;
+        have_time = true;
+
+        GroupOutput &output = groups[view.group];
+        if (output.have_sequence)
+        {
+            output.lost += static_cast<uint16_t>(view.sequence - output.next_sequence);
+        }
+        output.have_sequence = true;
+        output.next_sequence = static_cast<uint16_t>(view.sequence + 1U);
+
+        FILE *file = open_group(view.group, view);
+        if (file == nullptr)
+        {
+            return;
+        }
+        char line[8192];
+        int length = std::snprintf(line,
+                                   sizeof(line),
+                                   "%.6f,%u",
+                                   static_cast<double>(time_base_us + view.time_us) / 1.0e6,
+                                   static_cast<unsigned>(view.sequence));
+        const bool ok =
+            telemetry_for_each_value(view, [&](const TelemetryField &field, int, uint8_t, int64_t raw) {
+                if (length > 0 && static_cast<size_t>(length) < sizeof(line) - 32U)
+                {
+                    if (field.scale == 1.0f)
+                    {
+                        length += std::snprintf(line + length, sizeof(line) - length, ",%lld", static_cast<long long>(raw));
+                    }
+                    else
+                    {
+                        length += std::snprintf(line + length,
+                                                sizeof(line) - length,
+                                                ",%.*f",
+                                                decimals(field.scale),
+                                                static_cast<double>(raw) * field.scale);
+                    }
+                }
+            });
+        if (!ok)
+        {
+            ++output.layout_errors;
+            return;
+        }
+        std::fprintf(file, "%s\n", line);
+        ++output.frames;
+    }
+
+    void feed(const uint8_t *data, size_t size)
+    {
+        bytes += size;
+        for (size_t i = 0; i < size; ++i)
+        {
+            if (data[i] != 0U)
+            {
+                encoded.push_back(data[i]);
+                continue;
+            }
+            if (!encoded.empty())
+            {
+                frame(encoded.data(), encoded.size());
+            }
+            encoded.clear();
+        }
+    }
+
+    void close()
+    {
+        for (GroupOutput &output : groups)
+        {
+            if (output.file != nullptr)
+            {
+                std::fclose(output.file);
+                output.file = nullptr;
+            }
+        }
+    }
+};
+
+int usage(const char *program)
+{
+    std::fprintf(stderr, "usage: %s [-o prefix] [capture.bin | /dev/ttyACMx | -]\n", program);
+    return 2;
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Decoder decoder;
+    decoder.prefix = "telemetry";
+    const char *input = "-";
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            decoder.prefix = argv[++i];
+        }
+        else if (argv[i][0] == '-' && argv[i][1] != '\0')
+        {
+            return usage(argv[0]);
+        }
+        else
+        {
+            input = argv[i];
+        }
+    }
+
+    FILE *in = (std::strcmp(input, "-") == 0) ? stdin : std::fopen(input, "rb");
+    if (in == nullptr)
+    {
+        std::perror(input);
+        return 1;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    uint8_t buffer[65536];
+    size_t count = 0U;
+    while ((count = std::fread(buffer, 1U, sizeof(buffer), in)) > 0U)
+    {
+        decoder.feed(buffer, count);
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (in != stdin)
+    {
+        std::fclose(in);
+    }
+    decoder.close();
+
+    uint32_t frames = 0U;
+    for (int g = 0; g < TELEMETRY_GROUP_COUNT; ++g)
+    {
+        const GroupOutput &output = decoder.groups[g];
+        frames += output.frames;
+        if (output.frames != 0U || output.lost != 0U)
+        {
+            std::fprintf(stderr,
+                         "%-12s %8lu frames %6lu lost %4lu layout errors -> %s_%s.csv\n",
+                         kTelemetryLayouts[g].name,
+                         static_cast<unsigned long>(output.frames),
+                         static_cast<unsigned long>(output.lost),
+                         static_cast<unsigned long>(output.layout_errors),
+                         decoder.prefix.c_str(),
+                         kTelemetryLayouts[g].name);
+        }
+    }
+    std::fprintf(stderr,
+                 "%llu bytes, %lu frames, %lu bad frames, %.1f MB/s\n",
+                 static_cast<unsigned long long>(decoder.bytes),
+                 static_cast<unsigned long>(frames),
+                 static_cast<unsigned long>(decoder.bad_frames),
+                 (seconds > 0.0) ? decoder.bytes / seconds / 1.0e6 : 0.0);
+    return 0;
+}